@@ -4,13 +4,19 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+D:/NEW-MCU/mockproject1/Mock_prj1/src/source/boot_handoff.c \
+D:/NEW-MCU/mockproject1/Mock_prj1/src/source/clock_tree.c \
 ../src/source/Driver_NVIC.c 
 
 OBJS += \
-./src/source/Driver_NVIC.o 
+./src/source/Driver_NVIC.o \
+./src/source/boot_handoff.o \
+./src/source/clock_tree.o 
 
 C_DEPS += \
-./src/source/Driver_NVIC.d 
+./src/source/Driver_NVIC.d \
+./src/source/boot_handoff.d \
+./src/source/clock_tree.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -21,4 +27,18 @@ src/source/%.o: ../src/source/%.c
 	@echo 'Finished building: $<'
 	@echo ' '
 
+src/source/boot_handoff.o: D:/NEW-MCU/mockproject1/Mock_prj1/src/source/boot_handoff.c
+	@echo 'Building file: $<'
+	@echo 'Invoking: Standard S32DS C Compiler'
+	arm-none-eabi-gcc "@src/source/boot_handoff.args" -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+src/source/clock_tree.o: D:/NEW-MCU/mockproject1/Mock_prj1/src/source/clock_tree.c
+	@echo 'Building file: $<'
+	@echo 'Invoking: Standard S32DS C Compiler'
+	arm-none-eabi-gcc "@src/source/clock_tree.args" -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
 
@@ -51,15 +51,202 @@
 #include <stdint.h>
 
 
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/* Cortex-M4 debug registers used for STARTUP_DWT_TIMING */
+#define STARTUP_DEMCR           (*(volatile uint32_t *)0xE000EDFCUL)
+#define STARTUP_DEMCR_TRCENA    (1UL << 24)
+#define STARTUP_DWT_CTRL        (*(volatile uint32_t *)0xE0001000UL)
+#define STARTUP_DWT_CYCCNT      (*(volatile uint32_t *)0xE0001004UL)
+#define STARTUP_DWT_CYCCNTENA   (1UL << 0)
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+uint32_t startup_init_cycles;
+
 /*******************************************************************************
  * Static Variables
  ******************************************************************************/
 static volatile uint32_t * const s_vectors[NUMBER_OF_CORES] = FEATURE_INTERRUPT_INT_VECTORS;
+#if !defined(__ARMCC_VERSION) && (STARTUP_DMA_MIN_SIZE > 0U)
+static const uint32_t s_zero = 0U;
+#endif
 
 /*******************************************************************************
  * Code
  ******************************************************************************/
 
+#if !defined(__ARMCC_VERSION)
+#if (STARTUP_DMA_MIN_SIZE > 0U)
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : init_dma_words
+ * Description   : Move size bytes (multiple of 4) with one software-started
+ * major loop of STARTUP_DMA_CHANNEL. src_off is 4 for a copy, 0 to repeat one
+ * source word (clear).
+ *
+ *END**************************************************************************/
+static void init_dma_words(uint32_t dst, uint32_t src, uint16_t src_off, uint32_t size)
+{
+    /* DMA clock is on out of reset; kept on for a start after a warm reset */
+    IP_SIM->PLATCGC |= SIM_PLATCGC_CGCDMA_MASK;
+
+    IP_DMA->TCD[STARTUP_DMA_CHANNEL].SADDR        = src;
+    IP_DMA->TCD[STARTUP_DMA_CHANNEL].SOFF         = src_off;
+    IP_DMA->TCD[STARTUP_DMA_CHANNEL].ATTR         = DMA_TCD_ATTR_SSIZE(2U) | DMA_TCD_ATTR_DSIZE(2U);
+    IP_DMA->TCD[STARTUP_DMA_CHANNEL].NBYTES.MLNO  = size;
+    IP_DMA->TCD[STARTUP_DMA_CHANNEL].SLAST        = 0U;
+    IP_DMA->TCD[STARTUP_DMA_CHANNEL].DADDR        = dst;
+    IP_DMA->TCD[STARTUP_DMA_CHANNEL].DOFF         = 4U;
+    IP_DMA->TCD[STARTUP_DMA_CHANNEL].CITER.ELINKNO = 1U;
+    IP_DMA->TCD[STARTUP_DMA_CHANNEL].BITER.ELINKNO = 1U;
+    IP_DMA->TCD[STARTUP_DMA_CHANNEL].DLASTSGA     = 0U;
+    IP_DMA->TCD[STARTUP_DMA_CHANNEL].CSR          = DMA_TCD_CSR_START_MASK;
+
+    while ((IP_DMA->TCD[STARTUP_DMA_CHANNEL].CSR & DMA_TCD_CSR_DONE_MASK) == 0U)
+    {
+        /* Wait for the major loop */
+    }
+    IP_DMA->CDNE = (uint8_t)STARTUP_DMA_CHANNEL;
+}
+#endif /* STARTUP_DMA_MIN_SIZE */
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : init_copy
+ * Description   : Copy [src, src_end) to dst. Word-aligned sections move
+ * four words per LDM/STM pair, then word by word; the rest byte by byte.
+ *
+ *END**************************************************************************/
+static void init_copy(uint8_t * dst, const uint8_t * src, const uint8_t * src_end)
+{
+    uint32_t size = (uint32_t)(src_end - src);
+    uint32_t * dst_w;
+    const uint32_t * src_w;
+    uint32_t blocks;
+
+    if ((((uint32_t)dst | (uint32_t)src) & 3U) == 0U)
+    {
+#if (STARTUP_DMA_MIN_SIZE > 0U)
+        if (size >= STARTUP_DMA_MIN_SIZE)
+        {
+            init_dma_words((uint32_t)dst, (uint32_t)src, 4U, size & ~3UL);
+            dst  += size & ~3UL;
+            src  += size & ~3UL;
+            size &= 3U;
+        }
+#endif
+        dst_w  = (uint32_t *)dst;
+        src_w  = (const uint32_t *)src;
+        blocks = size & ~15UL;
+        if (blocks != 0U)
+        {
+#if defined(__GNUC__) && !defined(__ghs__)
+            __asm volatile (
+                "1: ldmia %[s]!, {r2-r5}    \n"
+                "   stmia %[d]!, {r2-r5}    \n"
+                "   subs  %[n], %[n], #16   \n"
+                "   bhi   1b                \n"
+                : [s] "+r" (src_w), [d] "+r" (dst_w), [n] "+r" (blocks)
+                :
+                : "r2", "r3", "r4", "r5", "cc", "memory");
+#else
+            for (; blocks != 0U; blocks -= 16U)
+            {
+                dst_w[0] = src_w[0];
+                dst_w[1] = src_w[1];
+                dst_w[2] = src_w[2];
+                dst_w[3] = src_w[3];
+                dst_w += 4;
+                src_w += 4;
+            }
+#endif
+        }
+        for (size &= 15U; size >= 4U; size -= 4U)
+        {
+            *dst_w = *src_w;
+            dst_w++;
+            src_w++;
+        }
+        dst = (uint8_t *)dst_w;
+        src = (const uint8_t *)src_w;
+    }
+
+    while (src_end != src)
+    {
+        *dst = *src;
+        dst++;
+        src++;
+    }
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : init_clear
+ * Description   : Clear [start, end), four words per STM when aligned.
+ *
+ *END**************************************************************************/
+static void init_clear(uint8_t * start, const uint8_t * end)
+{
+    uint32_t size = (uint32_t)(end - start);
+    uint32_t * start_w;
+    uint32_t blocks;
+
+    if (((uint32_t)start & 3U) == 0U)
+    {
+#if (STARTUP_DMA_MIN_SIZE > 0U)
+        if (size >= STARTUP_DMA_MIN_SIZE)
+        {
+            init_dma_words((uint32_t)start, (uint32_t)&s_zero, 0U, size & ~3UL);
+            start += size & ~3UL;
+            size  &= 3U;
+        }
+#endif
+        start_w = (uint32_t *)start;
+        blocks  = size & ~15UL;
+        if (blocks != 0U)
+        {
+#if defined(__GNUC__) && !defined(__ghs__)
+            __asm volatile (
+                "   movs  r2, #0            \n"
+                "   movs  r3, #0            \n"
+                "   movs  r4, #0            \n"
+                "   movs  r5, #0            \n"
+                "1: stmia %[d]!, {r2-r5}    \n"
+                "   subs  %[n], %[n], #16   \n"
+                "   bhi   1b                \n"
+                : [d] "+r" (start_w), [n] "+r" (blocks)
+                :
+                : "r2", "r3", "r4", "r5", "cc", "memory");
+#else
+            for (; blocks != 0U; blocks -= 16U)
+            {
+                start_w[0] = 0U;
+                start_w[1] = 0U;
+                start_w[2] = 0U;
+                start_w[3] = 0U;
+                start_w += 4;
+            }
+#endif
+        }
+        for (size &= 15U; size >= 4U; size -= 4U)
+        {
+            *start_w = 0U;
+            start_w++;
+        }
+        start = (uint8_t *)start_w;
+    }
+
+    while (end != start)
+    {
+        *start = 0;
+        start++;
+    }
+}
+#endif /* !__ARMCC_VERSION */
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : init_data_bss
@@ -68,6 +255,8 @@ static volatile uint32_t * const s_vectors[NUMBER_OF_CORES] = FEATURE_INTERRUPT_
  * - Copy initialized data from ROM to RAM.
  * - Copy code that should reside in RAM from ROM
  * - Clear the zero-initialized data section.
+ * Aligned sections are moved four words at a time (init_copy/init_clear);
+ * .noinit is not touched.
  *
  * Tool Chains:
  *   __GNUC__           : GNU Compiler Collection
@@ -80,8 +269,17 @@ static volatile uint32_t * const s_vectors[NUMBER_OF_CORES] = FEATURE_INTERRUPT_
  *END**************************************************************************/
 void init_data_bss(void)
 {
+#if defined(__ARMCC_VERSION)
     uint32_t n;
+#endif
     uint8_t coreId;
+#if (STARTUP_DWT_TIMING)
+    uint32_t t0;
+
+    STARTUP_DEMCR    |= STARTUP_DEMCR_TRCENA;
+    STARTUP_DWT_CTRL |= STARTUP_DWT_CYCCNTENA;
+    t0 = STARTUP_DWT_CYCCNT;
+#endif
 /* For ARMC we are using the library method of initializing DATA, Custom Section and
  * Code RAM sections so the below variables are not needed */
 #if !defined(__ARMCC_VERSION)
@@ -170,35 +368,16 @@ void init_data_bss(void)
 
 #if !defined(__ARMCC_VERSION)
     /* Copy initialized data from ROM to RAM */
-    while (data_rom_end != data_rom)
-    {
-        *data_ram = *data_rom;
-        data_ram++;
-        data_rom++;
-    }
+    init_copy(data_ram, data_rom, data_rom_end);
 
     /* Copy functions from ROM to RAM */
-    while (code_rom_end != code_rom)
-    {
-        *code_ram = *code_rom;
-        code_ram++;
-        code_rom++;
-    }
+    init_copy(code_ram, code_rom, code_rom_end);
 
     /* Clear the zero-initialized data section */
-    while(bss_end != bss_start)
-    {
-        *bss_start = 0;
-        bss_start++;
-    }
+    init_clear(bss_start, bss_end);
 
     /* Copy customsection rom to ram */
-    while(custom_rom_end != custom_rom)
-    {
-        *custom_ram = *custom_rom;
-        custom_rom++;
-        custom_ram++;
-    }
+    init_copy(custom_ram, custom_rom, custom_rom_end);
 #endif
     coreId = (uint8_t)GET_CORE_ID();
 #if defined (__ARMCC_VERSION)
@@ -215,10 +394,8 @@ void init_data_bss(void)
     if (__VECTOR_RAM != __VECTOR_TABLE)
     {
         /* Copy the vector table from ROM to RAM */
-        for (n = 0; n < (((uint32_t)__RAM_VECTOR_TABLE_SIZE)/sizeof(uint32_t)); n++)
-        {
-            __VECTOR_RAM[n] = __VECTOR_TABLE[n];
-        }
+        init_copy((uint8_t *)__VECTOR_RAM, (const uint8_t *)__VECTOR_TABLE,
+                  (const uint8_t *)__VECTOR_TABLE + (uint32_t)__RAM_VECTOR_TABLE_SIZE);
         /* Point the VTOR to the position of vector table */
         *s_vectors[coreId] = (uint32_t)__VECTOR_RAM;
     }
@@ -229,6 +406,11 @@ void init_data_bss(void)
     }
 #endif
 
+#if (STARTUP_DWT_TIMING)
+    /* .bss is cleared by now */
+    startup_init_cycles = STARTUP_DWT_CYCCNT - t0;
+#endif
+
 }
 
 /*******************************************************************************
@@ -1,13 +1,18 @@
 #include "S32K144.h"
 #include "S32K144_features.h"
 #include "Driver_NVIC.h"
+#include "boot_handoff.h"
+#include "boot_api.h"
+#include "clock_tree.h"
+#include <stddef.h>
 
 #define BLUELED_PIN 0		// blue led
 #define REDLED_PIN 15    //red led
 #define GREENLED_PIN 16    // green led
+#define BUTTON_PIN 13		// SW2 on PTC13, active low
 
 
-volatile unsigned long delay_second = 384000u; /* 128 kHZ *3 */
+volatile unsigned long delay_second = 384000u; /* 128 kHZ *3, tính lại trong LPIT0_init() */
 volatile uint8_t delay_done = 0;
 
 void relocate_vector_table(void)
@@ -23,8 +28,8 @@ void toggle_led(uint32_t pin)
 void LPIT0_init(void)
 {
 	/* 1. Chọn nguồn clock cho LPIT (LPO 128 kHz = option 7) */
-	IP_PCC->PCCn[PCC_LPIT_INDEX] = PCC_PCCn_PCS(7);
-	IP_PCC->PCCn[PCC_LPIT_INDEX] |= PCC_PCCn_CGC_MASK;
+	(void)ClockTree_PccAcquire(PCC_LPIT_INDEX, CLOCK_TREE_PCS_LPO);
+	delay_second = 3U * ClockTree_PccHz(PCC_LPIT_INDEX);
     /* 2. Enable module */
     IP_LPIT0->MCR = LPIT_MCR_M_CEN_MASK;   // enable module
     /* 3. Nạp giá trị đếm cho 3s */
@@ -50,13 +55,25 @@ void LPIT0_Ch0_IRQHandler(void)
     }
 }
 
+/* SW2 pressed: restart into the bootloader through its service table */
+void check_boot_button(void)
+{
+    const boot_api_t *api = BootApi_Get();
+
+    if ((api != NULL) && ((IP_PTC->PDIR & (1UL << BUTTON_PIN)) == 0U)) {
+        api->EnterBootloader();
+    }
+}
+
 void delay3s(void)
 {
     delay_done = 0;
     /* Start timer channel 0 */
     IP_LPIT0->TMR[0].TCTRL |= LPIT_TMR_TCTRL_T_EN_MASK;
     /* Chờ ISR set cờ */
-    while (!delay_done);
+    while (!delay_done) {
+        check_boot_button();
+    }
     /* Dừng timer nếu muốn one-shot */
     IP_LPIT0->TMR[0].TCTRL &= ~LPIT_TMR_TCTRL_T_EN_MASK;
 }
@@ -74,8 +91,16 @@ void set_led(uint32_t red, uint32_t green, uint32_t blue)
 
 int main(void)
 {
+	const boot_handoff_t *handoff = BootHandoff_Get();
+
 	relocate_vector_table();
 	LPIT0_init();
+
+	/* Bootloader already clocked PORTD and set the LED pins as GPIO outputs */
+	if ((handoff == NULL) ||
+	    ((handoff->periph_flags & (BOOT_HANDOFF_PERIPH_PORTD | BOOT_HANDOFF_PERIPH_LED_GPIO)) !=
+	     (BOOT_HANDOFF_PERIPH_PORTD | BOOT_HANDOFF_PERIPH_LED_GPIO)))
+	{
 	 IP_PCC -> PCCn[PCC_PORTD_INDEX] = PCC_PCCn_CGC_MASK; /* Enable clock to PORT D */
 
 
@@ -90,6 +115,17 @@ int main(void)
 	 /* Configure port D0 as GPIO output (LED on EVB) */
 	 IP_PTD->PDDR |= 1<<GREENLED_PIN; /* Port D0: Data Direction= output */
 	 IP_PORTD->PCR[16] = 0x00000100; /* Port D0: MUX = GPIO */
+	}
+
+	/* Bootloader already set SW2 as GPIO input with pull-up */
+	if ((handoff == NULL) ||
+	    ((handoff->periph_flags & (BOOT_HANDOFF_PERIPH_PORTC | BOOT_HANDOFF_PERIPH_BUTTON_GPIO)) !=
+	     (BOOT_HANDOFF_PERIPH_PORTC | BOOT_HANDOFF_PERIPH_BUTTON_GPIO)))
+	{
+	 IP_PCC->PCCn[PCC_PORTC_INDEX] = PCC_PCCn_CGC_MASK; /* Enable clock to PORT C */
+	 IP_PTC->PDDR &= ~(1UL << BUTTON_PIN); /* Port C13: Data Direction= input */
+	 IP_PORTC->PCR[BUTTON_PIN] = PORT_PCR_MUX(1U) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK; /* GPIO, pull-up */
+	}
 
 	 // Clear tất cả LED trước
 	 IP_PTD->PSOR = (1 << REDLED_PIN) | (1 << GREENLED_PIN) | (1 << BLUELED_PIN);
@@ -83,6 +83,48 @@ extern "C" {
 #define DISABLE_INTERRUPTS() __asm("cpsid i")
 #endif
 
+/** \brief  Mask the interrupts of one priority level and below (BASEPRI)
+ *    prio is the register value, (level << (8 - __NVIC_PRIO_BITS)); saved
+ *    receives the previous BASEPRI. BASEPRI_MAX only ever raises the mask, so
+ *    nested sections keep the stricter level. Higher priority interrupts stay
+ *    live. Other tool chains fall back to the global mask.
+ */
+#if defined (__GNUC__)
+#define MASK_PRIORITY(saved, prio)  do { __asm volatile ("mrs %0, basepri" : "=r" (saved) : : "memory"); \
+                                         __asm volatile ("msr basepri_max, %0" : : "r" (prio) : "memory"); } while (0)
+#define UNMASK_PRIORITY(saved)      __asm volatile ("msr basepri, %0" : : "r" (saved) : "memory")
+#else
+#define MASK_PRIORITY(saved, prio)  do { (saved) = 0U; (void)(prio); DISABLE_INTERRUPTS(); } while (0)
+#define UNMASK_PRIORITY(saved)      do { (void)(saved); ENABLE_INTERRUPTS(); } while (0)
+#endif
+
+/** \brief  Masked-window hooks of the latency histograms (src/include/boot_lat.h)
+ *    DISABLE_INTERRUPTS() and MASK_PRIORITY() open a window; it closes when
+ *    neither PRIMASK nor BASEPRI masks any more, so nested sections count as
+ *    one window. BOOT_LAT_ENABLE takes its default from boot_lat.h.
+ */
+#if defined (__GNUC__)
+#include "boot_lat.h"
+#if (BOOT_LAT_ENABLE)
+#undef ENABLE_INTERRUPTS
+#undef DISABLE_INTERRUPTS
+#undef MASK_PRIORITY
+#undef UNMASK_PRIORITY
+#define ENABLE_INTERRUPTS()  do { uint32_t bp_; \
+                                  __asm volatile ("mrs %0, basepri" : "=r" (bp_) : : "memory"); \
+                                  if (bp_ == 0U) { BootLat_MaskEnd(); } \
+                                  __asm volatile ("cpsie i" : : : "memory"); } while (0)
+#define DISABLE_INTERRUPTS() do { __asm volatile ("cpsid i" : : : "memory"); BootLat_MaskBegin(); } while (0)
+#define MASK_PRIORITY(saved, prio)  do { __asm volatile ("mrs %0, basepri" : "=r" (saved) : : "memory"); \
+                                         __asm volatile ("msr basepri_max, %0" : : "r" (prio) : "memory"); \
+                                         BootLat_MaskBegin(); } while (0)
+#define UNMASK_PRIORITY(saved)      do { uint32_t pm_; \
+                                         __asm volatile ("mrs %0, primask" : "=r" (pm_) : : "memory"); \
+                                         if (((saved) == 0U) && (pm_ == 0U)) { BootLat_MaskEnd(); } \
+                                         __asm volatile ("msr basepri, %0" : : "r" (saved) : "memory"); } while (0)
+#endif /* BOOT_LAT_ENABLE */
+#endif
+
 
 /** \brief  Enter low-power standby state
  *    WFI (Wait For Interrupt) makes the processor suspend execution (Clock is stopped) until an IRQ interrupts.
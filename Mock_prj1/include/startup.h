@@ -108,6 +108,46 @@
     #pragma section = "__CODE_ROM"
 #endif
 
+/*
+ * init_data_bss() copies and clears word-aligned sections in blocks of four
+ * words (LDM/STM) and the remainder word by word, then byte by byte.
+ *
+ * STARTUP_DMA_MIN_SIZE: a word-aligned section of at least this many bytes
+ * is moved by eDMA channel STARTUP_DMA_CHANNEL instead (software start, one
+ * major loop, 32-bit transfers). 0 keeps everything on the CPU.
+ *
+ * STARTUP_DWT_TIMING: init_data_bss() enables the DWT cycle counter and
+ * stores its own duration in startup_init_cycles (.bss is written after it
+ * has been cleared).
+ */
+#ifndef STARTUP_DMA_MIN_SIZE
+#define STARTUP_DMA_MIN_SIZE    (0U)
+#endif
+#ifndef STARTUP_DMA_CHANNEL
+#define STARTUP_DMA_CHANNEL     (0U)
+#endif
+#ifndef STARTUP_DWT_TIMING
+#define STARTUP_DWT_TIMING      (1)
+#endif
+
+/*
+ * Variables in .noinit are neither loaded nor cleared by init_data_bss().
+ * The section follows the handoff block in m_noinit; the ECC
+ * initialization of startup_S32K144.S skips it unless the reset was a
+ * power-on or low-voltage reset, so the content survives a warm reset.
+ * After a power-on reset it reads as zero.
+ */
+#if defined(__GNUC__) || defined(__ghs__)
+    #define STARTUP_NOINIT      __attribute__((section(".noinit")))
+#elif defined(__ICCARM__)
+    #define STARTUP_NOINIT      __no_init
+#else
+    #define STARTUP_NOINIT
+#endif
+
+/*! @brief Core cycles spent in init_data_bss() (0 without STARTUP_DWT_TIMING). */
+extern uint32_t startup_init_cycles;
+
 /*!
  * @brief Make necessary initializations for RAM.
  *
@@ -10,6 +10,51 @@
 
 
 #include "Driver_NVIC.h"
+#include "S32K144_features.h"
+#include "cmsis_gcc.h"
+#include <stddef.h>
+
+/* SRAM_L start to SRAM_U end: a vector table there can be written */
+#define NVIC_SRAM_START     (0x1FFF8000UL)
+#define NVIC_SRAM_END       (0x20007000UL)
+
+/* Exception number of IRQn 0 in the vector table */
+#define NVIC_USER_IRQ_OFFSET (16U)
+
+#ifndef NVIC_VECTOR_PORT
+/**
+ * @brief Vector table VTOR points to, NULL if it is not in SRAM
+ */
+static NVIC_Handler_t *NVIC_RamTable(void)
+{
+    uint32_t vtor = S32_SCB->VTOR;
+
+    if ((vtor < NVIC_SRAM_START) || (vtor >= NVIC_SRAM_END)) {
+        return NULL;
+    }
+    return (NVIC_Handler_t *)vtor;
+}
+#define NVIC_VECTOR_TABLE() NVIC_RamTable()
+#endif
+
+/**
+ * @brief Entry of IRQn in the SRAM vector table, NULL if there is none
+ */
+static NVIC_Handler_t *NVIC_Entry(IRQn_Type IRQn)
+{
+    NVIC_Handler_t *table;
+
+    if (((int32_t)IRQn < (int32_t)FEATURE_INTERRUPT_IRQ_MIN) ||
+        ((int32_t)IRQn > (int32_t)FEATURE_INTERRUPT_IRQ_MAX)) {
+        return NULL;
+    }
+    table = NVIC_VECTOR_TABLE();
+    if (table == NULL) {
+        return NULL;
+    }
+    return &table[(int32_t)NVIC_USER_IRQ_OFFSET + (int32_t)IRQn];
+}
+
 /**
  * @brief Enable một IRQ trong NVIC
  */
@@ -60,3 +105,31 @@ void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority) {
 uint32_t NVIC_GetPriority(IRQn_Type IRQn) {
     return (uint32_t)(NVIC->IP[(uint32_t)IRQn] >> (8U - __NVIC_PRIO_BITS));
 }
+
+
+/**
+ * @brief Ghi handler vào vector table trong SRAM, trả về handler cũ
+ */
+NVIC_Handler_t NVIC_InstallHandler(IRQn_Type IRQn, NVIC_Handler_t handler) {
+    volatile NVIC_Handler_t *entry = NVIC_Entry(IRQn);
+    NVIC_Handler_t old;
+
+    if ((entry == NULL) || (handler == NULL)) {
+        return NULL;
+    }
+    old = *entry;
+    *entry = handler;
+    /* The store completes before the next exception entry fetches the vector */
+    __DSB();
+    __ISB();
+    return old;
+}
+
+/**
+ * @brief Đọc handler của một IRQ từ vector table trong SRAM
+ */
+NVIC_Handler_t NVIC_GetHandler(IRQn_Type IRQn) {
+    volatile NVIC_Handler_t *entry = NVIC_Entry(IRQn);
+
+    return (entry != NULL) ? *entry : NULL;
+}
@@ -14,6 +14,8 @@
 
 #include "Driver_PORT_S32K144.h"
 #include "Driver_NVIC.h"
+#include "boot_trace.h"
+#include "clock_tree.h"
 
 #define PORT_MAX_PINS   160U               /* Tổng số pin (5 port * 32 pin) */
 #define PIN_PORT(pin)   ((pin) / 32U)      /* Tính số port từ chỉ số pin */
@@ -26,12 +28,22 @@ static GPIO_Type * const GPIO_BASE[] = IP_GPIO_BASE_PTRS;   /* Base address cho
 static ARM_PORT_SignalEvent_t port_cb[PORT_MAX_PINS];
 
 /**
- * @brief Enable clock cho PORTx
+ * @brief Enable clock cho PORTx (thêm một tham chiếu, clock_tree.h)
  * @param[in] port: 0=A, 1=B, 2=C, 3=D, 4=E
  */
 static int32_t PORT_EnableClock(uint32_t port) {
   if (port > 4) return ARM_DRIVER_ERROR_PARAMETER;
-  IP_PCC->PCCn[PCC_PORTA_INDEX + port] |= PCC_PCCn_CGC_MASK;
+  if (!ClockTree_PccAcquire(PCC_PORTA_INDEX + port, CLOCK_TREE_PCS_NONE)) return ARM_DRIVER_ERROR;
+  return ARM_DRIVER_OK;
+}
+
+/**
+ * @brief Trả một tham chiếu clock PORTx; tham chiếu cuối cùng tắt clock
+ * @param[in] port: 0=A, 1=B, 2=C, 3=D, 4=E
+ */
+static int32_t PORT_DisableClock(uint32_t port) {
+  if (port > 4) return ARM_DRIVER_ERROR_PARAMETER;
+  ClockTree_PccRelease(PCC_PORTA_INDEX + port);
   return ARM_DRIVER_OK;
 }
 
@@ -95,11 +107,11 @@ static int32_t PORT_SetInterrupt(ARM_PORT_Pin_t pin, uint32_t trigger, ARM_PORT_
 
   /* Enable NVIC cho port tương ứng */
   switch (port) {
-    case 0: NVIC_EnableIRQ(PORTA_IRQn); break;
-    case 1: NVIC_EnableIRQ(PORTB_IRQn); break;
-    case 2: NVIC_EnableIRQ(PORTC_IRQn); break;
-    case 3: NVIC_EnableIRQ(PORTD_IRQn); break;
-    case 4: NVIC_EnableIRQ(PORTE_IRQn); break;
+    case 0: NVIC_SetPriority(PORTA_IRQn, NVIC_PRIO_PORT); NVIC_EnableIRQ(PORTA_IRQn); break;
+    case 1: NVIC_SetPriority(PORTB_IRQn, NVIC_PRIO_PORT); NVIC_EnableIRQ(PORTB_IRQn); break;
+    case 2: NVIC_SetPriority(PORTC_IRQn, NVIC_PRIO_PORT); NVIC_EnableIRQ(PORTC_IRQn); break;
+    case 3: NVIC_SetPriority(PORTD_IRQn, NVIC_PRIO_PORT); NVIC_EnableIRQ(PORTD_IRQn); break;
+    case 4: NVIC_SetPriority(PORTE_IRQn, NVIC_PRIO_PORT); NVIC_EnableIRQ(PORTE_IRQn); break;
     default: break;
   }
 
@@ -113,6 +125,8 @@ static int32_t PORT_SetInterrupt(ARM_PORT_Pin_t pin, uint32_t trigger, ARM_PORT_
 static void PORT_HandleIRQ(uint32_t port) {
   uint32_t flags = PORT_BASE[port]->ISFR;  /* Lấy cờ ngắt */
 
+  TRACE_ISR_ENTER((uint32_t)PORTA_IRQn + port);
+
   for (uint32_t i = 0; i < 32; i++) {
     if (flags & (1UL << i)) {
       uint32_t pin = port * 32U + i;
@@ -135,6 +149,8 @@ static void PORT_HandleIRQ(uint32_t port) {
       }
     }
   }
+
+  TRACE_ISR_EXIT((uint32_t)PORTA_IRQn + port);
 }
 
 /* ISR cho từng PORT (wrapper) */
@@ -149,6 +165,7 @@ ARM_DRIVER_PORT Driver_PORT0 = {
   PORT_EnableClock,
   PORT_SetMux,
   PORT_SetPull,
-  PORT_SetInterrupt
+  PORT_SetInterrupt,
+  PORT_DisableClock
 };
 
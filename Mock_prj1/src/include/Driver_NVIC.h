@@ -43,6 +43,39 @@ typedef struct {
 /* Base address cho NVIC */
 #define NVIC                ((NVIC_Type*) NVIC_BASE)
 
+/*
+ * Interrupt priorities of the bootloader (0 = highest, 16 levels).
+ * A Flash command masks NVIC_PRIO_FLASH and below with BASEPRI
+ * (MASK_PRIORITY in s32_core_cm4.h): while the P-Flash is busy, code and
+ * constants in it cannot be read. Handlers above that level run from SRAM
+ * (.code_ram) with data in SRAM only, so they stay live through the whole
+ * programming phase. Every driver sets its level before enabling the line.
+ */
+#define NVIC_PRIO_LPUART    (1U)    /* RX into the RAM ring, .code_ram        */
+#define NVIC_PRIO_LPIT      (1U)    /* Latency probe (boot_lat.c), .code_ram  */
+#define NVIC_PRIO_FLASH     (2U)    /* BASEPRI level around Flash commands    */
+#define NVIC_PRIO_FTFC      (2U)    /* Runs from Flash                        */
+#define NVIC_PRIO_PORT      (3U)    /* Runs from Flash                        */
+
+/* BASEPRI / NVIC->IP value of a priority level */
+#define NVIC_PRIO_REG(prio) (((uint32_t)(prio) << (8U - __NVIC_PRIO_BITS)) & 0xFFUL)
+
+/*
+ * Runtime handlers. startup.c copies the vector table to __VECTOR_RAM
+ * (SRAM_L) and points VTOR at it. A handler written there with
+ * NVIC_InstallHandler() is entered straight from the exception, without the
+ * IRQHandler wrapper and callback of a driver. The entry is replaced by one
+ * aligned word store, so an interrupt taken meanwhile runs either the old or
+ * the new handler. A handler of a line above NVIC_PRIO_FLASH must be in
+ * SRAM (.code_ram) like the one it replaces.
+ *
+ * A build whose vector table is not in SRAM at the S32K144 addresses (host
+ * simulator) defines NVIC_VECTOR_PORT and provides NVIC_VECTOR_TABLE().
+ */
+
+/* Exception handler, an entry of the vector table */
+typedef void (*NVIC_Handler_t)(void);
+
 /* NVIC API giống CMSIS */
 void NVIC_EnableIRQ(IRQn_Type IRQn);
 void NVIC_DisableIRQ(IRQn_Type IRQn);
@@ -52,6 +85,11 @@ void NVIC_ClearPendingIRQ(IRQn_Type IRQn);
 void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
 uint32_t NVIC_GetPriority(IRQn_Type IRQn);
 
+/* Vector table in SRAM. Both return NULL if VTOR points to Flash or IRQn is
+ * out of range; InstallHandler returns the handler it replaced. */
+NVIC_Handler_t NVIC_InstallHandler(IRQn_Type IRQn, NVIC_Handler_t handler);
+NVIC_Handler_t NVIC_GetHandler(IRQn_Type IRQn);
+
 #ifdef __cplusplus
 }
 #endif
@@ -67,6 +67,7 @@ typedef struct _ARM_DRIVER_PORT {
   int32_t (*SetPull)     (ARM_PORT_Pin_t pin, ARM_PORT_PULL pull);    /* Cấu hình pull resistor */
   int32_t (*SetInterrupt)(ARM_PORT_Pin_t pin, uint32_t trigger,
                           ARM_PORT_SignalEvent_t cb);                 /* Cấu hình ngắt + callback */
+  int32_t (*DisableClock)(uint32_t port);                             /* Trả clock PORTx (đếm tham chiếu, clock_tree.h) */
 } const ARM_DRIVER_PORT;
 
 /* Driver instance toàn cục (theo CMSIS rule) */
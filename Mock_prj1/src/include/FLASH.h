@@ -11,12 +11,19 @@
  ******************************************************************************/
 #define CMD_PROGRAM_LONGWORD     (0x07)
 #define CMD_ERASE_FLASH_SECTOR   (0x09)
+#define CMD_PROGRAM_SECTION      (0x0B)
+#define CMD_SET_FLEXRAM_FUNCTION (0x81)
+/* Set FlexRAM Function control code: FlexRAM as traditional RAM */
+#define FTFC_FLEXRAM_AS_RAM      (0xFFU)
 /**
  * @brief  Program alignment
  */
 #define FTFC_WRITE_DOUBLE_WORD   (8U)
 #define FTFC_P_FLASH_SECTOR_SIZE (0x1000)
+/* RAM address the access code is copied to (a port may override it) */
+#ifndef WRITE_FUNCTION_ADDRESS
 #define WRITE_FUNCTION_ADDRESS    (0x1FFF8400)
+#endif
 void Mem_43_INFLS_IPW_LoadAc(void);
 
 void Ftfc_AccessCode(void) __attribute__ ((section (".acmem_43_infls_code_rom")));
@@ -39,8 +46,9 @@ uint32_t Read_FlashAddress(uint32_t Addr);
  * @param *Data: input data need to flash data into flash
  * @return
  * return 1: if success
+ * return 0: not in RUN mode (clock_and_mode.h) or command error
  */
-uint8_t Program_LongWord_8B(uint32_t Addr,uint8_t *Data);
+uint8_t Program_LongWord_8B(uint32_t Addr,const uint8_t *Data);
 
 /*!
  * @brief
@@ -48,6 +56,7 @@ uint8_t Program_LongWord_8B(uint32_t Addr,uint8_t *Data);
  * @param Addr: address to erase
  * @return
  * return 1: if success
+ * return 0: not in RUN mode (clock_and_mode.h) or command error
  */
 uint8_t Erase_Sector(uint32_t Addr);
 
@@ -57,7 +66,53 @@ uint8_t Erase_Sector(uint32_t Addr);
  * @param Addr: address to erase
  * @return
  * return 1: if success
+ * return 0: one or more sectors failed (all are tried)
  */
 uint8_t Erase_Multi_Sector(uint32_t Addr,uint8_t Size);
 
+/*!
+ * @brief
+ * the Program_LongWord_8B() command without RUN check, profiling or trace:
+ * it uses no RAM but the access code, so an application can run it through
+ * the service table (boot_api.h)
+ * @param Addr: phrase-aligned address
+ * @param *Data: 8 bytes
+ * @return
+ * return 1: if success
+ * return 0: command error (ACCERR, FPVIOL, MGSTAT0)
+ */
+uint8_t Ftfc_ProgramPhrase(uint32_t Addr,const uint8_t *Data);
+
+/*!
+ * @brief
+ * the Erase_Sector() command without RUN check, profiling or trace
+ * (see Ftfc_ProgramPhrase)
+ * @param Addr: address in the sector
+ * @return
+ * return 1: if success
+ * return 0: command error (ACCERR, FPVIOL, MGSTAT0)
+ */
+uint8_t Ftfc_EraseSector(uint32_t Addr);
+
+/*!
+ * @brief
+ * program phrases from the start of FlexRAM into flash (Program Section)
+ * @param Addr: phrase-aligned flash address
+ * @param Phrases: number of 8-byte phrases, data already in FlexRAM
+ * @return
+ * return 1: if success
+ * return 0: not in RUN mode, FlexRAM not available as RAM or command error
+ */
+uint8_t Program_Section(uint32_t Addr,uint16_t Phrases);
+
+/*!
+ * @brief
+ * select the FlexRAM function (Set FlexRAM Function)
+ * @param Control: FTFC_FLEXRAM_AS_RAM, or an EEE control code
+ * @return
+ * return 1: if success
+ * return 0: not in RUN mode or command error
+ */
+uint8_t Set_FlexRAM_Function(uint8_t Control);
+
 #endif
@@ -0,0 +1,131 @@
+/**
+ * @file    boot_api.h
+ * @brief   Bootloader services for applications, a table at a fixed address.
+ *
+ * The bootloader image carries a table of function pointers at
+ * BOOT_API_ADDRESS, the start of m_text right after the Flash
+ * Configuration Field (.boot_api, S32K144_64_flash.ld asserts the address).
+ * An application calls the bootloader's Flash, CRC and restart code through
+ * it instead of linking its own copy:
+ *
+ *   LoadAccessCode   copy the flash access code to WRITE_FUNCTION_ADDRESS
+ *   EraseSector      erase one 4 KB sector of the application region
+ *   Program          program phrases (Program Phrase, 8 bytes each)
+ *   Crc32            CRC-32 (reflected, 0xEDB88320), as tools/flasher
+ *   EnterBootloader  software reset into bootloader mode
+ *
+ * Entries are only ever appended; each addition raises BOOT_API_VERSION and
+ * size. BootApi_Get() returns the table if it is at least the version this
+ * header describes, NULL for an older bootloader or none.
+ *
+ * Rules for the caller:
+ * - The services run on the caller's stack and touch no .data or .bss of
+ *   the bootloader. LoadAccessCode writes BOOT_API_AC_SIZE bytes at
+ *   WRITE_FUNCTION_ADDRESS in SRAM_L: an application that erases or programs
+ *   keeps that window out of its own sections and calls LoadAccessCode once
+ *   before EraseSector or Program.
+ * - EraseSector and Program only accept the application region
+ *   [BOOT_API_APP_START, BOOT_API_APP_END), only in RUN mode, and mask all
+ *   interrupts (PRIMASK) per command: the application's handlers run from
+ *   P-Flash, which cannot be read while the FTFC works. The application
+ *   cannot erase the Flash it runs from without losing itself; a typical
+ *   user is a data or update area above the code.
+ * - EnterBootloader leaves a request at BOOT_API_REQUEST_ADDRESS (the
+ *   .boot_request slot of m_noinit, kept over a warm reset) and does not
+ *   return. Application linker files reserve the slot, so it never holds
+ *   one of their .noinit variables.
+ *
+ * LED_APP includes this header from here (include path of its .cproject).
+ */
+
+#ifndef BOOT_API_H_
+#define BOOT_API_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  DEFINITIONS
+ * ============================================================ */
+
+#define BOOT_API_ADDRESS        (0x00000410UL)
+#define BOOT_API_MAGIC          (0x42415049UL)  /* "BAPI" */
+#define BOOT_API_VERSION        (1U)
+
+/** @brief Flash the services erase and program (the application region). */
+#define BOOT_API_APP_START      (0x0000A000UL)
+#define BOOT_API_APP_END        (0x00080000UL)
+
+/** @brief Request slot of EnterBootloader (.boot_request, m_noinit). */
+#define BOOT_API_REQUEST_ADDRESS (0x20006F40UL)
+#define BOOT_API_REQUEST_SIZE   (8U)
+
+/** @brief SRAM_L window LoadAccessCode overwrites (.acfls_code_ram). */
+#define BOOT_API_AC_ADDRESS     (0x1FFF8400UL)
+#define BOOT_API_AC_SIZE        (0x40U)
+
+/* ============================================================
+ *                  TYPE DEFINITIONS
+ * ============================================================ */
+
+/**
+ * @brief Service table, version 1.
+ */
+typedef struct {
+    uint32_t magic;                 /**< BOOT_API_MAGIC                       */
+    uint16_t version;               /**< BOOT_API_VERSION of the bootloader   */
+    uint16_t size;                  /**< sizeof(boot_api_t) of the bootloader */
+
+    /** Copy the flash access code to BOOT_API_AC_ADDRESS. */
+    void     (*LoadAccessCode)(void);
+    /** Erase the sector at addr (4 KB aligned); false on a refused or
+     *  failed command. */
+    bool     (*EraseSector)(uint32_t addr);
+    /** Program size bytes (multiple of 8) at addr (8-byte aligned), stop at
+     *  the first failed phrase. */
+    bool     (*Program)(uint32_t addr, const uint8_t *data, uint32_t size);
+    /** Continue a CRC-32: start with crc = 0, pass the result back in. */
+    uint32_t (*Crc32)(uint32_t crc, const void *data, uint32_t size);
+    /** Restart into bootloader mode; does not return. */
+    void     (*EnterBootloader)(void);
+} boot_api_t;
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief The bootloader's service table (application side).
+ *
+ * @return NULL if there is no table or it is older than this header.
+ */
+static inline const boot_api_t *BootApi_Get(void)
+{
+    const boot_api_t *api = (const boot_api_t *)BOOT_API_ADDRESS;
+
+    if ((api->magic != BOOT_API_MAGIC) || (api->version < BOOT_API_VERSION) ||
+        (api->size < sizeof(boot_api_t))) {
+        return NULL;
+    }
+    return api;
+}
+
+/**
+ * @brief Read and clear a request left by EnterBootloader (bootloader side).
+ *
+ * Call once, early in main().
+ *
+ * @return true if the previous run asked for bootloader mode.
+ */
+bool BootApi_TakeRequest(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_API_H_ */
@@ -0,0 +1,94 @@
+/**
+ * @file    boot_cache.h
+ * @brief   LMEM processor code cache and P-Flash speculation control.
+ *
+ * The S32K144 code cache sits on the processor code bus: 4 KB, 2-way set
+ * associative, 16-byte lines. It is off after reset, so every instruction
+ * fetch from P-Flash pays the Flash wait states (80 MHz core, 26.67 MHz
+ * Flash clock). SRAM is not cached.
+ *
+ * The cache only holds copies of Flash, it is never dirty. Its content goes
+ * stale when the FTFC changes the array underneath, so FLASH.c invalidates
+ * the programmed phrase after Program_LongWord_8B() and the sector after
+ * Erase_Sector(). A range of one cache size or more invalidates both ways
+ * with one command instead of line by line.
+ *
+ * MSCM OCMDR0 controls the P-Flash prefetch and speculation buffers in
+ * front of the array; BootCache_Init() writes BOOT_CACHE_FLASH_OCM1 there.
+ *
+ * The cache stays on across the jump to the application. Set
+ * BOOT_CACHE_ENABLE to 0 to leave it off; the module then compiles to
+ * nothing. tools/target_bench measures both settings.
+ */
+
+#ifndef BOOT_CACHE_H_
+#define BOOT_CACHE_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  CONFIGURATION
+ * ============================================================ */
+
+#ifndef BOOT_CACHE_ENABLE
+#define BOOT_CACHE_ENABLE       1
+#endif
+
+/* OCM1 field of MSCM OCMDR0: each set bit disables one P-Flash speculation
+ * buffer (bit 0 instruction, bit 1 data), 0 keeps both on */
+#ifndef BOOT_CACHE_FLASH_OCM1
+#define BOOT_CACHE_FLASH_OCM1   (0U)
+#endif
+
+#define BOOT_CACHE_SIZE         (4096U)     /**< Bytes, 2 ways               */
+#define BOOT_CACHE_LINE         (16U)       /**< Bytes per line              */
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief Set the Flash speculation buffers, invalidate and enable the cache.
+ */
+void BootCache_Init(void);
+
+/**
+ * @brief Disable the cache (the content is invalidated).
+ */
+void BootCache_Disable(void);
+
+/**
+ * @brief Non-zero while the cache is enabled.
+ */
+uint32_t BootCache_Enabled(void);
+
+/**
+ * @brief Invalidate both ways.
+ */
+void BootCache_InvalidateAll(void);
+
+/**
+ * @brief Invalidate the lines holding [addr, addr + size).
+ *
+ * Line commands use physical addresses; a range of BOOT_CACHE_SIZE bytes
+ * or more falls back to BootCache_InvalidateAll().
+ */
+void BootCache_InvalidateRange(uint32_t addr, uint32_t size);
+
+/**
+ * @brief Clean and invalidate the lines holding [addr, addr + size).
+ *
+ * The code cache is never dirty, so this is an invalidation; it is kept
+ * for code that is written against a cache with write-back lines.
+ */
+void BootCache_CleanInvalidateRange(uint32_t addr, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_CACHE_H_ */
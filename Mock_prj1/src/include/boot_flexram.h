@@ -0,0 +1,94 @@
+/**
+ * @file    boot_flexram.h
+ * @brief   FlexRAM as extra RAM and as the FTFC Program Section buffer.
+ *
+ * FlexRAM is 4 KB at 0x14000000. With EEPROM emulation partitioned the FTFC
+ * loads it as the EEE at reset (FCNFG EEERDY); without a partition it comes
+ * up as traditional RAM (FCNFG RAMRDY) and is otherwise unused. The
+ * bootloader leaves EEE alone: BootFlexRam_Init() gives up if EEERDY is set.
+ *
+ * Layout (.flexram in m_flexram, S32K144_64_flash.ld):
+ *
+ *   0x14000000  BOOT_FLEXRAM_STAGE_SIZE bytes  Program Section buffer
+ *   after it    BOOT_FLEXRAM variables (boot_mem.h)
+ *
+ * Program Section (FTFC command 0x0B) takes its data from the start of
+ * FlexRAM, so one command programs up to BOOT_FLEXRAM_STAGE_SIZE bytes
+ * instead of one 8-byte phrase per Program Phrase command.
+ *
+ * Nothing in FlexRAM is loaded or cleared by the startup code, and it is
+ * not RAM until BootFlexRam_Init() returned true: BOOT_FLEXRAM variables
+ * must not be touched before. Init writes every word once so the ECC of
+ * FlexRAM is valid for later byte stores and reads.
+ *
+ * Set BOOT_FLEXRAM_ENABLE to 0 to drop the module.
+ */
+
+#ifndef BOOT_FLEXRAM_H_
+#define BOOT_FLEXRAM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  CONFIGURATION
+ * ============================================================ */
+
+#ifndef BOOT_FLEXRAM_ENABLE
+#define BOOT_FLEXRAM_ENABLE     1
+#endif
+
+#define BOOT_FLEXRAM_BASE       (0x14000000UL)
+#define BOOT_FLEXRAM_SIZE       (0x1000U)
+
+/** @brief Program Section buffer; the linker files assert the same value. */
+#define BOOT_FLEXRAM_STAGE_SIZE (0x400U)
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief Make FlexRAM traditional RAM and initialize it.
+ *
+ * Needs the flash access code in RAM (Mem_43_INFLS_IPW_LoadAc()) and the
+ * RUN mode if FlexRAM is not RAM yet.
+ *
+ * @return false if EEE uses FlexRAM or the FTFC refused the command.
+ */
+bool BootFlexRam_Init(void);
+
+/**
+ * @brief true after a successful BootFlexRam_Init().
+ */
+bool BootFlexRam_Ready(void);
+
+/**
+ * @brief The Program Section buffer, NULL if FlexRAM is not ready.
+ *
+ * A caller that assembles its data here saves the copy in
+ * BootFlexRam_ProgramSection().
+ */
+uint8_t *BootFlexRam_Stage(void);
+
+/**
+ * @brief Program size bytes at addr with one Program Section command.
+ *
+ * @param addr Phrase-aligned flash address.
+ * @param data Data, copied to the buffer unless it is the buffer.
+ * @param size Multiple of 8, at most BOOT_FLEXRAM_STAGE_SIZE, inside one
+ *             flash sector.
+ * @return false if FlexRAM is not ready, the arguments are invalid or the
+ *         command failed.
+ */
+bool BootFlexRam_ProgramSection(uint32_t addr, const uint8_t *data, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_FLEXRAM_H_ */
@@ -0,0 +1,112 @@
+/**
+ * @file    boot_handoff.h
+ * @brief   Bootloader -> application handoff block for S32K144.
+ *
+ * The bootloader publishes this block just before it jumps to the user
+ * application. It lives in the shared .boot_handoff section (m_noinit region
+ * of S32K144_64_flash.ld), which is placed at the same fixed address in the
+ * bootloader and in every application and is excluded from the application's
+ * RAM/ECC initialization, so the content survives the jump.
+ *
+ * An application that finds a valid block can skip clock and peripheral
+ * setup that the bootloader has already done.
+ *
+ * @note This header is shared with the applications (LED_APP has this
+ *       directory on its include path). Any layout change must bump
+ *       BOOT_HANDOFF_VERSION.
+ */
+
+#ifndef BOOT_HANDOFF_H_
+#define BOOT_HANDOFF_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  DEFINITIONS
+ * ============================================================ */
+
+/** @brief Block signature ("BHOF"). */
+#define BOOT_HANDOFF_MAGIC              (0x42484F46UL)
+
+/** @brief Layout version, bump on every change of boot_handoff_t. */
+#define BOOT_HANDOFF_VERSION            (1U)
+
+/** @brief Fixed address of the block (origin of m_noinit in the linker files). */
+#define BOOT_HANDOFF_ADDRESS            (0x20006F00UL)
+
+/* ---- clock_flags: clock sources already configured and locked ---- */
+#define BOOT_HANDOFF_CLK_SOSC_8MHZ      (1UL << 0)   /**< SOSC 8 MHz valid, DIV1/DIV2 = 1      */
+#define BOOT_HANDOFF_CLK_SPLL_160MHZ    (1UL << 1)   /**< SPLL 160 MHz valid, DIV1 = 2, DIV2 = 4 */
+#define BOOT_HANDOFF_CLK_RUN_80MHZ      (1UL << 2)   /**< RUN mode, SPLL source, core 80 MHz    */
+
+/* ---- periph_flags: peripherals already clocked and configured ---- */
+#define BOOT_HANDOFF_PERIPH_PORTA       (1UL << 0)   /**< PCC clock of PORTA enabled           */
+#define BOOT_HANDOFF_PERIPH_PORTC       (1UL << 2)   /**< PCC clock of PORTC enabled           */
+#define BOOT_HANDOFF_PERIPH_PORTD       (1UL << 3)   /**< PCC clock of PORTD enabled           */
+#define BOOT_HANDOFF_PERIPH_PORTE       (1UL << 4)   /**< PCC clock of PORTE enabled           */
+#define BOOT_HANDOFF_PERIPH_LED_GPIO    (1UL << 8)   /**< PTD0/15/16 muxed as GPIO outputs     */
+#define BOOT_HANDOFF_PERIPH_BUTTON_GPIO (1UL << 9)   /**< PTC13 muxed as GPIO input, pull-up   */
+#define BOOT_HANDOFF_PERIPH_LPUART1     (1UL << 16)  /**< LPUART1 clocked, pins muxed, IRQ off */
+
+/* ============================================================
+ *                  TYPE DEFINITIONS
+ * ============================================================ */
+
+/**
+ * @brief Handoff block layout (version 1).
+ */
+typedef struct {
+    uint32_t magic;          /**< BOOT_HANDOFF_MAGIC                          */
+    uint16_t version;        /**< BOOT_HANDOFF_VERSION of the writer          */
+    uint16_t size;           /**< sizeof(boot_handoff_t) of the writer        */
+    uint32_t clock_flags;    /**< BOOT_HANDOFF_CLK_xxx                        */
+    uint32_t core_clk_hz;    /**< CORE_CLK / SYS_CLK                          */
+    uint32_t bus_clk_hz;     /**< BUS_CLK                                     */
+    uint32_t slow_clk_hz;    /**< SLOW_CLK (flash clock)                      */
+    uint32_t spll_div2_hz;   /**< SPLLDIV2_CLK (LPUART/LPIT functional clock) */
+    uint32_t sosc_div2_hz;   /**< SOSCDIV2_CLK                                */
+    uint32_t periph_flags;   /**< BOOT_HANDOFF_PERIPH_xxx                     */
+    uint32_t lpuart1_baud;   /**< Baud rate LPUART1 was left configured at    */
+    uint32_t check;          /**< Complement of the sum of all previous words */
+} boot_handoff_t;
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief Fill and seal the handoff block (bootloader side).
+ *
+ * Frequencies are taken from the live SCG state (clock_tree.c), so a block
+ * never claims a configuration that is not actually in place.
+ *
+ * @param clock_flags    Clock plans in place (BOOT_HANDOFF_CLK_xxx).
+ * @param periph_flags   Peripherals left configured (BOOT_HANDOFF_PERIPH_xxx).
+ * @param lpuart1_baud   LPUART1 baud rate, 0 if LPUART1 is not handed over.
+ */
+void BootHandoff_Publish(uint32_t clock_flags, uint32_t periph_flags,
+                         uint32_t lpuart1_baud);
+
+/**
+ * @brief Get the handoff block if it is present and intact (application side).
+ *
+ * @return Pointer to the block, or NULL if there is no valid block
+ *         (cold start from the debugger, version mismatch, corrupted data).
+ */
+const boot_handoff_t *BootHandoff_Get(void);
+
+/**
+ * @brief Invalidate the block so a later warm reset does not reuse stale data.
+ */
+void BootHandoff_Invalidate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_HANDOFF_H_ */
@@ -0,0 +1,138 @@
+/**
+ * @file    boot_lat.h
+ * @brief   Interrupt latency and masked-window histograms in DWT cycles.
+ *
+ * Two histograms with power-of-two buckets:
+ *   - mask: length of every window in which DISABLE_INTERRUPTS() or
+ *     MASK_PRIORITY() (the Flash commands) masks interrupts. s32_core_cm4.h
+ *     routes these macros and ENABLE_INTERRUPTS()/UNMASK_PRIORITY() through
+ *     BootLat_MaskBegin()/BootLat_MaskEnd() when BOOT_LAT_ENABLE is set; it
+ *     includes this header, so the default below applies to both. Nested
+ *     sections count as one window. The call site of the longest window is
+ *     kept.
+ *   - irq: entry latency of an NVIC interrupt. LPIT0 channel 3 fires at
+ *     BOOT_LAT_PROBE_HZ with priority BOOT_LAT_PROBE_PRIO (NVIC_PRIO_LPIT,
+ *     the LPUART level; the handler runs from SRAM like the LPUART path,
+ *     Driver_NVIC.h). Its timeouts are exact multiples of the core clock, so the
+ *     handler knows when it should have run; the difference is the time
+ *     the request waited behind masked windows and other handlers, plus
+ *     the constant entry cost (the minimum).
+ *
+ * Bucket k counts samples in [2^(k-1), 2^k) cycles, bucket 0 counts zero.
+ * At 9600 baud one character takes 83 333 cycles at 80 MHz, so a window in
+ * bucket 17 or above can cost a received byte.
+ *
+ * The LAT command prints both histograms. Set BOOT_LAT_ENABLE to 1 to build
+ * the module; with 0 it compiles to nothing and the macros are unchanged.
+ */
+
+#ifndef BOOT_LAT_H_
+#define BOOT_LAT_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  CONFIGURATION
+ * ============================================================ */
+
+#ifndef BOOT_LAT_ENABLE
+#define BOOT_LAT_ENABLE     0
+#endif
+
+#ifndef BOOT_LAT_PROBE_HZ
+#define BOOT_LAT_PROBE_HZ   (1000U)     /**< Latency samples per second      */
+#endif
+
+#ifndef BOOT_LAT_PROBE_PRIO
+#define BOOT_LAT_PROBE_PRIO NVIC_PRIO_LPIT  /**< NVIC priority (Driver_NVIC.h) */
+#endif
+
+#define BOOT_LAT_BUCKETS    (32U)       /**< Bucket 31 also holds >= 2^31    */
+
+/** @brief Buffer size large enough for BootLat_Format(). */
+#define BOOT_LAT_TEXT_MAX   (560U)
+
+/* ============================================================
+ *                  TYPE DEFINITIONS
+ * ============================================================ */
+
+/**
+ * @brief Histograms.
+ */
+typedef enum {
+    BOOT_LAT_MASK = 0,          /**< Interrupts masked                     */
+    BOOT_LAT_IRQ,               /**< Probe interrupt entry latency         */
+    BOOT_LAT_COUNT
+} boot_lat_id_t;
+
+/**
+ * @brief One histogram.
+ */
+typedef struct {
+    uint32_t count;             /**< Samples                               */
+    uint32_t min;               /**< Minimum cycles (0xFFFFFFFF if empty)  */
+    uint32_t max;               /**< Maximum cycles                        */
+    uint32_t max_pc;            /**< Call site of the maximum (mask only)  */
+    uint32_t bucket[BOOT_LAT_BUCKETS];
+} boot_lat_hist_t;
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief Clear the histograms and start the LPIT0 channel 3 probe.
+ *
+ * Needs the SPLL (SPLLDIV2 clocks the LPIT) and DWT_Perf_Init().
+ */
+void BootLat_Init(void);
+
+/**
+ * @brief Stop the probe and gate the LPIT clock (before the jump to the
+ *        application).
+ */
+void BootLat_Stop(void);
+
+/**
+ * @brief Clear the histograms.
+ */
+void BootLat_Reset(void);
+
+/**
+ * @brief Start of a masked window (called after "cpsid i" or a BASEPRI raise);
+ *        no-op inside an open window.
+ */
+void BootLat_MaskBegin(void);
+
+/**
+ * @brief End of a masked window (called before the last mask is lifted).
+ */
+void BootLat_MaskEnd(void);
+
+/**
+ * @brief Read-only access to a histogram.
+ */
+const boot_lat_hist_t *BootLat_Get(boot_lat_id_t id);
+
+/**
+ * @brief Format one histogram.
+ *
+ * Output is one line "[LAT] name n=.. min=.. max=.. [pc=0x..] hK=count ..\r\n"
+ * with the non-empty buckets only.
+ *
+ * @param[in]  id   Histogram.
+ * @param[out] buf  Destination, at least BOOT_LAT_TEXT_MAX bytes.
+ * @param[in]  size Size of @p buf.
+ * @return Number of characters written (without terminator).
+ */
+uint32_t BootLat_Format(boot_lat_id_t id, char *buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_LAT_H_ */
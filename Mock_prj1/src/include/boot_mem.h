@@ -0,0 +1,68 @@
+/**
+ * @file    boot_mem.h
+ * @brief   SRAM placement rules of the bootloader (S32K144_64_flash.ld).
+ *
+ * The two SRAM blocks sit on different buses of the crossbar:
+ *
+ *   SRAM_L  0x1FFF8000  32 KB  core code bus (m_data)
+ *   SRAM_U  0x20000000  28 KB  core system bus (m_data_2, m_noinit)
+ *   FlexRAM 0x14000000   4 KB  FTFC, RAM only without EEE (boot_flexram.h)
+ *
+ * An access to one block does not wait for an access to the other, so the
+ * core fetches RAM code from SRAM_L while the hot loads and stores, the
+ * exception stacking and any DMA master go to SRAM_U. The linker files keep
+ * that split:
+ *
+ *   SRAM_L  RAM vector table, flash access code (WRITE_FUNCTION_ADDRESS,
+ *           FLASH.h), .data, .code_ram
+ *           (START/END_FUNCTION_DECLARATION_RAMSECTION)
+ *   SRAM_U  .bss (UART ring buffers, S-record queue), .dma_buffer, heap,
+ *           stack, .boot_handoff, .noinit
+ *
+ * .data stays in SRAM_L: it is a few hundred bytes of initialized
+ * variables, while SRAM_U is the smaller block and carries everything that
+ * grows. S32K144_64_flash.ld asserts that RAM_HEADROOM (4 KB by default)
+ * stays free in each block.
+ *
+ * The stack stays in SRAM_U: on an exception the core stacks the frame on
+ * the system bus while it reads the vector from SRAM_L on the code bus.
+ * While the FTFC runs a command nothing may be fetched from P-Flash, so the
+ * RAM handlers and the data they touch must not share one bus.
+ *
+ * BOOT_SRAM_L, BOOT_DMA_BUFFER and BOOT_FLEXRAM place a variable
+ * explicitly; none of these sections is loaded or cleared by
+ * init_data_bss(), the owner initializes it. BOOT_FLEXRAM variables are
+ * usable only after BootFlexRam_Init() returned true. tools/target_bench
+ * measures a ring buffer in each SRAM block while a Flash program command
+ * runs.
+ */
+
+#ifndef BOOT_MEM_H_
+#define BOOT_MEM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  DEFINITIONS
+ * ============================================================ */
+
+#if defined(__GNUC__)
+/** @brief Code-bus RAM (.sram_l), for data that must stay off the system bus. */
+#define BOOT_SRAM_L         __attribute__((section(".sram_l")))
+/** @brief DMA buffer in SRAM_U (.dma_buffer), 16-byte aligned. */
+#define BOOT_DMA_BUFFER     __attribute__((section(".dma_buffer"), aligned(16)))
+/** @brief FlexRAM after the Program Section buffer (.flexram), staging buffers. */
+#define BOOT_FLEXRAM        __attribute__((section(".flexram")))
+#else
+#define BOOT_SRAM_L
+#define BOOT_DMA_BUFFER
+#define BOOT_FLEXRAM
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_MEM_H_ */
@@ -0,0 +1,68 @@
+/**
+ * @file    boot_phrase.h
+ * @brief   Assembly of record data into 8-byte Flash phrases.
+ *
+ * The FTFC programs whole 8-byte phrases, records carry any number of
+ * bytes at any address. Record data is cut into phrases as follows:
+ *   a) 8 or more bytes at a phrase start: programmed directly
+ *   b) exactly 4 bytes at a phrase start: kept pending (low half)
+ *   c) 4 or more bytes at offset +4: merged with the pending low half of
+ *      the same phrase (0xFF if none) and programmed
+ *   d) anything else: the bytes up to the phrase end, padded with 0xFF
+ *      (and the pending low half of the same phrase), programmed
+ * The pending half is programmed by BootPhrase_Flush() at the end of the
+ * image. A phrase that case d) programs must not receive data from a later
+ * record: hosts send phrase-aligned records (tools/flasher).
+ *
+ * Pure logic: the phrase writer is a callback, so the module also runs in
+ * the host benchmark (tools/host_bench).
+ */
+
+#ifndef BOOT_PHRASE_H_
+#define BOOT_PHRASE_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  DEFINITIONS
+ * ============================================================ */
+
+#define BOOT_PHRASE_SIZE        (8U)    /**< FTFC program phrase */
+#define BOOT_PHRASE_HALF        (4U)
+
+/**
+ * @brief Program one phrase.
+ *
+ * @param[in] base Phrase-aligned address.
+ * @param[in] data BOOT_PHRASE_SIZE bytes.
+ */
+typedef void (*boot_phrase_write_t)(uint32_t base, const uint8_t *data);
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief Set the phrase writer and drop any pending half phrase.
+ */
+void BootPhrase_Init(boot_phrase_write_t write);
+
+/**
+ * @brief Program the data of one record.
+ */
+void BootPhrase_Write(uint32_t addr, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Program the pending low half phrase, if any (end of image).
+ */
+void BootPhrase_Flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_PHRASE_H_ */
@@ -0,0 +1,144 @@
+/**
+ * @file    boot_pool.h
+ * @brief   Fixed-block memory pool with size classes, O(1) and ISR-safe.
+ *
+ * Every class is a static array of equal blocks with a free list threaded
+ * through the free blocks themselves, plus one bit per block that marks it
+ * allocated:
+ *
+ *   BOOT_POOL_PHRASE   one 8-byte Flash phrase (boot_phrase.h)
+ *   BOOT_POOL_RECORD   one record line or frame (SREC_LINE_MAX_LEN)
+ *   BOOT_POOL_SECTOR   one 4 KB Flash sector, no blocks by default
+ *
+ * BootPool_Alloc() takes the smallest class that fits and has a free
+ * block; BootPool_Free() finds the class from the address. Both run a fixed
+ * number of steps with interrupts masked for a few instructions, so a block
+ * can be taken in an interrupt handler and released in the main loop: a
+ * pipeline stage hands the pointer on instead of copying the data. Nothing
+ * is ever split, merged or searched, so the pool does not fragment.
+ *
+ * Sizes and counts are set at compile time. Sizes are multiples of 8 (the
+ * free-list link and phrase copies need the alignment); a count of 0
+ * removes the class. Per-class statistics: blocks in use, high-water mark
+ * and failed allocations.
+ *
+ * A build without PRIMASK (host benchmark) defines BOOT_POOL_PORT and
+ * provides BOOT_POOL_LOCK(state) and BOOT_POOL_UNLOCK(state).
+ *
+ * @note No bootloader buffer uses the pool yet: line_buf, the UART ring and
+ *       the S-record queue are still static arrays. The only callers are
+ *       tools/host_bench and tools/target_bench.
+ */
+
+#ifndef BOOT_POOL_H_
+#define BOOT_POOL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  CONFIGURATION
+ * ============================================================ */
+
+#ifndef BOOT_POOL_PHRASE_SIZE
+#define BOOT_POOL_PHRASE_SIZE   (8U)
+#endif
+#ifndef BOOT_POOL_PHRASE_COUNT
+#define BOOT_POOL_PHRASE_COUNT  (16U)
+#endif
+
+#ifndef BOOT_POOL_RECORD_SIZE
+#define BOOT_POOL_RECORD_SIZE   (256U)
+#endif
+#ifndef BOOT_POOL_RECORD_COUNT
+#define BOOT_POOL_RECORD_COUNT  (4U)
+#endif
+
+#ifndef BOOT_POOL_SECTOR_SIZE
+#define BOOT_POOL_SECTOR_SIZE   (4096U)
+#endif
+#ifndef BOOT_POOL_SECTOR_COUNT
+#define BOOT_POOL_SECTOR_COUNT  (0U)
+#endif
+
+/* ============================================================
+ *                  TYPE DEFINITIONS
+ * ============================================================ */
+
+/**
+ * @brief Size classes, in ascending block size.
+ */
+typedef enum {
+    BOOT_POOL_PHRASE = 0,
+    BOOT_POOL_RECORD,
+    BOOT_POOL_SECTOR,
+    BOOT_POOL_CLASS_COUNT
+} boot_pool_class_t;
+
+/**
+ * @brief Statistics of one class.
+ */
+typedef struct {
+    uint32_t size;              /**< Bytes per block                       */
+    uint16_t count;             /**< Blocks                                */
+    uint16_t used;              /**< Blocks allocated now                  */
+    uint16_t high_water;        /**< Most blocks allocated at once         */
+    uint16_t fails;             /**< Requests this class fitted but could
+                                     not serve (saturates)                 */
+} boot_pool_stats_t;
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief Put every block on its free list and clear the statistics.
+ *
+ * Call before the first allocation, with no block in use.
+ */
+void BootPool_Init(void);
+
+/**
+ * @brief Allocate a block of at least size bytes.
+ *
+ * @return The block (8-byte aligned), NULL if no class that fits has a free
+ *         block.
+ */
+void *BootPool_Alloc(uint32_t size);
+
+/**
+ * @brief Allocate a block of one class.
+ *
+ * @return The block, NULL if the class is empty.
+ */
+void *BootPool_AllocClass(boot_pool_class_t cls);
+
+/**
+ * @brief Return a block to its class.
+ *
+ * @return false if the pointer is not the start of a pool block or the
+ *         block is not allocated, e.g. freed twice (nothing is changed).
+ */
+bool BootPool_Free(void *block);
+
+/**
+ * @brief Block size of a pool block, 0 if block is not the start of one.
+ */
+uint32_t BootPool_BlockSize(const void *block);
+
+/**
+ * @brief Statistics of a class.
+ *
+ * @return false if cls is out of range.
+ */
+bool BootPool_GetStats(boot_pool_class_t cls, boot_pool_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_POOL_H_ */
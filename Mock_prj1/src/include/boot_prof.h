@@ -0,0 +1,127 @@
+/**
+ * @file    boot_prof.h
+ * @brief   Statistical profiler: SysTick samples the interrupted PC into a
+ *          RAM histogram that is dumped over the UART.
+ *
+ * Every SysTick interrupt reads the PC stacked by the exception entry and
+ * counts it in one of BOOT_PROF_BUCKETS buckets covering the code range
+ * [base, end). The bucket size is the smallest power of two that makes the
+ * range fit. tools/profiler symbolizes the dump against the .elf or .map of
+ * the Debug_FLASH build, so no debug probe is needed.
+ *
+ * SysTick runs at the highest exception priority so interrupt handlers are
+ * sampled too. Code executed with interrupts masked (PRIMASK) cannot be
+ * sampled: its ticks are taken at the instruction after ENABLE_INTERRUPTS().
+ *
+ * The module owns SysTick_Handler. Set BOOT_PROF_ENABLE to 1 to build it;
+ * with 0 it compiles to nothing (tools/host_sim, tools/qemu_an386 which
+ * uses SysTick itself).
+ */
+
+#ifndef BOOT_PROF_H_
+#define BOOT_PROF_H_
+
+#include <stdint.h>
+#include "dwt_perf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  CONFIGURATION
+ * ============================================================ */
+
+#ifndef BOOT_PROF_ENABLE
+#define BOOT_PROF_ENABLE    0
+#endif
+
+#ifndef BOOT_PROF_BUCKETS
+#define BOOT_PROF_BUCKETS   (2048U)     /**< uint16_t counters: 4 KB of RAM */
+#endif
+
+#ifndef BOOT_PROF_RATE_HZ
+#define BOOT_PROF_RATE_HZ   (1000U)     /**< Default sampling rate           */
+#endif
+
+/* ============================================================
+ *                  REGISTER DEFINITIONS
+ * ============================================================ */
+
+/**
+\brief Access structure of the SysTick timer.
+*/
+typedef struct {
+  volatile uint32_t CSR;                   /* Offset: 0x000 (R/W) Control and Status Register */
+  volatile uint32_t RVR;                   /* Offset: 0x004 (R/W) Reload Value Register */
+  volatile uint32_t CVR;                   /* Offset: 0x008 (R/W) Current Value Register */
+  volatile uint32_t CALIB;                 /* Offset: 0x00C (R/ ) Calibration Register */
+} BOOT_PROF_SYST_Type;
+
+#define BOOT_PROF_SYST              ((BOOT_PROF_SYST_Type *)0xE000E010UL)
+
+#define BOOT_PROF_CSR_ENABLE        (1UL << 0)
+#define BOOT_PROF_CSR_TICKINT       (1UL << 1)
+#define BOOT_PROF_CSR_CLKSOURCE     (1UL << 2)  /* Processor clock */
+#define BOOT_PROF_RVR_MAX           (0x00FFFFFFUL)
+
+/* ============================================================
+ *                  TYPE DEFINITIONS
+ * ============================================================ */
+
+/* ---- Binary dump frame ----
+ *   uint32_t magic      BOOT_PROF_DUMP_MAGIC
+ *   uint8_t  version    BOOT_PROF_DUMP_VERSION
+ *   uint8_t  shift      bucket size = 1 << shift bytes
+ *   uint16_t reserved
+ *   uint32_t base       address of bucket 0
+ *   uint32_t rate_hz    samples per second (0 = stopped)
+ *   uint32_t samples    SysTick interrupts taken
+ *   uint32_t ram        PCs in SRAM (Flash access code)
+ *   uint32_t other      PCs outside [base, end) and SRAM
+ *   uint32_t saturated  samples lost to a full bucket
+ *   uint32_t n_entries
+ *   { uint16_t bucket, count } entries[n_entries]   non-empty buckets only
+ */
+#define BOOT_PROF_DUMP_MAGIC    (0x464F5250UL)  /* "PROF" */
+#define BOOT_PROF_DUMP_VERSION  (1U)
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief Clear the histogram and start sampling.
+ *
+ * @param base     First code address (image start).
+ * @param end      End of code (__etext).
+ * @param rate_hz  Samples per second; 0 stops sampling. Rates below
+ *                 core_hz / 2^24 are raised to that limit.
+ * @param core_hz  SysTick input clock (core clock).
+ */
+void BootProf_Start(uint32_t base, uint32_t end, uint32_t rate_hz, uint32_t core_hz);
+
+/**
+ * @brief Stop SysTick, keep the histogram.
+ */
+void BootProf_Stop(void);
+
+/**
+ * @brief Count one sample (called from SysTick_Handler).
+ *
+ * @param pc Stacked return address of the interrupted code.
+ */
+void BootProf_Sample(uint32_t pc);
+
+/**
+ * @brief Write the binary dump frame through @p write.
+ *
+ * Sampling is paused while the frame is written and resumes afterwards.
+ */
+void BootProf_Dump(perf_write_t write);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_PROF_H_ */
@@ -0,0 +1,104 @@
+/**
+ * @file    boot_record.h
+ * @brief   Format-agnostic record source for the bootloader.
+ *
+ * Every frame received in bootloader mode is decoded into one boot_record_t:
+ * an address and a data span to program, the end of the image, or a record
+ * to skip. Bootloader_Mode() programs from that one structure, whichever
+ * format the host sends:
+ *
+ *   'S'   Motorola S-record line (S1/S2/S3 data, S7/S8/S9 end), srec_parser.c
+ *   ':'   Intel HEX line (00 data, 01 end, 04/02 address base, 05/03 entry)
+ *   0x02  Binary frame: STX, len, address (4 bytes, big endian), len data
+ *         bytes, checksum = ~(len + address bytes + data) as in S-records.
+ *         len = 0 ends the image; the address is the entry point.
+ *
+ * The format is taken from the first byte of the first record and kept
+ * until the end of the image; a record in another format is a parse error.
+ * Text commands (STATS, MAP, PERF, PROF, TRACE, LAT) stay lines between records
+ * in every format. A binary frame is half the size of the equivalent text
+ * line.
+ */
+
+#ifndef BOOT_RECORD_H_
+#define BOOT_RECORD_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  DEFINITIONS
+ * ============================================================ */
+
+#define BOOT_RECORD_BIN_SOF         (0x02U)     /**< STX: first byte of a binary frame   */
+#define BOOT_RECORD_BIN_HEADER      (6U)        /**< STX, len, 4 address bytes           */
+#define BOOT_RECORD_BIN_OVERHEAD    (BOOT_RECORD_BIN_HEADER + 1U)  /**< Plus checksum    */
+
+typedef enum {
+    BOOT_FMT_NONE = 0,                          /**< No record yet in this image         */
+    BOOT_FMT_SREC,
+    BOOT_FMT_IHEX,
+    BOOT_FMT_BIN
+} boot_format_t;
+
+typedef enum {
+    BOOT_REC_SKIP = 0,                          /**< Header, count, address base...      */
+    BOOT_REC_DATA,                              /**< Program data at address             */
+    BOOT_REC_END                                /**< End of image, address = entry       */
+} boot_record_type_t;
+
+/**
+ * @brief One decoded record.
+ *
+ * @c data points into the frame (binary) or into the decoder (text); it is
+ * valid until the next BootRecord_Decode() call.
+ */
+typedef struct {
+    boot_record_type_t type;
+    uint32_t           address;
+    const uint8_t     *data;
+    uint16_t           len;
+    uint8_t            valid;                   /**< Checksum correct                    */
+} boot_record_t;
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief Format of a frame, from its first byte (BOOT_FMT_NONE: a command).
+ *
+ * @param[in] frame Frame or line.
+ * @param[in] len   Bytes in @p frame.
+ */
+boot_format_t BootRecord_Format(const uint8_t *frame, uint16_t len);
+
+/**
+ * @brief Decode one frame.
+ *
+ * @param[in]  frame Record line (without '\n') or binary frame.
+ * @param[in]  len   Bytes in @p frame.
+ * @param[out] rec   Decoded record.
+ * @return 0 on success, -1 on a malformed frame or a format change within
+ *         the image.
+ */
+int BootRecord_Decode(const uint8_t *frame, uint16_t len, boot_record_t *rec);
+
+/**
+ * @brief Forget the format and Intel HEX address base (next image).
+ */
+void BootRecord_Reset(void);
+
+/**
+ * @brief Format of the current image (BOOT_FMT_NONE before its first record).
+ */
+boot_format_t BootRecord_CurrentFormat(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_RECORD_H_ */
@@ -0,0 +1,71 @@
+/**
+ * @file    boot_rxmap.h
+ * @brief   Map of the application blocks programmed in this session.
+ *
+ * One bit per BOOT_RXMAP_BLOCK_SIZE bytes of the application region, set
+ * when a data record inside the block has been programmed. The MAP command
+ * reports the bits, so a host can resend only the blocks a node missed
+ * (selective repair after an RS-485 broadcast, or resuming an interrupted
+ * session). Hosts that use the map send one record per block, aligned to
+ * the block size.
+ */
+
+#ifndef BOOT_RXMAP_H_
+#define BOOT_RXMAP_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  DEFINITIONS
+ * ============================================================ */
+
+#define BOOT_RXMAP_BLOCK_SHIFT      (6U)
+#define BOOT_RXMAP_BLOCK_SIZE       (1UL << BOOT_RXMAP_BLOCK_SHIFT)   /**< 64 bytes = 8 phrases */
+
+/** @brief Largest application region the map covers (APP_FLASH_LENGTH). */
+#define BOOT_RXMAP_REGION_MAX       (0x00076000UL)
+#define BOOT_RXMAP_BLOCKS           (BOOT_RXMAP_REGION_MAX >> BOOT_RXMAP_BLOCK_SHIFT)
+
+/** @brief Most blocks reported by one MAP reply. */
+#define BOOT_RXMAP_QUERY_MAX        (512U)
+
+/** @brief Buffer size large enough for BootRxMap_Format(). */
+#define BOOT_RXMAP_TEXT_MAX         (32U + (BOOT_RXMAP_QUERY_MAX / 4U))
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief Clear the map and set the region it covers.
+ *
+ * @param[in] base   First address of the application region.
+ * @param[in] length Region size, at most BOOT_RXMAP_REGION_MAX.
+ */
+void BootRxMap_Init(uint32_t base, uint32_t length);
+
+/**
+ * @brief Mark the blocks touched by a programmed record.
+ */
+void BootRxMap_Mark(uint32_t address, uint32_t len);
+
+/**
+ * @brief Format "[MAP] first count hex\r\n" for blocks first..first+count-1.
+ *
+ * Each pair of hex digits holds eight blocks, lowest block in bit 0.
+ * @p count is limited to BOOT_RXMAP_QUERY_MAX and to the end of the map.
+ *
+ * @param[out] buf  Destination, at least BOOT_RXMAP_TEXT_MAX bytes.
+ * @return Number of characters written (without terminator).
+ */
+uint32_t BootRxMap_Format(char *buf, uint32_t size, uint32_t first, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_RXMAP_H_ */
@@ -0,0 +1,70 @@
+/**
+ * @file    boot_stats.h
+ * @brief   Always-on bootloader throughput counters.
+ *
+ * Cheap 32-bit counters updated along the receive -> parse -> program
+ * pipeline. Together with the LPUART error counters (hal_usart) and the
+ * queue high-water marks (uart_buffer, srec_queue) they show whether a slow
+ * or failing station is bound by the link, the parser or the flash.
+ * The STATS command in bootloader mode prints them as one text line.
+ */
+
+#ifndef BOOT_STATS_H_
+#define BOOT_STATS_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Counter set.
+ */
+typedef struct {
+    volatile uint32_t bytes_rx;          /**< Bytes delivered by the UART ISR          */
+    volatile uint32_t uart_buf_drops;    /**< UART_BufferPush() failures (buffer full) */
+    uint32_t lines_rx;                   /**< Complete lines assembled                 */
+    uint32_t line_overflows;             /**< Lines longer than the line buffer        */
+    uint32_t srec_queue_drops;           /**< SREC_QueuePush() failures (queue full)   */
+    uint32_t parse_errors;               /**< parse_srec_line() returned an error      */
+    uint32_t checksum_errors;            /**< Records with a bad checksum              */
+    uint32_t records_programmed;         /**< Data records written to flash            */
+    uint32_t phrases_programmed;         /**< 8-byte Program_LongWord_8B() commands    */
+    uint32_t phrase_errors;              /**< Phrases refused (not RUN) or failed      */
+    uint32_t sectors_erased;             /**< 4 KB sectors erased                      */
+} boot_stats_t;
+
+/** @brief Global counter set (zero-initialized in .bss). */
+extern boot_stats_t boot_stats;
+
+/** @brief Increment one counter field, e.g. BOOT_STATS_INC(lines_rx). */
+#define BOOT_STATS_INC(field)       (boot_stats.field++)
+
+/** @brief Add to one counter field. */
+#define BOOT_STATS_ADD(field, n)    (boot_stats.field += (uint32_t)(n))
+
+/** @brief Buffer size large enough for BootStats_Format(). */
+#define BOOT_STATS_TEXT_MAX         (320U)
+
+/**
+ * @brief Reset all counters (queue high-water marks are not affected).
+ */
+void BootStats_Reset(void);
+
+/**
+ * @brief Format all counters, LPUART1 errors and queue high-water marks.
+ *
+ * Output is a single line "[STATS] key=value ...\r\n".
+ *
+ * @param[out] buf  Destination, at least BOOT_STATS_TEXT_MAX bytes.
+ * @param[in]  size Size of @p buf.
+ * @return Number of characters written (without terminator).
+ */
+uint32_t BootStats_Format(char *buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_STATS_H_ */
@@ -0,0 +1,53 @@
+/**
+ * @file    boot_text.h
+ * @brief   "key=value" text lines for the STATS and LAT replies.
+ *
+ * The bootloader has no printf. A reply is built by appending fields that
+ * each end in a space ("key=value "); BootText_EndLine() then turns the
+ * last space into CR LF. Every function stops at size - 1 characters and
+ * returns the new position, so a short buffer truncates the line instead of
+ * overflowing it.
+ */
+
+#ifndef BOOT_TEXT_H_
+#define BOOT_TEXT_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief Append "key=value " with value in decimal.
+ *
+ * @return Position after the field.
+ */
+uint32_t BootText_AppendU32(char *buf, uint32_t pos, uint32_t size,
+                            const char *key, uint32_t value);
+
+/**
+ * @brief Append "key=0x%08X ".
+ *
+ * @return Position after the field.
+ */
+uint32_t BootText_AppendHex(char *buf, uint32_t pos, uint32_t size,
+                            const char *key, uint32_t value);
+
+/**
+ * @brief Replace the trailing space by CR LF and terminate the string.
+ *
+ * @param size At least 3.
+ * @return Number of characters in @p buf (without terminator).
+ */
+uint32_t BootText_EndLine(char *buf, uint32_t pos, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_TEXT_H_ */
@@ -0,0 +1,163 @@
+/**
+ * @file    boot_trace.h
+ * @brief   Event trace recorder: timestamped events in a fixed RAM ring.
+ *
+ * Every event is one 8-byte entry: the CYCCNT value and a word holding the
+ * event id and a 24-bit argument. The ring keeps the last BOOT_TRACE_DEPTH
+ * events. Recording an event masks interrupts for a few instructions, so
+ * ISRs and the main loop can record into the same ring.
+ *
+ * The TRACE command dumps the ring (BootTrace_Dump()). tools/trace converts
+ * the dump into Chrome/Perfetto trace JSON, with ISRs and the main loop on
+ * separate tracks, so the overlap of the LPUART ISR with Flash operations
+ * and the stalls in between can be seen.
+ *
+ * Set BOOT_TRACE_ENABLE to 1 to record. With 0 every TRACE_xxx macro
+ * compiles to nothing.
+ */
+
+#ifndef BOOT_TRACE_H_
+#define BOOT_TRACE_H_
+
+#include <stdint.h>
+#include "dwt_perf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  CONFIGURATION
+ * ============================================================ */
+
+#ifndef BOOT_TRACE_ENABLE
+#define BOOT_TRACE_ENABLE   0
+#endif
+
+#ifndef BOOT_TRACE_DEPTH
+#define BOOT_TRACE_DEPTH    (512U)      /**< Power of two, 8 bytes per event */
+#endif
+
+/* Stop recording at the first dropped UART byte, so the ring keeps the
+ * events that led to it; the next dump restarts recording */
+#ifndef BOOT_TRACE_STOP_ON_DROP
+#define BOOT_TRACE_STOP_ON_DROP 1
+#endif
+
+/* ============================================================
+ *                  TYPE DEFINITIONS
+ * ============================================================ */
+
+/**
+ * @brief Event ids. The argument of each event is given in brackets.
+ */
+typedef enum {
+    BOOT_TRACE_ISR_ENTER = 1,   /**< Handler entered [IRQn]                */
+    BOOT_TRACE_ISR_EXIT,        /**< Handler left [IRQn]                   */
+    BOOT_TRACE_LINE_RX,         /**< Line or frame assembled [length]      */
+    BOOT_TRACE_PARSE_BEGIN,     /**< BootRecord_Decode() [frame length]    */
+    BOOT_TRACE_PARSE_END,       /**< Record decoded [data length, 0 error] */
+    BOOT_TRACE_PROGRAM_BEGIN,   /**< Program_LongWord_8B() [address]       */
+    BOOT_TRACE_PROGRAM_END,     /**< Phrase programmed [address]           */
+    BOOT_TRACE_ERASE_BEGIN,     /**< Erase_Sector() [address]              */
+    BOOT_TRACE_ERASE_END,       /**< Sector erased [address]               */
+    BOOT_TRACE_QUEUE_FULL,      /**< Record queue full, frame dropped [length] */
+    BOOT_TRACE_UART_DROP,       /**< UART ring full, byte dropped [byte]   */
+    BOOT_TRACE_EV_COUNT
+} boot_trace_ev_t;
+
+/**
+ * @brief One event.
+ */
+typedef struct {
+    uint32_t cycles;            /**< DWT_PERF_NOW() at the event           */
+    uint32_t word;              /**< Event id | (argument << 8)            */
+} boot_trace_entry_t;
+
+/* ---- Binary dump frame ----
+ *   uint32_t magic      BOOT_TRACE_DUMP_MAGIC
+ *   uint8_t  version    BOOT_TRACE_DUMP_VERSION
+ *   uint8_t  reserved[3]
+ *   uint32_t core_hz    cycles per second
+ *   uint32_t total      events recorded since BootTrace_Init()
+ *   uint32_t n_events   events that follow (at most BOOT_TRACE_DEPTH)
+ *   boot_trace_entry_t events[n_events]   oldest first
+ */
+#define BOOT_TRACE_DUMP_MAGIC   (0x45435254UL)  /* "TRCE" */
+#define BOOT_TRACE_DUMP_VERSION (1U)
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief Clear the ring and start recording.
+ */
+void BootTrace_Init(void);
+
+/**
+ * @brief Write the binary dump frame through @p write.
+ *
+ * Recording is paused during the dump and resumes afterwards, so the
+ * events of the dump transmission itself are not recorded.
+ *
+ * @param write    Output function.
+ * @param core_hz  Core clock used to convert cycles on the host.
+ */
+void BootTrace_Dump(perf_write_t write, uint32_t core_hz);
+
+/* ============================================================
+ *                  INSTRUMENTATION MACROS
+ * ============================================================ */
+
+#if (BOOT_TRACE_ENABLE)
+
+#include "cmsis_gcc.h"
+
+extern boot_trace_entry_t boot_trace_ring[BOOT_TRACE_DEPTH];
+extern uint32_t           boot_trace_total;
+extern volatile uint8_t   boot_trace_on;
+
+/**
+ * @brief Record one event (any context, interrupts may be masked).
+ *
+ * Always inlined: the LPUART handlers run from SRAM during Flash commands
+ * and must not call into Flash, also at -O0.
+ */
+__attribute__((always_inline)) static inline void BootTrace_Event(uint32_t ev, uint32_t arg)
+{
+    uint32_t primask = __get_PRIMASK();
+    boot_trace_entry_t *e;
+
+    __disable_irq();
+    if (boot_trace_on != 0U) {
+        e = &boot_trace_ring[boot_trace_total & (BOOT_TRACE_DEPTH - 1U)];
+        boot_trace_total++;
+        e->cycles = DWT_PERF_NOW();
+        e->word   = ev | (arg << 8);
+    }
+    if (primask == 0U) {
+        __enable_irq();
+    }
+}
+
+#define TRACE_EVENT(ev, arg)    BootTrace_Event((uint32_t)(ev), (uint32_t)(arg))
+#define TRACE_ISR_ENTER(irq)    BootTrace_Event((uint32_t)BOOT_TRACE_ISR_ENTER, (uint32_t)(irq))
+#define TRACE_ISR_EXIT(irq)     BootTrace_Event((uint32_t)BOOT_TRACE_ISR_EXIT, (uint32_t)(irq))
+#if (BOOT_TRACE_STOP_ON_DROP)
+#define TRACE_DROP_STOP()       do { boot_trace_on = 0U; } while (0)
+#else
+#define TRACE_DROP_STOP()       do { } while (0)
+#endif
+#else
+#define TRACE_EVENT(ev, arg)    do { } while (0)
+#define TRACE_ISR_ENTER(irq)    do { } while (0)
+#define TRACE_ISR_EXIT(irq)     do { } while (0)
+#define TRACE_DROP_STOP()       do { } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_TRACE_H_ */
@@ -8,8 +8,93 @@
 #ifndef CLOCK_AND_MODE_H_
 #define CLOCK_AND_MODE_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Clock plan produced by SOSC_init_8MHz + SPLL_init_160MHz + NormalRUNmode_80MHz */
+#define CLOCK_CORE_HZ       80000000U   /* CORE_CLK = SPLL / 2                */
+#define CLOCK_BUS_HZ        40000000U   /* BUS_CLK  = CORE_CLK / 2            */
+#define CLOCK_SLOW_HZ       26666667U   /* SLOW_CLK = CORE_CLK / 3 (flash)    */
+#define CLOCK_SPLLDIV2_HZ   40000000U   /* SPLLDIV2_CLK = SPLL / 4 (LPUART)   */
+#define CLOCK_SOSCDIV2_HZ   8000000U    /* SOSCDIV2_CLK = SOSC / 1            */
+
+/* HSRUN plan: SPLL relocked at 112 MHz (VCO 224 MHz) */
+#define CLOCK_HSRUN_CORE_HZ     112000000U  /* CORE_CLK = SPLL / 1            */
+#define CLOCK_HSRUN_BUS_HZ      56000000U   /* BUS_CLK  = CORE_CLK / 2        */
+#define CLOCK_HSRUN_SLOW_HZ     28000000U   /* SLOW_CLK = CORE_CLK / 4 (flash) */
+#define CLOCK_HSRUN_SPLLDIV2_HZ 28000000U   /* SPLLDIV2_CLK = SPLL / 4        */
+
+/* VLPR plan: SIRC 8 MHz; SOSC, FIRC and SPLL are off */
+#define CLOCK_VLPR_CORE_HZ      4000000U    /* CORE_CLK = SIRC / 2            */
+#define CLOCK_VLPR_BUS_HZ       4000000U    /* BUS_CLK  = CORE_CLK            */
+#define CLOCK_VLPR_SLOW_HZ      1000000U    /* SLOW_CLK = CORE_CLK / 4 (flash) */
+
+/*
+ * Run modes (SMC PMCTRL[RUNM]). Flash program and erase are only allowed in
+ * RUN. Every switch between RUN and HSRUN relocks the SPLL (160 <-> 112 MHz)
+ * with FIRC as system clock meanwhile, so SPLLDIV2 stops for the lock time
+ * and comes back at another frequency. Drivers clocked from SPLLDIV2
+ * register a notifier and recompute their dividers after the switch; a
+ * LPUART that must not lose a character runs from SOSCDIV2 instead.
+ */
+typedef enum {
+ CLOCK_MODE_RUN = 0,            /* 80 MHz, the reset plan above            */
+ CLOCK_MODE_HSRUN,              /* 112 MHz, no Flash program/erase         */
+ CLOCK_MODE_VLPR,               /* 4 MHz, no Flash program/erase, no SPLL  */
+ CLOCK_MODE_COUNT
+} clock_mode_t;
+
+/* Frequencies of the running clocks, from the SCG registers (clock_tree.h); 0: clock off */
+typedef struct {
+ uint32_t core_hz;
+ uint32_t bus_hz;
+ uint32_t slow_hz;
+ uint32_t splldiv2_hz;
+ uint32_t soscdiv2_hz;
+} clock_freq_t;
+
+typedef enum {
+ CLOCK_NOTIFY_BEFORE = 0,       /* Old clocks still running                */
+ CLOCK_NOTIFY_AFTER             /* New clocks running                      */
+} clock_notify_ev_t;
+
+typedef void (*clock_notify_t)(clock_notify_ev_t ev, const clock_freq_t *freq);
+
+/* Governor: the code announces its workload phase, the governor switches to
+ * the mode configured for it. Defaults: decode in HSRUN, Flash in RUN. */
+typedef enum {
+ CLOCK_PHASE_IDLE = 0,
+ CLOCK_PHASE_DECODE,            /* CPU bound: parsing, checksums           */
+ CLOCK_PHASE_FLASH,             /* FTFC commands                           */
+ CLOCK_PHASE_COUNT
+} clock_phase_t;
+
+#ifndef CLOCK_NOTIFY_MAX
+#define CLOCK_NOTIFY_MAX    4U
+#endif
+
+/* The init functions return immediately when the configuration is already
+ * in place (e.g. the bootloader handed over a running clock tree). */
 void SOSC_init_8MHz(void);
 void SPLL_init_160MHz(void);
 void NormalRUNmode_80MHz (void);
 
+bool SOSC_is_8MHz(void);
+bool SPLL_is_160MHz(void);
+bool RUNmode_is_80MHz(void);
+
+/* Mode switch through the SMC, notifiers called before and after. Returns
+ * false for an unknown mode. The first call allows HSRUN and VLPR in
+ * SMC PMPROT (write-once after reset). Call from thread level only. */
+bool Clock_SetMode(clock_mode_t mode);
+clock_mode_t Clock_GetMode(void);
+const clock_freq_t *Clock_GetFreq(void);
+bool Clock_RegisterNotify(clock_notify_t fn); /* false: table full */
+
+/* Governor. Set returns false for an unknown phase or mode and for any mode
+ * but RUN in CLOCK_PHASE_FLASH (the FTFC refuses HSRUN and VLPR). */
+bool Clock_GovernorSet(clock_phase_t phase, clock_mode_t mode);
+void Clock_GovernorPhase(clock_phase_t phase);
+uint32_t Clock_GovernorSwitches(void); /* Mode switches since reset */
+
 #endif /* CLOCK_AND_MODE_H_ */
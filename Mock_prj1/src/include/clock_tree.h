@@ -0,0 +1,132 @@
+/**
+ * @file    clock_tree.h
+ * @brief   Clock tree queries from the live SCG/PCC registers and
+ *          reference-counted PCC clock gating.
+ *
+ * Every frequency is computed from the registers at the time of the call:
+ * the valid flag of each source, SPLLCFG, the xxxDIVn dividers, CSR (the
+ * system clock actually in use, not RCCR) and the PCS field of a PCC slot.
+ * A driver that asks here instead of using a constant keeps its baud rate
+ * or timer period when the clock plan changes (clock_and_mode.h). The only
+ * fixed values are the board crystal (CLOCK_TREE_SOSC_HZ) and the nominal
+ * IRC and LPO frequencies.
+ *
+ * PCC gating: ClockTree_PccAcquire() ungates a slot for the first user,
+ * ClockTree_PccRelease() gates it again after the last one, so a
+ * peripheral that nobody uses is not clocked. The source of a slot is set
+ * by its first user; PCS can only change while CGC = 0, so a shared slot
+ * keeps its source. A slot that was ungated before its first acquire
+ * (reset default, bootloader handoff) has no user and stays as it is.
+ *
+ * The functions are called from thread level only.
+ */
+
+#ifndef CLOCK_TREE_H_
+#define CLOCK_TREE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  CONFIGURATION
+ * ============================================================ */
+
+#ifndef CLOCK_TREE_SOSC_HZ
+#define CLOCK_TREE_SOSC_HZ      (8000000UL)     /**< EVB crystal            */
+#endif
+
+#define CLOCK_TREE_FIRC_HZ      (48000000UL)
+#define CLOCK_TREE_SIRC_HI_HZ   (8000000UL)     /**< SIRCCFG RANGE = 1      */
+#define CLOCK_TREE_SIRC_LO_HZ   (2000000UL)
+#define CLOCK_TREE_LPO_HZ       (128000UL)
+
+/* PCC PCS values (peripheral functional clock) */
+#define CLOCK_TREE_PCS_NONE     (0U)    /**< Bus clock only, or keep the PCS  */
+#define CLOCK_TREE_PCS_SOSCDIV2 (1U)
+#define CLOCK_TREE_PCS_SIRCDIV2 (2U)
+#define CLOCK_TREE_PCS_FIRCDIV2 (3U)
+#define CLOCK_TREE_PCS_SPLLDIV2 (6U)
+#define CLOCK_TREE_PCS_LPO      (7U)    /**< LPO128K                          */
+
+/* ============================================================
+ *                  TYPE DEFINITIONS
+ * ============================================================ */
+
+/**
+ * @brief Clock tree nodes.
+ */
+typedef enum {
+    CLOCK_TREE_SOSC = 0,        /**< System oscillator (0 if not valid)    */
+    CLOCK_TREE_SIRC,
+    CLOCK_TREE_FIRC,
+    CLOCK_TREE_SPLL,            /**< VCO / 2                               */
+    CLOCK_TREE_SOSCDIV1,
+    CLOCK_TREE_SOSCDIV2,
+    CLOCK_TREE_SIRCDIV1,
+    CLOCK_TREE_SIRCDIV2,
+    CLOCK_TREE_FIRCDIV1,
+    CLOCK_TREE_FIRCDIV2,
+    CLOCK_TREE_SPLLDIV1,
+    CLOCK_TREE_SPLLDIV2,
+    CLOCK_TREE_CORE,            /**< CORE_CLK / SYS_CLK (CSR)              */
+    CLOCK_TREE_BUS,
+    CLOCK_TREE_SLOW,            /**< Flash clock                           */
+    CLOCK_TREE_LPO,             /**< LPO128K, always running               */
+    CLOCK_TREE_COUNT
+} clock_tree_id_t;
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief Frequency of a clock tree node in Hz, 0 if it is not running.
+ */
+uint32_t ClockTree_GetHz(clock_tree_id_t id);
+
+/**
+ * @brief Functional clock of a PCC slot in Hz.
+ *
+ * @param pcc_index PCC_xxx_INDEX.
+ * @return Frequency of the PCS source, 0 if the slot is gated or has no
+ *         PCS selected.
+ */
+uint32_t ClockTree_PccHz(uint32_t pcc_index);
+
+/**
+ * @brief Take a reference on a PCC slot; the first one ungates it.
+ *
+ * @param pcc_index PCC_xxx_INDEX.
+ * @param pcs       CLOCK_TREE_PCS_xxx, written by the first user only.
+ * @return false if the slot is in use with another source (no reference taken).
+ */
+bool ClockTree_PccAcquire(uint32_t pcc_index, uint32_t pcs);
+
+/**
+ * @brief Drop a reference; the last one gates the slot.
+ */
+void ClockTree_PccRelease(uint32_t pcc_index);
+
+/**
+ * @brief Change the source of a slot that has at most one user.
+ *
+ * The slot is gated for the change and ungated again if it was in use.
+ *
+ * @return false if the slot is shared.
+ */
+bool ClockTree_PccSetSource(uint32_t pcc_index, uint32_t pcs);
+
+/**
+ * @brief Number of users of a PCC slot.
+ */
+uint32_t ClockTree_PccUsers(uint32_t pcc_index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLOCK_TREE_H_ */
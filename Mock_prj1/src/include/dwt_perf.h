@@ -0,0 +1,179 @@
+/**
+ * @file    dwt_perf.h
+ * @brief   Cycle-accurate instrumentation based on the Cortex-M4 DWT cycle counter.
+ *
+ * Provides two kinds of measurements:
+ *   - Marks:  named one-shot timestamps (cycles since DWT_Perf_Init()).
+ *   - Phases: named intervals with count/min/max/sum accumulators.
+ *
+ * All results can be dumped in a compact little-endian binary frame
+ * (see DWT_Perf_Dump()) for decoding on the host.
+ *
+ * Set DWT_PERF_ENABLE to 0 to compile every PERF_xxx macro to nothing.
+ */
+
+#ifndef DWT_PERF_H_
+#define DWT_PERF_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  CONFIGURATION
+ * ============================================================ */
+
+#ifndef DWT_PERF_ENABLE
+#define DWT_PERF_ENABLE     1
+#endif
+
+/* ============================================================
+ *                  REGISTER DEFINITIONS
+ * ============================================================ */
+
+/**
+\brief Access structure of the DWT (only the registers used here).
+*/
+typedef struct {
+  volatile uint32_t CTRL;                  /* Offset: 0x000 (R/W) Control Register */
+  volatile uint32_t CYCCNT;                /* Offset: 0x004 (R/W) Cycle Count Register */
+} DWT_PERF_Type;
+
+#define DWT_PERF_DEMCR_TRCENA_MASK  (1UL << 24)
+#define DWT_PERF_CTRL_CYCCNTENA     (1UL << 0)
+
+/*
+ * A target without a DWT defines DWT_PERF_PORT and provides DWT_PERF_DEMCR,
+ * DWT_PERF and DWT_PERF_NOW() itself (see tools/qemu_an386).
+ */
+#ifndef DWT_PERF_PORT
+
+/** @brief Debug Exception and Monitor Control Register (CoreDebug->DEMCR). */
+#define DWT_PERF_DEMCR              (*(volatile uint32_t *)0xE000EDFCUL)
+
+#define DWT_PERF                    ((DWT_PERF_Type *)0xE0001000UL)
+
+/** @brief Current value of the cycle counter. */
+#define DWT_PERF_NOW()              (DWT_PERF->CYCCNT)
+
+#endif /* DWT_PERF_PORT */
+
+/* ============================================================
+ *                  TYPE DEFINITIONS
+ * ============================================================ */
+
+/**
+ * @brief Named timestamp points (recorded once).
+ */
+typedef enum {
+    PERF_MARK_MAIN_ENTRY = 0,   /**< main() entered                         */
+    PERF_MARK_CLOCK_DONE,       /**< SOSC/SPLL locked, RUN 80 MHz selected  */
+    PERF_MARK_PERIPH_DONE,      /**< UART and board GPIO initialized        */
+    PERF_MARK_ERASE_DONE,       /**< Application region erased              */
+    PERF_MARK_FIRST_RECORD,     /**< First data record programmed           */
+    PERF_MARK_EOF_RECORD,       /**< S7/S8/S9 processed                     */
+    PERF_MARK_COUNT
+} perf_mark_t;
+
+/**
+ * @brief Named phases (accumulated).
+ */
+typedef enum {
+    PERF_PH_LINE_RX = 0,        /**< Interval between two completed lines   */
+    PERF_PH_PARSE,              /**< parse_srec_line()                      */
+    PERF_PH_RECORD,             /**< One data record: parse + program       */
+    PERF_PH_PROGRAM,            /**< Program_LongWord_8B()                  */
+    PERF_PH_ERASE,              /**< Erase_Sector()                         */
+    PERF_PH_STARTUP,            /**< init_data_bss() before main (startup.c) */
+    PERF_PH_COUNT
+} perf_phase_t;
+
+/**
+ * @brief Accumulator of one phase.
+ */
+typedef struct {
+    uint32_t count;             /**< Number of samples                      */
+    uint32_t min;               /**< Minimum cycles (0xFFFFFFFF if empty)   */
+    uint32_t max;               /**< Maximum cycles                         */
+    uint64_t sum;               /**< Total cycles (avg = sum / count)       */
+} perf_acc_t;
+
+/** @brief Output function used by DWT_Perf_Dump() (e.g. blocking UART send). */
+typedef void (*perf_write_t)(const void *data, uint32_t len);
+
+/* ---- Binary dump frame ----
+ *   uint32_t magic      DWT_PERF_DUMP_MAGIC
+ *   uint8_t  version    DWT_PERF_DUMP_VERSION
+ *   uint8_t  n_marks    PERF_MARK_COUNT
+ *   uint8_t  n_phases   PERF_PH_COUNT
+ *   uint8_t  reserved
+ *   uint32_t core_hz    cycles per second
+ *   uint32_t marks[n_marks]
+ *   { uint32_t count, min, max, sum_lo, sum_hi } phases[n_phases]
+ */
+#define DWT_PERF_DUMP_MAGIC     (0x46524550UL)  /* "PERF" */
+#define DWT_PERF_DUMP_VERSION   (1U)
+
+/* ============================================================
+ *                  FUNCTION PROTOTYPES
+ * ============================================================ */
+
+/**
+ * @brief Enable trace, reset and start CYCCNT, clear all marks and phases.
+ */
+void DWT_Perf_Init(void);
+
+/**
+ * @brief Record the current cycle count for a mark (first call wins).
+ */
+void DWT_Perf_Mark(perf_mark_t mark);
+
+/**
+ * @brief Add one sample (end - start cycles) to a phase accumulator.
+ */
+void DWT_Perf_Add(perf_phase_t phase, uint32_t start);
+
+/**
+ * @brief Add one sample of a known length to a phase accumulator.
+ */
+void DWT_Perf_AddCycles(perf_phase_t phase, uint32_t cycles);
+
+/**
+ * @brief Read-only access to a phase accumulator.
+ */
+const perf_acc_t *DWT_Perf_GetPhase(perf_phase_t phase);
+
+/**
+ * @brief Read a mark (0 if not reached).
+ */
+uint32_t DWT_Perf_GetMark(perf_mark_t mark);
+
+/**
+ * @brief Write the binary dump frame through @p write.
+ *
+ * @param write    Output function.
+ * @param core_hz  Core clock used to convert cycles on the host.
+ */
+void DWT_Perf_Dump(perf_write_t write, uint32_t core_hz);
+
+/* ============================================================
+ *                  INSTRUMENTATION MACROS
+ * ============================================================ */
+
+#if (DWT_PERF_ENABLE)
+#define PERF_MARK(m)            DWT_Perf_Mark(m)
+#define PERF_BEGIN(var)         uint32_t var = DWT_PERF_NOW()
+#define PERF_END(ph, var)       DWT_Perf_Add((ph), (var))
+#else
+#define PERF_MARK(m)            do { } while (0)
+#define PERF_BEGIN(var)         do { } while (0)
+#define PERF_END(ph, var)       do { } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DWT_PERF_H_ */
@@ -11,6 +11,7 @@
 
 #include "S32K144.h"
 #include "Driver_USART.h"
+#include "s32_core_cm4.h"
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -44,6 +45,38 @@ typedef enum {
     HAL_USART_BAUDRATE_921600 = 921600U
 } HAL_USART_Baudrate_t;
 
+/**
+ * @brief Address frames of the multi-drop mode (9th bit set).
+ *
+ * Node addresses are 0x80..0xFE, so the low 8 bits of an address frame,
+ * as delivered to the receive buffer, never look like ASCII data.
+ */
+#define HAL_USART_ADDRESS_MARK      (0x100U)    /**< 9th bit of an address frame */
+#define HAL_USART_NODE_MIN          (0x80U)     /**< Lowest node address         */
+#define HAL_USART_BROADCAST         (0xFFU)     /**< Address accepted by all nodes */
+
+/**
+ * @brief Functional clock sources (PCC PCS).
+ *
+ * The baud divisor uses the frequency the source has in the clock tree
+ * (clock_tree.h), whatever the clock plan. SPLLDIV2 follows the run mode
+ * (clock_and_mode.h): the baud divisor is recomputed after every mode
+ * switch, a character on the line during the switch is lost. SOSCDIV2
+ * (8 MHz) keeps running across RUN/HSRUN.
+ */
+#define HAL_USART_PCS_SOSCDIV2      (1U)
+#define HAL_USART_PCS_SPLLDIV2      (6U)
+
+/**
+ * @brief Receive error counters (LPUART STAT.OR/NF/FE/PF occurrences).
+ */
+typedef struct {
+    uint32_t overrun;   /**< Receiver overrun: a byte was lost        */
+    uint32_t noise;     /**< Noise detected in a received byte        */
+    uint32_t framing;   /**< Framing error (bad stop bit)             */
+    uint32_t parity;    /**< Parity error                             */
+} HAL_USART_Errors_t;
+
 /* ============================================================
  *                  FUNCTION PROTOTYPES
  * ============================================================ */
@@ -55,8 +88,11 @@ void HAL_USART_RegisterCallback(HAL_USART_Channel_t ch, ARM_USART_SignalEvent_t
 
 /**
  * @brief Configure the clock source for the specified USART channel.
+ *
+ * The first call takes the channel's PCC reference (clock_tree.h), later
+ * calls only change the source.
  * @param ch  Channel (LPUART0–2)
- * @param pcs Peripheral clock source selector (e.g. SPLL_DIV2 = 6)
+ * @param pcs Peripheral clock source selector (HAL_USART_PCS_xxx)
  */
 void HAL_USART_SetClockSource(HAL_USART_Channel_t ch, uint8_t pcs);
 
@@ -73,9 +109,24 @@ void HAL_USART_DisableIRQ(HAL_USART_Channel_t ch);
 
 /**
  * @brief Configure baudrate and control mode (asynchronous, etc.)
+ *
+ * The divisor is computed from the current frequency of the channel's
+ * clock source and again after every run mode switch.
  */
 void HAL_USART_Config(HAL_USART_Channel_t ch, uint32_t control, HAL_USART_Baudrate_t baud);
 
+/**
+ * @brief Switch a configured channel to RS-485 multi-drop operation.
+ *
+ * 9-bit frames with hardware address match: after an address frame equal
+ * to @p node or @p broadcast, the data frames that follow are received;
+ * after any other address frame they are discarded by the LPUART without
+ * an interrupt. Matching address frames are delivered like data bytes
+ * (value >= HAL_USART_NODE_MIN). RTS drives the transceiver DE pin while
+ * transmitting.
+ */
+void HAL_USART_ConfigMultidrop(HAL_USART_Channel_t ch, uint8_t node, uint8_t broadcast);
+
 /**
  * @brief Send data (blocking or interrupt-driven, depending on HAL implementation).
  */
@@ -83,20 +134,47 @@ void HAL_USART_Send(HAL_USART_Channel_t ch, const void *data, uint32_t num);
 
 /**
  * @brief Receive data (blocking or interrupt-driven).
+ *
+ * In SRAM: the receive callback re-arms from the ISR (Driver_NVIC.h).
+ */
+START_FUNCTION_DECLARATION_RAMSECTION
+void HAL_USART_Receive(HAL_USART_Channel_t ch, void *data, uint32_t num)
+END_FUNCTION_DECLARATION_RAMSECTION
+
+/**
+ * @brief Get receive error counters of the specified channel.
  */
-void HAL_USART_Receive(HAL_USART_Channel_t ch, void *data, uint32_t num);
+void HAL_USART_GetErrors(HAL_USART_Channel_t ch, HAL_USART_Errors_t *err);
 
 /**
  * @brief Common interrupt handler for all USART channels.
  */
-void HAL_USART_IRQHandler(HAL_USART_Channel_t ch);
+START_FUNCTION_DECLARATION_RAMSECTION
+void HAL_USART_IRQHandler(HAL_USART_Channel_t ch)
+END_FUNCTION_DECLARATION_RAMSECTION
+
+/**
+ * @brief Count and clear the receive error flags of a STAT value read by an
+ *        installed receive handler (NVIC_InstallHandler()).
+ */
+START_FUNCTION_DECLARATION_RAMSECTION
+void HAL_USART_CountErrors(HAL_USART_Channel_t ch, uint32_t stat)
+END_FUNCTION_DECLARATION_RAMSECTION
 
 /* ============================================================
  *                  INTERRUPT HANDLERS (ISR ENTRY POINTS)
  * ============================================================ */
-void LPUART0_RxTx_IRQHandler(void);
-void LPUART1_RxTx_IRQHandler(void);
-void LPUART2_RxTx_IRQHandler(void);
+
+/* In SRAM: they preempt Flash commands (NVIC_PRIO_LPUART, Driver_NVIC.h) */
+START_FUNCTION_DECLARATION_RAMSECTION
+void LPUART0_RxTx_IRQHandler(void)
+END_FUNCTION_DECLARATION_RAMSECTION
+START_FUNCTION_DECLARATION_RAMSECTION
+void LPUART1_RxTx_IRQHandler(void)
+END_FUNCTION_DECLARATION_RAMSECTION
+START_FUNCTION_DECLARATION_RAMSECTION
+void LPUART2_RxTx_IRQHandler(void)
+END_FUNCTION_DECLARATION_RAMSECTION
 
 #ifdef __cplusplus
 }
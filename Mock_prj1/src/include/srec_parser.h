@@ -52,9 +52,11 @@ unsigned char hex_to_byte(const char *hex);
 /**
  * @brief srec data check function
  *
- * @param line
+ * @param line '\0'-terminated record line
  * @param rec
- * @return int
+ * @return int 0 ok, -1 not an S-record, -2 unknown type,
+ *         -3 byte count below address + checksum, line shorter than the
+ *         count or a non-hex digit
  */
 int parse_srec_line(const char *line, srec_record_t *rec);
 
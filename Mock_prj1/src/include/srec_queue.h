@@ -15,8 +15,11 @@
 void SREC_QueueInit(void);
 bool SREC_QueuePush(const char *line);
 bool SREC_QueuePop(char *out_line);
+bool SREC_QueuePushFrame(const uint8_t *frame, uint16_t len);   /* Binary-safe, len < SREC_LINE_MAX_LEN */
+bool SREC_QueuePopFrame(uint8_t *out, uint16_t *len);           /* out is also '\0'-terminated */
 bool SREC_QueueIsEmpty(void);
 bool SREC_QueueIsFull(void);
 uint8_t SREC_QueueCount(void);
+uint8_t SREC_QueueHighWater(void);   /* Max lines queued at once, not cleared by SREC_QueueInit() */
 
 #endif /* SREC_QUEUE_H_ */
@@ -21,6 +21,7 @@ void UART_BufferInit(void);
 /**
  * @brief Push one received byte into the queue
  * @param c Byte to push
+ * @note In SRAM, called from the LPUART ISR during Flash commands
  */
 bool UART_BufferPush(uint8_t c);
 
@@ -45,6 +46,13 @@ bool UART_BufferPop(uint8_t *c);
  */
 uint16_t UART_BufferCount(void);
 
+/**
+ * @brief Get the highest number of bytes stored at once since reset
+ * @note  Not cleared by UART_BufferInit()
+ * @return High-water mark in bytes
+ */
+uint16_t UART_BufferHighWater(void);
+
 
 
 #endif /* INCLUDE_UART_QUEUE_H_ */
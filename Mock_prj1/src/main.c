@@ -1,4 +1,3 @@
-
 /**
  * @file main.c
  * @author: Nguyen Sy Hung
@@ -10,22 +9,40 @@
  * - Erases and programs Flash memory using access-code protection
  * - Handles 8-byte aligned Flash programming 
  * - Jumps to USER APP after successful programming or on button release
+ * - Optionally shares an RS-485 bus with other nodes (BOOT_MULTIDROP)
+ * - Optionally decodes in HSRUN and programs in RUN (BOOT_GOVERNOR_ENABLE)
+ * - Takes LPUART1 receive interrupts in its own vector (BOOT_RX_DIRECT_ENABLE)
+ * - Serves Flash, CRC and restart routines to applications (boot_api.h)
  *
  */
 
 #include "Driver_USART.h"
 #include "uart_buffer.h"
 #include "srec_queue.h"
-#include "SREC_parser.h"
+#include "boot_record.h"
+#include "boot_phrase.h"
 #include "hal_usart.h"
 #include "clock_and_mode.h"
+#include "clock_tree.h"
 #include "FLASH.h"
+#include "boot_handoff.h"
+#include "boot_api.h"
+#include "dwt_perf.h"
+#include "boot_stats.h"
+#include "boot_rxmap.h"
+#include "boot_prof.h"
+#include "boot_trace.h"
+#include "boot_lat.h"
+#include "boot_cache.h"
+#include "boot_flexram.h"
+#include "Driver_NVIC.h"
 #include "S32K144_features.h"
 #include "Driver_PORT_S32K144.h"
 #include "Driver_GPIO.h"
 #include "Driver_GPIO_Pins.h"
 #include "s32_core_cm4.h"
 #include "cmsis_gcc.h"
+#include <string.h>
 
 /*******************************************************************************
  * Definitions
@@ -37,9 +54,53 @@
 #define APP_FLASH_END      (APP_FLASH_START + APP_FLASH_LENGTH - 1U)      
 
 #define UART_DRIVER        Driver_USART1 
+#define UART_BAUDRATE      HAL_USART_BAUDRATE_9600
 #define MAX_LINE_LENGTH    256U          
-#define FLASH_ALIGN_SIZE   8U            /* Flash programming alignment requirement (8 bytes) */
-#define FLASH_HALF_SIZE    4U            /* Half of Flash alignment size for 4+4 merge */
+
+/* Text commands accepted in bootloader mode (lines that are not records, boot_record.h) */
+#define CMD_PERF           "PERF"        /* Binary dump of DWT marks and phase accumulators */
+#define CMD_STATS          "STATS"       /* Text line with throughput counters */
+#define CMD_MAP            "MAP"         /* "MAP first count": programmed blocks (boot_rxmap.h) */
+#define CMD_PROF           "PROF"        /* "PROF [hz]": PC histogram dump, or restart at hz (boot_prof.h) */
+#define CMD_TRACE          "TRACE"       /* Binary dump of the event trace ring (boot_trace.h) */
+#define CMD_LAT            "LAT"         /* "LAT [0]": latency histograms, or clear them (boot_lat.h) */
+
+/*
+ * RS-485 multi-drop operation (LPUART1 9-bit address match, see
+ * HAL_USART_ConfigMultidrop()). The host sends one broadcast copy of the
+ * image to every node on the bus, then addresses each node to query its
+ * block map and resend what it missed. A node transmits only while it is
+ * addressed by its own address, so the bus never has two drivers.
+ * Off by default: the OpenSDA virtual COM port carries 8-bit frames.
+ */
+#ifndef BOOT_MULTIDROP
+#define BOOT_MULTIDROP     0
+#endif
+#ifndef BOOT_NODE_ADDRESS
+#define BOOT_NODE_ADDRESS  0x81U         /* HAL_USART_NODE_MIN..0xFE, one per node */
+#endif
+
+/*
+ * Clock governor (clock_and_mode.h): record decoding runs in HSRUN at
+ * 112 MHz, Flash commands in RUN at 80 MHz (the FTFC refuses them in
+ * HSRUN). Every switch relocks the SPLL, so LPUART1 moves to SOSCDIV2,
+ * which keeps running across switches. Off by default: with one record per
+ * 9600 baud line the relock time exceeds the decode time saved.
+ */
+#ifndef BOOT_GOVERNOR_ENABLE
+#define BOOT_GOVERNOR_ENABLE 0
+#endif
+
+/*
+ * Receive path straight from the RAM vector table (NVIC_InstallHandler()):
+ * UART_RxIRQHandler() replaces LPUART1_RxTx_IRQHandler() and pushes the
+ * byte itself, without HAL_USART_IRQHandler(), the driver callback and the
+ * re-arm of a one-byte receive. If VTOR points to Flash the install fails
+ * and the driver path stays.
+ */
+#ifndef BOOT_RX_DIRECT_ENABLE
+#define BOOT_RX_DIRECT_ENABLE 1
+#endif
 
 /*******************************************************************************
  * Type Definitions
@@ -57,23 +118,48 @@ extern ARM_DRIVER_USART Driver_USART1;
 extern ARM_DRIVER_GPIO  Driver_GPIO0;
 extern ARM_DRIVER_PORT  Driver_PORT0;
 
+#if BOOT_PROF_ENABLE
+extern uint32_t __etext[];                  /* End of code (linker file) */
+#endif
+#if DWT_PERF_ENABLE
+extern uint32_t startup_init_cycles;        /* init_data_bss() duration (startup.c) */
+#endif
+
 /* UART reception buffer */
 static uint8_t rx_byte;                     /**< Single byte buffer for UART reception */
 
-/* SREC line assembly buffer */
-static char line_buf[MAX_LINE_LENGTH];      /**< Buffer for assembling one SREC line */
+/* Record line / frame assembly buffer */
+static char line_buf[MAX_LINE_LENGTH];      /**< Buffer for assembling one record line or frame */
 static uint16_t line_pos = 0U;              /**< Current position in line buffer */
+static uint16_t frame_need = 0U;            /**< Bytes still missing from a binary frame */
+
+/* Transmit permission: in multi-drop mode only while addressed by own address */
+static uint8_t tx_enabled = (BOOT_MULTIDROP == 0) ? 1U : 0U;
 
 /*******************************************************************************
  * Private Function Prototypes
  ******************************************************************************/
 static inline void UART_SendFast(const char *s);
+static void UART_Write(const void *data, uint32_t len);
+static void Handle_Command(const char *cmd);
+static inline void Flash_Program8(uint32_t addr, const uint8_t *data);
+static void Quiesce_Peripherals(void);
 static void jump_to_app(void);
 static void Board_Init(void);
 static inline uint8_t Button_Pressed(void);
 static void UART_Init(void);
 static void Bootloader_Mode(void);
 
+/* Receive path in SRAM: it keeps running during Flash commands (Driver_NVIC.h) */
+START_FUNCTION_DECLARATION_RAMSECTION
+void UART_EventHandler(uint32_t event)
+END_FUNCTION_DECLARATION_RAMSECTION
+#if BOOT_RX_DIRECT_ENABLE
+START_FUNCTION_DECLARATION_RAMSECTION
+void UART_RxIRQHandler(void)
+END_FUNCTION_DECLARATION_RAMSECTION
+#endif
+
 /*******************************************************************************
  * Private Functions
  ******************************************************************************/
@@ -89,20 +175,187 @@ static void Bootloader_Mode(void);
  */
 static inline void UART_SendFast(const char *s)
 {
+    if (tx_enabled == 0U) {
+        return;
+    }
     UART_DRIVER.Send(s, strlen(s));
     while (UART_DRIVER.GetStatus().tx_busy) {
         /* Wait for transmission complete */
     }
 }
 
+/**
+ * @brief Sends a binary buffer over UART1 in blocking mode
+ * 
+ * @param[in] data Pointer to data to send
+ * @param[in] len  Number of bytes
+ */
+static void UART_Write(const void *data, uint32_t len)
+{
+    if (tx_enabled == 0U) {
+        return;
+    }
+    UART_DRIVER.Send(data, len);
+    while (UART_DRIVER.GetStatus().tx_busy) {
+        /* Wait for transmission complete */
+    }
+}
+
+/**
+ * @brief Executes a text command received instead of an SREC line
+ * 
+ * Supported commands:
+ * - PERF:  binary dump of the DWT instrumentation (see dwt_perf.h)
+ * - STATS: text line with throughput counters (see boot_stats.h)
+ * - MAP first count: programmed application blocks (see boot_rxmap.h)
+ * - PROF [hz]: PC histogram dump, or restart sampling (see boot_prof.h)
+ * - TRACE: binary dump of the event trace ring (see boot_trace.h)
+ * - LAT [0]: masked-window and IRQ latency histograms, 0 clears (see boot_lat.h)
+ * 
+ * @param[in] cmd Null-terminated command line (without '\n')
+ */
+static void Handle_Command(const char *cmd)
+{
+    char text[BOOT_RXMAP_TEXT_MAX > BOOT_STATS_TEXT_MAX ? BOOT_RXMAP_TEXT_MAX : BOOT_STATS_TEXT_MAX];
+    const char *p;
+    uint32_t first = 0U;
+    uint32_t count = 0U;
+
+    if (strncmp(cmd, CMD_PERF, sizeof(CMD_PERF) - 1U) == 0) {
+        DWT_Perf_Dump(UART_Write, ClockTree_GetHz(CLOCK_TREE_CORE));
+    } else if (strncmp(cmd, CMD_STATS, sizeof(CMD_STATS) - 1U) == 0) {
+        (void)BootStats_Format(text, sizeof(text));
+        UART_SendFast(text);
+    } else if (strncmp(cmd, CMD_MAP, sizeof(CMD_MAP) - 1U) == 0) {
+        /* Two decimal arguments, no sscanf in the bootloader */
+        p = &cmd[sizeof(CMD_MAP) - 1U];
+        while (*p == ' ') { p++; }
+        while ((*p >= '0') && (*p <= '9')) { first = (first * 10U) + (uint32_t)(*p++ - '0'); }
+        while (*p == ' ') { p++; }
+        while ((*p >= '0') && (*p <= '9')) { count = (count * 10U) + (uint32_t)(*p++ - '0'); }
+        (void)BootRxMap_Format(text, sizeof(text), first, count);
+        UART_SendFast(text);
+#if BOOT_PROF_ENABLE
+    } else if (strncmp(cmd, CMD_PROF, sizeof(CMD_PROF) - 1U) == 0) {
+        /* No argument: dump. Argument: clear and sample at that rate, 0 stops */
+        p = &cmd[sizeof(CMD_PROF) - 1U];
+        while (*p == ' ') { p++; }
+        if ((*p >= '0') && (*p <= '9')) {
+            while ((*p >= '0') && (*p <= '9')) { first = (first * 10U) + (uint32_t)(*p++ - '0'); }
+            BootProf_Start(0U, (uint32_t)__etext, first, ClockTree_GetHz(CLOCK_TREE_CORE));
+        } else {
+            BootProf_Dump(UART_Write);
+        }
+#endif
+#if BOOT_TRACE_ENABLE
+    } else if (strncmp(cmd, CMD_TRACE, sizeof(CMD_TRACE) - 1U) == 0) {
+        BootTrace_Dump(UART_Write, ClockTree_GetHz(CLOCK_TREE_CORE));
+#endif
+#if BOOT_LAT_ENABLE
+    } else if (strncmp(cmd, CMD_LAT, sizeof(CMD_LAT) - 1U) == 0) {
+        char lat[BOOT_LAT_TEXT_MAX];
+
+        p = &cmd[sizeof(CMD_LAT) - 1U];
+        while (*p == ' ') { p++; }
+        if (*p == '0') {
+            BootLat_Reset();
+        } else {
+            (void)BootLat_Format(BOOT_LAT_MASK, lat, sizeof(lat));
+            UART_SendFast(lat);
+            (void)BootLat_Format(BOOT_LAT_IRQ, lat, sizeof(lat));
+            UART_SendFast(lat);
+        }
+#endif
+    } else {
+        /* Unknown command, ignore */
+    }
+}
+
+/**
+ * @brief Programs one 8-byte phrase with the Flash-resident interrupts masked
+ * 
+ * BASEPRI holds off NVIC_PRIO_FLASH and below; LPUART RX runs from SRAM
+ * and keeps receiving while the phrase is programmed (Driver_NVIC.h).
+ * 
+ * A phrase the FTFC refused (not in RUN mode, ACCERR, FPVIOL, MGSTAT0)
+ * counts in phrase_errors instead of phrases_programmed: STATS reports it as
+ * pherr and the end of the image as an error.
+ * 
+ * @param[in] addr 8-byte aligned Flash address
+ * @param[in] data Pointer to 8 bytes of data
+ */
+static inline void Flash_Program8(uint32_t addr, const uint8_t *data)
+{
+    uint32_t basepri;
+    uint8_t  ok;
+
+#if BOOT_GOVERNOR_ENABLE
+    Clock_GovernorPhase(CLOCK_PHASE_FLASH);
+#endif
+    MASK_PRIORITY(basepri, NVIC_PRIO_REG(NVIC_PRIO_FLASH));
+    ok = Program_LongWord_8B(addr, data);
+    UNMASK_PRIORITY(basepri);
+    if (ok != 0U) {
+        BOOT_STATS_INC(phrases_programmed);
+    } else {
+        BOOT_STATS_INC(phrase_errors);
+    }
+}
+
+/**
+ * @brief Stops every interrupt source before control is handed to the APP
+ * 
+ * - Masks interrupts globally (the APP startup unmasks them again)
+ * - Uninitializes the UART driver and clears the LPUART1 interrupt enables,
+ *   clock and pin mux are kept and reported in the handoff block
+ * - Stops the SysTick profiler when it is built (BOOT_PROF_ENABLE)
+ * - Stops the LPIT0 latency probe when it is built (BOOT_LAT_ENABLE)
+ * - Disables and clears every NVIC line so no bootloader ISR can fire
+ *   through the APP vector table
+ * 
+ */
+static void Quiesce_Peripherals(void)
+{
+    uint32_t i;
+
+    DISABLE_INTERRUPTS();
+
+#if BOOT_PROF_ENABLE
+    /* SysTick is not an NVIC line */
+    BootProf_Stop();
+#endif
+#if BOOT_LAT_ENABLE
+    BootLat_Stop();
+#endif
+
+    /* Stop LPUART1 interrupt generation, wait for the last byte on the line */
+    (void)UART_DRIVER.Uninitialize();
+    while ((IP_LPUART1->STAT & LPUART_STAT_TC_MASK) == 0U) {
+        /* Wait for transmission complete */
+    }
+    IP_LPUART1->CTRL &= ~(LPUART_CTRL_RIE_MASK | LPUART_CTRL_TIE_MASK |
+                          LPUART_CTRL_TCIE_MASK | LPUART_CTRL_ILIE_MASK);
+
+    /* Disable and clear pending state of all NVIC lines */
+    for (i = 0U; i < 8U; i++) {
+        NVIC->ICER[i] = 0xFFFFFFFFU;
+        NVIC->ICPR[i] = 0xFFFFFFFFU;
+    }
+
+    __DSB();
+    __ISB();
+}
+
 /**
  * @brief Validates and jumps to user application
  * 
  * This function performs the following steps:
  * 1. Validates user application by checking MSP and Reset Handler
- * 2. Updates VTOR to point to application vector table
- * 3. Sets Main Stack Pointer (MSP) and Process Stack Pointer (PSP)
- * 4. Jumps to application Reset Handler
+ * 2. Publishes the boot handoff block (clocks, bus frequencies, peripherals)
+ * 3. Quiesces peripherals and NVIC
+ * 4. Updates VTOR to point to application vector table
+ * 5. Sets Main Stack Pointer (MSP) and Process Stack Pointer (PSP)
+ * 6. Jumps to application Reset Handler
  * 
  */
 static void jump_to_app(void)
@@ -112,6 +365,7 @@ static void jump_to_app(void)
     /* Read MSP and Reset Handler from application vector table */
     uint32_t app_msp   = *(uint32_t *)APP_FLASH_START;
     uint32_t app_reset = *(uint32_t *)(APP_FLASH_START + 4U);
+    uint32_t clock_flags = 0U;
 
     /* Validate application exists (not erased Flash) */
     if ((app_msp == 0xFFFFFFFFU) || (app_reset == 0xFFFFFFFFU)) {
@@ -119,8 +373,34 @@ static void jump_to_app(void)
         return;
     }
 
+#if BOOT_GOVERNOR_ENABLE
+    /* The handoff block describes the RUN clock plan */
+    (void)Clock_SetMode(CLOCK_MODE_RUN);
+#endif
+
+    /* Tell the APP what is already configured: the clock plans of
+     * clock_and_mode.c that are fully in place, and the peripherals */
+    if (SOSC_is_8MHz()) {
+        clock_flags |= BOOT_HANDOFF_CLK_SOSC_8MHZ;
+    }
+    if (SPLL_is_160MHz()) {
+        clock_flags |= BOOT_HANDOFF_CLK_SPLL_160MHZ;
+    }
+    if (RUNmode_is_80MHz()) {
+        clock_flags |= BOOT_HANDOFF_CLK_RUN_80MHZ;
+    }
+    BootHandoff_Publish(clock_flags,
+                        BOOT_HANDOFF_PERIPH_PORTA | BOOT_HANDOFF_PERIPH_PORTC |
+                        BOOT_HANDOFF_PERIPH_PORTD | BOOT_HANDOFF_PERIPH_LED_GPIO |
+                        BOOT_HANDOFF_PERIPH_BUTTON_GPIO | BOOT_HANDOFF_PERIPH_LPUART1,
+                        UART_BAUDRATE);
+
+    Quiesce_Peripherals();
+
     /* Update Vector Table Offset Register to application base */
     S32_SCB->VTOR = APP_FLASH_START;
+    __DSB();
+    __ISB();
 
     /* Set stack pointers to application's initial MSP value */
     __set_MSP(app_msp);
@@ -197,11 +477,46 @@ static inline uint8_t Button_Pressed(void)
 void UART_EventHandler(uint32_t event)
 {
     if ((event & ARM_USART_EVENT_RECEIVE_COMPLETE) != 0U) {
-        (void)UART_BufferPush(rx_byte);
-        (void)UART_DRIVER.Receive(&rx_byte, 1U);
+        BOOT_STATS_INC(bytes_rx);
+        if (!UART_BufferPush(rx_byte)) {
+            BOOT_STATS_INC(uart_buf_drops);
+            TRACE_EVENT(BOOT_TRACE_UART_DROP, rx_byte);
+            TRACE_DROP_STOP();
+        }
+        /* HAL call: the driver access struct is a constant in Flash */
+        HAL_USART_Receive(HAL_LPUART1, &rx_byte, 1U);
     }
 }
 
+#if BOOT_RX_DIRECT_ENABLE
+/**
+ * @brief LPUART1 interrupt handler installed in the RAM vector table
+ * 
+ * Does what LPUART1_RxTx_IRQHandler() -> HAL_USART_IRQHandler() ->
+ * UART_EventHandler() do for one received byte, in one function:
+ * reads DATA (clears RDRF), pushes the byte and counts the error flags.
+ */
+void UART_RxIRQHandler(void)
+{
+    uint32_t stat;
+    uint8_t byte;
+
+    TRACE_ISR_ENTER(LPUART1_RxTx_IRQn);
+    stat = IP_LPUART1->STAT;
+    if ((stat & LPUART_STAT_RDRF_MASK) != 0U) {
+        byte = (uint8_t)IP_LPUART1->DATA;
+        BOOT_STATS_INC(bytes_rx);
+        if (!UART_BufferPush(byte)) {
+            BOOT_STATS_INC(uart_buf_drops);
+            TRACE_EVENT(BOOT_TRACE_UART_DROP, byte);
+            TRACE_DROP_STOP();
+        }
+    }
+    HAL_USART_CountErrors(HAL_LPUART1, stat);
+    TRACE_ISR_EXIT(LPUART1_RxTx_IRQn);
+}
+#endif
+
 /**
  * @brief Initializes UART1 peripheral for bootloader communication
  * 
@@ -225,14 +540,21 @@ static void UART_Init(void)
 
     /* Initialize UART driver */
     UART_DRIVER.Initialize(UART_EventHandler);
+#if BOOT_GOVERNOR_ENABLE
+    /* Mode switches stop SPLLDIV2 while the SPLL relocks */
+    HAL_USART_SetClockSource(HAL_LPUART1, HAL_USART_PCS_SOSCDIV2);
+#endif
     UART_DRIVER.Control(ARM_USART_MODE_ASYNCHRONOUS |
                         ARM_USART_DATA_BITS_8       |
                         ARM_USART_PARITY_NONE       |
                         ARM_USART_STOP_BITS_1,
-                        HAL_USART_BAUDRATE_9600);
+                        UART_BAUDRATE);
 
     /* Start receiving first byte */
     UART_DRIVER.Receive(&rx_byte, 1U);
+#if BOOT_RX_DIRECT_ENABLE
+    (void)NVIC_InstallHandler(LPUART1_RxTx_IRQn, UART_RxIRQHandler);
+#endif
 }
 
 /**
@@ -241,20 +563,25 @@ static void UART_Init(void)
  * This function performs two main tasks:
  * 
  * 1. UART Reception:
- *    - Assembles received bytes into complete SREC lines (terminated by '\n')
- *    - Pushes valid SREC lines (starting with 'S') to the queue
+ *    - Assembles received bytes into text lines (terminated by '\n') or
+ *      length-counted binary frames (starting with STX)
+ *    - Pushes record lines and frames (S-record, Intel HEX, binary) to the
+ *      queue, runs other lines as commands
  * 
- * 2. SREC Processing and Flash Programming:
- *    - Parses queued SREC records (S1/S2/S3 data records)
- *    - Implements 8-byte aligned Flash programming with 4+4 byte merging strategy:
- *      a) Exactly 4 bytes at offset 0: Store as pending
- *      b) 4 bytes at offset +4: Merge with pending and program 8 bytes
- *      c) 8 or more bytes aligned: Program directly
+ * 2. Record Processing and Flash Programming:
+ *    - Decodes queued records through boot_record.h (data and end records)
+ *    - Programs 8-byte phrases with the 4+4 byte merging strategy of
+ *      boot_phrase.h:
+ *      a) 8 or more bytes aligned: Program directly
+ *      b) Exactly 4 bytes at offset 0: Store as pending
+ *      c) 4 bytes at offset +4: Merge with pending and program 8 bytes
  *      d) Unaligned data: Pad with 0xFF and program
- *    - Flushes pending data on end-of-file records (S7/S8/S9)
+ *    - Flushes pending data on end records (S7/S8/S9, HEX 01, binary len 0)
  * 
  * @note This function should be called continuously in the main loop
- * @note Flash programming is performed with interrupts disabled
+ * @note Flash commands run with BASEPRI at NVIC_PRIO_FLASH: the LPUART RX
+ *       interrupt stays above it and keeps filling the ring from SRAM
+ *       (Driver_NVIC.h), lower priorities wait for the command
  * @note Addresses must be within APP_FLASH_START to APP_FLASH_END range
  * 
  * @warning Flash must be erased before programming
@@ -263,34 +590,74 @@ static void UART_Init(void)
 static void Bootloader_Mode(void)
 {
     uint8_t c;
-    char srec_line[MAX_LINE_LENGTH];
-
-    /* State for 4+4 byte merge strategy (static to persist across calls) */
-    static uint8_t  pending_valid = 0U;      /* Flag: pending low 4 bytes available */
-    static uint32_t pending_base  = 0U;      /* Aligned base address of pending data */
-    static uint8_t  pending_low4[FLASH_HALF_SIZE]; /* Pending low 4 bytes buffer */
+    uint8_t frame[MAX_LINE_LENGTH];
+    uint16_t frame_len;
 
     /* Working variables for parsing and Flash operations */
-    srec_record_t rec;
-    uint32_t addr;
-    uint32_t len;
-    uint8_t *p;
-    uint32_t base;
-    uint32_t off;
-    uint32_t n;
-    uint8_t  buf8[FLASH_ALIGN_SIZE];
+    boot_record_t rec;
+    static uint32_t line_t0 = 0U;            /* CYCCNT at previous completed line */
 
     /* ==================== UART Byte Reception -> Line Assembly ==================== */
     if (UART_BufferPop(&c)) {
-        if (c == '\n') {
+#if BOOT_MULTIDROP
+        if (c >= HAL_USART_NODE_MIN) {
+            /* Address frame: only own and broadcast pass the LPUART match.
+             * Earlier lines are already processed (queue drained per byte). */
+            tx_enabled = (c == BOOT_NODE_ADDRESS) ? 1U : 0U;
+            line_pos = 0U;
+        } else
+#endif
+        if (frame_need != 0U) {
+            /* Binary frame: length-counted, '\n' is data */
+            line_buf[line_pos++] = (char)c;
+            frame_need--;
+            if (line_pos == 2U) {
+                /* Length byte: address, data and checksum follow */
+                frame_need = (uint16_t)(c + BOOT_RECORD_BIN_OVERHEAD - 2U);
+                if ((line_pos + frame_need) > (sizeof(line_buf) - 1U)) {
+                    frame_need = 0U;
+                    line_pos = 0U;
+                    BOOT_STATS_INC(line_overflows);
+                }
+            } else if (frame_need == 0U) {
+                BOOT_STATS_INC(lines_rx);
+                TRACE_EVENT(BOOT_TRACE_LINE_RX, line_pos);
+                if (!SREC_QueuePushFrame((const uint8_t *)line_buf, line_pos)) {
+                    BOOT_STATS_INC(srec_queue_drops);
+                    TRACE_EVENT(BOOT_TRACE_QUEUE_FULL, line_pos);
+                }
+                if (line_t0 != 0U) {
+                    PERF_END(PERF_PH_LINE_RX, line_t0);
+                }
+                line_t0 = DWT_PERF_NOW();
+                line_pos = 0U;
+            } else {
+                /* More frame bytes to come */
+            }
+        } else if ((BOOT_MULTIDROP == 0) && (line_pos == 0U) && (c == BOOT_RECORD_BIN_SOF)) {
+            /* Start of a binary frame (8-bit data: not on a multi-drop bus) */
+            line_buf[line_pos++] = (char)c;
+            frame_need = 1U;
+        } else if (c == '\n') {
             /* End of line detected */
             if (line_pos > 0U) {
                 line_buf[line_pos] = '\0';
-
-                /* Only queue valid SREC lines (starting with 'S') */
-                if (line_buf[0] == 'S') {
-                    (void)SREC_QueuePush(line_buf);
+                BOOT_STATS_INC(lines_rx);
+                TRACE_EVENT(BOOT_TRACE_LINE_RX, line_pos);
+
+                /* Only queue record lines ('S' + type digit, ':'), the rest are commands */
+                if (BootRecord_Format((const uint8_t *)line_buf, line_pos) != BOOT_FMT_NONE) {
+                    if (!SREC_QueuePush(line_buf)) {
+                        BOOT_STATS_INC(srec_queue_drops);
+                        TRACE_EVENT(BOOT_TRACE_QUEUE_FULL, line_pos);
+                    }
+                    if (line_t0 != 0U) {
+                        PERF_END(PERF_PH_LINE_RX, line_t0);
+                    }
+                } else {
+                    Handle_Command(line_buf);
                 }
+                line_t0 = DWT_PERF_NOW();
 
                 line_pos = 0U;
             }
@@ -301,101 +668,62 @@ static void Bootloader_Mode(void)
             } else {
                 /* Buffer overflow, reset */
                 line_pos = 0U;
+                BOOT_STATS_INC(line_overflows);
             }
         }
     }
 
-    /* ==================== SREC Processing -> Parse -> Flash Programming ==================== */
-    while (SREC_QueuePop(srec_line)) {
-        if ((parse_srec_line(srec_line, &rec) == 0) && (rec.valid != 0)) {
+    /* ==================== Record Processing -> Decode -> Flash Programming ==================== */
+    while (SREC_QueuePopFrame(frame, &frame_len)) {
+        PERF_BEGIN(rec_t0);
+        TRACE_EVENT(BOOT_TRACE_PARSE_BEGIN, frame_len);
+#if BOOT_GOVERNOR_ENABLE
+        Clock_GovernorPhase(CLOCK_PHASE_DECODE);
+#endif
+        if (BootRecord_Decode(frame, frame_len, &rec) != 0) {
+            TRACE_EVENT(BOOT_TRACE_PARSE_END, 0U);
+            BOOT_STATS_INC(parse_errors);
+        } else if (rec.valid == 0) {
+            TRACE_EVENT(BOOT_TRACE_PARSE_END, 0U);
+            BOOT_STATS_INC(checksum_errors);
+        } else {
+            TRACE_EVENT(BOOT_TRACE_PARSE_END, rec.len);
             
-            /* ---------- Process Data Records (S1/S2/S3) ---------- */
-            if ((rec.type == 1) || (rec.type == 2) || (rec.type == 3)) {
+            /* ---------- Process Data Records (S1/S2/S3, HEX 00, binary) ---------- */
+            if (rec.type == BOOT_REC_DATA) {
                 
                 /* Verify address is within application Flash range */
                 if ((rec.address >= APP_FLASH_START) && (rec.address <= APP_FLASH_END)) {
-                    addr = rec.address;
-                    len  = rec.data_len;
-                    p    = rec.data;
-
-                    /* Process all bytes in this record */
-                    while (len > 0U) {
-                        
-                        /* Case 1: Exactly 4 bytes at 8-byte aligned offset 0 -> Store as pending */
-                        if (((addr & 0x7U) == 0U) && (len == 4U)) {
-                            memcpy(pending_low4, p, FLASH_HALF_SIZE);
-                            pending_base  = addr;
-                            pending_valid = 1U;
-
-                            addr += FLASH_HALF_SIZE;
-                            p    += FLASH_HALF_SIZE;
-                            len  -= FLASH_HALF_SIZE;
-                        }
-                        
-                        /* Case 2: At least 4 bytes at offset +4 -> Merge with pending and program */
-                        else if (((addr & 0x7U) == 4U) && (len >= FLASH_HALF_SIZE)) {
-                            base = addr - FLASH_HALF_SIZE;  /* Get aligned base address */
-                            memset(buf8, 0xFF, FLASH_ALIGN_SIZE);
-
-                            /* If we have matching pending data, use it */
-                            if ((pending_valid != 0U) && (pending_base == base)) {
-                                memcpy(buf8, pending_low4, FLASH_HALF_SIZE);
-                            }
-
-                            /* Copy high 4 bytes */
-                            memcpy(&buf8[FLASH_HALF_SIZE], p, FLASH_HALF_SIZE);
-
-                            /* Program 8 bytes with interrupts disabled */
-                            DISABLE_INTERRUPTS();
-                            (void)Program_LongWord_8B(base, buf8);
-                            ENABLE_INTERRUPTS();
-
-                            pending_valid = 0U;
-
-                            addr += FLASH_HALF_SIZE;
-                            p    += FLASH_HALF_SIZE;
-                            len  -= FLASH_HALF_SIZE;
-                        }
-                        
-                        /* Case 3: At least 8 bytes at aligned offset -> Program directly */
-                        else if (((addr & 0x7U) == 0U) && (len >= FLASH_ALIGN_SIZE)) {
-                            DISABLE_INTERRUPTS();
-                            (void)Program_LongWord_8B(addr, p);
-                            ENABLE_INTERRUPTS();
-
-                            addr += FLASH_ALIGN_SIZE;
-                            p    += FLASH_ALIGN_SIZE;
-                            len  -= FLASH_ALIGN_SIZE;
-                        }else{
-                        	/* do nothing */
-                        }
-                    }
+                    /* Cut into 8-byte phrases, 4+4 merge (boot_phrase.h) */
+                    BootPhrase_Write(rec.address, rec.data, rec.len);
+                    PERF_END(PERF_PH_RECORD, rec_t0);
+                    BootRxMap_Mark(rec.address, rec.len);
+                    BOOT_STATS_INC(records_programmed);
+                    PERF_MARK(PERF_MARK_FIRST_RECORD);
                 }
             }
 
-            /* ---------- Process End-of-File Records (S7/S8/S9) ---------- */
-            if ((rec.type == 7) || (rec.type == 8) || (rec.type == 9)) {
+            /* ---------- Process End Records (S7/S8/S9, HEX 01, binary len 0) ---------- */
+            if (rec.type == BOOT_REC_END) {
                 
                 /* Flush any pending 4-byte data */
-                if (pending_valid != 0U) {
-                    memset(buf8, 0xFF, FLASH_ALIGN_SIZE);
-                    memcpy(buf8, pending_low4, FLASH_HALF_SIZE);
-
-                    DISABLE_INTERRUPTS();
-                    (void)Program_LongWord_8B(pending_base, buf8);
-                    ENABLE_INTERRUPTS();
+                BootPhrase_Flush();
 
-                    pending_valid = 0U;
-                }
+                PERF_MARK(PERF_MARK_EOF_RECORD);
 
                 /* Notify completion */
+                if (boot_stats.phrase_errors != 0U) {
+                    UART_SendFast("\r\n[FLASH] ERROR: phrases not programmed, see STATS pherr\r\n");
+                }
                 UART_SendFast("\r\n[INFO] Flash programming completed.\r\n");
                 UART_SendFast("[INFO] Please RESET the board WITHOUT pressing the BOOT button.\r\n");
                 UART_SendFast("[INFO] The new application will run after reset.\r\n");
 
                 /* Reset state for next programming session */
                 SREC_QueueInit();
+                BootRecord_Reset();
                 line_pos = 0U;
+                frame_need = 0U;
             }
         }
     }
@@ -407,9 +735,9 @@ static void Bootloader_Mode(void)
  * Execution flow:
  * 1. Initialize system clocks (SOSC 8MHz, SPLL 160MHz, core 80MHz)
  * 2. Initialize UART and GPIO peripherals
- * 3. Check boot button state:
- *    - If NOT pressed: Jump to user application
- *    - If pressed: Enter bootloader mode
+ * 3. Check boot button state and the application's request (boot_api.h):
+ *    - If neither: Jump to user application
+ *    - If pressed or requested: Enter bootloader mode
  * 4. In bootloader mode:
  *    - Turn on BLUE LED indicator
  *    - Load Flash access code
@@ -422,32 +750,76 @@ static void Bootloader_Mode(void)
  */
 int main(void)
 {
+    /* EnterBootloader of the service table, left before the reset */
+    bool requested = BootApi_TakeRequest();
+
+    /* Start the cycle counter first so clock lock time is visible */
+    DWT_Perf_Init();
+    PERF_MARK(PERF_MARK_MAIN_ENTRY);
+#if DWT_PERF_ENABLE
+    DWT_Perf_AddCycles(PERF_PH_STARTUP, startup_init_cycles);
+#endif
+#if BOOT_TRACE_ENABLE
+    BootTrace_Init();
+#endif
+#if BOOT_CACHE_ENABLE
+    /* Code cache on before the clock setup, which runs from Flash too */
+    BootCache_Init();
+#endif
+
     /* Initialize system clocks */
     SOSC_init_8MHz();
     SPLL_init_160MHz();
     NormalRUNmode_80MHz();
+    PERF_MARK(PERF_MARK_CLOCK_DONE);
+#if BOOT_PROF_ENABLE
+    BootProf_Start(0U, (uint32_t)__etext, BOOT_PROF_RATE_HZ, ClockTree_GetHz(CLOCK_TREE_CORE));
+#endif
+#if BOOT_LAT_ENABLE
+    BootLat_Init();
+#endif
 
     /* Initialize peripherals */
     UART_Init();
+#if BOOT_MULTIDROP
+    HAL_USART_ConfigMultidrop(HAL_LPUART1, BOOT_NODE_ADDRESS, HAL_USART_BROADCAST);
+#endif
     Board_Init();
+    PERF_MARK(PERF_MARK_PERIPH_DONE);
 
     UART_SendFast("BOOT READY\n");
 
     /* Check boot mode selection */
-    if (Button_Pressed() == 0U) {
+    if ((Button_Pressed() == 0U) && !requested) {
         /* Button not pressed -> Jump to application */
         UART_SendFast("Button not pressed\n");
         jump_to_app();
     } else {
-        /* Button pressed -> Enter bootloader mode */
+        uint32_t basepri;
+        uint8_t  erased;
+
+        /* Button pressed or application request -> Enter bootloader mode */
         Driver_GPIO0.SetOutput(GPIO_PIN_LED_BLUE, 1);
         UART_SendFast("[BOOT] Please send USER APP SREC file...\r\n");
 
         /* Load Flash access code and erase application region */
         Mem_43_INFLS_IPW_LoadAc();
-        DISABLE_INTERRUPTS();
-        Erase_Multi_Sector(APP_FLASH_START, APP_SECTOR_COUNT);
-        ENABLE_INTERRUPTS();
+#if BOOT_FLEXRAM_ENABLE
+        /* FlexRAM as RAM for staging buffers, unless EEE uses it */
+        if (BootFlexRam_Init()) {
+            UART_SendFast("[FLEXRAM] 4 KB RAM\r\n");
+        }
+#endif
+        MASK_PRIORITY(basepri, NVIC_PRIO_REG(NVIC_PRIO_FLASH));
+        erased = Erase_Multi_Sector(APP_FLASH_START, APP_SECTOR_COUNT);
+        UNMASK_PRIORITY(basepri);
+        if (erased == 0U) {
+            UART_SendFast("[FLASH] ERROR: erase failed\r\n");
+        }
+        BootRxMap_Init(APP_FLASH_START, APP_FLASH_LENGTH);
+        BootPhrase_Init(Flash_Program8);
+        BOOT_STATS_ADD(sectors_erased, APP_SECTOR_COUNT);
+        PERF_MARK(PERF_MARK_ERASE_DONE);
 
         UART_SendFast("[FLASH] Ready\r\n");
     }
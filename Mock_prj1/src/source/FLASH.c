@@ -3,6 +3,11 @@
  ******************************************************************************/
 #include "S32K144.h"
 #include "FLASH.h"
+#include "Driver_NVIC.h"
+#include "dwt_perf.h"
+#include "boot_trace.h"
+#include "boot_cache.h"
+#include "clock_and_mode.h"
 extern const uint32_t Mem_43_INFLS_ACWriteRomStart;
 extern const uint32_t Mem_43_INFLS_ACWriteSize;
 typedef void (*Mem_43_INFLS_AcWritePtrType)  (void);
@@ -46,9 +51,51 @@ void Mem_43_INFLS_IPW_LoadAc(void)
         /* Copy 4 bytes at a time*/
         RamPtr[Count] = RomPtr[Count];
     }
+
+    /* The command complete handler runs from Flash: keep it below the
+     * BASEPRI level of a Flash command (Driver_NVIC.h) */
+    NVIC_SetPriority(FTFC_CMD_IRQn, NVIC_PRIO_FTFC);
 }
 /* Program Address and Data (8bit pointer) into Flash Memory */
-uint8_t Program_LongWord_8B(uint32_t Addr,uint8_t *Data)
+uint8_t Program_LongWord_8B(uint32_t Addr,const uint8_t *Data)
+{
+    /* The FTFC refuses program and erase in HSRUN and VLPR */
+    if (Clock_GetMode() != CLOCK_MODE_RUN)
+    {
+        return 0;
+    }
+
+    uint8_t ok;
+
+    PERF_BEGIN(perf_t0);
+    TRACE_EVENT(BOOT_TRACE_PROGRAM_BEGIN, Addr);
+    ok = Ftfc_ProgramPhrase(Addr, Data);
+    PERF_END(PERF_PH_PROGRAM, perf_t0);
+    TRACE_EVENT(BOOT_TRACE_PROGRAM_END, Addr);
+    return ok;
+}
+
+/* Erase a flash Sector */
+uint8_t  Erase_Sector(uint32_t Addr)
+{
+    /* The FTFC refuses program and erase in HSRUN and VLPR */
+    if (Clock_GetMode() != CLOCK_MODE_RUN)
+    {
+        return 0;
+    }
+
+    uint8_t ok;
+
+    PERF_BEGIN(perf_t0);
+    TRACE_EVENT(BOOT_TRACE_ERASE_BEGIN, Addr);
+    ok = Ftfc_EraseSector(Addr);
+    PERF_END(PERF_PH_ERASE, perf_t0);
+    TRACE_EVENT(BOOT_TRACE_ERASE_END, Addr);
+    return ok;
+}
+
+/* Program one phrase: FTFC registers only, no RAM of the bootloader */
+uint8_t Ftfc_ProgramPhrase(uint32_t Addr,const uint8_t *Data)
 {
     /* wait previous cmd finish */
     while (IP_FTFC->FSTAT == 0x00);
@@ -80,12 +127,17 @@ uint8_t Program_LongWord_8B(uint32_t Addr,uint8_t *Data)
 
     /* wait until operation finishes or write/erase timeout is reached */
     MEM_43_INFLS_AC_CALL(WRITE_FUNCTION_ADDRESS, Mem_43_INFLS_AcWritePtrType)();
+#if BOOT_CACHE_ENABLE
+    /* Drop the cached copy of the old phrase */
+    BootCache_InvalidateRange(Addr, FTFC_WRITE_DOUBLE_WORD);
+#endif
 
-    return 1;
+    return ((IP_FTFC->FSTAT & (FTFC_FSTAT_ACCERR_MASK | FTFC_FSTAT_FPVIOL_MASK |
+                               FTFC_FSTAT_MGSTAT0_MASK)) == 0U) ? 1U : 0U;
 }
 
-/* Erase a flash Sector */
-uint8_t  Erase_Sector(uint32_t Addr)
+/* Erase one sector: FTFC registers only, no RAM of the bootloader */
+uint8_t Ftfc_EraseSector(uint32_t Addr)
 {
     /* wait previous cmd finish */
     while (IP_FTFC->FSTAT == 0x00);
@@ -105,20 +157,101 @@ uint8_t  Erase_Sector(uint32_t Addr)
 
     /* wait until operation finishes or write/erase timeout is reached */
     MEM_43_INFLS_AC_CALL(WRITE_FUNCTION_ADDRESS, Mem_43_INFLS_AcWritePtrType)();
-    return 1;
+#if BOOT_CACHE_ENABLE
+    BootCache_InvalidateRange(Addr, FTFC_P_FLASH_SECTOR_SIZE);
+#endif
+
+    return ((IP_FTFC->FSTAT & (FTFC_FSTAT_ACCERR_MASK | FTFC_FSTAT_FPVIOL_MASK |
+                               FTFC_FSTAT_MGSTAT0_MASK)) == 0U) ? 1U : 0U;
 }
 
 /* Erase all flash sector */
 uint8_t  Erase_Multi_Sector(uint32_t Addr,uint8_t Size)
 {
     uint8_t i;
+    uint8_t ok = 1;
     for(i = 0; i < Size; i++)
     {
-        Erase_Sector(Addr + i*FTFC_P_FLASH_SECTOR_SIZE);
+        ok &= Erase_Sector(Addr + i*FTFC_P_FLASH_SECTOR_SIZE);
+    }
+    return ok;
+}
+/* Program phrases from FlexRAM into Flash Memory */
+uint8_t Program_Section(uint32_t Addr,uint16_t Phrases)
+{
+    /* The FTFC refuses program and erase in HSRUN and VLPR */
+    if (Clock_GetMode() != CLOCK_MODE_RUN)
+    {
+        return 0;
+    }
+    /* The data buffer is FlexRAM: it must be traditional RAM */
+    if ((IP_FTFC->FCNFG & FTFC_FCNFG_RAMRDY_MASK) == 0U)
+    {
+        return 0;
+    }
+
+    PERF_BEGIN(perf_t0);
+    TRACE_EVENT(BOOT_TRACE_PROGRAM_BEGIN, Addr);
+
+    /* wait previous cmd finish */
+    while (IP_FTFC->FSTAT == 0x00);
+
+    /* clear previous cmd error */
+    if(IP_FTFC->FSTAT != 0x80)
+    {
+        IP_FTFC->FSTAT = 0x30;
+    }
+    IP_FTFC->FCCOB[3] = CMD_PROGRAM_SECTION;
+
+    /* fill Address */
+    IP_FTFC->FCCOB[2] = (uint8_t)(Addr >> 16);
+    IP_FTFC->FCCOB[1] = (uint8_t)(Addr >> 8);
+    IP_FTFC->FCCOB[0] = (uint8_t)(Addr >> 0);
+
+    /* fill number of phrases */
+    IP_FTFC->FCCOB[7] = (uint8_t)(Phrases >> 8);
+    IP_FTFC->FCCOB[6] = (uint8_t)(Phrases >> 0);
+
+    /* wait until operation finishes or write/erase timeout is reached */
+    MEM_43_INFLS_AC_CALL(WRITE_FUNCTION_ADDRESS, Mem_43_INFLS_AcWritePtrType)();
+#if BOOT_CACHE_ENABLE
+    BootCache_InvalidateRange(Addr, (uint32_t)Phrases * FTFC_WRITE_DOUBLE_WORD);
+#endif
+
+    PERF_END(PERF_PH_PROGRAM, perf_t0);
+    TRACE_EVENT(BOOT_TRACE_PROGRAM_END, Addr);
+    return ((IP_FTFC->FSTAT & (FTFC_FSTAT_ACCERR_MASK | FTFC_FSTAT_FPVIOL_MASK |
+                               FTFC_FSTAT_MGSTAT0_MASK)) == 0U) ? 1U : 0U;
+}
+
+/* Select the FlexRAM function */
+uint8_t Set_FlexRAM_Function(uint8_t Control)
+{
+    if (Clock_GetMode() != CLOCK_MODE_RUN)
+    {
+        return 0;
+    }
+
+    /* wait previous cmd finish */
+    while (IP_FTFC->FSTAT == 0x00);
+
+    /* clear previous cmd error */
+    if(IP_FTFC->FSTAT != 0x80)
+    {
+        IP_FTFC->FSTAT = 0x30;
     }
-    return 1;
+    IP_FTFC->FCCOB[3] = CMD_SET_FLEXRAM_FUNCTION;
+    IP_FTFC->FCCOB[2] = Control;
+
+    /* FlexRAM is not accessible while the command runs */
+    MEM_43_INFLS_AC_CALL(WRITE_FUNCTION_ADDRESS, Mem_43_INFLS_AcWritePtrType)();
+
+    return ((IP_FTFC->FSTAT & (FTFC_FSTAT_ACCERR_MASK | FTFC_FSTAT_FPVIOL_MASK |
+                               FTFC_FSTAT_MGSTAT0_MASK)) == 0U) ? 1U : 0U;
 }
+
 void FTFC_IRQHandler(void)
 {
-	/* */
+    TRACE_ISR_ENTER(FTFC_CMD_IRQn);
+    TRACE_ISR_EXIT(FTFC_CMD_IRQn);
 }
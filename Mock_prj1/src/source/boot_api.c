@@ -0,0 +1,152 @@
+/**
+ * @file    boot_api.c
+ * @brief   Bootloader services for applications, a table at a fixed address.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "boot_api.h"
+#include "FLASH.h"
+#include "S32K144.h"
+#include "S32K144_features.h"
+#include "cmsis_gcc.h"
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define BOOT_API_REQUEST_MAGIC  (0x42524551U)  /* "BREQ" */
+#define SMC_PMSTAT_RUN          (0x01U)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+/* Written by the application through EnterBootloader, kept over the reset
+ * (BOOT_API_REQUEST_ADDRESS, the linker files assert it). The complement
+ * tells a request from what a power-on left in the RAM. */
+static volatile uint32_t boot_api_request[BOOT_API_REQUEST_SIZE / 4U] __attribute__((section(".boot_request")));
+
+/* CRC-32 one nibble at a time: 64 bytes of Flash instead of 1 KB */
+static const uint32_t crc32_nibble[16] = {
+    0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+    0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+    0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+    0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU,
+};
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Everything below runs in the application's context: no .data or .bss of
+ * the bootloader (Clock_GetMode(), PERF and TRACE use them), the power mode
+ * comes from the SMC and the lock is PRIMASK.
+ */
+
+static bool api_flash_ready(uint32_t addr, uint32_t size)
+{
+    return ((IP_SMC->PMSTAT & SMC_PMSTAT_PMSTAT_MASK) == SMC_PMSTAT_RUN) &&
+           (addr >= BOOT_API_APP_START) && (addr < BOOT_API_APP_END) &&
+           (size <= (BOOT_API_APP_END - addr));
+}
+
+static bool api_erase_sector(uint32_t addr)
+{
+    uint32_t primask;
+    uint8_t  ok;
+
+    if (((addr % FTFC_P_FLASH_SECTOR_SIZE) != 0U) ||
+        !api_flash_ready(addr, FTFC_P_FLASH_SECTOR_SIZE)) {
+        return false;
+    }
+    primask = __get_PRIMASK();
+    __disable_irq();
+    ok = Ftfc_EraseSector(addr);
+    if (primask == 0U) {
+        __enable_irq();
+    }
+    return (ok != 0U);
+}
+
+static bool api_program(uint32_t addr, const uint8_t *data, uint32_t size)
+{
+    uint32_t primask;
+    uint32_t off;
+    uint8_t  ok = 1U;
+
+    if ((data == NULL) || (size == 0U) ||
+        ((addr % FTFC_WRITE_DOUBLE_WORD) != 0U) ||
+        ((size % FTFC_WRITE_DOUBLE_WORD) != 0U) ||
+        !api_flash_ready(addr, size)) {
+        return false;
+    }
+    /* One phrase per lock: interrupts wait for one command at most */
+    for (off = 0U; (off < size) && (ok != 0U); off += FTFC_WRITE_DOUBLE_WORD) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        ok = Ftfc_ProgramPhrase(addr + off, &data[off]);
+        if (primask == 0U) {
+            __enable_irq();
+        }
+    }
+    return (ok != 0U);
+}
+
+static uint32_t api_crc32(uint32_t crc, const void *data, uint32_t size)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    crc = ~crc;
+    while (size-- > 0U) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ crc32_nibble[crc & 0x0FU];
+        crc = (crc >> 4) ^ crc32_nibble[crc & 0x0FU];
+    }
+    return ~crc;
+}
+
+static void api_enter_bootloader(void)
+{
+    __disable_irq();
+    boot_api_request[0] = BOOT_API_REQUEST_MAGIC;
+    boot_api_request[1] = ~BOOT_API_REQUEST_MAGIC;
+    __DSB();
+    S32_SCB->AIRCR = S32_SCB_AIRCR_VECTKEY(FEATURE_SCB_VECTKEY) | S32_SCB_AIRCR_SYSRESETREQ(1U);
+    __DSB();
+    for (;;) {
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                Service Table                                */
+/* -------------------------------------------------------------------------- */
+
+const boot_api_t boot_api __attribute__((section(".boot_api"), used)) = {
+    .magic           = BOOT_API_MAGIC,
+    .version         = BOOT_API_VERSION,
+    .size            = (uint16_t)sizeof(boot_api_t),
+    .LoadAccessCode  = Mem_43_INFLS_IPW_LoadAc,
+    .EraseSector     = api_erase_sector,
+    .Program         = api_program,
+    .Crc32           = api_crc32,
+    .EnterBootloader = api_enter_bootloader,
+};
+
+/* -------------------------------------------------------------------------- */
+/*                                 Public API                                  */
+/* -------------------------------------------------------------------------- */
+
+bool BootApi_TakeRequest(void)
+{
+    bool requested = (boot_api_request[0] == BOOT_API_REQUEST_MAGIC) &&
+                     (boot_api_request[1] == ~BOOT_API_REQUEST_MAGIC);
+
+    boot_api_request[0] = 0U;
+    boot_api_request[1] = 0U;
+    return requested;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file    boot_cache.c
+ * @brief   LMEM processor code cache and P-Flash speculation control.
+ *
+ * Cache commands: a way command sets the INVWn/PUSHWn bits together with GO
+ * in PCCCR; a line command selects the operation in PCCLCR (LADSEL: the
+ * address is physical) and starts it by writing the address with LGO to
+ * PCCSAR. Both complete when the GO bit reads 0 again. The commands are
+ * issued from the main loop only.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "boot_cache.h"
+
+#if (BOOT_CACHE_ENABLE)
+
+#include "S32K144.h"
+#include "cmsis_gcc.h"
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define CACHE_LCMD_INVALIDATE   (1U)
+#define CACHE_LCMD_CLEAR_INV    (3U)        /* Push the line, then invalidate */
+
+#define CACHE_INVW_ALL          (LMEM_PCCCR_INVW0_MASK | LMEM_PCCCR_INVW1_MASK)
+#define CACHE_PUSHW_ALL         (LMEM_PCCCR_PUSHW0_MASK | LMEM_PCCCR_PUSHW1_MASK)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Run a way command and wait for it.
+ */
+static void cache_way_command(uint32_t bits)
+{
+    IP_LMEM->PCCCR = (IP_LMEM->PCCCR & ~(CACHE_PUSHW_ALL | CACHE_INVW_ALL)) |
+                     bits | LMEM_PCCCR_GO_MASK;
+    while ((IP_LMEM->PCCCR & LMEM_PCCCR_GO_MASK) != 0U) {
+        /* Wait for command complete */
+    }
+}
+
+/**
+ * @brief Run a line command on every line of [addr, addr + size).
+ */
+static void cache_line_command(uint32_t cmd, uint32_t addr, uint32_t size)
+{
+    uint32_t line;
+    uint32_t end;
+
+    if (size == 0U) {
+        return;
+    }
+    if (size >= BOOT_CACHE_SIZE) {
+        cache_way_command((cmd == CACHE_LCMD_CLEAR_INV) ?
+                          (CACHE_PUSHW_ALL | CACHE_INVW_ALL) : CACHE_INVW_ALL);
+        return;
+    }
+
+    line = addr & ~(BOOT_CACHE_LINE - 1U);
+    end  = addr + size;
+    IP_LMEM->PCCLCR = LMEM_PCCLCR_LADSEL_MASK | LMEM_PCCLCR_LCMD(cmd);
+    for (; line < end; line += BOOT_CACHE_LINE) {
+        IP_LMEM->PCCSAR = (line & LMEM_PCCSAR_PHYADDR_MASK) | LMEM_PCCSAR_LGO_MASK;
+        while ((IP_LMEM->PCCSAR & LMEM_PCCSAR_LGO_MASK) != 0U) {
+            /* Wait for command complete */
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                 Public API                                  */
+/* -------------------------------------------------------------------------- */
+
+void BootCache_Init(void)
+{
+    uint32_t ocmdr = IP_MSCM->OCMDR[0];
+
+    /* OCMDR is locked once RO is set */
+    if ((ocmdr & MSCM_OCMDR_RO_MASK) == 0U) {
+        IP_MSCM->OCMDR[0] = (ocmdr & ~MSCM_OCMDR_OCM1_MASK) |
+                            MSCM_OCMDR_OCM1(BOOT_CACHE_FLASH_OCM1);
+    }
+
+    cache_way_command(CACHE_INVW_ALL);
+    IP_LMEM->PCCCR |= LMEM_PCCCR_ENCACHE_MASK;
+    __ISB();
+}
+
+void BootCache_Disable(void)
+{
+    IP_LMEM->PCCCR &= ~LMEM_PCCCR_ENCACHE_MASK;
+    cache_way_command(CACHE_INVW_ALL);
+    __ISB();
+}
+
+uint32_t BootCache_Enabled(void)
+{
+    return IP_LMEM->PCCCR & LMEM_PCCCR_ENCACHE_MASK;
+}
+
+void BootCache_InvalidateAll(void)
+{
+    cache_way_command(CACHE_INVW_ALL);
+    __ISB();
+}
+
+void BootCache_InvalidateRange(uint32_t addr, uint32_t size)
+{
+    cache_line_command(CACHE_LCMD_INVALIDATE, addr, size);
+    __ISB();
+}
+
+void BootCache_CleanInvalidateRange(uint32_t addr, uint32_t size)
+{
+    cache_line_command(CACHE_LCMD_CLEAR_INV, addr, size);
+    __ISB();
+}
+
+#endif /* BOOT_CACHE_ENABLE */
@@ -0,0 +1,95 @@
+/**
+ * @file    boot_flexram.c
+ * @brief   FlexRAM as extra RAM and as the FTFC Program Section buffer.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "boot_flexram.h"
+
+#if (BOOT_FLEXRAM_ENABLE)
+
+#include "S32K144.h"
+#include "FLASH.h"
+#include "Driver_NVIC.h"
+#include "s32_core_cm4.h"
+#include <stddef.h>
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static bool flexram_ready;
+
+/* -------------------------------------------------------------------------- */
+/*                                 Public API                                  */
+/* -------------------------------------------------------------------------- */
+
+bool BootFlexRam_Init(void)
+{
+    volatile uint32_t *word = (volatile uint32_t *)BOOT_FLEXRAM_BASE;
+    uint32_t basepri;
+    uint8_t  ok;
+    uint32_t i;
+
+    flexram_ready = false;
+    if ((IP_FTFC->FCNFG & FTFC_FCNFG_EEERDY_MASK) != 0U) {
+        return false;       /* EEPROM emulation owns it */
+    }
+    if ((IP_FTFC->FCNFG & FTFC_FCNFG_RAMRDY_MASK) == 0U) {
+        MASK_PRIORITY(basepri, NVIC_PRIO_REG(NVIC_PRIO_FLASH));
+        ok = Set_FlexRAM_Function(FTFC_FLEXRAM_AS_RAM);
+        UNMASK_PRIORITY(basepri);
+        if ((ok == 0U) || ((IP_FTFC->FCNFG & FTFC_FCNFG_RAMRDY_MASK) == 0U)) {
+            return false;
+        }
+    }
+
+    /* One word store each: valid ECC before any byte store or read */
+    for (i = 0U; i < (BOOT_FLEXRAM_SIZE / 4U); i++) {
+        word[i] = 0U;
+    }
+    flexram_ready = true;
+    return true;
+}
+
+bool BootFlexRam_Ready(void)
+{
+    return flexram_ready;
+}
+
+uint8_t *BootFlexRam_Stage(void)
+{
+    return flexram_ready ? (uint8_t *)BOOT_FLEXRAM_BASE : NULL;
+}
+
+bool BootFlexRam_ProgramSection(uint32_t addr, const uint8_t *data, uint32_t size)
+{
+    uint8_t *stage = (uint8_t *)BOOT_FLEXRAM_BASE;
+    uint32_t basepri;
+    uint8_t  ok;
+    uint32_t i;
+
+    if (!flexram_ready || (data == NULL) || (size == 0U) ||
+        (size > BOOT_FLEXRAM_STAGE_SIZE) ||
+        ((size % FTFC_WRITE_DOUBLE_WORD) != 0U) ||
+        ((addr % FTFC_WRITE_DOUBLE_WORD) != 0U) ||
+        (((addr % FTFC_P_FLASH_SECTOR_SIZE) + size) > FTFC_P_FLASH_SECTOR_SIZE)) {
+        return false;
+    }
+    if (data != stage) {
+        for (i = 0U; i < size; i++) {
+            stage[i] = data[i];
+        }
+    }
+
+    MASK_PRIORITY(basepri, NVIC_PRIO_REG(NVIC_PRIO_FLASH));
+    ok = Program_Section(addr, (uint16_t)(size / FTFC_WRITE_DOUBLE_WORD));
+    UNMASK_PRIORITY(basepri);
+    return (ok != 0U);
+}
+
+#endif /* BOOT_FLEXRAM_ENABLE */
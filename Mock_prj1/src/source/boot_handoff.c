@@ -0,0 +1,93 @@
+/**
+ * @file    boot_handoff.c
+ * @brief   Bootloader -> application handoff block for S32K144.
+ *
+ * The block is placed in the .boot_handoff section (m_noinit region) by the
+ * linker files of the bootloader and of the applications. The bootloader
+ * writes it right before jump_to_app(); the application reads it before its
+ * own clock/peripheral initialization. LED_APP links this file and
+ * clock_tree.c from here (.project), so it depends on nothing else of the
+ * bootloader.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "S32K144.h"
+#include "boot_handoff.h"
+#include "clock_tree.h"
+#include <stddef.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+/** @brief Number of words covered by the check word. */
+#define HANDOFF_CHECK_WORDS ((offsetof(boot_handoff_t, check)) / sizeof(uint32_t))
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+/** @brief The handoff block itself (not initialized by startup code). */
+static volatile boot_handoff_t boot_handoff __attribute__((section(".boot_handoff")));
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Compute the check word over all words before 'check'.
+ */
+static uint32_t handoff_checksum(const volatile boot_handoff_t *h)
+{
+    const volatile uint32_t *w = (const volatile uint32_t *)h;
+    uint32_t sum = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < HANDOFF_CHECK_WORDS; i++) {
+        sum += w[i];
+    }
+    return ~sum;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                 Public API                                  */
+/* -------------------------------------------------------------------------- */
+
+void BootHandoff_Publish(uint32_t clock_flags, uint32_t periph_flags,
+                         uint32_t lpuart1_baud)
+{
+    boot_handoff.magic        = BOOT_HANDOFF_MAGIC;
+    boot_handoff.version      = BOOT_HANDOFF_VERSION;
+    boot_handoff.size         = (uint16_t)sizeof(boot_handoff_t);
+    boot_handoff.clock_flags  = clock_flags;
+    /* Actual frequencies from the live SCG registers */
+    boot_handoff.core_clk_hz  = ClockTree_GetHz(CLOCK_TREE_CORE);
+    boot_handoff.bus_clk_hz   = ClockTree_GetHz(CLOCK_TREE_BUS);
+    boot_handoff.slow_clk_hz  = ClockTree_GetHz(CLOCK_TREE_SLOW);
+    boot_handoff.spll_div2_hz = ClockTree_GetHz(CLOCK_TREE_SPLLDIV2);
+    boot_handoff.sosc_div2_hz = ClockTree_GetHz(CLOCK_TREE_SOSCDIV2);
+    boot_handoff.periph_flags = periph_flags;
+    boot_handoff.lpuart1_baud = lpuart1_baud;
+    boot_handoff.check        = handoff_checksum(&boot_handoff);
+}
+
+const boot_handoff_t *BootHandoff_Get(void)
+{
+    if ((boot_handoff.magic != BOOT_HANDOFF_MAGIC) ||
+        (boot_handoff.version != BOOT_HANDOFF_VERSION) ||
+        (boot_handoff.size != sizeof(boot_handoff_t)) ||
+        (boot_handoff.check != handoff_checksum(&boot_handoff))) {
+        return NULL;
+    }
+    return (const boot_handoff_t *)&boot_handoff;
+}
+
+void BootHandoff_Invalidate(void)
+{
+    boot_handoff.magic = 0U;
+    boot_handoff.check = 0U;
+}
@@ -0,0 +1,267 @@
+/**
+ * @file    boot_lat.c
+ * @brief   Interrupt latency and masked-window histograms in DWT cycles.
+ *
+ * The probe runs LPIT0 channel 3 in 32-bit periodic mode from SPLLDIV2.
+ * SPLLDIV2 and the core clock come from the same SPLL, so every timeout
+ * falls on a known CYCCNT value: lat_due. The handler reads CYCCNT first;
+ * now - lat_due is the entry latency. If the request waited longer than a
+ * period, the later timeouts merged into the pending flag; lat_due then
+ * skips to the next timeout after now.
+ *
+ * A run mode switch (clock_and_mode.h) stops SPLLDIV2 while the SPLL
+ * relocks; the probe is stopped before and restarted with the periods of
+ * the new clocks after it.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "boot_lat.h"
+
+#if (BOOT_LAT_ENABLE)
+
+#include "S32K144.h"
+#include "Driver_NVIC.h"
+#include "clock_and_mode.h"
+#include "clock_tree.h"
+#include "dwt_perf.h"
+#include "boot_text.h"
+#include "cmsis_gcc.h"
+#include "s32_core_cm4.h"
+#include <stddef.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define LAT_CH              (3U)
+#if ((CLOCK_SPLLDIV2_HZ % BOOT_LAT_PROBE_HZ) != 0U) || ((CLOCK_CORE_HZ % CLOCK_SPLLDIV2_HZ) != 0U) || \
+    ((CLOCK_HSRUN_SPLLDIV2_HZ % BOOT_LAT_PROBE_HZ) != 0U) || ((CLOCK_HSRUN_CORE_HZ % CLOCK_HSRUN_SPLLDIV2_HZ) != 0U)
+#error "BOOT_LAT_PROBE_HZ must divide SPLLDIV2 so timeouts fall on whole core cycles"
+#endif
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static boot_lat_hist_t lat_hist[BOOT_LAT_COUNT];
+
+static uint8_t  lat_masked;     /* Inside a window (nested disables are one) */
+static uint32_t lat_mask_t0;
+static uint32_t lat_mask_pc;
+static uint32_t lat_due;        /* CYCCNT of the next probe timeout */
+static uint32_t lat_period_cycles;
+
+/* -------------------------------------------------------------------------- */
+/*                         Private Function Prototypes                         */
+/* -------------------------------------------------------------------------- */
+
+/* Probe path in SRAM, like the LPUART path it stands for (Driver_NVIC.h) */
+START_FUNCTION_DECLARATION_RAMSECTION
+static void lat_add(boot_lat_hist_t *h, uint32_t cycles, uint32_t pc)
+END_FUNCTION_DECLARATION_RAMSECTION
+START_FUNCTION_DECLARATION_RAMSECTION
+void LPIT0_Ch3_IRQHandler(void)
+END_FUNCTION_DECLARATION_RAMSECTION
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Add one sample; bucket k holds [2^(k-1), 2^k) cycles.
+ */
+static void lat_add(boot_lat_hist_t *h, uint32_t cycles, uint32_t pc)
+{
+    uint32_t k = (cycles == 0U) ? 0U : (32U - (uint32_t)__builtin_clz(cycles));
+
+    if (k >= BOOT_LAT_BUCKETS) {
+        k = BOOT_LAT_BUCKETS - 1U;
+    }
+    h->bucket[k]++;
+    h->count++;
+    if (cycles < h->min) {
+        h->min = cycles;
+    }
+    if (cycles >= h->max) {
+        h->max    = cycles;
+        h->max_pc = pc;
+    }
+}
+
+/**
+ * @brief Start the probe with the periods of the current clocks.
+ */
+static void lat_start(void)
+{
+    IP_LPIT0->TMR[LAT_CH].TCTRL = LPIT_TMR_TCTRL_MODE(0U);     /* 32-bit periodic */
+    IP_LPIT0->TMR[LAT_CH].TVAL  = (ClockTree_PccHz(PCC_LPIT_INDEX) / BOOT_LAT_PROBE_HZ) - 1U;  /* TVAL + 1 ticks */
+    IP_LPIT0->MSR   = LPIT_MSR_TIF3_MASK;
+    IP_LPIT0->MIER |= LPIT_MIER_TIE3_MASK;
+    lat_period_cycles = ClockTree_GetHz(CLOCK_TREE_CORE) / BOOT_LAT_PROBE_HZ;
+
+    /* The enable takes a few LPIT clocks to synchronise; that offset is
+     * constant and shows up in the minimum */
+    lat_due = DWT_PERF_NOW() + lat_period_cycles;
+    IP_LPIT0->TMR[LAT_CH].TCTRL |= LPIT_TMR_TCTRL_T_EN_MASK;
+}
+
+/**
+ * @brief Stop the probe and drop a pending timeout.
+ */
+static void lat_stop(void)
+{
+    IP_LPIT0->MIER &= ~LPIT_MIER_TIE3_MASK;
+    IP_LPIT0->TMR[LAT_CH].TCTRL = 0U;
+    IP_LPIT0->MSR = LPIT_MSR_TIF3_MASK;
+    NVIC_ClearPendingIRQ(LPIT0_Ch3_IRQn);
+}
+
+/**
+ * @brief Run mode switch: no probe while SPLLDIV2 is stopped (none in VLPR).
+ */
+static void lat_clock_notify(clock_notify_ev_t ev, const clock_freq_t *freq)
+{
+    (void)freq;
+    if (ev == CLOCK_NOTIFY_BEFORE) {
+        lat_stop();
+    } else if (ClockTree_PccHz(PCC_LPIT_INDEX) != 0U) {
+        lat_start();
+    } else {
+        /* Stays stopped */
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Probe Handler                                 */
+/* -------------------------------------------------------------------------- */
+
+void LPIT0_Ch3_IRQHandler(void)
+{
+    uint32_t late = DWT_PERF_NOW() - lat_due;
+
+    IP_LPIT0->MSR = LPIT_MSR_TIF3_MASK;
+    lat_add(&lat_hist[BOOT_LAT_IRQ], late, 0U);
+    lat_due += ((late / lat_period_cycles) + 1U) * lat_period_cycles;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+void BootLat_Reset(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t i;
+    uint32_t k;
+
+    __disable_irq();
+    for (i = 0U; i < (uint32_t)BOOT_LAT_COUNT; i++) {
+        lat_hist[i].count  = 0U;
+        lat_hist[i].min    = 0xFFFFFFFFU;
+        lat_hist[i].max    = 0U;
+        lat_hist[i].max_pc = 0U;
+        for (k = 0U; k < BOOT_LAT_BUCKETS; k++) {
+            lat_hist[i].bucket[k] = 0U;
+        }
+    }
+    if (primask == 0U) {
+        __enable_irq();
+    }
+}
+
+void BootLat_Init(void)
+{
+    lat_masked = 0U;
+    BootLat_Reset();
+
+    (void)ClockTree_PccAcquire(PCC_LPIT_INDEX, CLOCK_TREE_PCS_SPLLDIV2);
+    IP_LPIT0->MCR |= LPIT_MCR_M_CEN_MASK | LPIT_MCR_DBG_EN_MASK;
+
+    NVIC_SetPriority(LPIT0_Ch3_IRQn, BOOT_LAT_PROBE_PRIO);
+    NVIC_EnableIRQ(LPIT0_Ch3_IRQn);
+    (void)Clock_RegisterNotify(lat_clock_notify);
+    lat_start();
+}
+
+void BootLat_Stop(void)
+{
+    lat_stop();
+    NVIC_DisableIRQ(LPIT0_Ch3_IRQn);
+    IP_LPIT0->MCR &= ~LPIT_MCR_M_CEN_MASK;
+    ClockTree_PccRelease(PCC_LPIT_INDEX);
+}
+
+void BootLat_MaskBegin(void)
+{
+    if (lat_masked == 0U) {
+        lat_masked  = 1U;
+        lat_mask_pc = (uint32_t)__builtin_return_address(0) & ~1UL;
+        lat_mask_t0 = DWT_PERF_NOW();
+    }
+}
+
+void BootLat_MaskEnd(void)
+{
+    uint32_t dt = DWT_PERF_NOW() - lat_mask_t0;
+
+    if (lat_masked != 0U) {
+        lat_masked = 0U;
+        lat_add(&lat_hist[BOOT_LAT_MASK], dt, lat_mask_pc);
+    }
+}
+
+const boot_lat_hist_t *BootLat_Get(boot_lat_id_t id)
+{
+    return ((uint32_t)id < (uint32_t)BOOT_LAT_COUNT) ? &lat_hist[id] : NULL;
+}
+
+uint32_t BootLat_Format(boot_lat_id_t id, char *buf, uint32_t size)
+{
+    boot_lat_hist_t h;
+    char key[4];
+    uint32_t n;
+    uint32_t primask;
+    uint32_t pos = 0U;
+    uint32_t k;
+
+    if ((buf == NULL) || (size < 4U) || ((uint32_t)id >= (uint32_t)BOOT_LAT_COUNT)) {
+        return 0U;
+    }
+
+    /* Consistent copy: the probe handler updates the irq histogram */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    h = lat_hist[id];
+    if (primask == 0U) {
+        __enable_irq();
+    }
+
+    pos = BootText_AppendU32(buf, pos, size,
+                             (id == BOOT_LAT_MASK) ? "[LAT] mask n" : "[LAT] irq n", h.count);
+    pos = BootText_AppendU32(buf, pos, size, "min", (h.count != 0U) ? h.min : 0U);
+    pos = BootText_AppendU32(buf, pos, size, "max", h.max);
+    if (id == BOOT_LAT_MASK) {
+        pos = BootText_AppendHex(buf, pos, size, "pc", h.max_pc);
+    }
+    for (k = 0U; k < BOOT_LAT_BUCKETS; k++) {
+        if (h.bucket[k] != 0U) {
+            /* Key "h<k>" */
+            n = 0U;
+            key[n++] = 'h';
+            if (k >= 10U) {
+                key[n++] = (char)('0' + (k / 10U));
+            }
+            key[n++] = (char)('0' + (k % 10U));
+            key[n]   = '\0';
+            pos = BootText_AppendU32(buf, pos, size, key, h.bucket[k]);
+        }
+    }
+
+    return BootText_EndLine(buf, pos, size);
+}
+
+#endif /* BOOT_LAT_ENABLE */
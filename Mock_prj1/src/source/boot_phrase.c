@@ -0,0 +1,90 @@
+/**
+ * @file    boot_phrase.c
+ * @brief   Assembly of record data into 8-byte Flash phrases.
+ */
+
+#include "boot_phrase.h"
+#include <stddef.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static boot_phrase_write_t phrase_write = NULL;
+
+/* State for 4+4 byte merge strategy */
+static uint8_t  pending_valid = 0U;                 /* Pending low 4 bytes available */
+static uint32_t pending_base  = 0U;                 /* Phrase address of pending data */
+static uint8_t  pending_low4[BOOT_PHRASE_HALF];     /* Pending low 4 bytes */
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+void BootPhrase_Init(boot_phrase_write_t write)
+{
+    phrase_write  = write;
+    pending_valid = 0U;
+}
+
+void BootPhrase_Write(uint32_t addr, const uint8_t *data, uint32_t len)
+{
+    uint8_t  buf8[BOOT_PHRASE_SIZE];
+    uint32_t base;
+    uint32_t off;
+    uint32_t n;
+
+    while (len > 0U) {
+        off = addr & (BOOT_PHRASE_SIZE - 1U);
+
+        if ((off == 0U) && (len >= BOOT_PHRASE_SIZE)) {
+            /* a) Whole phrase */
+            phrase_write(addr, data);
+            n = BOOT_PHRASE_SIZE;
+        } else if ((off == 0U) && (len == BOOT_PHRASE_HALF)) {
+            /* b) Low half: wait for the high half */
+            BootPhrase_Flush();
+            memcpy(pending_low4, data, BOOT_PHRASE_HALF);
+            pending_base  = addr;
+            pending_valid = 1U;
+            n = BOOT_PHRASE_HALF;
+        } else {
+            /* c) High half, d) partial phrase: pad with 0xFF */
+            base = addr - off;
+            n    = BOOT_PHRASE_SIZE - off;
+            if ((off == BOOT_PHRASE_HALF) && (len >= BOOT_PHRASE_HALF)) {
+                n = BOOT_PHRASE_HALF;
+            } else if (n > len) {
+                n = len;
+            } else {
+                /* Up to the phrase end */
+            }
+            memset(buf8, 0xFF, BOOT_PHRASE_SIZE);
+            if ((pending_valid != 0U) && (pending_base == base) && (off >= BOOT_PHRASE_HALF)) {
+                memcpy(buf8, pending_low4, BOOT_PHRASE_HALF);
+            }
+            memcpy(&buf8[off], data, n);
+            phrase_write(base, buf8);
+            if (pending_base == base) {
+                pending_valid = 0U;
+            }
+        }
+
+        addr += n;
+        data += n;
+        len  -= n;
+    }
+}
+
+void BootPhrase_Flush(void)
+{
+    uint8_t buf8[BOOT_PHRASE_SIZE];
+
+    if (pending_valid != 0U) {
+        memset(buf8, 0xFF, BOOT_PHRASE_SIZE);
+        memcpy(buf8, pending_low4, BOOT_PHRASE_HALF);
+        phrase_write(pending_base, buf8);
+        pending_valid = 0U;
+    }
+}
@@ -0,0 +1,264 @@
+/**
+ * @file    boot_pool.c
+ * @brief   Fixed-block memory pool with size classes, O(1) and ISR-safe.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "boot_pool.h"
+#include <stddef.h>
+
+#ifndef BOOT_POOL_PORT
+#include "cmsis_gcc.h"
+#define BOOT_POOL_LOCK(state)   do { (state) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define BOOT_POOL_UNLOCK(state) do { if ((state) == 0U) { __enable_irq(); } } while (0)
+#endif
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#if ((BOOT_POOL_PHRASE_SIZE % 8U) != 0U) || ((BOOT_POOL_RECORD_SIZE % 8U) != 0U) || \
+    ((BOOT_POOL_SECTOR_SIZE % 8U) != 0U) || (BOOT_POOL_PHRASE_SIZE == 0U)
+#error "BOOT_POOL_xxx_SIZE must be a non-zero multiple of 8"
+#endif
+#if (BOOT_POOL_PHRASE_SIZE >= BOOT_POOL_RECORD_SIZE) || (BOOT_POOL_RECORD_SIZE >= BOOT_POOL_SECTOR_SIZE)
+#error "BOOT_POOL size classes must be in ascending order"
+#endif
+#if (BOOT_POOL_PHRASE_COUNT > 0xFFFFU) || (BOOT_POOL_RECORD_COUNT > 0xFFFFU) || \
+    (BOOT_POOL_SECTOR_COUNT > 0xFFFFU)
+#error "BOOT_POOL_xxx_COUNT must fit 16 bits"
+#endif
+
+/** @brief Words of the in-use bitmap of a class with n blocks. */
+#define POOL_MAP_WORDS(n)   (((n) + 31U) / 32U)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Types                                  */
+/* -------------------------------------------------------------------------- */
+
+/** @brief Head of a free block: the link to the next one. */
+typedef struct pool_block {
+    struct pool_block *next;
+} pool_block_t;
+
+typedef struct {
+    uint8_t      *base;         /* NULL for a class without blocks */
+    uint32_t     *in_use;       /* One bit per block, set while allocated */
+    uint32_t      size;
+    uint16_t      count;
+    uint16_t      used;
+    uint16_t      high_water;
+    uint16_t      fails;
+    pool_block_t *free;
+} pool_class_t;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+/* uint64_t storage: 8-byte aligned blocks */
+#if (BOOT_POOL_PHRASE_COUNT > 0U)
+static uint64_t pool_phrase_mem[(BOOT_POOL_PHRASE_SIZE * BOOT_POOL_PHRASE_COUNT) / 8U];
+static uint32_t pool_phrase_in_use[POOL_MAP_WORDS(BOOT_POOL_PHRASE_COUNT)];
+#define POOL_PHRASE_BASE    ((uint8_t *)pool_phrase_mem)
+#define POOL_PHRASE_MAP     (pool_phrase_in_use)
+#else
+#define POOL_PHRASE_BASE    (NULL)
+#define POOL_PHRASE_MAP     (NULL)
+#endif
+#if (BOOT_POOL_RECORD_COUNT > 0U)
+static uint64_t pool_record_mem[(BOOT_POOL_RECORD_SIZE * BOOT_POOL_RECORD_COUNT) / 8U];
+static uint32_t pool_record_in_use[POOL_MAP_WORDS(BOOT_POOL_RECORD_COUNT)];
+#define POOL_RECORD_BASE    ((uint8_t *)pool_record_mem)
+#define POOL_RECORD_MAP     (pool_record_in_use)
+#else
+#define POOL_RECORD_BASE    (NULL)
+#define POOL_RECORD_MAP     (NULL)
+#endif
+#if (BOOT_POOL_SECTOR_COUNT > 0U)
+static uint64_t pool_sector_mem[(BOOT_POOL_SECTOR_SIZE * BOOT_POOL_SECTOR_COUNT) / 8U];
+static uint32_t pool_sector_in_use[POOL_MAP_WORDS(BOOT_POOL_SECTOR_COUNT)];
+#define POOL_SECTOR_BASE    ((uint8_t *)pool_sector_mem)
+#define POOL_SECTOR_MAP     (pool_sector_in_use)
+#else
+#define POOL_SECTOR_BASE    (NULL)
+#define POOL_SECTOR_MAP     (NULL)
+#endif
+
+static pool_class_t pool[BOOT_POOL_CLASS_COUNT] = {
+    { POOL_PHRASE_BASE, POOL_PHRASE_MAP, BOOT_POOL_PHRASE_SIZE, BOOT_POOL_PHRASE_COUNT, 0U, 0U, 0U, NULL },
+    { POOL_RECORD_BASE, POOL_RECORD_MAP, BOOT_POOL_RECORD_SIZE, BOOT_POOL_RECORD_COUNT, 0U, 0U, 0U, NULL },
+    { POOL_SECTOR_BASE, POOL_SECTOR_MAP, BOOT_POOL_SECTOR_SIZE, BOOT_POOL_SECTOR_COUNT, 0U, 0U, 0U, NULL },
+};
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Pop a block of one class; call with the lock held.
+ */
+static void *pool_take(pool_class_t *c)
+{
+    pool_block_t *b = c->free;
+    uint32_t idx;
+
+    if (b != NULL) {
+        idx = (uint32_t)((uint8_t *)b - c->base) / c->size;
+        c->in_use[idx / 32U] |= (1UL << (idx % 32U));
+        c->free = b->next;
+        c->used++;
+        if (c->used > c->high_water) {
+            c->high_water = c->used;
+        }
+    }
+    return b;
+}
+
+/**
+ * @brief Class that owns block and its index there, NULL if block is not
+ *        the start of a block.
+ */
+static pool_class_t *pool_owner(const void *block, uint32_t *idx)
+{
+    uintptr_t addr = (uintptr_t)block;
+    uintptr_t off;
+    uint32_t i;
+
+    for (i = 0U; i < (uint32_t)BOOT_POOL_CLASS_COUNT; i++) {
+        if ((pool[i].base != NULL) && (addr >= (uintptr_t)pool[i].base)) {
+            off = addr - (uintptr_t)pool[i].base;
+            if (off < ((uintptr_t)pool[i].size * pool[i].count)) {
+                *idx = (uint32_t)(off / pool[i].size);
+                return ((off % pool[i].size) == 0U) ? &pool[i] : NULL;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                 Public API                                  */
+/* -------------------------------------------------------------------------- */
+
+void BootPool_Init(void)
+{
+    pool_class_t *c;
+    pool_block_t *b;
+    uint32_t state;
+    uint32_t i;
+    uint32_t k;
+
+    BOOT_POOL_LOCK(state);
+    for (i = 0U; i < (uint32_t)BOOT_POOL_CLASS_COUNT; i++) {
+        c = &pool[i];
+        c->free       = NULL;
+        c->used       = 0U;
+        c->high_water = 0U;
+        c->fails      = 0U;
+        for (k = 0U; k < POOL_MAP_WORDS((uint32_t)c->count); k++) {
+            c->in_use[k] = 0U;
+        }
+        /* Last block first: the list hands out blocks in address order */
+        for (k = c->count; k > 0U; k--) {
+            b = (pool_block_t *)(void *)&c->base[(k - 1U) * c->size];
+            b->next = c->free;
+            c->free = b;
+        }
+    }
+    BOOT_POOL_UNLOCK(state);
+}
+
+void *BootPool_Alloc(uint32_t size)
+{
+    void *block = NULL;
+    pool_class_t *fit = NULL;
+    uint32_t state;
+    uint32_t i;
+
+    BOOT_POOL_LOCK(state);
+    for (i = 0U; (i < (uint32_t)BOOT_POOL_CLASS_COUNT) && (block == NULL); i++) {
+        if ((pool[i].count != 0U) && (size <= pool[i].size)) {
+            if (fit == NULL) {
+                fit = &pool[i];
+            }
+            block = pool_take(&pool[i]);
+        }
+    }
+    if ((block == NULL) && (fit != NULL) && (fit->fails != 0xFFFFU)) {
+        fit->fails++;
+    }
+    BOOT_POOL_UNLOCK(state);
+    return block;
+}
+
+void *BootPool_AllocClass(boot_pool_class_t cls)
+{
+    void *block = NULL;
+    uint32_t state;
+
+    if ((uint32_t)cls >= (uint32_t)BOOT_POOL_CLASS_COUNT) {
+        return NULL;
+    }
+    BOOT_POOL_LOCK(state);
+    block = pool_take(&pool[cls]);
+    if ((block == NULL) && (pool[cls].fails != 0xFFFFU)) {
+        pool[cls].fails++;
+    }
+    BOOT_POOL_UNLOCK(state);
+    return block;
+}
+
+bool BootPool_Free(void *block)
+{
+    uint32_t idx = 0U;
+    pool_class_t *c = pool_owner(block, &idx);
+    pool_block_t *b = (pool_block_t *)block;
+    uint32_t mask = 1UL << (idx % 32U);
+    uint32_t state;
+    bool ok = false;
+
+    if (c == NULL) {
+        return false;
+    }
+    BOOT_POOL_LOCK(state);
+    /* A block that is not allocated (double free) would enter the list twice */
+    if ((c->in_use[idx / 32U] & mask) != 0U) {
+        c->in_use[idx / 32U] &= ~mask;
+        b->next = c->free;
+        c->free = b;
+        c->used--;
+        ok = true;
+    }
+    BOOT_POOL_UNLOCK(state);
+    return ok;
+}
+
+uint32_t BootPool_BlockSize(const void *block)
+{
+    uint32_t idx;
+    const pool_class_t *c = pool_owner(block, &idx);
+
+    return (c != NULL) ? c->size : 0U;
+}
+
+bool BootPool_GetStats(boot_pool_class_t cls, boot_pool_stats_t *stats)
+{
+    uint32_t state;
+
+    if (((uint32_t)cls >= (uint32_t)BOOT_POOL_CLASS_COUNT) || (stats == NULL)) {
+        return false;
+    }
+    BOOT_POOL_LOCK(state);
+    stats->size       = pool[cls].size;
+    stats->count      = pool[cls].count;
+    stats->used       = pool[cls].used;
+    stats->high_water = pool[cls].high_water;
+    stats->fails      = pool[cls].fails;
+    BOOT_POOL_UNLOCK(state);
+    return true;
+}
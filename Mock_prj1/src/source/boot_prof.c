@@ -0,0 +1,192 @@
+/**
+ * @file    boot_prof.c
+ * @brief   Statistical profiler: SysTick samples the interrupted PC into a
+ *          RAM histogram that is dumped over the UART.
+ *
+ * SysTick_Handler is a naked shim: it picks the stack the exception frame
+ * was pushed to (EXC_RETURN bit 2), loads the stacked PC (frame word 6) and
+ * tail-calls BootProf_Sample(), which returns straight to the interrupted
+ * code through the unchanged EXC_RETURN in LR.
+ *
+ * SysTick runs at priority 0, above the BASEPRI mask of a Flash command
+ * (NVIC_PRIO_FLASH), so both run from SRAM like the LPUART path.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "boot_prof.h"
+
+#if (BOOT_PROF_ENABLE)
+
+#include "S32K144_features.h"
+#include "s32_core_cm4.h"
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define PROF_SRAM_START     (0x1FFF8000UL)  /* SRAM_L */
+#define PROF_SRAM_END       (0x20007000UL)  /* End of SRAM_U */
+#define PROF_COUNT_MAX      (0xFFFFU)
+#define PROF_CHUNK          (32U)           /* Entries per write() call */
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+/** @brief Saturating sample counters, one per bucket. */
+static uint16_t prof_hist[BOOT_PROF_BUCKETS];
+
+static uint32_t prof_base;
+static uint32_t prof_shift;
+static uint32_t prof_rate;
+static volatile uint32_t prof_samples;
+static volatile uint32_t prof_ram;
+static volatile uint32_t prof_other;
+static volatile uint32_t prof_saturated;
+
+/* Taken during Flash commands: no fetch from P-Flash (Driver_NVIC.h) */
+START_FUNCTION_DECLARATION_RAMSECTION
+void SysTick_Handler(void)
+END_FUNCTION_DECLARATION_RAMSECTION
+START_FUNCTION_DECLARATION_RAMSECTION
+void BootProf_Sample(uint32_t pc)
+END_FUNCTION_DECLARATION_RAMSECTION
+
+/* -------------------------------------------------------------------------- */
+/*                               SysTick Handler                               */
+/* -------------------------------------------------------------------------- */
+
+__attribute__((naked)) void SysTick_Handler(void)
+{
+    __asm volatile (
+        "tst   lr, #4           \n"
+        "ite   eq               \n"
+        "mrseq r0, msp          \n"
+        "mrsne r0, psp          \n"
+        "ldr   r0, [r0, #24]    \n"
+        "b     BootProf_Sample  \n"
+    );
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+void BootProf_Start(uint32_t base, uint32_t end, uint32_t rate_hz, uint32_t core_hz)
+{
+    uint32_t reload;
+    uint32_t i;
+
+    BootProf_Stop();
+    if (rate_hz == 0U) {
+        prof_rate = 0U;
+        return;
+    }
+
+    prof_base  = base;
+    prof_shift = 0U;
+    while (((uint32_t)BOOT_PROF_BUCKETS << prof_shift) < (end - base)) {
+        prof_shift++;
+    }
+    for (i = 0U; i < BOOT_PROF_BUCKETS; i++) {
+        prof_hist[i] = 0U;
+    }
+    prof_samples   = 0U;
+    prof_ram       = 0U;
+    prof_other     = 0U;
+    prof_saturated = 0U;
+
+    reload = core_hz / rate_hz;
+    if (reload > (BOOT_PROF_RVR_MAX + 1UL)) {
+        reload = BOOT_PROF_RVR_MAX + 1UL;
+    }
+    prof_rate = core_hz / reload;
+
+    /* Highest priority: sample inside the other handlers as well */
+    S32_SCB->SHPR3 &= ~S32_SCB_SHPR3_PRI_15_MASK;
+    BOOT_PROF_SYST->RVR = reload - 1UL;
+    BOOT_PROF_SYST->CVR = 0U;
+    BOOT_PROF_SYST->CSR = BOOT_PROF_CSR_CLKSOURCE | BOOT_PROF_CSR_TICKINT | BOOT_PROF_CSR_ENABLE;
+}
+
+void BootProf_Stop(void)
+{
+    BOOT_PROF_SYST->CSR = 0U;
+    /* A tick already pending would still be taken */
+    S32_SCB->ICSR = S32_SCB_ICSR_PENDSTCLR_MASK;
+}
+
+void BootProf_Sample(uint32_t pc)
+{
+    uint32_t idx = (pc - prof_base) >> prof_shift;
+
+    prof_samples++;
+    if ((pc >= prof_base) && (idx < BOOT_PROF_BUCKETS)) {
+        if (prof_hist[idx] != PROF_COUNT_MAX) {
+            prof_hist[idx]++;
+        } else {
+            prof_saturated++;
+        }
+    } else if ((pc >= PROF_SRAM_START) && (pc < PROF_SRAM_END)) {
+        prof_ram++;
+    } else {
+        prof_other++;
+    }
+}
+
+void BootProf_Dump(perf_write_t write)
+{
+    uint32_t hdr[9];
+    uint16_t chunk[PROF_CHUNK * 2U];
+    uint32_t csr;
+    uint32_t n = 0U;
+    uint32_t k = 0U;
+    uint32_t i;
+
+    if (write == 0) {
+        return;
+    }
+
+    /* Freeze the histogram so the entry count matches the entries sent */
+    csr = BOOT_PROF_SYST->CSR;
+    BOOT_PROF_SYST->CSR = csr & ~BOOT_PROF_CSR_TICKINT;
+
+    for (i = 0U; i < BOOT_PROF_BUCKETS; i++) {
+        if (prof_hist[i] != 0U) {
+            n++;
+        }
+    }
+
+    hdr[0] = BOOT_PROF_DUMP_MAGIC;
+    hdr[1] = (uint32_t)BOOT_PROF_DUMP_VERSION | (prof_shift << 8);
+    hdr[2] = prof_base;
+    hdr[3] = ((csr & BOOT_PROF_CSR_TICKINT) != 0U) ? prof_rate : 0U;
+    hdr[4] = prof_samples;
+    hdr[5] = prof_ram;
+    hdr[6] = prof_other;
+    hdr[7] = prof_saturated;
+    hdr[8] = n;
+    write(hdr, sizeof(hdr));
+
+    for (i = 0U; i < BOOT_PROF_BUCKETS; i++) {
+        if (prof_hist[i] != 0U) {
+            chunk[k++] = (uint16_t)i;
+            chunk[k++] = prof_hist[i];
+            if (k == (PROF_CHUNK * 2U)) {
+                write(chunk, k * sizeof(chunk[0]));
+                k = 0U;
+            }
+        }
+    }
+    if (k != 0U) {
+        write(chunk, k * sizeof(chunk[0]));
+    }
+
+    BOOT_PROF_SYST->CSR = csr;
+}
+
+#endif /* BOOT_PROF_ENABLE */
@@ -0,0 +1,218 @@
+/**
+ * @file    boot_record.c
+ * @brief   Format-agnostic record source: S-record, Intel HEX and binary.
+ */
+
+#include "boot_record.h"
+#include "srec_parser.h"
+#include <stddef.h>
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static boot_format_t image_format = BOOT_FMT_NONE;
+static uint32_t      ihex_base    = 0U;        /**< Type 04/02 address base */
+static uint32_t      ihex_entry   = 0U;        /**< Type 05/03 entry point  */
+
+/* Text decoders write their data here (an S3 line holds at most 250 bytes) */
+static srec_record_t srec;
+static uint8_t       ihex_data[128];
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static int hex_pair(const uint8_t *p, uint8_t *out)
+{
+    uint8_t v = 0U;
+    uint32_t i;
+    uint8_t c;
+
+    for (i = 0U; i < 2U; i++) {
+        c = p[i];
+        if ((c >= '0') && (c <= '9'))      { v = (uint8_t)((v << 4) | (uint8_t)(c - '0')); }
+        else if ((c >= 'A') && (c <= 'F')) { v = (uint8_t)((v << 4) | (uint8_t)(c - 'A' + 10U)); }
+        else if ((c >= 'a') && (c <= 'f')) { v = (uint8_t)((v << 4) | (uint8_t)(c - 'a' + 10U)); }
+        else                               { return -1; }
+    }
+    *out = v;
+    return 0;
+}
+
+static int decode_srec(const uint8_t *frame, boot_record_t *rec)
+{
+    if (parse_srec_line((const char *)frame, &srec) != 0) {
+        return -1;
+    }
+    rec->address = srec.address;
+    rec->data    = srec.data;
+    rec->len     = srec.data_len;
+    rec->valid   = srec.valid;
+    switch ((int)srec.type) {           /* parse_srec_line() stores the type digit */
+    case 1: case 2: case 3: rec->type = BOOT_REC_DATA; break;
+    case 7: case 8: case 9: rec->type = BOOT_REC_END;  break;
+    default:                rec->type = BOOT_REC_SKIP; break;
+    }
+    return 0;
+}
+
+/**
+ * @brief ":LLAAAATT<LL data bytes>CC", checksum: all bytes sum to 0.
+ */
+static int decode_ihex(const uint8_t *frame, uint16_t len, boot_record_t *rec)
+{
+    uint8_t head[4];
+    uint8_t cksum;
+    uint8_t sum = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < 4U; i++) {
+        if ((len < 11U) || (hex_pair(&frame[1U + (2U * i)], &head[i]) != 0)) {
+            return -1;
+        }
+        sum += head[i];
+    }
+    if ((head[0] > sizeof(ihex_data)) || (len != (11U + (2U * (uint32_t)head[0])))) {
+        return -1;
+    }
+    for (i = 0U; i < head[0]; i++) {
+        if (hex_pair(&frame[9U + (2U * i)], &ihex_data[i]) != 0) {
+            return -1;
+        }
+        sum += ihex_data[i];
+    }
+    if (hex_pair(&frame[len - 2U], &cksum) != 0) {
+        return -1;
+    }
+
+    rec->valid   = ((uint8_t)(sum + cksum) == 0U) ? 1U : 0U;
+    rec->address = ihex_base + (((uint32_t)head[1] << 8) | head[2]);
+    rec->data    = ihex_data;
+    rec->len     = head[0];
+    rec->type    = BOOT_REC_SKIP;
+    if (rec->valid == 0U) {
+        return 0;
+    }
+
+    switch (head[3]) {
+    case 0x00U:
+        rec->type = BOOT_REC_DATA;
+        break;
+    case 0x01U:
+        rec->type    = BOOT_REC_END;
+        rec->address = ihex_entry;
+        break;
+    case 0x02U:
+    case 0x04U:
+        if (head[0] != 2U) {
+            return -1;
+        }
+        ihex_base = ((uint32_t)ihex_data[0] << 8) | ihex_data[1];
+        ihex_base <<= (head[3] == 0x04U) ? 16U : 4U;
+        break;
+    case 0x03U:
+    case 0x05U:
+        if (head[0] != 4U) {
+            return -1;
+        }
+        ihex_entry = ((uint32_t)ihex_data[0] << 24) | ((uint32_t)ihex_data[1] << 16) |
+                     ((uint32_t)ihex_data[2] << 8)  | ihex_data[3];
+        if (head[3] == 0x03U) {
+            ihex_entry = ((ihex_entry >> 16) << 4) + (ihex_entry & 0xFFFFU);    /* CS:IP */
+        }
+        break;
+    default:
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief STX, len, address, data, ~sum: same checksum rule as S-records.
+ */
+static int decode_bin(const uint8_t *frame, uint16_t len, boot_record_t *rec)
+{
+    uint8_t sum = 0U;
+    uint32_t i;
+
+    if ((len < BOOT_RECORD_BIN_OVERHEAD) || (len != (BOOT_RECORD_BIN_OVERHEAD + (uint32_t)frame[1]))) {
+        return -1;
+    }
+    for (i = 1U; i < len; i++) {
+        sum += frame[i];
+    }
+    rec->valid   = (sum == 0xFFU) ? 1U : 0U;
+    rec->address = ((uint32_t)frame[2] << 24) | ((uint32_t)frame[3] << 16) |
+                   ((uint32_t)frame[4] << 8)  | frame[5];
+    rec->data    = &frame[BOOT_RECORD_BIN_HEADER];
+    rec->len     = frame[1];
+    rec->type    = (frame[1] == 0U) ? BOOT_REC_END : BOOT_REC_DATA;
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+boot_format_t BootRecord_Format(const uint8_t *frame, uint16_t len)
+{
+    if (len == 0U) {
+        return BOOT_FMT_NONE;
+    }
+    if ((frame[0] == 'S') && (len > 1U) && (frame[1] >= '0') && (frame[1] <= '9')) {
+        return BOOT_FMT_SREC;
+    }
+    if (frame[0] == ':') {
+        return BOOT_FMT_IHEX;
+    }
+    if (frame[0] == BOOT_RECORD_BIN_SOF) {
+        return BOOT_FMT_BIN;
+    }
+    return BOOT_FMT_NONE;
+}
+
+int BootRecord_Decode(const uint8_t *frame, uint16_t len, boot_record_t *rec)
+{
+    boot_format_t fmt = BootRecord_Format(frame, len);
+    int rc;
+
+    rec->type  = BOOT_REC_SKIP;
+    rec->data  = NULL;
+    rec->len   = 0U;
+    rec->valid = 0U;
+
+    /* Text lines may end in "\r\n" */
+    if (fmt != BOOT_FMT_BIN) {
+        while ((len > 0U) && (frame[len - 1U] == '\r')) {
+            len--;
+        }
+    }
+
+    /* The first record fixes the format of the image */
+    if ((fmt == BOOT_FMT_NONE) || ((image_format != BOOT_FMT_NONE) && (fmt != image_format))) {
+        return -1;
+    }
+
+    switch (fmt) {
+    case BOOT_FMT_SREC: rc = decode_srec(frame, rec);      break;
+    case BOOT_FMT_IHEX: rc = decode_ihex(frame, len, rec); break;
+    default:            rc = decode_bin(frame, len, rec);  break;
+    }
+    if ((rc == 0) && (rec->valid != 0U)) {
+        image_format = fmt;
+    }
+    return rc;
+}
+
+void BootRecord_Reset(void)
+{
+    image_format = BOOT_FMT_NONE;
+    ihex_base    = 0U;
+    ihex_entry   = 0U;
+}
+
+boot_format_t BootRecord_CurrentFormat(void)
+{
+    return image_format;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file    boot_rxmap.c
+ * @brief   Map of the application blocks programmed in this session.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "boot_rxmap.h"
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static uint8_t  rxmap[(BOOT_RXMAP_BLOCKS + 7U) / 8U];
+static uint32_t rxmap_base;
+static uint32_t rxmap_blocks;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static uint32_t append_text(char *buf, uint32_t pos, uint32_t size, const char *text)
+{
+    while ((*text != '\0') && (pos + 1U < size)) {
+        buf[pos++] = *text++;
+    }
+    return pos;
+}
+
+static uint32_t append_dec(char *buf, uint32_t pos, uint32_t size, uint32_t value)
+{
+    char digits[10];
+    uint32_t n = 0U;
+
+    do {
+        digits[n++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while (value != 0U);
+    while ((n > 0U) && (pos + 1U < size)) {
+        buf[pos++] = digits[--n];
+    }
+    return pos;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+void BootRxMap_Init(uint32_t base, uint32_t length)
+{
+    if (length > BOOT_RXMAP_REGION_MAX) {
+        length = BOOT_RXMAP_REGION_MAX;
+    }
+    memset(rxmap, 0, sizeof(rxmap));
+    rxmap_base   = base;
+    rxmap_blocks = length >> BOOT_RXMAP_BLOCK_SHIFT;
+}
+
+void BootRxMap_Mark(uint32_t address, uint32_t len)
+{
+    uint32_t first;
+    uint32_t last;
+
+    if ((len == 0U) || (address < rxmap_base)) {
+        return;
+    }
+    first = (address - rxmap_base) >> BOOT_RXMAP_BLOCK_SHIFT;
+    last  = ((address - rxmap_base) + len - 1U) >> BOOT_RXMAP_BLOCK_SHIFT;
+    for (; (first <= last) && (first < rxmap_blocks); first++) {
+        rxmap[first >> 3] |= (uint8_t)(1U << (first & 7U));
+    }
+}
+
+uint32_t BootRxMap_Format(char *buf, uint32_t size, uint32_t first, uint32_t count)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    uint32_t pos = 0U;
+    uint32_t i;
+    uint8_t bits = 0U;
+
+    if ((buf == NULL) || (size < 4U)) {
+        return 0U;
+    }
+    if (first > rxmap_blocks) {
+        first = rxmap_blocks;
+    }
+    if (count > BOOT_RXMAP_QUERY_MAX) {
+        count = BOOT_RXMAP_QUERY_MAX;
+    }
+    if (count > (rxmap_blocks - first)) {
+        count = rxmap_blocks - first;
+    }
+
+    pos = append_text(buf, pos, size, "[MAP] ");
+    pos = append_dec(buf, pos, size, first);
+    pos = append_text(buf, pos, size, " ");
+    pos = append_dec(buf, pos, size, count);
+    pos = append_text(buf, pos, size, " ");
+    for (i = 0U; i < count; i++) {
+        if ((rxmap[(first + i) >> 3] & (1U << ((first + i) & 7U))) != 0U) {
+            bits |= (uint8_t)(1U << (i & 7U));
+        }
+        if (((i & 7U) == 7U) || ((i + 1U) == count)) {
+            if (pos + 3U < size) {
+                buf[pos++] = hex[bits >> 4];
+                buf[pos++] = hex[bits & 0xFU];
+            }
+            bits = 0U;
+        }
+    }
+
+    if (pos + 3U > size) {
+        pos = size - 3U;
+    }
+    buf[pos++] = '\r';
+    buf[pos++] = '\n';
+    buf[pos]   = '\0';
+    return pos;
+}
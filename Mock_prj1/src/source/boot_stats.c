@@ -0,0 +1,62 @@
+/**
+ * @file    boot_stats.c
+ * @brief   Always-on bootloader throughput counters.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "boot_stats.h"
+#include "hal_usart.h"
+#include "uart_buffer.h"
+#include "srec_queue.h"
+#include "boot_text.h"
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                              Public Variables                               */
+/* -------------------------------------------------------------------------- */
+
+boot_stats_t boot_stats;
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+void BootStats_Reset(void)
+{
+    memset(&boot_stats, 0, sizeof(boot_stats));
+}
+
+uint32_t BootStats_Format(char *buf, uint32_t size)
+{
+    HAL_USART_Errors_t err;
+    uint32_t pos = 0U;
+
+    if ((buf == NULL) || (size < 4U)) {
+        return 0U;
+    }
+
+    HAL_USART_GetErrors(HAL_LPUART1, &err);
+
+    pos = BootText_AppendU32(buf, pos, size, "[STATS] rx",  boot_stats.bytes_rx);
+    pos = BootText_AppendU32(buf, pos, size, "ovr",         err.overrun);
+    pos = BootText_AppendU32(buf, pos, size, "fe",          err.framing);
+    pos = BootText_AppendU32(buf, pos, size, "nf",          err.noise);
+    pos = BootText_AppendU32(buf, pos, size, "bufdrop",     boot_stats.uart_buf_drops);
+    pos = BootText_AppendU32(buf, pos, size, "bufhw",       UART_BufferHighWater());
+    pos = BootText_AppendU32(buf, pos, size, "lines",       boot_stats.lines_rx);
+    pos = BootText_AppendU32(buf, pos, size, "linelong",    boot_stats.line_overflows);
+    pos = BootText_AppendU32(buf, pos, size, "qdrop",       boot_stats.srec_queue_drops);
+    pos = BootText_AppendU32(buf, pos, size, "qhw",         SREC_QueueHighWater());
+    pos = BootText_AppendU32(buf, pos, size, "perr",        boot_stats.parse_errors);
+    pos = BootText_AppendU32(buf, pos, size, "cksum",       boot_stats.checksum_errors);
+    pos = BootText_AppendU32(buf, pos, size, "recs",        boot_stats.records_programmed);
+    pos = BootText_AppendU32(buf, pos, size, "phrases",     boot_stats.phrases_programmed);
+    pos = BootText_AppendU32(buf, pos, size, "pherr",       boot_stats.phrase_errors);
+    pos = BootText_AppendU32(buf, pos, size, "sectors",     boot_stats.sectors_erased);
+
+    return BootText_EndLine(buf, pos, size);
+}
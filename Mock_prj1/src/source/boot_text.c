@@ -0,0 +1,84 @@
+/**
+ * @file    boot_text.c
+ * @brief   "key=value" text lines for the STATS and LAT replies.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "boot_text.h"
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static uint32_t append_key(char *buf, uint32_t pos, uint32_t size, const char *key)
+{
+    while ((*key != '\0') && (pos + 1U < size)) {
+        buf[pos++] = *key++;
+    }
+    if (pos + 1U < size) {
+        buf[pos++] = '=';
+    }
+    return pos;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+uint32_t BootText_AppendU32(char *buf, uint32_t pos, uint32_t size,
+                            const char *key, uint32_t value)
+{
+    char digits[10];
+    uint32_t n = 0U;
+
+    pos = append_key(buf, pos, size, key);
+    do {
+        digits[n++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while (value != 0U);
+    while ((n > 0U) && (pos + 1U < size)) {
+        buf[pos++] = digits[--n];
+    }
+    if (pos + 1U < size) {
+        buf[pos++] = ' ';
+    }
+    return pos;
+}
+
+uint32_t BootText_AppendHex(char *buf, uint32_t pos, uint32_t size,
+                            const char *key, uint32_t value)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    int32_t shift;
+
+    pos = append_key(buf, pos, size, key);
+    if (pos + 2U < size) {
+        buf[pos++] = '0';
+        buf[pos++] = 'x';
+    }
+    for (shift = 28; (shift >= 0) && (pos + 1U < size); shift -= 4) {
+        buf[pos++] = hex[(value >> (uint32_t)shift) & 0xFU];
+    }
+    if (pos + 1U < size) {
+        buf[pos++] = ' ';
+    }
+    return pos;
+}
+
+uint32_t BootText_EndLine(char *buf, uint32_t pos, uint32_t size)
+{
+    if ((pos > 0U) && (buf[pos - 1U] == ' ')) {
+        pos--;
+    }
+    if (pos + 3U > size) {
+        pos = size - 3U;
+    }
+    buf[pos++] = '\r';
+    buf[pos++] = '\n';
+    buf[pos]   = '\0';
+    return pos;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file    boot_trace.c
+ * @brief   Event trace recorder: timestamped events in a fixed RAM ring.
+ *
+ * Timestamps are raw CYCCNT values; the host unwraps them, which is exact
+ * as long as two consecutive events are less than one wrap period apart.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "boot_trace.h"
+
+#if (BOOT_TRACE_ENABLE)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+/** @brief Event ring, written at boot_trace_total modulo BOOT_TRACE_DEPTH. */
+boot_trace_entry_t boot_trace_ring[BOOT_TRACE_DEPTH];
+
+/** @brief Events recorded since BootTrace_Init(). */
+uint32_t boot_trace_total;
+
+/** @brief Recording enabled. */
+volatile uint8_t boot_trace_on;
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+void BootTrace_Init(void)
+{
+    boot_trace_on    = 0U;
+    boot_trace_total = 0U;
+    boot_trace_on    = 1U;
+}
+
+void BootTrace_Dump(perf_write_t write, uint32_t core_hz)
+{
+    uint32_t hdr[5];
+    uint32_t first;
+    uint32_t n;
+    uint32_t idx;
+
+    if (write == 0) {
+        return;
+    }
+
+    boot_trace_on = 0U;
+
+    n     = (boot_trace_total < BOOT_TRACE_DEPTH) ? boot_trace_total : BOOT_TRACE_DEPTH;
+    first = boot_trace_total - n;
+
+    hdr[0] = BOOT_TRACE_DUMP_MAGIC;
+    hdr[1] = (uint32_t)BOOT_TRACE_DUMP_VERSION;
+    hdr[2] = core_hz;
+    hdr[3] = boot_trace_total;
+    hdr[4] = n;
+    write(hdr, sizeof(hdr));
+
+    /* Oldest first: up to the end of the array, then from its start */
+    idx = first & (BOOT_TRACE_DEPTH - 1U);
+    if ((idx + n) > BOOT_TRACE_DEPTH) {
+        write(&boot_trace_ring[idx], (BOOT_TRACE_DEPTH - idx) * sizeof(boot_trace_ring[0]));
+        n  -= BOOT_TRACE_DEPTH - idx;
+        idx = 0U;
+    }
+    if (n != 0U) {
+        write(&boot_trace_ring[idx], n * sizeof(boot_trace_ring[0]));
+    }
+
+    boot_trace_on = 1U;
+}
+
+#endif /* BOOT_TRACE_ENABLE */
@@ -6,9 +6,70 @@
  */
 #include "S32K144.h" /* include peripheral declarations S32K144 */
 #include "clock_and_mode.h"
+#include "clock_tree.h"
+
+/* Expected register images of the configuration below, used to skip
+ * re-initialization when the bootloader has already set the clocks up. */
+#define SOSC_CFG_8MHZ    0x00000024U
+#define SOSC_DIV_8MHZ    0x00000101U
+#define SPLL_CFG_160MHZ  0x00180000U
+#define SPLL_DIV_160MHZ  0x00000302U
+#define RUN_CSR_80MHZ    (SCG_CSR_SCS(6) | SCG_CSR_DIVCORE(1) | SCG_CSR_DIVBUS(1) | SCG_CSR_DIVSLOW(2))
+
+/* Mode switch plans (clock_and_mode.h) */
+#define SPLL_CFG_112MHZ  0x000C0000U /* MULT=12: 8 MHz * 28 / 2 = 112 MHz */
+#define HSRUN_CSR_112MHZ (SCG_CSR_SCS(6) | SCG_CSR_DIVCORE(0) | SCG_CSR_DIVBUS(1) | SCG_CSR_DIVSLOW(3))
+#define VLPR_CSR_4MHZ    (SCG_CSR_SCS(2) | SCG_CSR_DIVCORE(1) | SCG_CSR_DIVBUS(0) | SCG_CSR_DIVSLOW(3))
+#define FIRC_CSR_48MHZ   (SCG_CSR_SCS(3) | SCG_CSR_DIVCORE(0) | SCG_CSR_DIVBUS(0) | SCG_CSR_DIVSLOW(1))
+#define SIRC_CSR_8MHZ    (SCG_CSR_SCS(2) | SCG_CSR_DIVCORE(0) | SCG_CSR_DIVBUS(0) | SCG_CSR_DIVSLOW(1))
+
+#define SMC_RUNM_RUN     0U
+#define SMC_RUNM_VLPR    2U
+#define SMC_RUNM_HSRUN   3U
+#define SMC_PMSTAT_RUN   0x01U
+#define SMC_PMSTAT_VLPR  0x04U
+#define SMC_PMSTAT_HSRUN 0x80U
+
+#ifndef CLOCK_GOV_IDLE_MODE
+#define CLOCK_GOV_IDLE_MODE   CLOCK_MODE_RUN
+#endif
+#ifndef CLOCK_GOV_DECODE_MODE
+#define CLOCK_GOV_DECODE_MODE CLOCK_MODE_HSRUN
+#endif
+/* The FTFC refuses program and erase in HSRUN and VLPR: Flash is always RUN */
+#ifdef CLOCK_GOV_FLASH_MODE
+#error "CLOCK_GOV_FLASH_MODE: Flash commands run in CLOCK_MODE_RUN only"
+#endif
+#define CLOCK_GOV_FLASH_MODE  CLOCK_MODE_RUN
+
+static clock_freq_t   clk_freq; /* Last Clock_GetFreq() */
+static clock_mode_t   clk_mode = CLOCK_MODE_RUN;
+static bool           clk_modes_allowed;
+static clock_notify_t clk_notify[CLOCK_NOTIFY_MAX];
+static clock_mode_t   gov_mode[CLOCK_PHASE_COUNT] = {
+ CLOCK_GOV_IDLE_MODE, CLOCK_GOV_DECODE_MODE, CLOCK_GOV_FLASH_MODE
+};
+static uint32_t       gov_switches;
+
+static void spll_start(uint32_t cfg);
+
+bool SOSC_is_8MHz(void) {
+ return ((IP_SCG->SOSCCSR & SCG_SOSCCSR_SOSCVLD_MASK) != 0U)
+     && (IP_SCG->SOSCCFG == SOSC_CFG_8MHZ)
+     && (IP_SCG->SOSCDIV == SOSC_DIV_8MHZ);
+}
+bool SPLL_is_160MHz(void) {
+ return ((IP_SCG->SPLLCSR & SCG_SPLLCSR_SPLLVLD_MASK) != 0U)
+     && (IP_SCG->SPLLCFG == SPLL_CFG_160MHZ)
+     && (IP_SCG->SPLLDIV == SPLL_DIV_160MHZ);
+}
+bool RUNmode_is_80MHz(void) {
+ return (IP_SCG->CSR == RUN_CSR_80MHZ);
+}
 void SOSC_init_8MHz(void) {
- IP_SCG->SOSCDIV=0x00000101; /* SOSCDIV1 & SOSCDIV2 =1: divide by 1 */
- IP_SCG->SOSCCFG=0x00000024; /* Range=2: Medium freq (SOSC between 1MHz-8MHz)*/
+ if (SOSC_is_8MHz()) return; /* Already running (e.g. set up by the bootloader) */
+ IP_SCG->SOSCDIV=SOSC_DIV_8MHZ; /* SOSCDIV1 & SOSCDIV2 =1: divide by 1 */
+ IP_SCG->SOSCCFG=SOSC_CFG_8MHZ; /* Range=2: Medium freq (SOSC between 1MHz-8MHz)*/
  /* HGO=0: Config xtal osc for low power */
 /* EREFS=1: Input is external XTAL */
  while(IP_SCG->SOSCCSR & SCG_SOSCCSR_LK_MASK); /* Ensure SOSCCSR unlocked */
@@ -22,12 +83,16 @@ void SOSC_init_8MHz(void) {
  while(!(IP_SCG->SOSCCSR & SCG_SOSCCSR_SOSCVLD_MASK)); /* Wait for sys OSC clk valid */
 }
 void SPLL_init_160MHz(void) {
+ if (SPLL_is_160MHz()) return; /* Already locked; SPLL may be SYS_CLK, do not disable it */
+ spll_start(SPLL_CFG_160MHZ); /* PREDIV=0: Divide SOSC_CLK by 0+1=1 */
+ /* MULT=24: Multiply sys pll by 16+24=40 */
+/* SPLL_CLK = 8MHz / 1 * 40 / 2 = 160 MHz */
+}
+static void spll_start(uint32_t cfg) { /* SPLL must not be SYS_CLK */
  while(IP_SCG->SPLLCSR & SCG_SPLLCSR_LK_MASK); /* Ensure SPLLCSR unlocked */
  IP_SCG->SPLLCSR = 0x00000000; /* SPLLEN=0: SPLL is disabled (default) */
- IP_SCG->SPLLDIV = 0x00000302; /* SPLLDIV1 divide by 2; SPLLDIV2 divide by 4 */
- IP_SCG->SPLLCFG = 0x00180000; /* PREDIV=0: Divide SOSC_CLK by 0+1=1 */
- /* MULT=24: Multiply sys pll by 4+24=40 */
-/* SPLL_CLK = 8MHz / 1 * 40 / 2 = 160 MHz */
+ IP_SCG->SPLLDIV = SPLL_DIV_160MHZ; /* SPLLDIV1 divide by 2; SPLLDIV2 divide by 4 */
+ IP_SCG->SPLLCFG = cfg;
  while(IP_SCG->SPLLCSR & SCG_SPLLCSR_LK_MASK); /* Ensure SPLLCSR unlocked */
  IP_SCG->SPLLCSR = 0x00000001; /* LK=0: SPLLCSR can be written */
  /* SPLLCMRE=0: SPLL CLK monitor IRQ if enabled */
@@ -37,6 +102,7 @@ void SPLL_init_160MHz(void) {
  while(!(IP_SCG->SPLLCSR & SCG_SPLLCSR_SPLLVLD_MASK)); /* Wait for SPLL valid */
 }
 void NormalRUNmode_80MHz (void) { /* Change to normal RUN mode with 8MHz SOSC, 80 MHz PLL*/
+ if (RUNmode_is_80MHz()) return; /* Dividers and source already in place */
  IP_SCG->RCCR=SCG_RCCR_SCS(6) /* PLL as clock source*/
  |SCG_RCCR_DIVCORE(0b01) /* DIVCORE=1, div. by 2: Core clock = 160/2 MHz = 80 MHz*/
  |SCG_RCCR_DIVBUS(0b01) /* DIVBUS=1, div. by 2: bus clock = 40 MHz*/
@@ -44,3 +110,112 @@ void NormalRUNmode_80MHz (void) { /* Change to normal RUN mode with 8MHz SOSC, 8
  while (((IP_SCG->CSR & SCG_CSR_SCS_MASK) >> SCG_CSR_SCS_SHIFT ) != 6) {}
  /* Wait for sys clk src = SPLL */
 }
+
+/* ------------------------------------------------------------------------
+ * Run modes and governor
+ * ------------------------------------------------------------------------ */
+
+static void sysclk_switch(uint32_t rccr) { /* RUN: RCCR applies at once */
+ IP_SCG->RCCR = rccr;
+ while ((IP_SCG->CSR & SCG_CSR_SCS_MASK) != (rccr & SCG_CSR_SCS_MASK)) {}
+}
+static void runm_switch(uint32_t runm, uint32_t pmstat) {
+ IP_SMC->PMCTRL = (IP_SMC->PMCTRL & ~SMC_PMCTRL_RUNM_MASK) | SMC_PMCTRL_RUNM(runm);
+ while (IP_SMC->PMSTAT != pmstat) {} /* SCG takes HCCR/VCCR/RCCR on entry */
+}
+static void run_from_hsrun(void) {
+ runm_switch(SMC_RUNM_RUN, SMC_PMSTAT_RUN); /* RCCR still holds FIRC 48 MHz */
+ SPLL_init_160MHz();
+ NormalRUNmode_80MHz();
+}
+static void run_from_vlpr(void) {
+ runm_switch(SMC_RUNM_RUN, SMC_PMSTAT_RUN); /* RCCR still holds SIRC 8 MHz */
+ IP_SCG->FIRCCSR = SCG_FIRCCSR_FIRCEN_MASK;
+ while(!(IP_SCG->FIRCCSR & SCG_FIRCCSR_FIRCVLD_MASK));
+ SOSC_init_8MHz();
+ SPLL_init_160MHz();
+ NormalRUNmode_80MHz();
+}
+static void hsrun_from_run(void) {
+ sysclk_switch(FIRC_CSR_48MHZ); /* SPLL cannot be relocked while it is SYS_CLK */
+ spll_start(SPLL_CFG_112MHZ);
+ IP_SCG->HCCR = HSRUN_CSR_112MHZ;
+ runm_switch(SMC_RUNM_HSRUN, SMC_PMSTAT_HSRUN);
+}
+static void vlpr_from_run(void) {
+ IP_SCG->VCCR = VLPR_CSR_4MHZ;
+ sysclk_switch(SIRC_CSR_8MHZ);
+ /* Only SIRC may run in VLPR */
+ while(IP_SCG->SPLLCSR & SCG_SPLLCSR_LK_MASK);
+ IP_SCG->SPLLCSR = 0U;
+ while(IP_SCG->FIRCCSR & SCG_FIRCCSR_LK_MASK);
+ IP_SCG->FIRCCSR = 0U;
+ while(IP_SCG->SOSCCSR & SCG_SOSCCSR_LK_MASK);
+ IP_SCG->SOSCCSR = 0U;
+ runm_switch(SMC_RUNM_VLPR, SMC_PMSTAT_VLPR);
+}
+static void clock_notify(clock_notify_ev_t ev) {
+ uint32_t i;
+ const clock_freq_t *freq = Clock_GetFreq();
+ for (i = 0U; i < CLOCK_NOTIFY_MAX; i++) {
+  if (clk_notify[i] != 0) clk_notify[i](ev, freq);
+ }
+}
+bool Clock_SetMode(clock_mode_t mode) {
+ if ((uint32_t)mode >= (uint32_t)CLOCK_MODE_COUNT) return false;
+ if (mode == clk_mode) return true;
+ if (!clk_modes_allowed) {
+  IP_SMC->PMPROT = SMC_PMPROT_AHSRUN_MASK | SMC_PMPROT_AVLP_MASK;
+  clk_modes_allowed = true;
+ }
+ clock_notify(CLOCK_NOTIFY_BEFORE);
+ /* HSRUN <-> VLPR goes through RUN */
+ if (clk_mode == CLOCK_MODE_HSRUN) run_from_hsrun();
+ if (clk_mode == CLOCK_MODE_VLPR) run_from_vlpr();
+ if (mode == CLOCK_MODE_HSRUN) hsrun_from_run();
+ if (mode == CLOCK_MODE_VLPR) vlpr_from_run();
+ clk_mode = mode;
+ gov_switches++;
+ clock_notify(CLOCK_NOTIFY_AFTER);
+ return true;
+}
+clock_mode_t Clock_GetMode(void) {
+ return clk_mode;
+}
+const clock_freq_t *Clock_GetFreq(void) { /* Live registers (clock_tree.h) */
+ clk_freq.core_hz     = ClockTree_GetHz(CLOCK_TREE_CORE);
+ clk_freq.bus_hz      = ClockTree_GetHz(CLOCK_TREE_BUS);
+ clk_freq.slow_hz     = ClockTree_GetHz(CLOCK_TREE_SLOW);
+ clk_freq.splldiv2_hz = ClockTree_GetHz(CLOCK_TREE_SPLLDIV2);
+ clk_freq.soscdiv2_hz = ClockTree_GetHz(CLOCK_TREE_SOSCDIV2);
+ return &clk_freq;
+}
+bool Clock_RegisterNotify(clock_notify_t fn) {
+ uint32_t i;
+ for (i = 0U; i < CLOCK_NOTIFY_MAX; i++) {
+  if (clk_notify[i] == fn) return true;
+ }
+ for (i = 0U; i < CLOCK_NOTIFY_MAX; i++) {
+  if (clk_notify[i] == 0) {
+   clk_notify[i] = fn;
+   return true;
+  }
+ }
+ return false;
+}
+bool Clock_GovernorSet(clock_phase_t phase, clock_mode_t mode) {
+ if (((uint32_t)phase >= (uint32_t)CLOCK_PHASE_COUNT) || ((uint32_t)mode >= (uint32_t)CLOCK_MODE_COUNT)) {
+  return false;
+ }
+ if ((phase == CLOCK_PHASE_FLASH) && (mode != CLOCK_MODE_RUN)) {
+  return false;
+ }
+ gov_mode[phase] = mode;
+ return true;
+}
+void Clock_GovernorPhase(clock_phase_t phase) {
+ if ((uint32_t)phase < (uint32_t)CLOCK_PHASE_COUNT) (void)Clock_SetMode(gov_mode[phase]);
+}
+uint32_t Clock_GovernorSwitches(void) {
+ return gov_switches;
+}
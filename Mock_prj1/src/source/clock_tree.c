@@ -0,0 +1,189 @@
+/**
+ * @file    clock_tree.c
+ * @brief   Clock tree queries from the live SCG/PCC registers and
+ *          reference-counted PCC clock gating.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "clock_tree.h"
+#include "S32K144.h"
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define FIELD(reg, name)    (((reg) & name##_MASK) >> name##_SHIFT)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+/** @brief Users of each PCC slot. */
+static uint8_t pcc_users[PCC_PCCn_COUNT];
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Convert an SCG xxxDIVn field to the output frequency (0 = disabled).
+ */
+static uint32_t div_output(uint32_t src_hz, uint32_t field)
+{
+    return (field == 0U) ? 0U : (src_hz >> (field - 1U));
+}
+
+static uint32_t sosc_hz(void)
+{
+    return ((IP_SCG->SOSCCSR & SCG_SOSCCSR_SOSCVLD_MASK) != 0U) ? CLOCK_TREE_SOSC_HZ : 0U;
+}
+
+static uint32_t sirc_hz(void)
+{
+    if ((IP_SCG->SIRCCSR & SCG_SIRCCSR_SIRCVLD_MASK) == 0U) {
+        return 0U;
+    }
+    return ((IP_SCG->SIRCCFG & SCG_SIRCCFG_RANGE_MASK) != 0U) ? CLOCK_TREE_SIRC_HI_HZ
+                                                             : CLOCK_TREE_SIRC_LO_HZ;
+}
+
+static uint32_t firc_hz(void)
+{
+    return ((IP_SCG->FIRCCSR & SCG_FIRCCSR_FIRCVLD_MASK) != 0U) ? CLOCK_TREE_FIRC_HZ : 0U;
+}
+
+static uint32_t spll_hz(void)
+{
+    uint32_t cfg = IP_SCG->SPLLCFG;
+
+    if ((IP_SCG->SPLLCSR & SCG_SPLLCSR_SPLLVLD_MASK) == 0U) {
+        return 0U;
+    }
+    /* SOSC / (PREDIV + 1) * (MULT + 16) is the VCO, SPLL_CLK is VCO / 2 */
+    return (sosc_hz() / (FIELD(cfg, SCG_SPLLCFG_PREDIV) + 1U))
+           * (FIELD(cfg, SCG_SPLLCFG_MULT) + 16U) / 2U;
+}
+
+static uint32_t core_hz(void)
+{
+    uint32_t csr = IP_SCG->CSR;
+    uint32_t src;
+
+    switch (FIELD(csr, SCG_CSR_SCS)) {
+    case 1U:  src = sosc_hz(); break;
+    case 2U:  src = sirc_hz(); break;
+    case 3U:  src = firc_hz(); break;
+    case 6U:  src = spll_hz(); break;
+    default:  src = 0U;        break;
+    }
+    return src / (FIELD(csr, SCG_CSR_DIVCORE) + 1U);
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                 Public API                                  */
+/* -------------------------------------------------------------------------- */
+
+uint32_t ClockTree_GetHz(clock_tree_id_t id)
+{
+    switch (id) {
+    case CLOCK_TREE_SOSC:     return sosc_hz();
+    case CLOCK_TREE_SIRC:     return sirc_hz();
+    case CLOCK_TREE_FIRC:     return firc_hz();
+    case CLOCK_TREE_SPLL:     return spll_hz();
+    case CLOCK_TREE_SOSCDIV1: return div_output(sosc_hz(), FIELD(IP_SCG->SOSCDIV, SCG_SOSCDIV_SOSCDIV1));
+    case CLOCK_TREE_SOSCDIV2: return div_output(sosc_hz(), FIELD(IP_SCG->SOSCDIV, SCG_SOSCDIV_SOSCDIV2));
+    case CLOCK_TREE_SIRCDIV1: return div_output(sirc_hz(), FIELD(IP_SCG->SIRCDIV, SCG_SIRCDIV_SIRCDIV1));
+    case CLOCK_TREE_SIRCDIV2: return div_output(sirc_hz(), FIELD(IP_SCG->SIRCDIV, SCG_SIRCDIV_SIRCDIV2));
+    case CLOCK_TREE_FIRCDIV1: return div_output(firc_hz(), FIELD(IP_SCG->FIRCDIV, SCG_FIRCDIV_FIRCDIV1));
+    case CLOCK_TREE_FIRCDIV2: return div_output(firc_hz(), FIELD(IP_SCG->FIRCDIV, SCG_FIRCDIV_FIRCDIV2));
+    case CLOCK_TREE_SPLLDIV1: return div_output(spll_hz(), FIELD(IP_SCG->SPLLDIV, SCG_SPLLDIV_SPLLDIV1));
+    case CLOCK_TREE_SPLLDIV2: return div_output(spll_hz(), FIELD(IP_SCG->SPLLDIV, SCG_SPLLDIV_SPLLDIV2));
+    case CLOCK_TREE_CORE:     return core_hz();
+    case CLOCK_TREE_BUS:      return core_hz() / (FIELD(IP_SCG->CSR, SCG_CSR_DIVBUS) + 1U);
+    case CLOCK_TREE_SLOW:     return core_hz() / (FIELD(IP_SCG->CSR, SCG_CSR_DIVSLOW) + 1U);
+    case CLOCK_TREE_LPO:      return CLOCK_TREE_LPO_HZ;
+    default:                  return 0U;
+    }
+}
+
+uint32_t ClockTree_PccHz(uint32_t pcc_index)
+{
+    uint32_t pcc;
+
+    if (pcc_index >= PCC_PCCn_COUNT) {
+        return 0U;
+    }
+    pcc = IP_PCC->PCCn[pcc_index];
+    if ((pcc & PCC_PCCn_CGC_MASK) == 0U) {
+        return 0U;
+    }
+    switch (FIELD(pcc, PCC_PCCn_PCS)) {
+    case CLOCK_TREE_PCS_SOSCDIV2: return ClockTree_GetHz(CLOCK_TREE_SOSCDIV2);
+    case CLOCK_TREE_PCS_SIRCDIV2: return ClockTree_GetHz(CLOCK_TREE_SIRCDIV2);
+    case CLOCK_TREE_PCS_FIRCDIV2: return ClockTree_GetHz(CLOCK_TREE_FIRCDIV2);
+    case CLOCK_TREE_PCS_SPLLDIV2: return ClockTree_GetHz(CLOCK_TREE_SPLLDIV2);
+    case CLOCK_TREE_PCS_LPO:      return CLOCK_TREE_LPO_HZ;
+    default:                      return 0U;
+    }
+}
+
+bool ClockTree_PccAcquire(uint32_t pcc_index, uint32_t pcs)
+{
+    uint32_t pcc;
+
+    if (pcc_index >= PCC_PCCn_COUNT) {
+        return false;
+    }
+    pcc = IP_PCC->PCCn[pcc_index];
+    if (pcc_users[pcc_index] == 0U) {
+        /* PCS only changes with CGC = 0 */
+        if ((pcs != CLOCK_TREE_PCS_NONE) && (FIELD(pcc, PCC_PCCn_PCS) != pcs)) {
+            pcc &= ~(PCC_PCCn_CGC_MASK | PCC_PCCn_PCS_MASK);
+            IP_PCC->PCCn[pcc_index] = pcc;
+            IP_PCC->PCCn[pcc_index] = pcc | PCC_PCCn_PCS(pcs);
+        }
+        IP_PCC->PCCn[pcc_index] |= PCC_PCCn_CGC_MASK;
+    } else if ((pcs != CLOCK_TREE_PCS_NONE) && (FIELD(pcc, PCC_PCCn_PCS) != pcs)) {
+        return false;
+    } else if (pcc_users[pcc_index] == UINT8_MAX) {
+        return false;
+    } else {
+        /* Shared with the same source */
+    }
+    pcc_users[pcc_index]++;
+    return true;
+}
+
+void ClockTree_PccRelease(uint32_t pcc_index)
+{
+    if ((pcc_index >= PCC_PCCn_COUNT) || (pcc_users[pcc_index] == 0U)) {
+        return;
+    }
+    pcc_users[pcc_index]--;
+    if (pcc_users[pcc_index] == 0U) {
+        IP_PCC->PCCn[pcc_index] &= ~PCC_PCCn_CGC_MASK;
+    }
+}
+
+bool ClockTree_PccSetSource(uint32_t pcc_index, uint32_t pcs)
+{
+    uint32_t pcc;
+
+    if ((pcc_index >= PCC_PCCn_COUNT) || (pcc_users[pcc_index] > 1U)) {
+        return false;
+    }
+    pcc = IP_PCC->PCCn[pcc_index] & ~(PCC_PCCn_CGC_MASK | PCC_PCCn_PCS_MASK);
+    IP_PCC->PCCn[pcc_index] = pcc;
+    IP_PCC->PCCn[pcc_index] = pcc | PCC_PCCn_PCS(pcs) |
+                              ((pcc_users[pcc_index] != 0U) ? PCC_PCCn_CGC_MASK : 0U);
+    return true;
+}
+
+uint32_t ClockTree_PccUsers(uint32_t pcc_index)
+{
+    return (pcc_index < PCC_PCCn_COUNT) ? pcc_users[pcc_index] : 0U;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file    dwt_perf.c
+ * @brief   Cycle-accurate instrumentation based on the Cortex-M4 DWT cycle counter.
+ *
+ * CYCCNT is a free running 32-bit counter (wraps after ~53 s at 80 MHz).
+ * Phase samples use unsigned differences and are therefore wrap-safe as long
+ * as a single phase is shorter than one wrap period; marks are absolute and
+ * only meaningful during the first wrap period after DWT_Perf_Init().
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "dwt_perf.h"
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+/** @brief Mark timestamps (0 = not reached yet). */
+static uint32_t perf_marks[PERF_MARK_COUNT];
+
+/** @brief Phase accumulators. */
+static perf_acc_t perf_phases[PERF_PH_COUNT];
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+void DWT_Perf_Init(void)
+{
+    uint32_t i;
+
+    DWT_PERF_DEMCR |= DWT_PERF_DEMCR_TRCENA_MASK;
+    DWT_PERF->CYCCNT = 0U;
+    DWT_PERF->CTRL  |= DWT_PERF_CTRL_CYCCNTENA;
+
+    for (i = 0U; i < (uint32_t)PERF_MARK_COUNT; i++) {
+        perf_marks[i] = 0U;
+    }
+    for (i = 0U; i < (uint32_t)PERF_PH_COUNT; i++) {
+        perf_phases[i].count = 0U;
+        perf_phases[i].min   = 0xFFFFFFFFU;
+        perf_phases[i].max   = 0U;
+        perf_phases[i].sum   = 0U;
+    }
+}
+
+void DWT_Perf_Mark(perf_mark_t mark)
+{
+    uint32_t now = DWT_PERF_NOW();
+
+    if ((mark < PERF_MARK_COUNT) && (perf_marks[mark] == 0U)) {
+        perf_marks[mark] = (now != 0U) ? now : 1U;
+    }
+}
+
+void DWT_Perf_Add(perf_phase_t phase, uint32_t start)
+{
+    DWT_Perf_AddCycles(phase, DWT_PERF_NOW() - start);
+}
+
+void DWT_Perf_AddCycles(perf_phase_t phase, uint32_t cycles)
+{
+    perf_acc_t *acc;
+
+    if (phase >= PERF_PH_COUNT) {
+        return;
+    }
+
+    acc = &perf_phases[phase];
+    acc->count++;
+    acc->sum += cycles;
+    if (cycles < acc->min) {
+        acc->min = cycles;
+    }
+    if (cycles > acc->max) {
+        acc->max = cycles;
+    }
+}
+
+const perf_acc_t *DWT_Perf_GetPhase(perf_phase_t phase)
+{
+    return (phase < PERF_PH_COUNT) ? &perf_phases[phase] : (const perf_acc_t *)0;
+}
+
+uint32_t DWT_Perf_GetMark(perf_mark_t mark)
+{
+    return (mark < PERF_MARK_COUNT) ? perf_marks[mark] : 0U;
+}
+
+void DWT_Perf_Dump(perf_write_t write, uint32_t core_hz)
+{
+    uint32_t hdr[3];
+    uint32_t rec[5];
+    uint32_t i;
+
+    if (write == 0) {
+        return;
+    }
+
+    hdr[0] = DWT_PERF_DUMP_MAGIC;
+    hdr[1] = (uint32_t)DWT_PERF_DUMP_VERSION
+           | ((uint32_t)PERF_MARK_COUNT << 8)
+           | ((uint32_t)PERF_PH_COUNT   << 16);
+    hdr[2] = core_hz;
+    write(hdr, sizeof(hdr));
+    write(perf_marks, sizeof(perf_marks));
+
+    for (i = 0U; i < (uint32_t)PERF_PH_COUNT; i++) {
+        rec[0] = perf_phases[i].count;
+        rec[1] = perf_phases[i].min;
+        rec[2] = perf_phases[i].max;
+        rec[3] = (uint32_t)(perf_phases[i].sum);
+        rec[4] = (uint32_t)(perf_phases[i].sum >> 32);
+        write(rec, sizeof(rec));
+    }
+}
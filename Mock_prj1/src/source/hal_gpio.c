@@ -172,11 +172,11 @@ int32_t HAL_GPIO_SetTrigger(HAL_GPIO_Port_t port, uint8_t pin,
 
     /* Enable NVIC interrupt for corresponding port */
     switch (port) {
-        case HAL_GPIO_PORT_A: NVIC_EnableIRQ(PORTA_IRQn); break;
-        case HAL_GPIO_PORT_B: NVIC_EnableIRQ(PORTB_IRQn); break;
-        case HAL_GPIO_PORT_C: NVIC_EnableIRQ(PORTC_IRQn); break;
-        case HAL_GPIO_PORT_D: NVIC_EnableIRQ(PORTD_IRQn); break;
-        case HAL_GPIO_PORT_E: NVIC_EnableIRQ(PORTE_IRQn); break;
+        case HAL_GPIO_PORT_A: NVIC_SetPriority(PORTA_IRQn, NVIC_PRIO_PORT); NVIC_EnableIRQ(PORTA_IRQn); break;
+        case HAL_GPIO_PORT_B: NVIC_SetPriority(PORTB_IRQn, NVIC_PRIO_PORT); NVIC_EnableIRQ(PORTB_IRQn); break;
+        case HAL_GPIO_PORT_C: NVIC_SetPriority(PORTC_IRQn, NVIC_PRIO_PORT); NVIC_EnableIRQ(PORTC_IRQn); break;
+        case HAL_GPIO_PORT_D: NVIC_SetPriority(PORTD_IRQn, NVIC_PRIO_PORT); NVIC_EnableIRQ(PORTD_IRQn); break;
+        case HAL_GPIO_PORT_E: NVIC_SetPriority(PORTE_IRQn, NVIC_PRIO_PORT); NVIC_EnableIRQ(PORTE_IRQn); break;
         default: break;
     }
 
@@ -24,6 +24,9 @@
 
 #include "hal_usart.h"
 #include "Driver_NVIC.h"
+#include "clock_and_mode.h"
+#include "clock_tree.h"
+#include "boot_trace.h"
 
 /* -------------------------------------------------------------------------- */
 /*                              Private Variables                              */
@@ -38,6 +41,12 @@ static volatile uint8_t *rx_ptr[3] = {NULL};
 /** @brief Remaining bytes to receive for each channel. */
 static volatile uint32_t rx_num[3] = {0};
 
+/** @brief Receive error counters for each channel (updated in the ISR). */
+static volatile HAL_USART_Errors_t rx_err[3];
+
+/** @brief Configured baud rate for each channel (0: not configured). */
+static uint32_t usart_baud[3];
+
 /* -------------------------------------------------------------------------- */
 /*                               Private Macros                                */
 /* -------------------------------------------------------------------------- */
@@ -51,6 +60,63 @@ static volatile uint32_t rx_num[3] = {0};
 /** @brief Get IRQ number from channel enum. */
 #define GET_IRQn(ch)   ((ch)==HAL_LPUART0 ? LPUART0_RxTx_IRQn : (ch)==HAL_LPUART1 ? LPUART1_RxTx_IRQn : LPUART2_RxTx_IRQn)
 
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Program the baud divisor; BAUD is written with TE and RE cleared.
+ */
+static void usart_set_baud(HAL_USART_Channel_t ch)
+{
+    LPUART_Type *uart = GET_UART(ch);
+    uint32_t periph_clk = ClockTree_PccHz(GET_PCC_INDEX(ch));
+    uint32_t baud = usart_baud[ch];
+    uint32_t osr = 15;               /* 16x oversampling */
+    uint32_t sbr;
+    uint32_t ctrl;
+
+    if ((periph_clk == 0U) || (baud == 0U)) {
+        return;                      /* Clock off (VLPR): keep the old divisor */
+    }
+    sbr = (periph_clk + ((osr + 1) * baud / 2)) / ((osr + 1) * baud);
+    if ((uart->BAUD & (LPUART_BAUD_OSR_MASK | LPUART_BAUD_SBR_MASK)) ==
+        (LPUART_BAUD_OSR(osr) | LPUART_BAUD_SBR(sbr))) {
+        return;                      /* Same divisor: keep RE, no character lost */
+    }
+
+    ctrl = uart->CTRL;
+    uart->CTRL = ctrl & ~(LPUART_CTRL_TE_MASK | LPUART_CTRL_RE_MASK);
+    uart->BAUD = (uart->BAUD & ~(LPUART_BAUD_OSR_MASK | LPUART_BAUD_SBR_MASK)) |
+                 LPUART_BAUD_OSR(osr) | LPUART_BAUD_SBR(sbr);
+    uart->CTRL = ctrl;
+}
+
+/**
+ * @brief Run mode switch: let the last character out before SPLLDIV2
+ *        stops, recompute the divisors with the new frequencies.
+ */
+static void usart_clock_notify(clock_notify_ev_t ev, const clock_freq_t *freq)
+{
+    uint32_t ch;
+
+    (void)freq;
+    for (ch = 0U; ch <= (uint32_t)HAL_LPUART2; ch++) {
+        if ((usart_baud[ch] == 0U) ||
+            ((IP_PCC->PCCn[GET_PCC_INDEX(ch)] & PCC_PCCn_CGC_MASK) == 0U)) {
+            continue;               /* Not configured, or clock gated */
+        }
+        if (ev == CLOCK_NOTIFY_BEFORE) {
+            while (((GET_UART(ch)->CTRL & LPUART_CTRL_TE_MASK) != 0U) &&
+                   ((GET_UART(ch)->STAT & LPUART_STAT_TC_MASK) == 0U)) {
+                /* Wait for transmission complete */
+            }
+        } else {
+            usart_set_baud((HAL_USART_Channel_t)ch);
+        }
+    }
+}
+
 /* -------------------------------------------------------------------------- */
 /*                               HAL API Functions                             */
 /* -------------------------------------------------------------------------- */
@@ -77,7 +143,11 @@ void HAL_USART_SetClockSource(HAL_USART_Channel_t ch, uint8_t pcs)
 {
     if (ch > HAL_LPUART2) return;
     if (pcs > 7) pcs = 6; /* SPLL_DIV2 default */
-    IP_PCC->PCCn[GET_PCC_INDEX(ch)] = PCC_PCCn_PCS(pcs) | PCC_PCCn_CGC_MASK;
+    if (ClockTree_PccUsers(GET_PCC_INDEX(ch)) == 0U) {
+        (void)ClockTree_PccAcquire(GET_PCC_INDEX(ch), pcs);
+    } else {
+        (void)ClockTree_PccSetSource(GET_PCC_INDEX(ch), pcs);
+    }
 }
 
 /**
@@ -90,19 +160,19 @@ void HAL_USART_InitPins(HAL_USART_Channel_t ch)
     switch (ch)
     {
     case HAL_LPUART0:
-        IP_PCC->PCCn[PCC_PORTE_INDEX] |= PCC_PCCn_CGC_MASK;
+        (void)ClockTree_PccAcquire(PCC_PORTE_INDEX, CLOCK_TREE_PCS_NONE);
         IP_PORTE->PCR[0] = PORT_PCR_MUX(3); /* PTE0 - TX */
         IP_PORTE->PCR[1] = PORT_PCR_MUX(3); /* PTE1 - RX */
         break;
 
     case HAL_LPUART1:
-        IP_PCC->PCCn[PCC_PORTC_INDEX] |= PCC_PCCn_CGC_MASK;
+        (void)ClockTree_PccAcquire(PCC_PORTC_INDEX, CLOCK_TREE_PCS_NONE);
         IP_PORTC->PCR[6] = PORT_PCR_MUX(2); /* PTC6 - TX */
         IP_PORTC->PCR[7] = PORT_PCR_MUX(2); /* PTC7 - RX */
         break;
 
     case HAL_LPUART2:
-        IP_PCC->PCCn[PCC_PORTD_INDEX] |= PCC_PCCn_CGC_MASK;
+        (void)ClockTree_PccAcquire(PCC_PORTD_INDEX, CLOCK_TREE_PCS_NONE);
         IP_PORTD->PCR[15] = PORT_PCR_MUX(3); /* PTD15 - TX */
         IP_PORTD->PCR[16] = PORT_PCR_MUX(3); /* PTD16 - RX */
         break;
@@ -119,6 +189,7 @@ void HAL_USART_InitPins(HAL_USART_Channel_t ch)
  */
 void HAL_USART_EnableIRQ(HAL_USART_Channel_t ch)
 {
+    NVIC_SetPriority(GET_IRQn(ch), NVIC_PRIO_LPUART);
     NVIC_ClearPendingIRQ(GET_IRQn(ch));
     NVIC_EnableIRQ(GET_IRQn(ch));
 }
@@ -149,23 +220,55 @@ void HAL_USART_Config(HAL_USART_Channel_t ch, uint32_t control, HAL_USART_Baudra
     LPUART_Type *uart = GET_UART(ch);
     uart->CTRL = 0; /* Disable before configuration */
 
-    uint32_t periph_clk = 40000000U; /* SPLL_DIV2_CLK */
-    uint32_t osr = 15;               /* 16x oversampling */
-    uint32_t sbr = (periph_clk + ((osr + 1) * baud / 2)) / ((osr + 1) * baud);
-
-    uart->BAUD = LPUART_BAUD_OSR(osr) | LPUART_BAUD_SBR(sbr);
+    uart->BAUD = 0U;
+    usart_baud[ch] = (uint32_t)baud;
+    usart_set_baud(ch);
+    (void)Clock_RegisterNotify(usart_clock_notify);
     uart->CTRL = LPUART_CTRL_TE_MASK | LPUART_CTRL_RE_MASK | LPUART_CTRL_RIE_MASK;
 
     /* Clear status flags */
     uart->STAT |= (LPUART_STAT_OR_MASK | LPUART_STAT_NF_MASK |
                    LPUART_STAT_FE_MASK | LPUART_STAT_PF_MASK);
 
+    NVIC_SetPriority(GET_IRQn(ch), NVIC_PRIO_LPUART);
     NVIC_ClearPendingIRQ(GET_IRQn(ch));
     NVIC_EnableIRQ(GET_IRQn(ch));
 
     (void)control; /* reserved parameter for compatibility */
 }
 
+/**
+ * @brief Switch a configured channel to RS-485 multi-drop operation.
+ *
+ * - CTRL[M] = 1: 9-bit frames, the 9th bit marks an address frame.
+ * - BAUD[MAEN1/MAEN2] with MATCH[MA1] = node, MATCH[MA2] = broadcast: only
+ *   a matching address frame, and the data frames after it, set RDRF.
+ *   MA1/MA2 hold the address mark as well (bit 8).
+ * - MODIR[TXRTSE/TXRTSPOL]: RTS is asserted (high) while transmitting, to
+ *   drive the DE input of the RS-485 transceiver. The RTS pin mux is part
+ *   of the board setup.
+ *
+ * Transmitted frames have the 9th bit clear (data): nodes never address.
+ *
+ * @param[in] ch         USART channel, already configured by HAL_USART_Config().
+ * @param[in] node       Own address, HAL_USART_NODE_MIN..0xFE.
+ * @param[in] broadcast  Broadcast address (HAL_USART_BROADCAST).
+ */
+void HAL_USART_ConfigMultidrop(HAL_USART_Channel_t ch, uint8_t node, uint8_t broadcast)
+{
+    if (ch > HAL_LPUART2) return;
+    LPUART_Type *uart = GET_UART(ch);
+    uint32_t ctrl = uart->CTRL;
+
+    /* Frame format and match registers change with TE/RE cleared */
+    uart->CTRL  = ctrl & ~(LPUART_CTRL_TE_MASK | LPUART_CTRL_RE_MASK);
+    uart->MATCH = LPUART_MATCH_MA1(HAL_USART_ADDRESS_MARK | node) |
+                  LPUART_MATCH_MA2(HAL_USART_ADDRESS_MARK | broadcast);
+    uart->BAUD |= LPUART_BAUD_MAEN1_MASK | LPUART_BAUD_MAEN2_MASK;
+    uart->MODIR = LPUART_MODIR_TXRTSE_MASK | LPUART_MODIR_TXRTSPOL_MASK;
+    uart->CTRL  = ctrl | LPUART_CTRL_M_MASK;
+}
+
 /**
  * @brief Send data (blocking mode).
  *
@@ -229,11 +332,47 @@ void HAL_USART_IRQHandler(HAL_USART_Channel_t ch)
             usart_cb[ch](ARM_USART_EVENT_RECEIVE_COMPLETE);
     }
 
-    /* Clear error flags */
+    HAL_USART_CountErrors(ch, stat);
+}
+
+/**
+ * @brief Count and clear the receive error flags of a STAT value.
+ *
+ * For handlers installed in place of LPUARTx_RxTx_IRQHandler() (see
+ * NVIC_InstallHandler()), so HAL_USART_GetErrors() keeps counting.
+ *
+ * @param[in] ch    USART channel.
+ * @param[in] stat  STAT as read by the handler.
+ */
+void HAL_USART_CountErrors(HAL_USART_Channel_t ch, uint32_t stat)
+{
+    if (ch > HAL_LPUART2) return;
+    LPUART_Type *uart = GET_UART(ch);
+
+    /* Count and clear error flags */
+    if (stat & LPUART_STAT_OR_MASK) rx_err[ch].overrun++;
+    if (stat & LPUART_STAT_NF_MASK) rx_err[ch].noise++;
+    if (stat & LPUART_STAT_FE_MASK) rx_err[ch].framing++;
+    if (stat & LPUART_STAT_PF_MASK) rx_err[ch].parity++;
     uart->STAT |= (LPUART_STAT_OR_MASK | LPUART_STAT_NF_MASK |
                    LPUART_STAT_FE_MASK | LPUART_STAT_PF_MASK);
 }
 
+/**
+ * @brief Get a snapshot of the receive error counters of a channel.
+ *
+ * @param[in]  ch   USART channel.
+ * @param[out] err  Destination for the counters.
+ */
+void HAL_USART_GetErrors(HAL_USART_Channel_t ch, HAL_USART_Errors_t *err)
+{
+    if (ch > HAL_LPUART2 || err == NULL) return;
+    err->overrun = rx_err[ch].overrun;
+    err->noise   = rx_err[ch].noise;
+    err->framing = rx_err[ch].framing;
+    err->parity  = rx_err[ch].parity;
+}
+
 /* -------------------------------------------------------------------------- */
 /*                               IRQ Definitions                              */
 /* -------------------------------------------------------------------------- */
@@ -241,14 +380,29 @@ void HAL_USART_IRQHandler(HAL_USART_Channel_t ch)
 /**
  * @brief LPUART0 interrupt handler.
  */
-void LPUART0_RxTx_IRQHandler(void) { HAL_USART_IRQHandler(HAL_LPUART0); }
+void LPUART0_RxTx_IRQHandler(void)
+{
+    TRACE_ISR_ENTER(LPUART0_RxTx_IRQn);
+    HAL_USART_IRQHandler(HAL_LPUART0);
+    TRACE_ISR_EXIT(LPUART0_RxTx_IRQn);
+}
 
 /**
  * @brief LPUART1 interrupt handler.
  */
-void LPUART1_RxTx_IRQHandler(void) { HAL_USART_IRQHandler(HAL_LPUART1); }
+void LPUART1_RxTx_IRQHandler(void)
+{
+    TRACE_ISR_ENTER(LPUART1_RxTx_IRQn);
+    HAL_USART_IRQHandler(HAL_LPUART1);
+    TRACE_ISR_EXIT(LPUART1_RxTx_IRQn);
+}
 
 /**
  * @brief LPUART2 interrupt handler.
  */
-void LPUART2_RxTx_IRQHandler(void) { HAL_USART_IRQHandler(HAL_LPUART2); }
+void LPUART2_RxTx_IRQHandler(void)
+{
+    TRACE_ISR_ENTER(LPUART2_RxTx_IRQn);
+    HAL_USART_IRQHandler(HAL_LPUART2);
+    TRACE_ISR_EXIT(LPUART2_RxTx_IRQn);
+}
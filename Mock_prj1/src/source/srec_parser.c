@@ -7,6 +7,22 @@
 
 
 #include "srec_parser.h"
+#include "dwt_perf.h"
+#include <string.h>
+
+/* Two hex digits at hex[0], hex[1] (hex_to_byte() returns 0 for both "00" and junk) */
+static int is_hex_pair(const char *hex)
+{
+    int i;
+    char c;
+
+    for (i = 0; i < 2; i++) {
+        c = hex[i];
+        if (!((c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f')))
+            return 0;
+    }
+    return 1;
+}
 
 
 unsigned char hex_to_byte(const char *hex)
@@ -43,12 +59,15 @@ unsigned char hex_to_byte(const char *hex)
 }
 
 int parse_srec_line(const char *line, srec_record_t *rec) {
+    PERF_BEGIN(perf_t0);
     /*type of srec*/
     int type ;
     /*length of addr*/
     int addr_len ;
     /* byte count*/
-    uint8_t count = hex_to_byte(line + 2);
+    uint8_t count ;
+    /* characters in the line */
+    size_t line_len = strlen(line);
     /*length of data*/
     int data_len ;
     /*position of srec*/
@@ -56,7 +75,10 @@ int parse_srec_line(const char *line, srec_record_t *rec) {
     /* caclulate ByteCount + Address bytes + Data bytes + Checksum*/
     uint8_t sum = 0 ;
     /*1. check first character */
-    if (line[0] != 'S') return -1;
+    if (line[0] != 'S') {
+        PERF_END(PERF_PH_PARSE, perf_t0);
+        return -1;
+    }
 
     /*2. check type */
     type = line[1] - '0';
@@ -67,7 +89,25 @@ int parse_srec_line(const char *line, srec_record_t *rec) {
         case 0: case 1: case 5: case 9: addr_len = 2; break;
         case 2: case 8: addr_len = 3; break;
         case 3: case 7: addr_len = 4; break;
-        default: return -2;
+        default: PERF_END(PERF_PH_PARSE, perf_t0); return -2;
+    }
+
+    /*3b. check byte count: address and checksum must fit, and the line must
+     *    hold every byte it counts ("S" type count + 2 digits per byte) */
+    if (line_len < 4 || !is_hex_pair(line + 2)) {
+        PERF_END(PERF_PH_PARSE, perf_t0);
+        return -3;
+    }
+    count = hex_to_byte(line + 2);
+    if (count < addr_len + 1 || line_len < 4 + (size_t)count * 2) {
+        PERF_END(PERF_PH_PARSE, perf_t0);
+        return -3;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!is_hex_pair(line + 4 + i * 2)) {
+            PERF_END(PERF_PH_PARSE, perf_t0);
+            return -3;
+        }
     }
 
     /*4. get address */
@@ -104,5 +144,6 @@ int parse_srec_line(const char *line, srec_record_t *rec) {
     sum += rec->checksum;
     rec->valid = ((sum & 0xFF) == 0xFF);
 
+    PERF_END(PERF_PH_PARSE, perf_t0);
     return 0;
 }
@@ -3,9 +3,11 @@
 #include <stdint.h>
 
 static char srec_buf[SREC_MAX_LINES][SREC_LINE_MAX_LEN];
+static uint16_t srec_len[SREC_MAX_LINES];
 static volatile uint8_t head = 0;
 static volatile uint8_t tail = 0;
 static volatile uint8_t count = 0;
+static volatile uint8_t high_water = 0;
 
 void SREC_QueueInit(void)
 {
@@ -22,41 +24,42 @@ bool SREC_QueueIsEmpty(void)
     return (count == 0);
 }
 
-bool SREC_QueuePush(const char *line)
+bool SREC_QueuePushFrame(const uint8_t *frame, uint16_t len)
 {
     bool res = false;
 
-    if (count < SREC_MAX_LINES)
+    if ((count < SREC_MAX_LINES) && (len < SREC_LINE_MAX_LEN))
     {
-        uint16_t i = 0;
-        while (line[i] != '\0' && i < (SREC_LINE_MAX_LEN - 1))
+        uint16_t i;
+        for (i = 0; i < len; i++)
         {
-            srec_buf[head][i] = line[i];
-            i++;
+            srec_buf[head][i] = (char)frame[i];
         }
-        srec_buf[head][i] = '\0';
+        srec_buf[head][len] = '\0';
+        srec_len[head] = len;
 
         head = (head + 1U) % SREC_MAX_LINES;
         count++;
+        if (count > high_water)
+            high_water = count;
         res = true;
     }
 
     return res;
 }
 
-bool SREC_QueuePop(char *out_line)
+bool SREC_QueuePopFrame(uint8_t *out, uint16_t *len)
 {
     bool res = false;
 
     if (count > 0)
     {
-        uint16_t i = 0;
-        while (srec_buf[tail][i] != '\0' && i < (SREC_LINE_MAX_LEN - 1))
+        uint16_t i;
+        for (i = 0; i <= srec_len[tail]; i++)       /* With the terminator */
         {
-            out_line[i] = srec_buf[tail][i];
-            i++;
+            out[i] = (uint8_t)srec_buf[tail][i];
         }
-        out_line[i] = '\0';
+        *len = srec_len[tail];
 
         tail = (tail + 1U) % SREC_MAX_LINES;
         count--;
@@ -65,3 +68,31 @@ bool SREC_QueuePop(char *out_line)
 
     return res;
 }
+
+bool SREC_QueuePush(const char *line)
+{
+    uint16_t i = 0;
+
+    while (line[i] != '\0' && i < (SREC_LINE_MAX_LEN - 1))
+    {
+        i++;
+    }
+    return SREC_QueuePushFrame((const uint8_t *)line, i);
+}
+
+bool SREC_QueuePop(char *out_line)
+{
+    uint16_t len;
+
+    return SREC_QueuePopFrame((uint8_t *)out_line, &len);
+}
+
+uint8_t SREC_QueueCount(void)
+{
+    return count;
+}
+
+uint8_t SREC_QueueHighWater(void)
+{
+    return high_water;
+}
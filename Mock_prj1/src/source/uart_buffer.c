@@ -13,11 +13,22 @@
 #include "uart_buffer.h"
 #include <stdint.h>
 
+/* The LPUART ISR pushes while a Flash command runs: UART_BufferPush stays in
+ * SRAM (.code_ram). A host build without the vendor headers defines
+ * UART_BUFFER_PORT and keeps the function where it is. */
+#ifndef UART_BUFFER_PORT
+#include "s32_core_cm4.h"
+START_FUNCTION_DECLARATION_RAMSECTION
+bool UART_BufferPush(uint8_t data)
+END_FUNCTION_DECLARATION_RAMSECTION
+#endif
+
 /* ================== STATIC LOCAL VARIABLES ================== */
 static uint8_t uart_rx_buf[UART_QUEUE_SIZE];
 static volatile uint16_t head = 0;
 static volatile uint16_t tail = 0;
 static volatile uint16_t count = 0;
+static volatile uint16_t high_water = 0;
 
 /* ================== FUNCTION IMPLEMENTATION ================== */
 void UART_BufferInit(void)
@@ -43,6 +54,8 @@ bool UART_BufferPush(uint8_t data)
     uart_rx_buf[head] = data;
     head = (head + 1U) % UART_QUEUE_SIZE;
     count++;
+    if (count > high_water)
+        high_water = count;
     return true;
 }
 
@@ -57,3 +70,12 @@ bool UART_BufferPop(uint8_t *data)
     return true;
 }
 
+uint16_t UART_BufferCount(void)
+{
+    return count;
+}
+
+uint16_t UART_BufferHighWater(void)
+{
+    return high_water;
+}
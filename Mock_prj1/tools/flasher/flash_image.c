@@ -0,0 +1,807 @@
+/**
+ * @file    flash_image.c
+ * @brief   Host flasher - image readers (S-record, Intel HEX, binary) and
+ *          record plan.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "flash_image.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define SREC_TEXT_MAX       (600U)          /**< Longest accepted input line */
+#define SREC_DATA_MAX       (255U)
+#define BIN_MAX             (0x00100000U)   /**< 1 MiB, twice the P-Flash */
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Types                                  */
+/* -------------------------------------------------------------------------- */
+
+/** Data record as read, before sorting. */
+typedef struct {
+    uint32_t address;
+    uint32_t len;
+    uint32_t line;
+    uint8_t  data[SREC_DATA_MAX];
+} srec_in_t;
+
+/** Data records of one input file. */
+typedef struct {
+    srec_in_t *recs;
+    size_t     count;
+    size_t     cap;
+} srec_list_t;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static void set_err(char *err, size_t errlen, const char *fmt, ...)
+{
+    va_list ap;
+
+    if ((err == NULL) || (errlen == 0U)) {
+        return;
+    }
+    va_start(ap, fmt);
+    (void)vsnprintf(err, errlen, fmt, ap);
+    va_end(ap);
+}
+
+static int hex_nibble(char c)
+{
+    if ((c >= '0') && (c <= '9')) return c - '0';
+    if ((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+    if ((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+    return -1;
+}
+
+/**
+ * @brief Decode @p n bytes of hex text.
+ * @return 0 on success, -1 on a non-hex character.
+ */
+static int hex_decode(const char *text, uint8_t *out, uint32_t n)
+{
+    uint32_t i;
+    int hi;
+    int lo;
+
+    for (i = 0U; i < n; i++) {
+        hi = hex_nibble(text[2U * i]);
+        lo = hex_nibble(text[(2U * i) + 1U]);
+        if ((hi < 0) || (lo < 0)) {
+            return -1;
+        }
+        out[i] = (uint8_t)((hi << 4) | lo);
+    }
+    return 0;
+}
+
+static int cmp_srec_in(const void *a, const void *b)
+{
+    const srec_in_t *ra = (const srec_in_t *)a;
+    const srec_in_t *rb = (const srec_in_t *)b;
+
+    if (ra->address != rb->address) {
+        return (ra->address < rb->address) ? -1 : 1;
+    }
+    return (ra->line < rb->line) ? -1 : 1;
+}
+
+/**
+ * @brief Append one data record to the last segment or open a new one.
+ */
+static int add_to_image(flash_image_t *img, const srec_in_t *rec)
+{
+    flash_seg_t *seg = (img->count > 0U) ? &img->segs[img->count - 1U] : NULL;
+    uint8_t *data;
+
+    if ((seg != NULL) && ((seg->address + seg->len) == rec->address)) {
+        data = realloc(seg->data, seg->len + rec->len);
+        if (data == NULL) {
+            return -1;
+        }
+        memcpy(&data[seg->len], rec->data, rec->len);
+        seg->data = data;
+        seg->len += rec->len;
+        return 0;
+    }
+
+    seg = realloc(img->segs, (img->count + 1U) * sizeof(*seg));
+    if (seg == NULL) {
+        return -1;
+    }
+    img->segs = seg;
+    seg = &img->segs[img->count];
+    seg->data = malloc(rec->len);
+    if (seg->data == NULL) {
+        return -1;
+    }
+    memcpy(seg->data, rec->data, rec->len);
+    seg->address = rec->address;
+    seg->len     = rec->len;
+    img->count++;
+    return 0;
+}
+
+static srec_in_t *list_add(srec_list_t *list, flash_image_t *img, uint32_t address,
+                            const uint8_t *data, uint32_t len, uint32_t line)
+{
+    srec_in_t *grow;
+    srec_in_t *rec;
+
+    if (list->count == list->cap) {
+        list->cap = (list->cap == 0U) ? 256U : (list->cap * 2U);
+        grow = realloc(list->recs, list->cap * sizeof(*grow));
+        if (grow == NULL) {
+            return NULL;
+        }
+        list->recs = grow;
+    }
+    rec = &list->recs[list->count++];
+    rec->address = address;
+    rec->len     = len;
+    rec->line    = line;
+    memcpy(rec->data, data, len);
+    img->in_records++;
+    img->in_bytes += len;
+    if (((address % FLASH_PHRASE_SIZE) != 0U) || ((len % FLASH_PHRASE_SIZE) != 0U)) {
+        img->in_unaligned++;
+    }
+    return rec;
+}
+
+/**
+ * @brief Sort the records of a file by address and merge them into segments.
+ * @return 0 on success, -1 on overlapping data or out of memory.
+ */
+static int list_to_image(srec_list_t *list, flash_image_t *img, const char *path,
+                         char *err, size_t errlen)
+{
+    const srec_in_t *r = list->recs;
+    size_t i;
+
+    qsort(list->recs, list->count, sizeof(*list->recs), cmp_srec_in);
+    for (i = 0U; i < list->count; i++) {
+        if ((i > 0U) && (r[i].address < (r[i - 1U].address + r[i - 1U].len))) {
+            set_err(err, errlen, "%s:%u: data overlaps line %u at 0x%08X",
+                    path, r[i].line, r[i - 1U].line, r[i].address);
+            return -1;
+        }
+        if ((r[i].len > 0U) && (add_to_image(img, &r[i]) != 0)) {
+            set_err(err, errlen, "out of memory");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 1 if every image byte in the phrase at @p phrase is 0xFF.
+ *
+ * @param[in] s A segment that overlaps the phrase.
+ */
+static int phrase_blank(const flash_image_t *img, size_t s, uint32_t phrase)
+{
+    const flash_seg_t *seg;
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t b;
+
+    /* Small segments before s may share the phrase */
+    while ((s > 0U) && ((img->segs[s - 1U].address + img->segs[s - 1U].len) > phrase)) {
+        s--;
+    }
+    for (; (s < img->count) && (img->segs[s].address < (phrase + FLASH_PHRASE_SIZE)); s++) {
+        seg = &img->segs[s];
+        lo  = (seg->address > phrase) ? seg->address : phrase;
+        hi  = ((seg->address + seg->len) < (phrase + FLASH_PHRASE_SIZE)) ?
+              (seg->address + seg->len) : (phrase + FLASH_PHRASE_SIZE);
+        for (b = lo; b < hi; b++) {
+            if (seg->data[b - seg->address] != 0xFFU) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Close the record under construction and open the next one.
+ */
+static int plan_next(flash_plan_t *plan, size_t *cap, uint32_t address)
+{
+    flash_rec_t *rec;
+
+    if (plan->count == *cap) {
+        *cap = (*cap == 0U) ? 64U : (*cap * 2U);
+        rec = realloc(plan->recs, *cap * sizeof(*rec));
+        if (rec == NULL) {
+            return -1;
+        }
+        plan->recs = rec;
+    }
+    rec = &plan->recs[plan->count++];
+    rec->address = address;
+    rec->len     = FLASH_PHRASE_SIZE;
+    memset(rec->data, 0xFF, sizeof(rec->data));
+    plan->bytes += FLASH_PHRASE_SIZE;
+    return 0;
+}
+
+static size_t format_srec(char *line, char type, uint32_t address,
+                          const uint8_t *data, uint32_t len)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    uint8_t bytes[4U + FLASH_REC_MAX];
+    uint8_t count = (uint8_t)(4U + len + 1U);
+    uint8_t sum = count;
+    size_t pos = 0U;
+    uint32_t i;
+
+    bytes[0] = (uint8_t)(address >> 24);
+    bytes[1] = (uint8_t)(address >> 16);
+    bytes[2] = (uint8_t)(address >> 8);
+    bytes[3] = (uint8_t)address;
+    if (len > 0U) {
+        memcpy(&bytes[4], data, len);
+    }
+
+    line[pos++] = 'S';
+    line[pos++] = type;
+    line[pos++] = digits[count >> 4];
+    line[pos++] = digits[count & 0xFU];
+    for (i = 0U; i < (4U + len); i++) {
+        sum += bytes[i];
+        line[pos++] = digits[bytes[i] >> 4];
+        line[pos++] = digits[bytes[i] & 0xFU];
+    }
+    sum = (uint8_t)~sum;
+    line[pos++] = digits[sum >> 4];
+    line[pos++] = digits[sum & 0xFU];
+    line[pos++] = '\n';
+    line[pos]   = '\0';
+    return pos;
+}
+
+/**
+ * @brief One Intel HEX line ":LLAAAATT<data>CC\n".
+ */
+static size_t format_ihex(char *line, uint8_t type, uint16_t offset,
+                          const uint8_t *data, uint32_t len)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    uint8_t head[4];
+    uint8_t sum = 0U;
+    size_t pos = 0U;
+    uint32_t i;
+
+    head[0] = (uint8_t)len;
+    head[1] = (uint8_t)(offset >> 8);
+    head[2] = (uint8_t)offset;
+    head[3] = type;
+
+    line[pos++] = ':';
+    for (i = 0U; i < (4U + len); i++) {
+        uint8_t b = (i < 4U) ? head[i] : data[i - 4U];
+        sum += b;
+        line[pos++] = digits[b >> 4];
+        line[pos++] = digits[b & 0xFU];
+    }
+    sum = (uint8_t)(0U - sum);
+    line[pos++] = digits[sum >> 4];
+    line[pos++] = digits[sum & 0xFU];
+    line[pos++] = '\n';
+    line[pos]   = '\0';
+    return pos;
+}
+
+/**
+ * @brief One binary frame: STX, len, address, data, ~sum.
+ */
+static size_t format_bin(char *line, uint32_t address, const uint8_t *data, uint32_t len)
+{
+    uint8_t *out = (uint8_t *)line;
+    uint8_t sum;
+    size_t pos = 0U;
+    uint32_t i;
+
+    out[pos++] = FLASH_BIN_SOF;
+    out[pos++] = (uint8_t)len;
+    out[pos++] = (uint8_t)(address >> 24);
+    out[pos++] = (uint8_t)(address >> 16);
+    out[pos++] = (uint8_t)(address >> 8);
+    out[pos++] = (uint8_t)address;
+    if (len > 0U) {
+        memcpy(&out[pos], data, len);
+        pos += len;
+    }
+    sum = 0U;
+    for (i = 1U; i < pos; i++) {
+        sum += out[i];
+    }
+    out[pos++] = (uint8_t)~sum;
+    return pos;
+}
+
+/**
+ * @brief Format @p rec (the end record when NULL) in the plan's format;
+ *        @p prev is the record before it, for the Intel HEX address base.
+ */
+static size_t format_record(const flash_plan_t *plan, const flash_rec_t *rec,
+                            const flash_rec_t *prev, char *line)
+{
+    uint8_t ext[4];
+    size_t pos = 0U;
+
+    switch (plan->format) {
+    case FLASH_FMT_IHEX:
+        if (rec == NULL) {
+            ext[0] = (uint8_t)(plan->entry >> 24);
+            ext[1] = (uint8_t)(plan->entry >> 16);
+            ext[2] = (uint8_t)(plan->entry >> 8);
+            ext[3] = (uint8_t)plan->entry;
+            pos  = format_ihex(line, 0x05U, 0U, ext, 4U);
+            pos += format_ihex(&line[pos], 0x01U, 0U, NULL, 0U);
+            return pos;
+        }
+        /* Upper address in a type 04 line before the first record of each 64 KiB */
+        if ((prev == NULL) || ((prev->address >> 16) != (rec->address >> 16))) {
+            ext[0] = (uint8_t)(rec->address >> 24);
+            ext[1] = (uint8_t)(rec->address >> 16);
+            pos = format_ihex(line, 0x04U, 0U, ext, 2U);
+        }
+        return pos + format_ihex(&line[pos], 0x00U, (uint16_t)rec->address, rec->data, rec->len);
+    case FLASH_FMT_BIN:
+        return (rec == NULL) ? format_bin(line, plan->entry, NULL, 0U)
+                             : format_bin(line, rec->address, rec->data, rec->len);
+    default:
+        return (rec == NULL) ? FlashPlan_FormatS7(plan->entry, line)
+                             : FlashPlan_FormatS3(rec, line);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+int FlashImage_LoadSrec(flash_image_t *img, const char *path, char *err, size_t errlen)
+{
+    char text[SREC_TEXT_MAX];
+    uint8_t bytes[SREC_DATA_MAX + 1U];
+    srec_list_t list = { NULL, 0U, 0U };
+    uint32_t lineno = 0U;
+    uint32_t addr_len;
+    uint32_t address;
+    uint32_t count;
+    uint32_t i;
+    size_t len;
+    uint8_t sum;
+    FILE *f;
+    int rc = -1;
+
+    memset(img, 0, sizeof(*img));
+
+    f = fopen(path, "r");
+    if (f == NULL) {
+        set_err(err, errlen, "%s: cannot open", path);
+        return -1;
+    }
+
+    while (fgets(text, sizeof(text), f) != NULL) {
+        lineno++;
+        len = strcspn(text, "\r\n");
+        text[len] = '\0';
+        if (len == 0U) {
+            continue;
+        }
+        if ((len < 4U) || (text[0] != 'S')) {
+            set_err(err, errlen, "%s:%u: not an S-record", path, lineno);
+            goto out;
+        }
+
+        switch (text[1]) {
+        case '0': case '1': case '5': case '9': addr_len = 2U; break;
+        case '2': case '8':                     addr_len = 3U; break;
+        case '3': case '7':                     addr_len = 4U; break;
+        case '6':                               addr_len = 3U; break;
+        default:
+            set_err(err, errlen, "%s:%u: unknown record type S%c", path, lineno, text[1]);
+            goto out;
+        }
+
+        if ((hex_decode(&text[2], bytes, 1U) != 0) ||
+            ((count = bytes[0]) < (addr_len + 1U)) ||
+            (len != (4U + (2U * count))) ||
+            (hex_decode(&text[4], &bytes[1], count) != 0)) {
+            set_err(err, errlen, "%s:%u: malformed record", path, lineno);
+            goto out;
+        }
+
+        sum = 0U;
+        for (i = 0U; i <= count; i++) {
+            sum += bytes[i];
+        }
+        if (sum != 0xFFU) {
+            set_err(err, errlen, "%s:%u: checksum error", path, lineno);
+            goto out;
+        }
+
+        address = 0U;
+        for (i = 0U; i < addr_len; i++) {
+            address = (address << 8) | bytes[1U + i];
+        }
+
+        if ((text[1] >= '7') && (text[1] <= '9')) {
+            img->entry = address;
+        } else if ((text[1] >= '1') && (text[1] <= '3')) {
+            if (list_add(&list, img, address, &bytes[1U + addr_len],
+                         count - addr_len - 1U, lineno) == NULL) {
+                set_err(err, errlen, "out of memory");
+                goto out;
+            }
+        } else {
+            /* S0 header, S5/S6 record count */
+        }
+    }
+
+    rc = list_to_image(&list, img, path, err, errlen);
+
+out:
+    free(list.recs);
+    (void)fclose(f);
+    if (rc != 0) {
+        FlashImage_Free(img);
+    }
+    return rc;
+}
+
+int FlashImage_LoadHex(flash_image_t *img, const char *path, char *err, size_t errlen)
+{
+    char text[SREC_TEXT_MAX];
+    uint8_t bytes[SREC_DATA_MAX + 5U];
+    srec_list_t list = { NULL, 0U, 0U };
+    uint32_t lineno = 0U;
+    uint32_t upper = 0U;        /* Extended linear or segment base */
+    uint32_t count;
+    uint32_t offset;
+    uint32_t i;
+    size_t len;
+    uint8_t sum;
+    FILE *f;
+    int rc = -1;
+
+    memset(img, 0, sizeof(*img));
+
+    f = fopen(path, "r");
+    if (f == NULL) {
+        set_err(err, errlen, "%s: cannot open", path);
+        return -1;
+    }
+
+    while (fgets(text, sizeof(text), f) != NULL) {
+        lineno++;
+        len = strcspn(text, "\r\n");
+        text[len] = '\0';
+        if (len == 0U) {
+            continue;
+        }
+        /* ":LLAAAATT<data>CC" */
+        if ((len < 11U) || (text[0] != ':') ||
+            (hex_decode(&text[1], bytes, 1U) != 0) ||
+            ((count = bytes[0]), (len != (11U + (2U * count)))) ||
+            (hex_decode(&text[1], bytes, count + 5U) != 0)) {
+            set_err(err, errlen, "%s:%u: malformed Intel HEX record", path, lineno);
+            goto out;
+        }
+
+        sum = 0U;
+        for (i = 0U; i < (count + 5U); i++) {
+            sum += bytes[i];
+        }
+        if (sum != 0U) {
+            set_err(err, errlen, "%s:%u: checksum error", path, lineno);
+            goto out;
+        }
+
+        offset = ((uint32_t)bytes[1] << 8) | bytes[2];
+        switch (bytes[3]) {
+        case 0x00U:             /* Data */
+            if (list_add(&list, img, upper + offset, &bytes[4], count, lineno) == NULL) {
+                set_err(err, errlen, "out of memory");
+                goto out;
+            }
+            break;
+        case 0x01U:             /* End of file */
+            rc = list_to_image(&list, img, path, err, errlen);
+            goto out;
+        case 0x02U:             /* Extended segment address */
+            upper = (((uint32_t)bytes[4] << 8) | bytes[5]) << 4;
+            break;
+        case 0x04U:             /* Extended linear address */
+            upper = (((uint32_t)bytes[4] << 8) | bytes[5]) << 16;
+            break;
+        case 0x03U:             /* Start segment address CS:IP */
+            img->entry = (((((uint32_t)bytes[4] << 8) | bytes[5]) << 4) +
+                          (((uint32_t)bytes[6] << 8) | bytes[7]));
+            break;
+        case 0x05U:             /* Start linear address */
+            img->entry = ((uint32_t)bytes[4] << 24) | ((uint32_t)bytes[5] << 16) |
+                         ((uint32_t)bytes[6] << 8) | bytes[7];
+            break;
+        default:
+            set_err(err, errlen, "%s:%u: unknown record type %02X", path, lineno, bytes[3]);
+            goto out;
+        }
+    }
+    set_err(err, errlen, "%s: no end-of-file record", path);
+
+out:
+    free(list.recs);
+    (void)fclose(f);
+    if (rc != 0) {
+        FlashImage_Free(img);
+    }
+    return rc;
+}
+
+int FlashImage_LoadBin(flash_image_t *img, const char *path, uint32_t base,
+                       char *err, size_t errlen)
+{
+    srec_in_t rec;
+    size_t n;
+    FILE *f;
+    int rc = 0;
+
+    memset(img, 0, sizeof(*img));
+
+    f = fopen(path, "rb");
+    if (f == NULL) {
+        set_err(err, errlen, "%s: cannot open", path);
+        return -1;
+    }
+
+    /* One segment: add_to_image() appends each chunk to the last one */
+    rec.address = base;
+    rec.line    = 0U;
+    while ((rc == 0) && ((n = fread(rec.data, 1U, sizeof(rec.data), f)) > 0U)) {
+        rec.len = (uint32_t)n;
+        if ((img->in_bytes + rec.len) > BIN_MAX) {
+            set_err(err, errlen, "%s: larger than %u bytes", path, BIN_MAX);
+            rc = -1;
+        } else if (add_to_image(img, &rec) != 0) {
+            set_err(err, errlen, "out of memory");
+            rc = -1;
+        } else {
+            img->in_records++;
+            img->in_bytes += rec.len;
+            rec.address   += rec.len;
+        }
+    }
+    if ((rc == 0) && (ferror(f) != 0)) {
+        set_err(err, errlen, "%s: read error", path);
+        rc = -1;
+    }
+    img->entry = base;
+
+    (void)fclose(f);
+    if (rc != 0) {
+        FlashImage_Free(img);
+    }
+    return rc;
+}
+
+int FlashImage_Load(flash_image_t *img, const char *path, uint32_t base,
+                    char *err, size_t errlen)
+{
+    int first;
+    FILE *f;
+
+    memset(img, 0, sizeof(*img));
+
+    /* Text formats by their first character, anything else is binary */
+    f = fopen(path, "rb");
+    if (f == NULL) {
+        set_err(err, errlen, "%s: cannot open", path);
+        return -1;
+    }
+    first = fgetc(f);
+    (void)fclose(f);
+
+    if (first == 'S') {
+        return FlashImage_LoadSrec(img, path, err, errlen);
+    }
+    if (first == ':') {
+        return FlashImage_LoadHex(img, path, err, errlen);
+    }
+    return FlashImage_LoadBin(img, path, base, err, errlen);
+}
+
+uint32_t FlashImage_DropBlank(flash_image_t *img)
+{
+    flash_image_t out;
+    srec_in_t rec;
+    const flash_seg_t *seg;
+    uint32_t dropped = 0U;
+    uint32_t phrase;
+    uint32_t a;
+    uint32_t end;
+    uint32_t n;
+    size_t s;
+
+    memset(&out, 0, sizeof(out));
+    out.entry        = img->entry;
+    out.in_records   = img->in_records;
+    out.in_bytes     = img->in_bytes;
+    out.in_unaligned = img->in_unaligned;
+    rec.line = 0U;
+
+    /* A phrase is dropped if every image byte in it is 0xFF: the bootloader
+     * erased it and the missing bytes would be 0xFF padding anyway */
+    for (s = 0U; s < img->count; s++) {
+        seg = &img->segs[s];
+        a   = seg->address;
+        end = seg->address + seg->len;
+        while (a < end) {
+            phrase = a & ~(FLASH_PHRASE_SIZE - 1U);
+            n = ((phrase + FLASH_PHRASE_SIZE) < end) ? (phrase + FLASH_PHRASE_SIZE - a) : (end - a);
+
+            if (phrase_blank(img, s, phrase) != 0) {
+                dropped += n;
+            } else {
+                rec.address = a;
+                rec.len     = n;
+                memcpy(rec.data, &seg->data[a - seg->address], n);
+                if (add_to_image(&out, &rec) != 0) {
+                    FlashImage_Free(&out);
+                    return 0U;
+                }
+            }
+            a += n;
+        }
+    }
+
+    FlashImage_Free(img);
+    *img = out;
+    return dropped;
+}
+
+void FlashImage_Free(flash_image_t *img)
+{
+    size_t i;
+
+    for (i = 0U; i < img->count; i++) {
+        free(img->segs[i].data);
+    }
+    free(img->segs);
+    memset(img, 0, sizeof(*img));
+}
+
+int FlashPlan_Build(const flash_image_t *img, uint32_t max_data,
+                    uint32_t lo, uint32_t hi, uint32_t align, flash_format_t format,
+                    flash_plan_t *plan)
+{
+    flash_rec_t *rec = NULL;
+    size_t cap = 0U;
+    size_t s;
+    uint32_t i;
+    uint32_t a;
+    uint32_t base;
+
+    memset(plan, 0, sizeof(*plan));
+    plan->format = format;
+    if ((max_data == 0U) || (max_data > FlashPlan_RecMax(format)) ||
+        ((max_data % FLASH_PHRASE_SIZE) != 0U)) {
+        return -1;
+    }
+    if ((format == FLASH_FMT_IHEX) && (align == 0U)) {
+        align = 0x10000U;       /* 16-bit offsets */
+    }
+
+    /* Addresses only increase: each byte lands in the open record, extends
+     * it by one phrase, or opens the next one */
+    for (s = 0U; s < img->count; s++) {
+        for (i = 0U; i < img->segs[s].len; i++) {
+            a = img->segs[s].address + i;
+            if ((a < lo) || (a > hi)) {
+                plan->skipped++;
+                continue;
+            }
+            base = a & ~(FLASH_PHRASE_SIZE - 1U);
+            if ((rec != NULL) && (base == (rec->address + rec->len)) && (rec->len < max_data) &&
+                ((align == 0U) || ((base % align) != 0U))) {
+                rec->len += FLASH_PHRASE_SIZE;
+                plan->bytes += FLASH_PHRASE_SIZE;
+            } else if ((rec == NULL) || (base >= (rec->address + rec->len))) {
+                if (plan_next(plan, &cap, base) != 0) {
+                    FlashPlan_Free(plan);
+                    return -1;
+                }
+            } else {
+                /* Phrase already open */
+            }
+            rec = &plan->recs[plan->count - 1U];
+            rec->data[a - rec->address] = img->segs[s].data[i];
+        }
+    }
+
+    /* Format every line once, each fits in FLASH_LINE_BUF (plus a type 04
+     * or 05 line in Intel HEX) */
+    plan->entry    = img->entry;
+    plan->text     = malloc(((plan->count + 1U) * (FLASH_LINE_BUF + 24U)));
+    plan->line_end = malloc((plan->count + 1U) * sizeof(*plan->line_end));
+    if ((plan->text == NULL) || (plan->line_end == NULL)) {
+        FlashPlan_Free(plan);
+        return -1;
+    }
+    for (s = 0U; s < plan->count; s++) {
+        plan->wire_bytes += (uint32_t)format_record(plan, &plan->recs[s],
+                                                    (s > 0U) ? &plan->recs[s - 1U] : NULL,
+                                                    &plan->text[plan->wire_bytes]);
+        plan->line_end[s] = plan->wire_bytes;
+        plan->crc = FlashPlan_Crc32(plan->crc, plan->recs[s].data, plan->recs[s].len);
+    }
+    plan->wire_bytes += (uint32_t)format_record(plan, NULL, NULL, &plan->text[plan->wire_bytes]);
+    plan->line_end[plan->count] = plan->wire_bytes;
+    return 0;
+}
+
+uint32_t FlashPlan_RecMax(flash_format_t format)
+{
+    switch (format) {
+    case FLASH_FMT_IHEX: return FLASH_HEX_REC_MAX;
+    case FLASH_FMT_BIN:  return FLASH_BIN_REC_MAX;
+    default:             return FLASH_REC_MAX;
+    }
+}
+
+void FlashPlan_Free(flash_plan_t *plan)
+{
+    free(plan->recs);
+    free(plan->text);
+    free(plan->line_end);
+    memset(plan, 0, sizeof(*plan));
+}
+
+const char *FlashPlan_Line(const flash_plan_t *plan, size_t i, size_t *len)
+{
+    uint32_t start = (i == 0U) ? 0U : plan->line_end[i - 1U];
+
+    *len = plan->line_end[i] - start;
+    return &plan->text[start];
+}
+
+uint32_t FlashPlan_Crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+    uint32_t bit;
+
+    crc = ~crc;
+    while (len-- > 0U) {
+        crc ^= *data++;
+        for (bit = 0U; bit < 8U; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+size_t FlashPlan_FormatS3(const flash_rec_t *rec, char *line)
+{
+    return format_srec(line, '3', rec->address, rec->data, rec->len);
+}
+
+size_t FlashPlan_FormatS7(uint32_t entry, char *line)
+{
+    return format_srec(line, '7', entry, NULL, 0U);
+}
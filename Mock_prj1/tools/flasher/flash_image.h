@@ -0,0 +1,238 @@
+/**
+ * @file    flash_image.h
+ * @brief   Host flasher - application image and record plan.
+ *
+ * The image is read once into address-sorted segments, from an S-record,
+ * Intel HEX or binary file. The plan cuts it into the records sent to the
+ * bootloader: each record starts on an 8-byte phrase boundary and holds
+ * whole phrases (gaps inside a phrase are 0xFF, the erased value), so
+ * Bootloader_Mode() programs every phrase exactly once and never takes the
+ * 4+4 merge path.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#ifndef FLASH_IMAGE_H_
+#define FLASH_IMAGE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================
+ *                  BOOTLOADER LIMITS (src/main.c)
+ * ============================================================ */
+
+#define FLASH_APP_START         (0x0000A000U)   /**< APP_FLASH_START             */
+#define FLASH_APP_END           (0x0007FFFFU)   /**< APP_FLASH_END               */
+#define FLASH_PHRASE_SIZE       (8U)            /**< BOOT_PHRASE_SIZE            */
+#define FLASH_LINE_MAX          (255U)          /**< MAX_LINE_LENGTH - 1 ('\0')  */
+#define FLASH_MAP_BLOCK         (64U)           /**< BOOT_RXMAP_BLOCK_SIZE       */
+#define FLASH_MAP_QUERY_MAX     (512U)          /**< BOOT_RXMAP_QUERY_MAX        */
+
+/** S3 line overhead: "S3" + count + 4 address bytes + checksum, in chars. */
+#define FLASH_S3_OVERHEAD       (2U + 2U + 8U + 2U)
+
+/** Largest phrase-aligned data length whose S3 line ends in '\n' only. */
+#define FLASH_REC_MAX           ((((FLASH_LINE_MAX - FLASH_S3_OVERHEAD) / 2U) / FLASH_PHRASE_SIZE) * FLASH_PHRASE_SIZE)
+
+/** Intel HEX line overhead: ':' + count + 2 address bytes + type + checksum, in chars. */
+#define FLASH_HEX_OVERHEAD      (1U + 2U + 4U + 2U + 2U)
+
+/** Largest phrase-aligned data length of an Intel HEX line. */
+#define FLASH_HEX_REC_MAX       ((((FLASH_LINE_MAX - FLASH_HEX_OVERHEAD) / 2U) / FLASH_PHRASE_SIZE) * FLASH_PHRASE_SIZE)
+
+/** Binary frame (boot_record.h): STX, length, 4 address bytes, data, checksum. */
+#define FLASH_BIN_SOF           (0x02U)         /**< BOOT_RECORD_BIN_SOF         */
+#define FLASH_BIN_OVERHEAD      (7U)            /**< BOOT_RECORD_BIN_OVERHEAD    */
+
+/** Largest phrase-aligned data length of a binary frame. */
+#define FLASH_BIN_REC_MAX       (((FLASH_LINE_MAX - FLASH_BIN_OVERHEAD) / FLASH_PHRASE_SIZE) * FLASH_PHRASE_SIZE)
+
+/** Buffer size for one formatted record line, with '\n' and '\0'. */
+#define FLASH_LINE_BUF          (FLASH_LINE_MAX + 2U)
+
+/* ============================================================
+ *                  TYPES
+ * ============================================================ */
+
+/**
+ * @brief Record format sent to the bootloader (boot_record.h).
+ */
+typedef enum {
+    FLASH_FMT_SREC = 0,         /**< S3 lines, S7 end                      */
+    FLASH_FMT_IHEX,             /**< Type 00 lines, 04 per 64 KiB, 05 + 01 */
+    FLASH_FMT_BIN               /**< Binary frames, length 0 ends          */
+} flash_format_t;
+
+/**
+ * @brief Contiguous run of image bytes.
+ */
+typedef struct {
+    uint32_t address;
+    uint32_t len;
+    uint8_t *data;
+} flash_seg_t;
+
+/**
+ * @brief Image as read from the input file.
+ */
+typedef struct {
+    flash_seg_t *segs;          /**< Sorted by address, not overlapping    */
+    size_t       count;
+    uint32_t     entry;         /**< S7/S8/S9 address, 0 if none           */
+    uint32_t     in_records;    /**< Data records in the input             */
+    uint32_t     in_bytes;      /**< Data bytes in the input               */
+    uint32_t     in_unaligned;  /**< Input records not on whole phrases    */
+} flash_image_t;
+
+/**
+ * @brief One record of the plan.
+ */
+typedef struct {
+    uint32_t address;           /**< Phrase aligned                        */
+    uint32_t len;               /**< Multiple of FLASH_PHRASE_SIZE         */
+    uint8_t  data[FLASH_BIN_REC_MAX];
+} flash_rec_t;
+
+/**
+ * @brief Records sent to the bootloader, in address order.
+ *
+ * The lines are formatted once when the plan is built; sessions only read
+ * the plan, so one plan is shared by every port of a parallel run.
+ */
+typedef struct {
+    flash_rec_t *recs;
+    size_t       count;
+    uint32_t     entry;
+    uint32_t     bytes;         /**< Sum of record lengths (with padding)  */
+    uint32_t     skipped;       /**< Image bytes outside the range         */
+    flash_format_t format;
+    uint32_t     wire_bytes;    /**< Characters of all lines, with S7      */
+    uint32_t     crc;           /**< CRC-32 of the record data, in order   */
+    char        *text;          /**< Record lines, then the end record     */
+    uint32_t    *line_end;      /**< End offset in text of line i, count+1 */
+} flash_plan_t;
+
+/* ============================================================
+ *                  API
+ * ============================================================ */
+
+/**
+ * @brief Read a Motorola S-record file.
+ *
+ * Checks hex digits, byte counts and checksums. Overlapping data is an
+ * error. Adjacent records are merged into one segment.
+ *
+ * @param[out] img    Image, release with FlashImage_Free().
+ * @param[in]  path   Input file.
+ * @param[out] err    Error text on failure.
+ * @param[in]  errlen Size of @p err.
+ * @return 0 on success, -1 on error.
+ */
+int FlashImage_LoadSrec(flash_image_t *img, const char *path, char *err, size_t errlen);
+
+/**
+ * @brief Read an Intel HEX file (types 00..05, 32-bit addresses).
+ *
+ * Same checks and result as FlashImage_LoadSrec(); the start address
+ * (type 03 or 05) becomes the entry.
+ */
+int FlashImage_LoadHex(flash_image_t *img, const char *path, char *err, size_t errlen);
+
+/**
+ * @brief Read a raw binary file as one segment at @p base (also the entry).
+ */
+int FlashImage_LoadBin(flash_image_t *img, const char *path, uint32_t base,
+                       char *err, size_t errlen);
+
+/**
+ * @brief Read an S-record, Intel HEX or binary file, chosen by its first
+ *        character ('S', ':', anything else).
+ *
+ * @param[in] base Load address of a binary file.
+ */
+int FlashImage_Load(flash_image_t *img, const char *path, uint32_t base,
+                    char *err, size_t errlen);
+
+/**
+ * @brief Remove the phrases whose image bytes are all 0xFF (erased flash).
+ *
+ * @return Bytes removed; 0 and the image unchanged when out of memory.
+ */
+uint32_t FlashImage_DropBlank(flash_image_t *img);
+
+/**
+ * @brief Release an image.
+ */
+void FlashImage_Free(flash_image_t *img);
+
+/**
+ * @brief Cut the image into phrase-aligned records.
+ *
+ * @param[in]  img      Image.
+ * @param[in]  max_data Record data length, multiple of 8, at most
+ *                      FlashPlan_RecMax(@p format).
+ * @param[in]  lo       First address sent (bytes below are counted as skipped).
+ * @param[in]  hi       Last address sent.
+ * @param[in]  align    Records never cross a multiple of @p align (0: no
+ *                      limit); with align == max_data every record is one
+ *                      block of the bootloader's MAP (boot_rxmap.h).
+ *                      Intel HEX records never cross 64 KiB either.
+ * @param[in]  format   Format of the lines.
+ * @param[out] plan     Plan, release with FlashPlan_Free().
+ * @return 0 on success, -1 on a bad @p max_data or out of memory.
+ */
+int FlashPlan_Build(const flash_image_t *img, uint32_t max_data,
+                    uint32_t lo, uint32_t hi, uint32_t align, flash_format_t format,
+                    flash_plan_t *plan);
+
+/**
+ * @brief Largest record data length of a format.
+ */
+uint32_t FlashPlan_RecMax(flash_format_t format);
+
+/**
+ * @brief Release a plan.
+ */
+void FlashPlan_Free(flash_plan_t *plan);
+
+/**
+ * @brief Formatted line @p i of the plan (i == count: the end record).
+ *
+ * An Intel HEX line may start with its type 04 line; a binary frame is
+ * not text.
+ *
+ * @param[out] len Line length including '\n'.
+ * @return Pointer into plan->text (not terminated).
+ */
+const char *FlashPlan_Line(const flash_plan_t *plan, size_t i, size_t *len);
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected) update.
+ *
+ * @param[in] crc  Previous value, 0 for the first block.
+ */
+uint32_t FlashPlan_Crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+/**
+ * @brief Format a record as an S3 line terminated by '\n'.
+ *
+ * @param[in]  rec  Record.
+ * @param[out] line At least FLASH_LINE_BUF bytes.
+ * @return Line length without the terminator.
+ */
+size_t FlashPlan_FormatS3(const flash_rec_t *rec, char *line);
+
+/**
+ * @brief Format the S7 termination record terminated by '\n'.
+ *
+ * @param[in]  entry Entry address.
+ * @param[out] line  At least FLASH_LINE_BUF bytes.
+ * @return Line length without the terminator.
+ */
+size_t FlashPlan_FormatS7(uint32_t entry, char *line);
+
+#endif /* FLASH_IMAGE_H_ */
@@ -0,0 +1,334 @@
+/**
+ * @file    flash_link.c
+ * @brief   Host flasher - serial link to the bootloader.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#define _GNU_SOURCE
+#include "flash_link.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define BITS_PER_CHAR       (10U)       /**< 8N1 */
+#define BITS_PER_CHAR_9     (11U)       /**< 8 + address bit + stop */
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static speed_t baud_to_speed(uint32_t baud)
+{
+    switch (baud) {
+    case 1200U:    return B1200;
+    case 2400U:    return B2400;
+    case 4800U:    return B4800;
+    case 9600U:    return B9600;
+    case 19200U:   return B19200;
+    case 38400U:   return B38400;
+    case 57600U:   return B57600;
+    case 115200U:  return B115200;
+    case 230400U:  return B230400;
+    case 460800U:  return B460800;
+    case 921600U:  return B921600;
+    default:       return B0;
+    }
+}
+
+/**
+ * @brief Select the 9th bit: mark (address) or space (data) parity.
+ */
+static int set_mark(flash_link_t *link, int mark)
+{
+    struct termios tio;
+
+    if (tcgetattr(link->fd, &tio) != 0) {
+        return -1;
+    }
+    tio.c_cflag |= PARENB | CMSPAR;
+    if (mark != 0) {
+        tio.c_cflag |= PARODD;
+    } else {
+        tio.c_cflag &= ~(tcflag_t)PARODD;
+    }
+    tio.c_iflag &= ~(tcflag_t)(INPCK | PARMRK);
+    tio.c_iflag |= IGNPAR;
+    return tcsetattr(link->fd, TCSADRAIN, &tio);
+}
+
+static void sleep_until(uint64_t t_ns)
+{
+    struct timespec ts;
+
+    ts.tv_sec  = (time_t)(t_ns / 1000000000ULL);
+    ts.tv_nsec = (long)(t_ns % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        /* Retry */
+    }
+}
+
+/**
+ * @brief Append received bytes to link->rx (which must have room).
+ *
+ * @return 1 when bytes were added, 0 at the deadline, -1 on error.
+ */
+static int link_fill(flash_link_t *link, uint64_t deadline)
+{
+    struct pollfd pfd;
+    uint64_t now;
+    ssize_t r;
+    int rc;
+
+    for (;;) {
+        now = FlashLink_NowNs();
+        if (now >= deadline) {
+            return 0;
+        }
+        pfd.fd      = link->fd;
+        pfd.events  = POLLIN;
+        pfd.revents = 0;
+        rc = poll(&pfd, 1, (int)(((deadline - now) + 999999ULL) / 1000000ULL));
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (rc == 0) {
+            continue;
+        }
+        r = read(link->fd, &link->rx[link->rx_len], sizeof(link->rx) - link->rx_len);
+        if (r < 0) {
+            if ((errno == EINTR) || (errno == EAGAIN)) {
+                continue;
+            }
+            return -1;
+        }
+        if (r == 0) {
+            /* pty closed by the other side: wait for the next poll */
+            sleep_until(FlashLink_NowNs() + 10000000ULL);
+            continue;
+        }
+        link->rx_len += (size_t)r;
+        return 1;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+uint64_t FlashLink_NowNs(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+int FlashLink_Open(flash_link_t *link, const char *path, uint32_t baud, int pace)
+{
+    struct termios tio;
+    speed_t speed = baud_to_speed(baud);
+
+    memset(link, 0, sizeof(*link));
+    link->fd = -1;
+    if (speed == B0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    link->fd = open(path, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (link->fd < 0) {
+        return -1;
+    }
+
+    /* Raw 8N1, no flow control, no echo (a pty echoes by default) */
+    if (tcgetattr(link->fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tio.c_cflag &= ~(tcflag_t)(CSTOPB | PARENB | CRTSCTS);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_iflag &= ~(tcflag_t)(IXON | IXOFF | IXANY);
+        tio.c_cc[VMIN]  = 0;
+        tio.c_cc[VTIME] = 0;
+        (void)cfsetispeed(&tio, speed);
+        (void)cfsetospeed(&tio, speed);
+        if (tcsetattr(link->fd, TCSANOW, &tio) != 0) {
+            (void)close(link->fd);
+            link->fd = -1;
+            return -1;
+        }
+    }
+
+    link->baud    = baud;
+    link->char_ns = (pace != 0) ? ((BITS_PER_CHAR * 1000000000ULL) / baud) : 0U;
+    link->next_ns = FlashLink_NowNs();
+    return 0;
+}
+
+void FlashLink_Close(flash_link_t *link)
+{
+    if (link->fd >= 0) {
+        (void)close(link->fd);
+    }
+    link->fd = -1;
+}
+
+int FlashLink_Write(flash_link_t *link, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint64_t now;
+    size_t n;
+    ssize_t w;
+
+    while (len > 0U) {
+        n = (len < FLASH_LINK_AHEAD) ? len : FLASH_LINK_AHEAD;
+
+        if (link->char_ns != 0U) {
+            /* Keep at most FLASH_LINK_AHEAD characters ahead of the wire */
+            now = FlashLink_NowNs();
+            if (link->next_ns < now) {
+                link->next_ns = now;
+            }
+            if (link->next_ns > (now + (FLASH_LINK_AHEAD * link->char_ns))) {
+                sleep_until(link->next_ns - (FLASH_LINK_AHEAD * link->char_ns));
+            }
+        }
+
+        w = write(link->fd, p, n);
+        if (w < 0) {
+            if ((errno == EINTR) || (errno == EAGAIN)) {
+                continue;
+            }
+            return -1;
+        }
+        link->next_ns += (uint64_t)w * link->char_ns;
+        p   += w;
+        len -= (size_t)w;
+    }
+    return 0;
+}
+
+void FlashLink_Drain(flash_link_t *link)
+{
+    (void)tcdrain(link->fd);
+    if ((link->char_ns != 0U) && (link->next_ns > FlashLink_NowNs())) {
+        sleep_until(link->next_ns);
+    }
+}
+
+int FlashLink_ReadLine(flash_link_t *link, char *line, size_t size, uint32_t timeout_ms)
+{
+    uint64_t deadline = FlashLink_NowNs() + ((uint64_t)timeout_ms * 1000000ULL);
+    char *nl;
+    size_t len;
+    int rc;
+
+    for (;;) {
+        /* Complete line already buffered? */
+        while ((nl = memchr(link->rx, '\n', link->rx_len)) != NULL) {
+            len = (size_t)(nl - link->rx);
+            while ((len > 0U) && (link->rx[len - 1U] == '\r')) {
+                len--;
+            }
+            if (len >= size) {
+                len = size - 1U;
+            }
+            memcpy(line, link->rx, len);
+            line[len] = '\0';
+            link->rx_len -= (size_t)(nl + 1 - link->rx);
+            memmove(link->rx, nl + 1, link->rx_len);
+            if (len > 0U) {
+                if (link->echo != 0) {
+                    fprintf(stderr, "  %s< %s\n", (link->tag != NULL) ? link->tag : "", line);
+                }
+                return (int)len;
+            }
+        }
+
+        if (link->rx_len == sizeof(link->rx)) {
+            /* Line longer than the buffer (binary output): drop it */
+            link->rx_len = 0U;
+        }
+
+        rc = link_fill(link, deadline);
+        if (rc <= 0) {
+            return rc;
+        }
+    }
+}
+
+int FlashLink_Read(flash_link_t *link, void *data, size_t len, uint32_t timeout_ms)
+{
+    uint64_t deadline = FlashLink_NowNs() + ((uint64_t)timeout_ms * 1000000ULL);
+    uint8_t *dst = data;
+    size_t done = 0U;
+    size_t n;
+    int rc;
+
+    for (;;) {
+        n = (link->rx_len < (len - done)) ? link->rx_len : (len - done);
+        memcpy(&dst[done], link->rx, n);
+        link->rx_len -= n;
+        memmove(link->rx, &link->rx[n], link->rx_len);
+        done += n;
+        if (done == len) {
+            return (int)done;
+        }
+
+        rc = link_fill(link, deadline);
+        if (rc < 0) {
+            return -1;
+        }
+        if (rc == 0) {
+            return (int)done;
+        }
+    }
+}
+
+void FlashLink_Flush(flash_link_t *link)
+{
+    (void)tcflush(link->fd, TCIFLUSH);
+    link->rx_len = 0U;
+}
+
+int FlashLink_SetNineBit(flash_link_t *link)
+{
+    if (set_mark(link, 0) != 0) {
+        return -1;
+    }
+    if (link->char_ns != 0U) {
+        link->char_ns = (BITS_PER_CHAR_9 * 1000000000ULL) / link->baud;
+    }
+    return 0;
+}
+
+int FlashLink_SendAddress(flash_link_t *link, uint8_t address)
+{
+    int rc;
+
+    FlashLink_Drain(link);
+    if (set_mark(link, 1) != 0) {
+        return -1;
+    }
+    rc = FlashLink_Write(link, &address, 1U);
+    FlashLink_Drain(link);
+    if (set_mark(link, 0) != 0) {
+        return -1;
+    }
+    return rc;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file    flash_link.h
+ * @brief   Host flasher - serial link to the bootloader.
+ *
+ * Works on any character device: a USB-UART adapter, the OpenSDA virtual
+ * COM port or the pty of tools/host_sim. The line is set to raw 8N1 without
+ * flow control, like the bootloader's LPUART1.
+ *
+ * The bootloader has no flow control, so transmission is paced on the host
+ * at the character time of the baud rate. A pty accepts data at any speed
+ * and a USB-UART adapter buffers several KB, so write() blocking is not
+ * enough to keep the receiver from overrunning.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#ifndef FLASH_LINK_H_
+#define FLASH_LINK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Characters written ahead of the wire, like a 16-byte UART FIFO. */
+#define FLASH_LINK_AHEAD        (16U)
+
+/** Longest bootloader text line kept by FlashLink_ReadLine(). */
+#define FLASH_LINK_LINE_MAX     (512U)
+
+/**
+ * @brief Open link.
+ */
+typedef struct {
+    int      fd;
+    uint32_t baud;
+    uint64_t char_ns;           /**< Character time, 0 = no host pacing    */
+    uint64_t next_ns;           /**< Wire is busy until this time          */
+    int      echo;              /**< Print received lines to stderr        */
+    const char *tag;            /**< Prefix of echoed lines (port name)    */
+    char     rx[FLASH_LINK_LINE_MAX];
+    size_t   rx_len;
+} flash_link_t;
+
+/**
+ * @brief Monotonic time in nanoseconds.
+ */
+uint64_t FlashLink_NowNs(void);
+
+/**
+ * @brief Open and configure a serial device.
+ *
+ * @param[out] link Link.
+ * @param[in]  path Device or pty path.
+ * @param[in]  baud Baud rate (standard rates only).
+ * @param[in]  pace Non-zero: pace writes at the character time.
+ * @return 0 on success, -1 on error (errno set).
+ */
+int FlashLink_Open(flash_link_t *link, const char *path, uint32_t baud, int pace);
+
+/**
+ * @brief Close the link.
+ */
+void FlashLink_Close(flash_link_t *link);
+
+/**
+ * @brief Write all bytes, paced at the character time.
+ *
+ * Returns when the last byte has been handed to the device; at most
+ * FLASH_LINK_AHEAD characters are ahead of the wire.
+ *
+ * @return 0 on success, -1 on error.
+ */
+int FlashLink_Write(flash_link_t *link, const void *data, size_t len);
+
+/**
+ * @brief Wait until every written character has left the wire.
+ */
+void FlashLink_Drain(flash_link_t *link);
+
+/**
+ * @brief Receive one text line.
+ *
+ * '\r' is removed, the line is returned without '\n'. Empty lines are
+ * skipped.
+ *
+ * @param[out] line       Destination.
+ * @param[in]  size       Size of @p line.
+ * @param[in]  timeout_ms Time limit.
+ * @return Line length, 0 on timeout, -1 on error.
+ */
+int FlashLink_ReadLine(flash_link_t *link, char *line, size_t size, uint32_t timeout_ms);
+
+/**
+ * @brief Receive binary data (bytes not taken by FlashLink_ReadLine() first).
+ *
+ * @param[out] data       Destination.
+ * @param[in]  len        Number of bytes to receive.
+ * @param[in]  timeout_ms Time limit for the whole transfer.
+ * @return Bytes received (less than @p len on timeout), -1 on error.
+ */
+int FlashLink_Read(flash_link_t *link, void *data, size_t len, uint32_t timeout_ms);
+
+/**
+ * @brief Discard received data not read yet.
+ */
+void FlashLink_Flush(flash_link_t *link);
+
+/**
+ * @brief Switch to 9-bit frames for an RS-485 multi-drop bus.
+ *
+ * The 9th bit is the parity bit of an 8-bit UART: space parity for data
+ * frames, mark parity for address frames (CMSPAR). Received parity is not
+ * checked. Pacing counts 11 bits per character.
+ *
+ * @return 0 on success, -1 if the device does not support it.
+ */
+int FlashLink_SetNineBit(flash_link_t *link);
+
+/**
+ * @brief Send one address frame (9th bit set) on a 9-bit link.
+ *
+ * Written characters are drained before and after the parity switch, so
+ * the frame is exactly the one character.
+ *
+ * @return 0 on success, -1 on error.
+ */
+int FlashLink_SendAddress(flash_link_t *link, uint8_t address);
+
+#endif /* FLASH_LINK_H_ */
@@ -0,0 +1,315 @@
+/**
+ * @file    flash_loopback.c
+ * @brief   Host flasher - bootloader model on a pty for tests without boards.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#define _GNU_SOURCE
+#include "flash_loopback.h"
+#include "flash_image.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define LB_LINE_MAX         (256U)      /**< MAX_LINE_LENGTH of src/main.c */
+#define LB_ERASE_MS         (200U)
+#define LB_POLL_MS          (50)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static void lb_send(flash_loopback_t *lb, const char *text)
+{
+    size_t len = strlen(text);
+    ssize_t w;
+
+    while (len > 0U) {
+        w = write(lb->master, text, len);
+        if (w <= 0) {
+            if ((w < 0) && (errno == EINTR)) {
+                continue;
+            }
+            return;
+        }
+        text += w;
+        len  -= (size_t)w;
+    }
+}
+
+static int lb_hex(const char *p, uint8_t *out)
+{
+    unsigned int v;
+
+    if ((sscanf(p, "%2x", &v) != 1) || (p[0] == '\0') || (p[1] == '\0')) {
+        return -1;
+    }
+    *out = (uint8_t)v;
+    return 0;
+}
+
+static void lb_end(flash_loopback_t *lb)
+{
+    lb_send(lb, "\r\n[INFO] Flash programming completed.\r\n"
+                "[INFO] Please RESET the board WITHOUT pressing the BOOT button.\r\n"
+                "[INFO] The new application will run after reset.\r\n");
+    lb->hex_base = 0U;
+}
+
+static void lb_data(flash_loopback_t *lb, uint32_t address, const uint8_t *data, uint32_t len)
+{
+    if ((address >= FLASH_APP_START) && (address <= FLASH_APP_END)) {
+        lb->crc = FlashPlan_Crc32(lb->crc, data, len);
+        lb->phrases += (len + FLASH_PHRASE_SIZE - 1U) / FLASH_PHRASE_SIZE;
+        lb->recs++;
+    }
+    /* Outside the application region: ignored */
+}
+
+/**
+ * @brief Handle one Intel HEX line (types 00, 01, 04, 05).
+ */
+static void lb_ihex(flash_loopback_t *lb, const char *line)
+{
+    uint8_t bytes[256];
+    uint32_t i;
+    uint8_t sum = 0U;
+
+    if (lb_hex(&line[1], &bytes[0]) != 0) {
+        lb->perr++;
+        return;
+    }
+    for (i = 1U; i < (bytes[0] + 5U); i++) {
+        if (lb_hex(&line[1U + (2U * i)], &bytes[i]) != 0) {
+            lb->perr++;
+            return;
+        }
+    }
+    for (i = 0U; i < (bytes[0] + 5U); i++) {
+        sum += bytes[i];
+    }
+    if (sum != 0U) {
+        lb->cksum++;
+        return;
+    }
+    switch (bytes[3]) {
+    case 0x00U: lb_data(lb, lb->hex_base + (((uint32_t)bytes[1] << 8) | bytes[2]), &bytes[4], bytes[0]); break;
+    case 0x01U: lb_end(lb); break;
+    case 0x04U: lb->hex_base = (((uint32_t)bytes[4] << 8) | bytes[5]) << 16; break;
+    default:    break;
+    }
+}
+
+/**
+ * @brief Handle one binary frame: STX, len, address, data, ~sum.
+ */
+static void lb_bin(flash_loopback_t *lb, const uint8_t *frame, uint32_t len)
+{
+    uint8_t sum = 0U;
+    uint32_t i;
+
+    for (i = 1U; i < len; i++) {
+        sum += frame[i];
+    }
+    if (sum != 0xFFU) {
+        lb->cksum++;
+    } else if (frame[1] == 0U) {
+        lb_end(lb);
+    } else {
+        lb_data(lb, ((uint32_t)frame[2] << 24) | ((uint32_t)frame[3] << 16) |
+                    ((uint32_t)frame[4] << 8) | frame[5], &frame[6], frame[1]);
+    }
+}
+
+/**
+ * @brief Handle one S-record line like Bootloader_Mode().
+ */
+static void lb_record(flash_loopback_t *lb, const char *line)
+{
+    uint8_t bytes[256];
+    uint32_t addr_len;
+    uint32_t address = 0U;
+    uint32_t i;
+    uint8_t sum = 0U;
+
+    switch (line[1]) {
+    case '1': case '9': addr_len = 2U; break;
+    case '2': case '8': addr_len = 3U; break;
+    case '3': case '7': addr_len = 4U; break;
+    default:            return;             /* S0, S5: ignored */
+    }
+
+    if ((lb_hex(&line[2], &bytes[0]) != 0) || (bytes[0] < (addr_len + 1U))) {
+        lb->perr++;
+        return;
+    }
+    for (i = 1U; i <= bytes[0]; i++) {
+        if (lb_hex(&line[2U * (i + 1U)], &bytes[i]) != 0) {
+            lb->perr++;
+            return;
+        }
+    }
+    for (i = 0U; i <= bytes[0]; i++) {
+        sum += bytes[i];
+    }
+    if (sum != 0xFFU) {
+        lb->cksum++;
+        return;
+    }
+    for (i = 0U; i < addr_len; i++) {
+        address = (address << 8) | bytes[1U + i];
+    }
+
+    if ((line[1] >= '7') && (line[1] <= '9')) {
+        lb_end(lb);
+    } else {
+        lb_data(lb, address, &bytes[1U + addr_len], bytes[0] - addr_len - 1U);
+    }
+}
+
+static void lb_stats(flash_loopback_t *lb)
+{
+    char text[320];
+
+    (void)snprintf(text, sizeof(text),
+                   "[STATS] rx=%u ovr=0 fe=0 nf=0 bufdrop=0 bufhw=0 lines=%u linelong=0 "
+                   "qdrop=0 qhw=0 perr=%u cksum=%u recs=%u phrases=%u pherr=0 sectors=118\r\n",
+                   lb->rx, lb->lines, lb->perr, lb->cksum, lb->recs, lb->phrases);
+    lb_send(lb, text);
+}
+
+static void *lb_thread(void *arg)
+{
+    flash_loopback_t *lb = (flash_loopback_t *)arg;
+    struct timespec erase = { 0, (long)LB_ERASE_MS * 1000000L };
+    char line[LB_LINE_MAX];
+    uint32_t pos = 0U;
+    uint32_t need = 0U;         /* Bytes missing from a binary frame */
+    struct pollfd pfd;
+    uint8_t buf[256];
+    ssize_t r;
+    ssize_t i;
+
+    lb_send(lb, "BOOT READY\n[BOOT] Please send USER APP SREC file...\r\n");
+    (void)nanosleep(&erase, NULL);
+    lb_send(lb, "[FLASH] Ready\r\n");
+
+    while (atomic_load(&lb->stop) == 0) {
+        pfd.fd      = lb->master;
+        pfd.events  = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, LB_POLL_MS) <= 0) {
+            continue;
+        }
+        r = read(lb->master, buf, sizeof(buf));
+        if (r <= 0) {
+            continue;
+        }
+        for (i = 0; i < r; i++) {
+            lb->rx++;
+            if ((need != 0U) || ((pos == 0U) && (buf[i] == FLASH_BIN_SOF))) {
+                /* Binary frame: length-counted like Bootloader_Mode() */
+                line[pos++] = (char)buf[i];
+                need = (pos == 1U) ? 1U : (need - 1U);
+                if (pos == 2U) {
+                    need = buf[i] + FLASH_BIN_OVERHEAD - 2U;
+                } else if (need == 0U) {
+                    lb->lines++;
+                    lb_bin(lb, (const uint8_t *)line, pos);
+                    pos = 0U;
+                }
+                continue;
+            }
+            if (buf[i] != '\n') {
+                if (pos < (sizeof(line) - 1U)) {
+                    line[pos++] = (char)buf[i];
+                } else {
+                    pos = 0U;
+                }
+                continue;
+            }
+            if (pos == 0U) {
+                continue;
+            }
+            line[pos] = '\0';
+            pos = 0U;
+            lb->lines++;
+            if ((line[0] == 'S') && (line[1] >= '0') && (line[1] <= '9')) {
+                lb_record(lb, line);
+            } else if (line[0] == ':') {
+                lb_ihex(lb, line);
+            } else if (strncmp(line, "STATS", 5U) == 0) {
+                lb_stats(lb);
+            } else {
+                /* Unknown command, ignored */
+            }
+        }
+    }
+    return NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+int FlashLoopback_Start(flash_loopback_t *lb)
+{
+    struct termios tio;
+    const char *name;
+
+    memset(lb, 0, sizeof(*lb));
+    lb->slave = -1;
+    lb->master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if ((lb->master < 0) || (grantpt(lb->master) != 0) || (unlockpt(lb->master) != 0) ||
+        ((name = ptsname(lb->master)) == NULL)) {
+        goto err;
+    }
+    (void)snprintf(lb->path, sizeof(lb->path), "%s", name);
+
+    /* Raw before the banner is written: a cooked pty would echo it back */
+    lb->slave = open(lb->path, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if ((lb->slave < 0) || (tcgetattr(lb->slave, &tio) != 0)) {
+        goto err;
+    }
+    cfmakeraw(&tio);
+    if (tcsetattr(lb->slave, TCSANOW, &tio) != 0) {
+        goto err;
+    }
+
+    if (pthread_create(&lb->thread, NULL, lb_thread, lb) != 0) {
+        goto err;
+    }
+    return 0;
+
+err:
+    if (lb->slave >= 0) {
+        (void)close(lb->slave);
+    }
+    if (lb->master >= 0) {
+        (void)close(lb->master);
+    }
+    return -1;
+}
+
+void FlashLoopback_Stop(flash_loopback_t *lb)
+{
+    atomic_store(&lb->stop, 1);
+    (void)pthread_join(lb->thread, NULL);
+    (void)close(lb->slave);
+    (void)close(lb->master);
+}
@@ -0,0 +1,62 @@
+/**
+ * @file    flash_loopback.h
+ * @brief   Host flasher - bootloader model on a pty for tests without boards.
+ *
+ * Each loopback port is a pty whose master side is served by a thread that
+ * answers like src/main.c in bootloader mode: the boot banner, a short erase
+ * delay, "[FLASH] Ready", records (S-record, Intel HEX or binary frames,
+ * boot_record.h) checked and counted, STATS replies
+ * in the boot_stats.c format and the completion message after S7/S8/S9.
+ * The data of the records is folded into a CRC-32 in arrival order, which
+ * must match the plan's CRC.
+ *
+ * The model does not limit the receive rate; the flasher paces at the baud
+ * rate as for a board. It tests the host side (pacing, acknowledgement,
+ * parallel ports), not the firmware: use tools/host_sim for that.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#ifndef FLASH_LOOPBACK_H_
+#define FLASH_LOOPBACK_H_
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+/**
+ * @brief One loopback port.
+ */
+typedef struct {
+    char        path[64];       /**< pty slave, opened by the session      */
+    int         master;
+    int         slave;          /**< Kept open: the master never sees EOF  */
+    pthread_t   thread;
+    _Atomic int stop;
+
+    /* Counters, valid after FlashLoopback_Stop() */
+    uint32_t    rx;
+    uint32_t    lines;
+    uint32_t    recs;
+    uint32_t    phrases;
+    uint32_t    perr;
+    uint32_t    cksum;
+    uint32_t    crc;            /**< CRC-32 of the record data             */
+    uint32_t    hex_base;       /**< Intel HEX type 04 address base        */
+} flash_loopback_t;
+
+/**
+ * @brief Create the pty and start the bootloader model.
+ * @return 0 on success, -1 on error (errno set).
+ */
+int FlashLoopback_Start(flash_loopback_t *lb);
+
+/**
+ * @brief Stop the model and close the pty.
+ */
+void FlashLoopback_Stop(flash_loopback_t *lb);
+
+#endif /* FLASH_LOOPBACK_H_ */
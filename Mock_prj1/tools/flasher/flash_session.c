@@ -0,0 +1,655 @@
+/**
+ * @file    flash_session.c
+ * @brief   Host flasher - one flashing session on one port.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "flash_session.h"
+#include "flash_link.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define REPLY_TIMEOUT_MS    (3000U)     /**< Plus the reply's own wire time */
+#define REPLY_CHARS         (150U)      /**< Length of a STATS reply        */
+#define DONE_TIMEOUT_MS     (5000U)
+
+#define MSG_READY           "[FLASH] Ready"
+#define MSG_BOOT_WAIT       "[BOOT] Please send"
+#define MSG_APP_BOOT        "Button not pressed"
+#define MSG_DONE            "[INFO] Flash programming completed."
+#define MSG_STATS           "[STATS]"
+#define MSG_MAP             "[MAP] "
+
+#define BCAST_ADDRESS       (0xFFU)     /**< HAL_USART_BROADCAST           */
+#define REPAIR_ROUNDS       (3U)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Types                                  */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Counters of the bootloader's STATS line (boot_stats.c).
+ */
+typedef struct {
+    uint32_t rx;
+    uint32_t ovr;
+    uint32_t fe;
+    uint32_t nf;
+    uint32_t bufdrop;
+    uint32_t bufhw;
+    uint32_t lines;
+    uint32_t linelong;
+    uint32_t qdrop;
+    uint32_t qhw;
+    uint32_t perr;
+    uint32_t cksum;
+    uint32_t recs;
+    uint32_t phrases;
+    uint32_t pherr;
+} boot_counters_t;
+
+typedef struct {
+    const char *key;
+    size_t      offset;
+    int         error;          /**< Must not change during a session */
+} counter_key_t;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+#define COUNTER(name, err)  { #name, offsetof(boot_counters_t, name), (err) }
+
+static const counter_key_t counter_keys[] = {
+    COUNTER(rx,       0),
+    COUNTER(ovr,      1),
+    COUNTER(fe,       1),
+    COUNTER(nf,       1),
+    COUNTER(bufdrop,  1),
+    COUNTER(bufhw,    0),
+    COUNTER(lines,    0),
+    COUNTER(linelong, 1),
+    COUNTER(qdrop,    1),
+    COUNTER(qhw,      0),
+    COUNTER(perr,     1),
+    COUNTER(cksum,    1),
+    COUNTER(recs,     0),
+    COUNTER(phrases,  0),
+    COUNTER(pherr,    1),
+};
+
+#define COUNTER_KEYS    (sizeof(counter_keys) / sizeof(counter_keys[0]))
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static int fail(flash_session_t *s, const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    (void)vsnprintf(s->error, sizeof(s->error), fmt, ap);
+    va_end(ap);
+    atomic_store(&s->state, FLASH_STATE_FAILED);
+    return -1;
+}
+
+static uint32_t counter(const boot_counters_t *c, size_t i)
+{
+    return *(const uint32_t *)((const uint8_t *)c + counter_keys[i].offset);
+}
+
+static uint32_t ms_left(uint64_t deadline)
+{
+    uint64_t now = FlashLink_NowNs();
+
+    return (now < deadline) ? (uint32_t)((deadline - now) / 1000000ULL) : 0U;
+}
+
+/**
+ * @brief Parse "[STATS] key=value ..." into @p c (unknown keys ignored).
+ */
+static void parse_stats(const char *line, boot_counters_t *c)
+{
+    const char *p = line + strlen(MSG_STATS);
+    const char *eq;
+    size_t klen;
+    size_t i;
+
+    memset(c, 0, sizeof(*c));
+    while (*p != '\0') {
+        while (*p == ' ') {
+            p++;
+        }
+        eq = strchr(p, '=');
+        if (eq == NULL) {
+            break;
+        }
+        klen = (size_t)(eq - p);
+        for (i = 0U; i < COUNTER_KEYS; i++) {
+            if ((strlen(counter_keys[i].key) == klen) &&
+                (strncmp(counter_keys[i].key, p, klen) == 0)) {
+                *(uint32_t *)((uint8_t *)c + counter_keys[i].offset) =
+                    (uint32_t)strtoul(eq + 1, NULL, 10);
+            }
+        }
+        p = strchr(eq, ' ');
+        if (p == NULL) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Send STATS and wait for the reply.
+ * @return 0 on success, -1 on timeout or link error.
+ */
+static int query_stats(flash_link_t *link, boot_counters_t *c)
+{
+    char line[FLASH_LINK_LINE_MAX];
+    uint32_t timeout = REPLY_TIMEOUT_MS + ((REPLY_CHARS * 10U * 1000U) / link->baud);
+    uint64_t deadline;
+    int n;
+
+    if (FlashLink_Write(link, "STATS\n", 6U) != 0) {
+        return -1;
+    }
+    deadline = FlashLink_NowNs() + ((uint64_t)timeout * 1000000ULL);
+    while (ms_left(deadline) > 0U) {
+        n = FlashLink_ReadLine(link, line, sizeof(line), ms_left(deadline));
+        if (n < 0) {
+            return -1;
+        }
+        if ((n > 0) && (strncmp(line, MSG_STATS, strlen(MSG_STATS)) == 0)) {
+            parse_stats(line, c);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Compare two STATS replies.
+ *
+ * @param[in] base Counters at the start of the session.
+ * @param[in] now  Current counters.
+ * @param[in] recs Records sent since @p base.
+ * @return 0 if every record arrived and no error counter moved.
+ */
+static int check_stats(flash_session_t *s, const boot_counters_t *base,
+                       const boot_counters_t *now, uint32_t recs)
+{
+    size_t i;
+
+    for (i = 0U; i < COUNTER_KEYS; i++) {
+        if ((counter_keys[i].error != 0) && (counter(now, i) != counter(base, i))) {
+            return fail(s, "bootloader %s counter %u -> %u after %u records",
+                        counter_keys[i].key, counter(base, i), counter(now, i), recs);
+        }
+    }
+    if ((now->recs - base->recs) != recs) {
+        return fail(s, "%u records sent, bootloader programmed %u", recs, now->recs - base->recs);
+    }
+    return 0;
+}
+
+/**
+ * @brief Wait for "[FLASH] Ready".
+ * @return 0 when ready, -1 otherwise.
+ */
+static int wait_ready(flash_session_t *s, flash_link_t *link)
+{
+    char line[FLASH_LINK_LINE_MAX];
+    uint64_t deadline = FlashLink_NowNs() + ((uint64_t)s->opt->ready_s * 1000000000ULL);
+    uint64_t t_wait = 0U;
+    int n;
+
+    while (ms_left(deadline) > 0U) {
+        n = FlashLink_ReadLine(link, line, sizeof(line), ms_left(deadline));
+        if (n < 0) {
+            return fail(s, "read: %s", strerror(errno));
+        }
+        if (n == 0) {
+            continue;
+        }
+        if (strstr(line, MSG_BOOT_WAIT) != NULL) {
+            t_wait = FlashLink_NowNs();
+        } else if (strstr(line, MSG_APP_BOOT) != NULL) {
+            return fail(s, "the board started the application; hold BOOT during reset");
+        } else if (strstr(line, MSG_READY) != NULL) {
+            s->erase_ns = (t_wait != 0U) ? (FlashLink_NowNs() - t_wait) : 0U;
+            return 0;
+        } else {
+            /* Other bootloader output */
+        }
+    }
+    return fail(s, "no \"%s\" within %u s (use -s if the bootloader already waits)",
+                MSG_READY, s->opt->ready_s);
+}
+
+/**
+ * @brief Wait for the completion message after the S7 record.
+ */
+static int wait_done(flash_link_t *link)
+{
+    char line[FLASH_LINK_LINE_MAX];
+    uint64_t deadline = FlashLink_NowNs() + ((uint64_t)DONE_TIMEOUT_MS * 1000000ULL);
+    int n;
+
+    while (ms_left(deadline) > 0U) {
+        n = FlashLink_ReadLine(link, line, sizeof(line), ms_left(deadline));
+        if (n < 0) {
+            return -1;
+        }
+        if ((n > 0) && (strstr(line, MSG_DONE) != NULL)) {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Handshake, records, S7 and checks on an open link.
+ */
+static int run_link(flash_session_t *s, flash_link_t *link)
+{
+    const flash_plan_t *plan = s->plan;
+    boot_counters_t base;
+    boot_counters_t now;
+    uint32_t since_sync = 0U;
+    const char *line;
+    size_t len;
+    size_t i;
+
+    if (s->opt->skip_ready == 0) {
+        atomic_store(&s->state, FLASH_STATE_WAIT);
+        if (wait_ready(s, link) != 0) {
+            return -1;
+        }
+    }
+    FlashLink_Flush(link);
+
+    /* Counters before the first record: the sync point of the session */
+    if (query_stats(link, &base) != 0) {
+        return fail(s, "no STATS reply from the bootloader");
+    }
+
+    atomic_store(&s->state, FLASH_STATE_SEND);
+    s->t0 = FlashLink_NowNs();
+    for (i = 0U; i < plan->count; i++) {
+        line = FlashPlan_Line(plan, i, &len);
+        if (FlashLink_Write(link, line, len) != 0) {
+            return fail(s, "write: %s", strerror(errno));
+        }
+        s->wire += (uint32_t)len;
+        since_sync++;
+
+        if ((s->opt->sync != 0U) && (since_sync == s->opt->sync) && ((i + 1U) < plan->count)) {
+            if (query_stats(link, &now) != 0) {
+                return fail(s, "no STATS reply after record %zu", i + 1U);
+            }
+            if (check_stats(s, &base, &now, (uint32_t)(i + 1U)) != 0) {
+                return -1;
+            }
+            since_sync = 0U;
+        }
+        atomic_fetch_add(&s->recs_done, 1U);
+        atomic_fetch_add(&s->bytes_done, plan->recs[i].len);
+    }
+
+    line = FlashPlan_Line(plan, plan->count, &len);
+    if ((FlashLink_Write(link, line, len) != 0) || (wait_done(link) != 0)) {
+        return fail(s, "no \"%s\" after the S7 record", MSG_DONE);
+    }
+    s->wire += (uint32_t)len;
+    s->t1 = FlashLink_NowNs();
+
+    if (query_stats(link, &now) != 0) {
+        return fail(s, "no STATS reply after the S7 record");
+    }
+    if (check_stats(s, &base, &now, (uint32_t)plan->count) != 0) {
+        return -1;
+    }
+    s->phrases = now.phrases - base.phrases;
+    s->bufhw   = now.bufhw;
+    s->qhw     = now.qhw;
+    return 0;
+}
+
+/* ---------------------------- Broadcast session ---------------------------- */
+
+static int node_fail(flash_node_t *n, const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    (void)vsnprintf(n->error, sizeof(n->error), fmt, ap);
+    va_end(ap);
+    n->state = FLASH_STATE_FAILED;
+    return -1;
+}
+
+static uint32_t block_of(const flash_rec_t *r)
+{
+    return (r->address - FLASH_APP_START) / FLASH_MAP_BLOCK;
+}
+
+/**
+ * @brief Send "MAP first count" and merge the reply into @p bits
+ *        (bit 0 of bits[0] is block @p origin).
+ * @return 0 on success, -1 on timeout, link error or short reply.
+ */
+static int query_map(flash_link_t *link, uint32_t origin, uint32_t first, uint32_t count,
+                     uint8_t *bits)
+{
+    char line[FLASH_LINK_LINE_MAX];
+    char cmd[32];
+    uint32_t chars = 24U + (count / 4U);
+    uint32_t timeout = REPLY_TIMEOUT_MS + ((chars * 10U * 1000U) / link->baud);
+    uint64_t deadline;
+    unsigned int r_first;
+    unsigned int r_count;
+    unsigned int v;
+    const char *hex;
+    uint32_t i;
+    uint32_t k;
+    int pos;
+    int n;
+
+    n = snprintf(cmd, sizeof(cmd), "MAP %u %u\n", first, count);
+    if (FlashLink_Write(link, cmd, (size_t)n) != 0) {
+        return -1;
+    }
+    deadline = FlashLink_NowNs() + ((uint64_t)timeout * 1000000ULL);
+    while (ms_left(deadline) > 0U) {
+        n = FlashLink_ReadLine(link, line, sizeof(line), ms_left(deadline));
+        if (n < 0) {
+            return -1;
+        }
+        if ((n == 0) || (strncmp(line, MSG_MAP, strlen(MSG_MAP)) != 0)) {
+            continue;
+        }
+        if ((sscanf(line + strlen(MSG_MAP), "%u %u %n", &r_first, &r_count, &pos) != 2) ||
+            (r_first != first) || (r_count != count)) {
+            return -1;
+        }
+        hex = line + strlen(MSG_MAP) + pos;
+        for (i = 0U; i < count; i += 8U) {
+            if (sscanf(&hex[i / 4U], "%2x", &v) != 1) {
+                return -1;
+            }
+            for (k = 0U; (k < 8U) && ((i + k) < count); k++) {
+                if ((v & (1U << k)) != 0U) {
+                    bits[(first - origin + i + k) / 8U] |= (uint8_t)(1U << ((first - origin + i + k) % 8U));
+                }
+            }
+        }
+        return 0;
+    }
+    return -1;
+}
+
+/**
+ * @brief Address one node and wait until it answers STATS.
+ */
+static int find_node(flash_broadcast_t *b, flash_link_t *link, flash_node_t *n,
+                     boot_counters_t *base, uint64_t deadline)
+{
+    n->state = FLASH_STATE_WAIT;
+    do {
+        FlashLink_Flush(link);
+        if (FlashLink_SendAddress(link, n->address) != 0) {
+            return node_fail(n, "write: %s", strerror(errno));
+        }
+        if (query_stats(link, base) == 0) {
+            n->state = FLASH_STATE_SEND;
+            return 0;
+        }
+    } while (ms_left(deadline) > 0U);
+    return node_fail(n, "node 0x%02X did not answer within %u s", n->address, b->opt->ready_s);
+}
+
+/**
+ * @brief Query a node's block map, resend what it missed, end with S7.
+ */
+static int repair_node(flash_broadcast_t *b, flash_link_t *link, flash_node_t *n,
+                       const boot_counters_t *base, uint8_t *bits)
+{
+    const flash_plan_t *plan = b->plan;
+    uint32_t origin = block_of(&plan->recs[0]);
+    uint32_t blocks = block_of(&plan->recs[plan->count - 1U]) - origin + 1U;
+    boot_counters_t now;
+    const char *line;
+    uint32_t missing;
+    uint32_t first;
+    uint32_t k;
+    size_t len;
+    size_t i;
+
+    if (FlashLink_SendAddress(link, n->address) != 0) {
+        return node_fail(n, "write: %s", strerror(errno));
+    }
+    for (n->rounds = 0U; ; n->rounds++) {
+        memset(bits, 0, (blocks + 7U) / 8U);
+        for (first = 0U; first < blocks; first += FLASH_MAP_QUERY_MAX) {
+            if (query_map(link, origin, origin + first,
+                          ((blocks - first) < FLASH_MAP_QUERY_MAX) ? (blocks - first) : FLASH_MAP_QUERY_MAX,
+                          bits) != 0) {
+                return node_fail(n, "no MAP reply from node 0x%02X", n->address);
+            }
+        }
+
+        missing = 0U;
+        for (i = 0U; i < plan->count; i++) {
+            k = block_of(&plan->recs[i]) - origin;
+            if ((bits[k / 8U] & (1U << (k % 8U))) != 0U) {
+                continue;
+            }
+            missing++;
+            if (n->rounds == REPAIR_ROUNDS) {
+                continue;
+            }
+            line = FlashPlan_Line(plan, i, &len);
+            if (FlashLink_Write(link, line, len) != 0) {
+                return node_fail(n, "write: %s", strerror(errno));
+            }
+            b->wire += (uint32_t)len;
+            n->repaired++;
+        }
+        if (n->rounds == 0U) {
+            n->missing = missing;
+        }
+        if (missing == 0U) {
+            break;
+        }
+        if (n->rounds == REPAIR_ROUNDS) {
+            return node_fail(n, "%u records still missing after %u rounds", missing, REPAIR_ROUNDS);
+        }
+    }
+
+    line = FlashPlan_Line(plan, plan->count, &len);
+    if ((FlashLink_Write(link, line, len) != 0) || (wait_done(link) != 0)) {
+        return node_fail(n, "no \"%s\" after the S7 record", MSG_DONE);
+    }
+    b->wire += (uint32_t)len;
+    n->t_done = FlashLink_NowNs();
+
+    /* Parse and checksum errors are expected on a broadcast: the map repairs
+     * them. Every record must be programmed exactly once, though. */
+    if (query_stats(link, &now) != 0) {
+        return node_fail(n, "no STATS reply after the S7 record");
+    }
+    if ((now.recs - base->recs) != plan->count) {
+        return node_fail(n, "%zu records planned, node programmed %u",
+                         plan->count, now.recs - base->recs);
+    }
+    if (now.pherr != base->pherr) {
+        return node_fail(n, "bootloader pherr counter %u -> %u", base->pherr, now.pherr);
+    }
+    n->phrases = now.phrases - base->phrases;
+    n->state   = FLASH_STATE_DONE;
+    return 0;
+}
+
+static int run_broadcast(flash_broadcast_t *b, flash_link_t *link)
+{
+    const flash_plan_t *plan = b->plan;
+    boot_counters_t base[FLASH_NODES_MAX];
+    uint64_t deadline = FlashLink_NowNs() + ((uint64_t)b->opt->ready_s * 1000000000ULL);
+    uint32_t blocks;
+    uint8_t *bits;
+    uint32_t found = 0U;
+    int rc = 0;
+    const char *line;
+    size_t len;
+    size_t i;
+
+    /* 1. Every node erased and listening */
+    atomic_store(&b->state, FLASH_STATE_WAIT);
+    for (i = 0U; i < b->node_count; i++) {
+        if (find_node(b, link, &b->nodes[i], &base[i], deadline) == 0) {
+            found++;
+        }
+    }
+    if (found == 0U) {
+        (void)snprintf(b->error, sizeof(b->error), "no node answered");
+        atomic_store(&b->state, FLASH_STATE_FAILED);
+        return -1;
+    }
+
+    /* 2. One copy of the records for all nodes */
+    atomic_store(&b->state, FLASH_STATE_SEND);
+    if (FlashLink_SendAddress(link, BCAST_ADDRESS) != 0) {
+        (void)snprintf(b->error, sizeof(b->error), "write: %s", strerror(errno));
+        atomic_store(&b->state, FLASH_STATE_FAILED);
+        return -1;
+    }
+    b->t0 = FlashLink_NowNs();
+    for (i = 0U; i < plan->count; i++) {
+        line = FlashPlan_Line(plan, i, &len);
+        if (FlashLink_Write(link, line, len) != 0) {
+            (void)snprintf(b->error, sizeof(b->error), "write: %s", strerror(errno));
+            atomic_store(&b->state, FLASH_STATE_FAILED);
+            return -1;
+        }
+        b->wire += (uint32_t)len;
+        atomic_fetch_add(&b->recs_done, 1U);
+    }
+    FlashLink_Drain(link);
+    b->t_bcast = FlashLink_NowNs();
+
+    /* 3. Per node: block map, resend, S7 */
+    blocks = block_of(&plan->recs[plan->count - 1U]) - block_of(&plan->recs[0]) + 1U;
+    bits   = malloc((blocks + 7U) / 8U);
+    if (bits == NULL) {
+        (void)snprintf(b->error, sizeof(b->error), "out of memory");
+        atomic_store(&b->state, FLASH_STATE_FAILED);
+        return -1;
+    }
+    for (i = 0U; i < b->node_count; i++) {
+        if ((b->nodes[i].state == FLASH_STATE_SEND) &&
+            (repair_node(b, link, &b->nodes[i], &base[i], bits) == 0)) {
+            continue;
+        }
+        rc = -1;
+    }
+    free(bits);
+    b->t1 = FlashLink_NowNs();
+    atomic_store(&b->state, (rc == 0) ? FLASH_STATE_DONE : FLASH_STATE_FAILED);
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+int FlashSession_Run(flash_session_t *s)
+{
+    char tag[64];
+    flash_link_t link;
+    int rc;
+
+    atomic_store(&s->state, FLASH_STATE_OPEN);
+    s->t_start = FlashLink_NowNs();
+    if (FlashLink_Open(&link, s->device, s->opt->baud, s->opt->pace) != 0) {
+        return fail(s, "%s", strerror(errno));
+    }
+    (void)snprintf(tag, sizeof(tag), "%s ", s->device);
+    link.echo = s->opt->verbose;
+    link.tag  = tag;
+
+    rc = run_link(s, &link);
+    if (rc == 0) {
+        atomic_store(&s->state, FLASH_STATE_DONE);
+    }
+
+    FlashLink_Drain(&link);
+    FlashLink_Close(&link);
+    return rc;
+}
+
+int FlashSession_RunBroadcast(flash_broadcast_t *b)
+{
+    flash_link_t link;
+    int rc;
+
+    atomic_store(&b->state, FLASH_STATE_OPEN);
+    b->t_start = FlashLink_NowNs();
+    if ((b->node_count == 0U) || (b->node_count > FLASH_NODES_MAX) || (b->plan->count == 0U)) {
+        (void)snprintf(b->error, sizeof(b->error), "no node or no record");
+        atomic_store(&b->state, FLASH_STATE_FAILED);
+        return -1;
+    }
+    if (FlashLink_Open(&link, b->device, b->opt->baud, b->opt->pace) != 0) {
+        (void)snprintf(b->error, sizeof(b->error), "%s", strerror(errno));
+        atomic_store(&b->state, FLASH_STATE_FAILED);
+        return -1;
+    }
+    if (FlashLink_SetNineBit(&link) != 0) {
+        (void)snprintf(b->error, sizeof(b->error), "no mark/space parity: %s", strerror(errno));
+        atomic_store(&b->state, FLASH_STATE_FAILED);
+        FlashLink_Close(&link);
+        return -1;
+    }
+    link.echo = b->opt->verbose;
+    link.tag  = "";
+
+    rc = run_broadcast(b, &link);
+
+    FlashLink_Drain(&link);
+    FlashLink_Close(&link);
+    return rc;
+}
+
+void *FlashSession_Thread(void *arg)
+{
+    (void)FlashSession_Run((flash_session_t *)arg);
+    return NULL;
+}
+
+const char *FlashSession_StateName(flash_state_t state)
+{
+    switch (state) {
+    case FLASH_STATE_IDLE:   return "idle";
+    case FLASH_STATE_OPEN:   return "open";
+    case FLASH_STATE_WAIT:   return "wait";
+    case FLASH_STATE_SEND:   return "send";
+    case FLASH_STATE_DONE:   return "done";
+    case FLASH_STATE_FAILED: return "FAILED";
+    default:                 return "?";
+    }
+}
@@ -0,0 +1,156 @@
+/**
+ * @file    flash_session.h
+ * @brief   Host flasher - one flashing session on one port.
+ *
+ * Session:
+ *   1. Handshake: wait for "[FLASH] Ready", printed after the application
+ *      region is erased. A board that boots the application instead is
+ *      reported at once.
+ *   2. The plan's lines are sent at the wire rate. Every N records the
+ *      session sends STATS and waits for the reply: the bootloader handles a
+ *      command only after every earlier line is programmed, so the reply is
+ *      an acknowledgement. Its counters must show N more records and no new
+ *      overrun, drop, parse or checksum error.
+ *   3. The S7 record is sent; the session ends with
+ *      "[INFO] Flash programming completed." and a last STATS check.
+ *
+ * A session only reads the plan. Several sessions run in parallel threads
+ * on one plan; progress fields are updated atomically for the monitor.
+ *
+ * Broadcast session (RS-485 bus, bootloaders built with BOOT_MULTIDROP):
+ *   1. Each node is addressed and polled with STATS until it answers.
+ *   2. The records are sent once to the broadcast address; no node answers.
+ *   3. Each node is addressed in turn: its block map (MAP) shows the
+ *      records it missed, which are resent to it alone until the map is
+ *      complete; the S7 record and a STATS check end the node's session.
+ * The plan must be cut into FLASH_MAP_BLOCK records on the block grid.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#ifndef FLASH_SESSION_H_
+#define FLASH_SESSION_H_
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "flash_image.h"
+
+/**
+ * @brief Session options, shared by all ports.
+ */
+typedef struct {
+    uint32_t baud;
+    uint32_t sync;              /**< Records between STATS checks, 0 = end only */
+    uint32_t ready_s;           /**< Handshake time limit                       */
+    int      skip_ready;        /**< Bootloader already waits: no handshake      */
+    int      pace;              /**< Pace writes at the character time           */
+    int      verbose;           /**< Print bootloader output                     */
+} flash_session_opt_t;
+
+typedef enum {
+    FLASH_STATE_IDLE = 0,
+    FLASH_STATE_OPEN,
+    FLASH_STATE_WAIT,           /**< Waiting for "[FLASH] Ready"                 */
+    FLASH_STATE_SEND,
+    FLASH_STATE_DONE,
+    FLASH_STATE_FAILED
+} flash_state_t;
+
+/**
+ * @brief One port.
+ */
+typedef struct {
+    /* Input */
+    const char                *device;
+    const flash_plan_t        *plan;
+    const flash_session_opt_t *opt;
+
+    /* Progress, written by the session, read by the monitor */
+    _Atomic int               state;
+    _Atomic uint32_t          recs_done;
+    _Atomic uint32_t          bytes_done;
+
+    /* Result, valid after the session returned */
+    uint64_t t_start;           /**< Port opened                                 */
+    uint64_t t0;                /**< First record sent                           */
+    uint64_t t1;                /**< Completion message received                 */
+    uint64_t erase_ns;          /**< "[BOOT] Please send" to "[FLASH] Ready"     */
+    uint32_t wire;              /**< Characters of record lines sent             */
+    uint32_t phrases;           /**< Phrases programmed (bootloader counter)     */
+    uint32_t bufhw;             /**< UART buffer high-water mark                 */
+    uint32_t qhw;               /**< SREC queue high-water mark                  */
+    char     error[160];
+} flash_session_t;
+
+/** Most nodes on one bus. */
+#define FLASH_NODES_MAX         (32U)
+
+/**
+ * @brief One node of a broadcast session.
+ */
+typedef struct {
+    uint8_t  address;           /**< 0x80..0xFE (hal_usart.h)                    */
+    int      state;             /**< flash_state_t                               */
+    uint32_t missing;           /**< Records missing after the broadcast         */
+    uint32_t repaired;          /**< Records resent to this node                 */
+    uint32_t rounds;            /**< MAP / resend rounds                         */
+    uint32_t phrases;           /**< Phrases programmed (bootloader counter)     */
+    uint64_t t_done;            /**< Completion message received                 */
+    char     error[160];
+} flash_node_t;
+
+/**
+ * @brief Broadcast session on one RS-485 port.
+ */
+typedef struct {
+    /* Input */
+    const char                *device;
+    const flash_plan_t        *plan;
+    const flash_session_opt_t *opt;
+    flash_node_t              *nodes;
+    size_t                     node_count;
+
+    /* Progress of the broadcast */
+    _Atomic int               state;
+    _Atomic uint32_t          recs_done;
+
+    /* Result */
+    uint64_t t_start;           /**< Port opened                                 */
+    uint64_t t0;                /**< Broadcast started                           */
+    uint64_t t_bcast;           /**< Broadcast sent                              */
+    uint64_t t1;                /**< Last node done                              */
+    uint32_t wire;              /**< Characters sent, all addresses              */
+    char     error[160];
+} flash_broadcast_t;
+
+/**
+ * @brief Run one session: open the port, flash the plan, close the port.
+ *
+ * Usable as a thread body through FlashSession_Thread().
+ *
+ * @return 0 on success, -1 on failure (text in s->error).
+ */
+int FlashSession_Run(flash_session_t *s);
+
+/**
+ * @brief pthread entry point for FlashSession_Run().
+ */
+void *FlashSession_Thread(void *arg);
+
+/**
+ * @brief Run a broadcast session: open the port, flash every node, close.
+ *
+ * @return 0 if every node completed, -1 otherwise (per-node errors in
+ *         b->nodes[i].error, link errors in b->error).
+ */
+int FlashSession_RunBroadcast(flash_broadcast_t *b);
+
+/**
+ * @brief Short name of a state for progress output.
+ */
+const char *FlashSession_StateName(flash_state_t state);
+
+#endif /* FLASH_SESSION_H_ */
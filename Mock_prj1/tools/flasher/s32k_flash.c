@@ -0,0 +1,448 @@
+/**
+ * @file    s32k_flash.c
+ * @brief   Host flasher for the S32K144 UART bootloader (Mock_prj1).
+ *
+ * The image (S-record, Intel HEX, or binary at the application start) is
+ * read once, before any port is opened: all-0xFF phrases are dropped and the
+ * rest is cut into phrase-aligned S3 records of up to FLASH_REC_MAX bytes
+ * (flash_image.c). Every port given with -d then runs its own session
+ * (flash_session.c) in a thread on that shared, read-only plan, so a
+ * station with N USB-UART adapters flashes N boards in the time of one.
+ *
+ * Bytes/s, records/s and the end-to-end time are printed per port and for
+ * the whole run, so every firmware change can be measured the same way on a
+ * board, the host simulator (tools/host_sim) or QEMU (tools/qemu_an386).
+ * With -L N the ports are N ptys served by a bootloader model
+ * (flash_loopback.c), to test the station without boards.
+ *
+ * With -B the port is an RS-485 bus of bootloaders built with BOOT_MULTIDROP:
+ * the image is sent once to every node and each node's gaps are repaired
+ * afterwards (FlashSession_RunBroadcast()).
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "flash_image.h"
+#include "flash_link.h"
+#include "flash_loopback.h"
+#include "flash_session.h"
+
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define DEFAULT_BAUD        (9600U)     /**< UART_BAUDRATE of src/main.c */
+#define DEFAULT_SYNC        (32U)       /**< Records between STATS checks */
+#define DEFAULT_READY_S     (60U)
+#define MAX_PORTS           (32U)
+#define MONITOR_MS          (250L)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static const char *const format_names[] = { "srec", "ihex", "bin" };
+
+static flash_session_opt_t opt = {
+    .baud    = DEFAULT_BAUD,
+    .sync    = DEFAULT_SYNC,
+    .ready_s = DEFAULT_READY_S,
+    .pace    = 1,
+};
+
+static const char      *devices[MAX_PORTS];
+static uint32_t         device_count;
+static flash_session_t  sessions[MAX_PORTS];
+static flash_loopback_t loops[MAX_PORTS];
+static flash_node_t     nodes[FLASH_NODES_MAX];
+static uint32_t         node_count;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static double seconds(uint64_t ns)
+{
+    return (double)ns / 1e9;
+}
+
+static int all_finished(void)
+{
+    uint32_t i;
+    int st;
+
+    for (i = 0U; i < device_count; i++) {
+        st = atomic_load(&sessions[i].state);
+        if ((st != FLASH_STATE_DONE) && (st != FLASH_STATE_FAILED)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Progress: one line per port, redrawn in place on a terminal.
+ */
+static void monitor(const flash_plan_t *plan, uint64_t t_start, int redraw)
+{
+    double t = seconds(FlashLink_NowNs() - t_start);
+    uint32_t total = 0U;
+    uint32_t bytes;
+    uint32_t i;
+
+    if (redraw != 0) {
+        fprintf(stderr, "\033[%uA", device_count + 1U);
+    }
+    for (i = 0U; i < device_count; i++) {
+        bytes  = atomic_load(&sessions[i].bytes_done);
+        total += bytes;
+        fprintf(stderr, "\033[2K  %-24s %-6s %4u/%zu records %7u bytes\n",
+                sessions[i].device,
+                FlashSession_StateName((flash_state_t)atomic_load(&sessions[i].state)),
+                atomic_load(&sessions[i].recs_done), plan->count, bytes);
+    }
+    fprintf(stderr, "\033[2K  %u ports  %.1f s  %.0f B/s total\n",
+            device_count, t, (t > 0.0) ? ((double)total / t) : 0.0);
+}
+
+/**
+ * @brief Result table and aggregate throughput.
+ * @return Number of failed ports.
+ */
+static uint32_t report(const flash_plan_t *plan, uint64_t t_start, uint64_t t_end, int loopback)
+{
+    const flash_session_t *s;
+    uint32_t failed = 0U;
+    uint32_t bytes = 0U;
+    uint32_t recs = 0U;
+    double t;
+    uint32_t i;
+
+    printf("\n  %-24s %-6s %8s %8s %9s %9s %9s  %s\n",
+           "port", "state", "records", "bytes", "erase s", "xfer s", "B/s", "result");
+    for (i = 0U; i < device_count; i++) {
+        s = &sessions[i];
+        if (atomic_load(&s->state) != FLASH_STATE_DONE) {
+            printf("  %-24s %-6s %8u %8u %9s %9s %9s  %s\n", s->device, "FAILED",
+                   atomic_load(&s->recs_done), atomic_load(&s->bytes_done), "-", "-", "-", s->error);
+            failed++;
+            continue;
+        }
+        t = seconds(s->t1 - s->t0);
+        bytes += plan->bytes;
+        recs  += (uint32_t)plan->count;
+        printf("  %-24s %-6s %8zu %8u %9.2f %9.2f %9.1f  ok",
+               s->device, "done", plan->count, plan->bytes, seconds(s->erase_ns), t,
+               (double)plan->bytes / t);
+        if (loopback != 0) {
+            if (loops[i].crc == plan->crc) {
+                printf(", crc %08X", loops[i].crc);
+            } else {
+                printf(", CRC MISMATCH %08X", loops[i].crc);
+                failed++;
+            }
+        }
+        printf("\n");
+    }
+
+    t = seconds(t_end - t_start);
+    printf("[DONE] %u/%u ports in %.2f s: %u bytes, %u records, %.1f B/s, %.2f records/s total\n",
+           device_count - failed, device_count, t, bytes, recs,
+           (double)bytes / t, (double)recs / t);
+    if (device_count == 1U) {
+        s = &sessions[0];
+        if (failed == 0U) {
+            t = seconds(s->t1 - s->t0);
+            printf("       %u phrases, wire %u chars = %.0f%% of %u baud\n",
+                   s->phrases, s->wire, (100.0 * (double)s->wire * 10.0) / ((double)opt.baud * t),
+                   opt.baud);
+            printf("       end-to-end %.2f s (handshake %.2f s, transfer %.2f s)\n",
+                   seconds(s->t1 - s->t_start), seconds(s->t0 - s->t_start), t);
+            printf("       bootloader: bufhw=%u qhw=%u\n", s->bufhw, s->qhw);
+        }
+    }
+    return failed;
+}
+
+/**
+ * @brief Parse "0x81,0x82,..." into nodes[].
+ * @return 0 on success, -1 on a bad or duplicate address.
+ */
+static int parse_nodes(const char *list)
+{
+    char *end;
+    unsigned long a;
+    uint32_t i;
+
+    while (*list != '\0') {
+        a = strtoul(list, &end, 0);
+        if ((end == list) || (a < 0x80UL) || (a > 0xFEUL) || (node_count == FLASH_NODES_MAX)) {
+            return -1;
+        }
+        for (i = 0U; i < node_count; i++) {
+            if (nodes[i].address == (uint8_t)a) {
+                return -1;
+            }
+        }
+        nodes[node_count++].address = (uint8_t)a;
+        list = (*end == ',') ? (end + 1) : end;
+        if ((*end != ',') && (*end != '\0')) {
+            return -1;
+        }
+    }
+    return (node_count != 0U) ? 0 : -1;
+}
+
+/**
+ * @brief Broadcast session on devices[0], result table per node.
+ * @return Number of failed nodes.
+ */
+static uint32_t run_broadcast(const flash_plan_t *plan)
+{
+    flash_broadcast_t b;
+    const flash_node_t *n;
+    uint32_t failed = 0U;
+    double t_unicast;
+    double t;
+    uint32_t i;
+
+    memset(&b, 0, sizeof(b));
+    b.device     = devices[0];
+    b.plan       = plan;
+    b.opt        = &opt;
+    b.nodes      = nodes;
+    b.node_count = node_count;
+    if (FlashSession_RunBroadcast(&b) != 0) {
+        if (b.error[0] != '\0') {
+            fprintf(stderr, "s32k_flash: %s: %s\n", b.device, b.error);
+        }
+    }
+
+    printf("\n  %-6s %-6s %8s %8s %8s %6s %9s  %s\n",
+           "node", "state", "records", "missing", "resent", "rounds", "done s", "result");
+    for (i = 0U; i < node_count; i++) {
+        n = &nodes[i];
+        if (n->state != FLASH_STATE_DONE) {
+            printf("  0x%02X   %-6s %8s %8s %8u %6u %9s  %s\n", n->address, "FAILED",
+                   "-", "-", n->repaired, n->rounds, "-", n->error);
+            failed++;
+            continue;
+        }
+        printf("  0x%02X   %-6s %8zu %8u %8u %6u %9.2f  ok, %u phrases\n", n->address, "done",
+               plan->count, n->missing, n->repaired, n->rounds,
+               seconds(n->t_done - b.t0), n->phrases);
+    }
+    if (b.t1 == 0U) {
+        return node_count;
+    }
+
+    /* Unicast reference: the same records sent to every node in turn */
+    t_unicast = (double)plan->wire_bytes * 10.0 * (double)node_count / (double)opt.baud;
+    t = seconds(b.t1 - b.t0);
+    printf("[DONE] %u/%u nodes in %.2f s (broadcast %.2f s, repair %.2f s), wire %u chars;\n"
+           "       %u unicast sessions would need about %.2f s\n",
+           node_count - failed, node_count, t, seconds(b.t_bcast - b.t0),
+           seconds(b.t1 - b.t_bcast), b.wire, node_count, t_unicast);
+    return failed;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "usage: %s [options] FILE.srec|FILE.hex|FILE.bin\n"
+        "  -d, --device PATH    serial device or pty, repeat for parallel flashing (max %u);\n"
+        "                       without -d or -L only the plan is printed\n"
+        "  -L, --loopback N     flash N ptys served by a bootloader model (no hardware)\n"
+        "  -B, --broadcast LIST RS-485 bus on the one -d port: node addresses 0x80..0xFE,\n"
+        "                       comma separated (bootloaders built with BOOT_MULTIDROP)\n"
+        "  -b, --baud N         baud rate (default %u)\n"
+        "  -F, --format FMT     records sent: srec, ihex or bin (default srec)\n"
+        "  -m, --max-data N     data bytes per record, multiple of 8 (default and max:\n"
+        "                       %u srec, %u ihex, %u bin)\n"
+        "  -k, --sync N         STATS check every N records, 0 = only at the end (default %u)\n"
+        "  -w, --wait S         seconds to wait for \"[FLASH] Ready\" (default %u)\n"
+        "  -s, --no-wait        the bootloader already waits for data: no handshake\n"
+        "  -P, --no-pace        do not pace writes at the baud rate\n"
+        "  -v, --verbose        print bootloader output\n",
+        prog, MAX_PORTS, DEFAULT_BAUD, FLASH_REC_MAX, FLASH_HEX_REC_MAX, FLASH_BIN_REC_MAX,
+        DEFAULT_SYNC, DEFAULT_READY_S);
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                   Main                                      */
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    static const struct option longopts[] = {
+        { "device",   required_argument, NULL, 'd' },
+        { "loopback", required_argument, NULL, 'L' },
+        { "broadcast", required_argument, NULL, 'B' },
+        { "baud",     required_argument, NULL, 'b' },
+        { "format",   required_argument, NULL, 'F' },
+        { "max-data", required_argument, NULL, 'm' },
+        { "sync",     required_argument, NULL, 'k' },
+        { "wait",     required_argument, NULL, 'w' },
+        { "no-wait",  no_argument,       NULL, 's' },
+        { "no-pace",  no_argument,       NULL, 'P' },
+        { "verbose",  no_argument,       NULL, 'v' },
+        { "help",     no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    const struct timespec tick = { 0, MONITOR_MS * 1000000L };
+    pthread_t threads[MAX_PORTS];
+    flash_format_t format = FLASH_FMT_SREC;
+    uint32_t rec_max = 0U;
+    uint32_t loopback = 0U;
+    uint32_t align = 0U;
+    uint32_t failed;
+    uint64_t t_start;
+    uint64_t t_end;
+    char err[256];
+    flash_image_t img;
+    flash_plan_t plan;
+    int show;
+    uint32_t i;
+    int c;
+
+    while ((c = getopt_long(argc, argv, "d:L:B:b:F:m:k:w:sPvh", longopts, NULL)) != -1) {
+        switch (c) {
+        case 'd':
+            if (device_count == MAX_PORTS) {
+                fprintf(stderr, "s32k_flash: at most %u ports\n", MAX_PORTS);
+                return 2;
+            }
+            devices[device_count++] = optarg;
+            break;
+        case 'L': loopback       = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'B':
+            if (parse_nodes(optarg) != 0) {
+                fprintf(stderr, "s32k_flash: bad node list \"%s\"\n", optarg);
+                return 2;
+            }
+            break;
+        case 'b': opt.baud       = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'F':
+            for (i = 0U; (i < 3U) && (strcmp(optarg, format_names[i]) != 0); i++) {
+            }
+            if (i == 3U) {
+                fprintf(stderr, "s32k_flash: unknown format \"%s\"\n", optarg);
+                return 2;
+            }
+            format = (flash_format_t)i;
+            break;
+        case 'm': rec_max        = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'k': opt.sync       = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'w': opt.ready_s    = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': opt.skip_ready = 1; break;
+        case 'P': opt.pace       = 0; break;
+        case 'v': opt.verbose    = 1; break;
+        default:
+            usage(argv[0]);
+            return (c == 'h') ? 0 : 2;
+        }
+    }
+    if ((optind != (argc - 1)) || ((loopback != 0U) && (device_count != 0U)) ||
+        (loopback > MAX_PORTS) || ((node_count != 0U) && (device_count != 1U))) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (node_count != 0U) {
+        /* One record per block of the nodes' maps; text only on the bus */
+        rec_max = FLASH_MAP_BLOCK;
+        align   = FLASH_MAP_BLOCK;
+        if (format == FLASH_FMT_BIN) {
+            fprintf(stderr, "s32k_flash: -B needs a text format (srec or ihex)\n");
+            return 2;
+        }
+    }
+    if (rec_max == 0U) {
+        rec_max = FlashPlan_RecMax(format);
+    }
+
+    /* Image preparation, once for all ports */
+    if (FlashImage_Load(&img, argv[optind], FLASH_APP_START, err, sizeof(err)) != 0) {
+        fprintf(stderr, "s32k_flash: %s\n", err);
+        return 1;
+    }
+    (void)FlashImage_DropBlank(&img);
+    if (FlashPlan_Build(&img, rec_max, FLASH_APP_START, FLASH_APP_END, align, format, &plan) != 0) {
+        fprintf(stderr, "s32k_flash: -m must be a multiple of %u up to %u\n",
+                FLASH_PHRASE_SIZE, FlashPlan_RecMax(format));
+        FlashImage_Free(&img);
+        return 2;
+    }
+    printf("%s: %u records, %u bytes -> %zu %s records of up to %u bytes, %u bytes, %u chars, crc %08X\n",
+           argv[optind], img.in_records, img.in_bytes, plan.count, format_names[format], rec_max,
+           plan.bytes, plan.wire_bytes, plan.crc);
+    if (plan.skipped != 0U) {
+        printf("  %u bytes outside 0x%08X..0x%08X not sent\n",
+               plan.skipped, FLASH_APP_START, FLASH_APP_END);
+    }
+    FlashImage_Free(&img);
+
+    for (i = 0U; i < loopback; i++) {
+        if (FlashLoopback_Start(&loops[i]) != 0) {
+            perror("s32k_flash: loopback pty");
+            return 1;
+        }
+        devices[device_count++] = loops[i].path;
+    }
+    if (device_count == 0U) {
+        FlashPlan_Free(&plan);
+        return 0;
+    }
+
+    if (node_count != 0U) {
+        failed = run_broadcast(&plan);
+        FlashPlan_Free(&plan);
+        return (failed == 0U) ? 0 : 1;
+    }
+
+    /* One session thread per port on the shared plan */
+    fflush(stdout);
+    t_start = FlashLink_NowNs();
+    for (i = 0U; i < device_count; i++) {
+        sessions[i].device = devices[i];
+        sessions[i].plan   = &plan;
+        sessions[i].opt    = &opt;
+        if (pthread_create(&threads[i], NULL, FlashSession_Thread, &sessions[i]) != 0) {
+            perror("s32k_flash: pthread_create");
+            return 1;
+        }
+    }
+
+    show = (isatty(STDERR_FILENO) != 0) && (opt.verbose == 0);
+    if (show != 0) {
+        monitor(&plan, t_start, 0);
+    }
+    while (all_finished() == 0) {
+        (void)nanosleep(&tick, NULL);
+        if (show != 0) {
+            monitor(&plan, t_start, 1);
+        }
+    }
+    for (i = 0U; i < device_count; i++) {
+        (void)pthread_join(threads[i], NULL);
+    }
+    t_end = FlashLink_NowNs();
+
+    for (i = 0U; i < loopback; i++) {
+        FlashLoopback_Stop(&loops[i]);
+    }
+    failed = report(&plan, t_start, t_end, (loopback != 0U));
+
+    FlashPlan_Free(&plan);
+    return (failed == 0U) ? 0 : 1;
+}
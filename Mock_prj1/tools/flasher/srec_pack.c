@@ -0,0 +1,148 @@
+/**
+ * @file    srec_pack.c
+ * @brief   Repack an application image into bootloader-friendly S3 records.
+ *
+ * Reads an S-record, Intel HEX or binary file and writes the records the
+ * flasher would send (flash_image.c): address-sorted, contiguous data merged,
+ * all-0xFF phrases dropped, every record on whole 8-byte phrases and as long
+ * as the bootloader's line buffer allows. A terminal program can then send
+ * the output without the 4+4 merge path or short records.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "flash_image.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "usage: %s [options] FILE.srec|FILE.hex|FILE.bin\n"
+        "  -o, --output FILE    output S-record file (default stdout)\n"
+        "  -F, --format FMT     output records: srec, ihex or bin (boot_record.h frames;\n"
+        "                       default srec)\n"
+        "  -m, --max-data N     data bytes per record, multiple of 8 (default and max:\n"
+        "                       %u srec, %u ihex, %u bin)\n"
+        "  -a, --address ADDR   load address of a binary file (default 0x%08X)\n"
+        "  -k, --keep-blank     keep phrases that are all 0xFF\n"
+        "  -A, --all            keep data outside 0x%08X..0x%08X\n",
+        prog, FLASH_REC_MAX, FLASH_HEX_REC_MAX, FLASH_BIN_REC_MAX,
+        FLASH_APP_START, FLASH_APP_START, FLASH_APP_END);
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                   Main                                      */
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    static const struct option longopts[] = {
+        { "output",     required_argument, NULL, 'o' },
+        { "format",     required_argument, NULL, 'F' },
+        { "max-data",   required_argument, NULL, 'm' },
+        { "address",    required_argument, NULL, 'a' },
+        { "keep-blank", no_argument,       NULL, 'k' },
+        { "all",        no_argument,       NULL, 'A' },
+        { "help",       no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    const char *output = NULL;
+    static const char *const names[] = { "srec", "ihex", "bin" };
+    flash_format_t format = FLASH_FMT_SREC;
+    uint32_t rec_max = 0U;
+    uint32_t base = FLASH_APP_START;
+    uint32_t lo = FLASH_APP_START;
+    uint32_t hi = FLASH_APP_END;
+    uint32_t blank = 0U;
+    int keep_blank = 0;
+    char err[256];
+    flash_image_t img;
+    flash_plan_t plan;
+    FILE *out = stdout;
+    uint32_t i;
+    int c;
+
+    while ((c = getopt_long(argc, argv, "o:F:m:a:kAh", longopts, NULL)) != -1) {
+        switch (c) {
+        case 'o': output     = optarg; break;
+        case 'F':
+            for (i = 0U; (i < 3U) && (strcmp(optarg, names[i]) != 0); i++) {
+            }
+            if (i == 3U) {
+                fprintf(stderr, "srec_pack: unknown format \"%s\"\n", optarg);
+                return 2;
+            }
+            format = (flash_format_t)i;
+            break;
+        case 'm': rec_max    = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'a': base       = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'k': keep_blank = 1; break;
+        case 'A': lo = 0U; hi = 0xFFFFFFFFU; break;
+        default:
+            usage(argv[0]);
+            return (c == 'h') ? 0 : 2;
+        }
+    }
+    if (optind != (argc - 1)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (FlashImage_Load(&img, argv[optind], base, err, sizeof(err)) != 0) {
+        fprintf(stderr, "srec_pack: %s\n", err);
+        return 1;
+    }
+    if (keep_blank == 0) {
+        blank = FlashImage_DropBlank(&img);
+    }
+    if (rec_max == 0U) {
+        rec_max = FlashPlan_RecMax(format);
+    }
+    if (FlashPlan_Build(&img, rec_max, lo, hi, 0U, format, &plan) != 0) {
+        fprintf(stderr, "srec_pack: -m must be a multiple of %u up to %u\n",
+                FLASH_PHRASE_SIZE, FlashPlan_RecMax(format));
+        FlashImage_Free(&img);
+        return 2;
+    }
+
+    if ((output != NULL) && ((out = fopen(output, "wb")) == NULL)) {
+        fprintf(stderr, "srec_pack: %s: cannot create\n", output);
+        FlashPlan_Free(&plan);
+        FlashImage_Free(&img);
+        return 1;
+    }
+    if ((fwrite(plan.text, 1U, plan.wire_bytes, out) != plan.wire_bytes) ||
+        ((out != stdout) && (fclose(out) != 0))) {
+        fprintf(stderr, "srec_pack: %s: write error\n", (output != NULL) ? output : "stdout");
+        FlashPlan_Free(&plan);
+        FlashImage_Free(&img);
+        return 1;
+    }
+
+    fprintf(stderr, "%s: %u records (%u not on whole phrases), %u bytes\n"
+                    "  -> %zu %s records of up to %u bytes in %zu ranges, %u bytes, %u chars, entry 0x%08X\n",
+            argv[optind], img.in_records, img.in_unaligned, img.in_bytes,
+            plan.count, names[format], rec_max, img.count, plan.bytes, plan.wire_bytes, plan.entry);
+    if (blank != 0U) {
+        fprintf(stderr, "  %u bytes of 0xFF dropped\n", blank);
+    }
+    if (plan.skipped != 0U) {
+        fprintf(stderr, "  %u bytes outside 0x%08X..0x%08X dropped (-A keeps them)\n",
+                plan.skipped, lo, hi);
+    }
+
+    FlashPlan_Free(&plan);
+    FlashImage_Free(&img);
+    return 0;
+}
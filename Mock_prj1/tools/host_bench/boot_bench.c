@@ -0,0 +1,485 @@
+/**
+ * @file    boot_bench.c
+ * @brief   Host benchmark of the bootloader's receive path.
+ *
+ * Runs the firmware modules of the record path (src/source) natively on a
+ * corpus of images and prints the time per byte of each stage:
+ *
+ *   hex_to_byte       every hex pair of the S-record lines
+ *   parse_srec_line   the S-record lines as written by the toolchain
+ *   decode_srec/ihex/bin
+ *                     BootRecord_Decode() on the records the flasher sends
+ *   uart_buffer       UART_BufferPush()/Pop() of the S-record stream
+ *   srec_queue        SREC_QueuePushFrame()/PopFrame() of the S-record lines
+ *   phrase_aligned    BootPhrase_Write() of the flasher's records
+ *   phrase_4+4        the same data in 4-byte records (4+4 merge path)
+ *   pool_record       each S-record frame copied into a BootPool_Alloc()
+ *                     block, BOOT_POOL_RECORD_COUNT frames in flight
+ *   malloc_record     the same with the C library's malloc()/free()
+ *   pool_phrase       each data phrase in a BOOT_POOL_PHRASE block,
+ *                     BOOT_POOL_PHRASE_COUNT in flight
+ *   malloc_phrase     the same with malloc()/free()
+ *
+ * Each case runs a number of passes over the corpus; the best of several
+ * runs is reported, in ns per frame byte, per frame and per data byte.
+ * These are host numbers: they rank changes to the code, the target
+ * figures come from the PERF command (dwt_perf.h).
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#define _GNU_SOURCE
+#include "corpus.h"
+#include "srec_parser.h"
+#include "uart_buffer.h"
+#include "srec_queue.h"
+#include "boot_record.h"
+#include "boot_phrase.h"
+#include "boot_pool.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Types                                 */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Data record of the image, decoded once for the phrase cases.
+ */
+typedef struct {
+    uint32_t address;
+    uint16_t len;
+    uint8_t  data[FLASH_BIN_REC_MAX];
+} bench_rec_t;
+
+/**
+ * @brief Inputs of one image.
+ */
+typedef struct {
+    const char  *name;
+    corpus_t     lines;                 /**< Toolchain S-record lines       */
+    corpus_t     plan[3];               /**< flash_format_t order           */
+    bench_rec_t *recs;
+    size_t       rec_count;
+} bench_input_t;
+
+/**
+ * @brief One measured case.
+ */
+typedef struct {
+    const char *name;
+    void      (*run)(const bench_input_t *in);
+    const corpus_t *(*corpus)(const bench_input_t *in);
+} bench_case_t;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static volatile uint32_t sink;          /* Keeps results alive */
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static void phrase_sink(uint32_t base, const uint8_t *data)
+{
+    sink += base ^ data[0] ^ data[7];
+}
+
+static void run_hex(const bench_input_t *in)
+{
+    const corpus_frame_t *f;
+    uint32_t acc = 0U;
+    size_t i;
+    size_t j;
+
+    for (i = 0U; i < in->lines.count; i++) {
+        f = &in->lines.frames[i];
+        for (j = 2U; (j + 1U) < f->len; j += 2U) {
+            acc += hex_to_byte((const char *)&f->data[j]);
+        }
+    }
+    sink += acc;
+}
+
+static void run_parse(const bench_input_t *in)
+{
+    static srec_record_t rec;
+    size_t i;
+
+    for (i = 0U; i < in->lines.count; i++) {
+        if (parse_srec_line((const char *)in->lines.frames[i].data, &rec) == 0) {
+            sink += rec.valid;
+        }
+    }
+}
+
+static void run_decode(const corpus_t *c)
+{
+    boot_record_t rec;
+    size_t i;
+
+    BootRecord_Reset();
+    for (i = 0U; i < c->count; i++) {
+        if (BootRecord_Decode(c->frames[i].data, c->frames[i].len, &rec) == 0) {
+            sink += rec.len;
+        }
+    }
+    BootRecord_Reset();
+}
+
+static void run_decode_srec(const bench_input_t *in) { run_decode(&in->plan[FLASH_FMT_SREC]); }
+static void run_decode_ihex(const bench_input_t *in) { run_decode(&in->plan[FLASH_FMT_IHEX]); }
+static void run_decode_bin(const bench_input_t *in)  { run_decode(&in->plan[FLASH_FMT_BIN]); }
+
+static void run_uart(const bench_input_t *in)
+{
+    const corpus_t *c = &in->plan[FLASH_FMT_SREC];
+    const uint8_t *p;
+    size_t left;
+    size_t n;
+    size_t i;
+    size_t j;
+    uint8_t b;
+
+    UART_BufferInit();
+    for (i = 0U; i < c->count; i++) {
+        p    = c->frames[i].data;
+        left = c->frames[i].len;
+        while (left > 0U) {
+            n = (left < UART_QUEUE_SIZE) ? left : UART_QUEUE_SIZE;
+            for (j = 0U; j < n; j++) {
+                (void)UART_BufferPush(p[j]);
+            }
+            while (UART_BufferPop(&b)) {
+                sink += b;
+            }
+            p    += n;
+            left -= n;
+        }
+    }
+}
+
+static void run_queue(const bench_input_t *in)
+{
+    static uint8_t out[SREC_LINE_MAX_LEN + 1];
+    const corpus_t *c = &in->plan[FLASH_FMT_SREC];
+    uint16_t len;
+    size_t i;
+
+    SREC_QueueInit();
+    for (i = 0U; i < c->count; i++) {
+        (void)SREC_QueuePushFrame(c->frames[i].data, c->frames[i].len);
+        if (SREC_QueueIsFull()) {
+            while (SREC_QueuePopFrame(out, &len)) {
+                sink += len;
+            }
+        }
+    }
+    while (SREC_QueuePopFrame(out, &len)) {
+        sink += len;
+    }
+}
+
+static void run_phrase(const bench_input_t *in)
+{
+    size_t i;
+
+    BootPhrase_Init(phrase_sink);
+    for (i = 0U; i < in->rec_count; i++) {
+        BootPhrase_Write(in->recs[i].address, in->recs[i].data, in->recs[i].len);
+    }
+    BootPhrase_Flush();
+}
+
+static void run_phrase_44(const bench_input_t *in)
+{
+    const bench_rec_t *r;
+    uint32_t off;
+    uint32_t n;
+    size_t i;
+
+    BootPhrase_Init(phrase_sink);
+    for (i = 0U; i < in->rec_count; i++) {
+        r = &in->recs[i];
+        for (off = 0U; off < r->len; off += n) {
+            n = ((r->len - off) < BOOT_PHRASE_HALF) ? (r->len - off) : BOOT_PHRASE_HALF;
+            BootPhrase_Write(r->address + off, &r->data[off], n);
+        }
+    }
+    BootPhrase_Flush();
+}
+
+/**
+ * @brief Allocator under test: BootPool or the C library.
+ */
+typedef struct {
+    void *(*alloc)(uint32_t size);
+    void  (*release)(void *block);
+} bench_alloc_t;
+
+static void *pool_alloc(uint32_t size)   { return BootPool_Alloc(size); }
+static void  pool_release(void *block)   { (void)BootPool_Free(block); }
+static void *libc_alloc(uint32_t size)   { return malloc(size); }
+static void  libc_release(void *block)   { free(block); }
+
+static const bench_alloc_t alloc_pool = { pool_alloc, pool_release };
+static const bench_alloc_t alloc_libc = { libc_alloc, libc_release };
+
+/**
+ * @brief Replace the block in a slot by a new one holding len bytes of
+ *        data: the oldest block goes back first, as a pipeline stage hands
+ *        its buffer on.
+ */
+static void hand_on(const bench_alloc_t *a, uint8_t **slot, const uint8_t *data, uint32_t len)
+{
+    if (*slot != NULL) {
+        a->release(*slot);
+    }
+    *slot = (uint8_t *)a->alloc(len);
+    if (*slot != NULL) {
+        memcpy(*slot, data, len);
+        sink += (*slot)[0];
+    }
+}
+
+static void release_all(const bench_alloc_t *a, uint8_t **held, uint32_t n)
+{
+    uint32_t k;
+
+    for (k = 0U; k < n; k++) {
+        if (held[k] != NULL) {
+            a->release(held[k]);
+        }
+    }
+}
+
+static void run_record_blocks(const bench_input_t *in, const bench_alloc_t *a)
+{
+    uint8_t *held[BOOT_POOL_RECORD_COUNT] = { NULL };
+    const corpus_t *c = &in->plan[FLASH_FMT_SREC];
+    size_t i;
+
+    BootPool_Init();
+    for (i = 0U; i < c->count; i++) {
+        hand_on(a, &held[i % BOOT_POOL_RECORD_COUNT], c->frames[i].data, (uint32_t)c->frames[i].len);
+    }
+    release_all(a, held, BOOT_POOL_RECORD_COUNT);
+}
+
+static void run_phrase_blocks(const bench_input_t *in, const bench_alloc_t *a)
+{
+    uint8_t *held[BOOT_POOL_PHRASE_COUNT] = { NULL };
+    const bench_rec_t *r;
+    uint32_t off;
+    size_t i;
+    size_t n = 0U;
+
+    BootPool_Init();
+    for (i = 0U; i < in->rec_count; i++) {
+        r = &in->recs[i];
+        for (off = 0U; (off + BOOT_POOL_PHRASE_SIZE) <= r->len; off += BOOT_POOL_PHRASE_SIZE) {
+            hand_on(a, &held[n % BOOT_POOL_PHRASE_COUNT], &r->data[off], BOOT_POOL_PHRASE_SIZE);
+            n++;
+        }
+    }
+    release_all(a, held, BOOT_POOL_PHRASE_COUNT);
+}
+
+static void run_pool_record(const bench_input_t *in)   { run_record_blocks(in, &alloc_pool); }
+static void run_malloc_record(const bench_input_t *in) { run_record_blocks(in, &alloc_libc); }
+static void run_pool_phrase(const bench_input_t *in)   { run_phrase_blocks(in, &alloc_pool); }
+static void run_malloc_phrase(const bench_input_t *in) { run_phrase_blocks(in, &alloc_libc); }
+
+static const corpus_t *corpus_lines(const bench_input_t *in) { return &in->lines; }
+static const corpus_t *corpus_srec(const bench_input_t *in)  { return &in->plan[FLASH_FMT_SREC]; }
+static const corpus_t *corpus_ihex(const bench_input_t *in)  { return &in->plan[FLASH_FMT_IHEX]; }
+static const corpus_t *corpus_bin(const bench_input_t *in)   { return &in->plan[FLASH_FMT_BIN]; }
+
+static const bench_case_t cases[] = {
+    { "hex_to_byte",     run_hex,         corpus_lines },
+    { "parse_srec_line", run_parse,       corpus_lines },
+    { "decode_srec",     run_decode_srec, corpus_srec  },
+    { "decode_ihex",     run_decode_ihex, corpus_ihex  },
+    { "decode_bin",      run_decode_bin,  corpus_bin   },
+    { "uart_buffer",     run_uart,        corpus_srec  },
+    { "srec_queue",      run_queue,       corpus_srec  },
+    { "phrase_aligned",  run_phrase,      corpus_srec  },
+    { "phrase_4+4",      run_phrase_44,   corpus_srec  },
+    { "pool_record",     run_pool_record,   corpus_srec },
+    { "malloc_record",   run_malloc_record, corpus_srec },
+    { "pool_phrase",     run_pool_phrase,   corpus_srec },
+    { "malloc_phrase",   run_malloc_phrase, corpus_srec },
+};
+
+/**
+ * @brief Read one image in every form the cases use.
+ */
+static int load_input(bench_input_t *in, const char *path)
+{
+    const corpus_t *c;
+    boot_record_t rec;
+    size_t i;
+    int f;
+
+    memset(in, 0, sizeof(*in));
+    in->name = strrchr(path, '/') ? (strrchr(path, '/') + 1) : path;
+    if (Corpus_LoadLines(&in->lines, path) != 0) {
+        return -1;
+    }
+    for (f = 0; f < 3; f++) {
+        if (Corpus_LoadPlan(&in->plan[f], path, (flash_format_t)f) != 0) {
+            return -1;
+        }
+    }
+
+    c = &in->plan[FLASH_FMT_SREC];
+    in->recs = calloc(c->count, sizeof(*in->recs));
+    if (in->recs == NULL) {
+        return -1;
+    }
+    BootRecord_Reset();
+    for (i = 0U; i < c->count; i++) {
+        if ((BootRecord_Decode(c->frames[i].data, c->frames[i].len, &rec) == 0) &&
+            (rec.valid != 0U) && (rec.type == BOOT_REC_DATA)) {
+            in->recs[in->rec_count].address = rec.address;
+            in->recs[in->rec_count].len     = rec.len;
+            memcpy(in->recs[in->rec_count].data, rec.data, rec.len);
+            in->rec_count++;
+        }
+    }
+    BootRecord_Reset();
+    return 0;
+}
+
+static void free_input(bench_input_t *in)
+{
+    int f;
+
+    Corpus_Free(&in->lines);
+    for (f = 0; f < 3; f++) {
+        Corpus_Free(&in->plan[f]);
+    }
+    free(in->recs);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "usage: %s [options] [FILE.srec ...]\n"
+        "  -r, --runs N     runs per case, the best is reported (default 15)\n"
+        "  -p, --passes N   passes over the corpus per run (default 20)\n"
+        "  -c, --csv        CSV output\n"
+        "Without files the corpus is Debug_FLASH/Mock_prj1.srec and\n"
+        "LED_APP/APP_LED/Debug_FLASH/APP_LED.srec.\n",
+        prog);
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                   Main                                      */
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    static const struct option longopts[] = {
+        { "runs",   required_argument, NULL, 'r' },
+        { "passes", required_argument, NULL, 'p' },
+        { "csv",    no_argument,       NULL, 'c' },
+        { "help",   no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    static const char *const defaults[] = {
+        "../../Debug_FLASH/Mock_prj1.srec",
+        "../../LED_APP/APP_LED/Debug_FLASH/APP_LED.srec"
+    };
+    const char *const *files = defaults;
+    size_t file_count = 2U;
+    uint32_t runs = 15U;
+    uint32_t passes = 20U;
+    int csv = 0;
+    bench_input_t in;
+    const corpus_t *c;
+    const bench_case_t *bc;
+    uint64_t best;
+    uint64_t t;
+    double per;
+    size_t fi;
+    size_t k;
+    uint32_t r;
+    uint32_t p;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "r:p:ch", longopts, NULL)) != -1) {
+        switch (opt) {
+        case 'r': runs   = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'p': passes = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'c': csv    = 1; break;
+        default:
+            usage(argv[0]);
+            return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if ((runs == 0U) || (passes == 0U)) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (optind < argc) {
+        files      = (const char *const *)&argv[optind];
+        file_count = (size_t)(argc - optind);
+    }
+
+    if (csv != 0) {
+        printf("case,file,frames,bytes,data,ns_per_byte,ns_per_frame,ns_per_data\n");
+    } else {
+        printf("%-16s %-16s %7s %8s %8s %9s %10s %9s\n",
+               "case", "file", "frames", "bytes", "data", "ns/byte", "ns/frame", "ns/data");
+    }
+
+    for (fi = 0U; fi < file_count; fi++) {
+        if (load_input(&in, files[fi]) != 0) {
+            free_input(&in);
+            return 1;
+        }
+        for (k = 0U; k < (sizeof(cases) / sizeof(cases[0])); k++) {
+            bc   = &cases[k];
+            c    = bc->corpus(&in);
+            best = UINT64_MAX;
+            for (r = 0U; r < runs; r++) {
+                t = now_ns();
+                for (p = 0U; p < passes; p++) {
+                    bc->run(&in);
+                }
+                t = now_ns() - t;
+                best = (t < best) ? t : best;
+            }
+            per = (double)best / (double)passes;
+            if (csv != 0) {
+                printf("%s,%s,%zu,%zu,%zu,%.3f,%.1f,%.3f\n", bc->name, in.name,
+                       c->count, c->bytes, c->data,
+                       per / (double)c->bytes, per / (double)c->count, per / (double)c->data);
+            } else {
+                printf("%-16s %-16s %7zu %8zu %8zu %9.3f %10.1f %9.3f\n", bc->name, in.name,
+                       c->count, c->bytes, c->data,
+                       per / (double)c->bytes, per / (double)c->count, per / (double)c->data);
+            }
+        }
+        free_input(&in);
+    }
+    return 0;
+}
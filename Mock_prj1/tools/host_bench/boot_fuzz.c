@@ -0,0 +1,478 @@
+/**
+ * @file    boot_fuzz.c
+ * @brief   Host fuzz target for the bootloader's record decoders and phrase
+ *          assembly.
+ *
+ * LLVMFuzzerTestOneInput() takes one frame as Bootloader_Mode() pops it from
+ * the SREC queue ('\0'-terminated, in its own heap block so the sanitizers
+ * see any read past the end) and checks:
+ *
+ *   - parse_srec_line() against a reference decoder written from the
+ *     S-record definition: a line is accepted only if it holds every byte
+ *     its count announces, and then data_len == count - address - 1;
+ *   - BootRecord_Decode() in each format: the data span lies inside the
+ *     frame or the decoder's buffer and the length fits the frame;
+ *   - BootPhrase_Write() against a shadow flash: the frame bytes drive a
+ *     record sequence as hosts send it (phrase-aligned records, or 4-byte
+ *     halves), every phrase must be programmed once, at a phrase address,
+ *     and the flash must equal the records' data with 0xFF elsewhere.
+ *
+ * Built with gcc the file has its own driver: seeds from image files,
+ * deterministic mutations (bit flips, hex digits, byte count, truncation,
+ * insertion), -fsanitize=address,undefined. With clang and
+ * -DBOOT_FUZZ_LIBFUZZER -fsanitize=fuzzer the same target runs under
+ * libFuzzer.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#define _GNU_SOURCE
+#include "corpus.h"
+#include "srec_parser.h"
+#include "srec_queue.h"
+#include "boot_record.h"
+#include "boot_phrase.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define FUZZ_FRAME_MAX      (300U)      /**< Longer than any queue entry    */
+#define FUZZ_SHADOW_SIZE    (1024U)     /**< Shadow flash window            */
+
+#define FUZZ_CHECK(cond, what)                                              \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fuzz_fail(what, data, size);                                    \
+        }                                                                   \
+    } while (0)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static uint8_t  shadow[FUZZ_SHADOW_SIZE];       /* Programmed flash          */
+static uint8_t  expect[FUZZ_SHADOW_SIZE];       /* Data of the records       */
+static uint8_t  written[FUZZ_SHADOW_SIZE / BOOT_PHRASE_SIZE];
+static int      phrase_error;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static void fuzz_fail(const char *what, const uint8_t *data, size_t size)
+{
+    size_t i;
+
+    fprintf(stderr, "boot_fuzz: %s\ninput (%zu bytes):", what, size);
+    for (i = 0U; i < size; i++) {
+        fprintf(stderr, "%s%02X", ((i & 31U) == 0U) ? "\n  " : " ", data[i]);
+    }
+    fprintf(stderr, "\n");
+    abort();
+}
+
+static int ref_hex(const uint8_t *p, size_t avail, uint8_t *out)
+{
+    unsigned int v = 0U;
+    size_t i;
+
+    if (avail < 2U) {
+        return -1;
+    }
+    for (i = 0U; i < 2U; i++) {
+        if ((p[i] >= '0') && (p[i] <= '9'))      { v = (v << 4) | (unsigned int)(p[i] - '0'); }
+        else if ((p[i] >= 'A') && (p[i] <= 'F')) { v = (v << 4) | (unsigned int)(p[i] - 'A' + 10); }
+        else if ((p[i] >= 'a') && (p[i] <= 'f')) { v = (v << 4) | (unsigned int)(p[i] - 'a' + 10); }
+        else                                     { return -1; }
+    }
+    *out = (uint8_t)v;
+    return 0;
+}
+
+/**
+ * @brief Reference S-record decoder on a '\0'-terminated line.
+ * @return 0 and the fields, or -1 for a line parse_srec_line() must reject.
+ */
+static int ref_srec(const uint8_t *line, srec_record_t *ref)
+{
+    size_t len = strlen((const char *)line);
+    uint8_t bytes[256];
+    uint32_t addr_len;
+    uint32_t i;
+    uint8_t sum = 0U;
+
+    if ((len < 2U) || (line[0] != 'S')) {
+        return -1;
+    }
+    switch (line[1]) {
+    case '0': case '1': case '5': case '9': addr_len = 2U; break;
+    case '2': case '8':                     addr_len = 3U; break;
+    case '3': case '7':                     addr_len = 4U; break;
+    default:                                return -1;
+    }
+    if ((ref_hex(&line[2], len - 2U, &bytes[0]) != 0) || (bytes[0] < (addr_len + 1U))) {
+        return -1;
+    }
+    for (i = 1U; i <= bytes[0]; i++) {
+        if (ref_hex(&line[2U + (2U * i)], len - (2U + (2U * i)), &bytes[i]) != 0) {
+            return -1;
+        }
+    }
+    ref->type     = (srec_type_t)(line[1] - '0');
+    ref->address  = 0U;
+    for (i = 0U; i < addr_len; i++) {
+        ref->address = (ref->address << 8) | bytes[1U + i];
+    }
+    ref->data_len = (uint8_t)(bytes[0] - addr_len - 1U);
+    memcpy(ref->data, &bytes[1U + addr_len], ref->data_len);
+    ref->checksum = bytes[bytes[0]];
+    for (i = 0U; i <= bytes[0]; i++) {
+        sum += bytes[i];
+    }
+    ref->valid = (sum == 0xFFU) ? 1U : 0U;
+    return 0;
+}
+
+static void check_srec(const uint8_t *frame, const uint8_t *data, size_t size)
+{
+    static srec_record_t got;
+    static srec_record_t ref;
+    int rc_got;
+    int rc_ref;
+
+    memset(&got, 0, sizeof(got));
+    rc_got = parse_srec_line((const char *)frame, &got);
+    rc_ref = ref_srec(frame, &ref);
+
+    FUZZ_CHECK((rc_got == 0) == (rc_ref == 0), "parse_srec_line: accepts a malformed line or rejects a valid one");
+    if (rc_ref == 0) {
+        FUZZ_CHECK(got.address == ref.address, "parse_srec_line: address");
+        FUZZ_CHECK(got.data_len == ref.data_len, "parse_srec_line: data_len differs from count - address - 1");
+        FUZZ_CHECK(memcmp(got.data, ref.data, ref.data_len) == 0, "parse_srec_line: data");
+        FUZZ_CHECK(got.valid == ref.valid, "parse_srec_line: checksum");
+    }
+}
+
+static void check_decode(const uint8_t *frame, uint16_t len, const uint8_t *data, size_t size)
+{
+    boot_record_t rec;
+    volatile uint8_t acc = 0U;
+    uint16_t i;
+
+    BootRecord_Reset();
+    if (BootRecord_Decode(frame, len, &rec) != 0) {
+        return;
+    }
+    FUZZ_CHECK(rec.len <= len, "BootRecord_Decode: record longer than its frame");
+    if (rec.len > 0U) {
+        FUZZ_CHECK(rec.data != NULL, "BootRecord_Decode: no data");
+        if ((rec.data >= frame) && (rec.data < &frame[len])) {
+            FUZZ_CHECK(&rec.data[rec.len] <= &frame[len], "BootRecord_Decode: data past the frame");
+        }
+        /* Touch the span: the sanitizer checks the decoder's buffer */
+        for (i = 0U; i < rec.len; i++) {
+            acc ^= rec.data[i];
+        }
+    }
+    BootRecord_Reset();
+}
+
+static void shadow_write(uint32_t base, const uint8_t *data)
+{
+    uint32_t i;
+
+    if (((base & (BOOT_PHRASE_SIZE - 1U)) != 0U) || (base >= FUZZ_SHADOW_SIZE) ||
+        (written[base / BOOT_PHRASE_SIZE] != 0U)) {
+        phrase_error = 1;
+        return;
+    }
+    written[base / BOOT_PHRASE_SIZE] = 1U;
+    for (i = 0U; i < BOOT_PHRASE_SIZE; i++) {
+        shadow[base + i] &= data[i];            /* NOR flash: 1 -> 0 only */
+    }
+}
+
+/**
+ * @brief Records as hosts send them, driven by the input bytes.
+ *
+ * Per record, one input byte: the low bits pick a gap of whole phrases,
+ * bit 7 a 4+4 pair (two 4-byte records on one phrase), otherwise the next
+ * byte sets a length (whole phrases, or any length for the last record of
+ * a run, which the next run starts a phrase after).
+ */
+static void check_phrase(const uint8_t *data, size_t size)
+{
+    uint32_t addr = 0U;
+    uint32_t len;
+    uint8_t rec[64];
+    size_t pos = 0U;
+    uint32_t i;
+    uint8_t b;
+
+    memset(shadow, 0xFF, sizeof(shadow));
+    memset(expect, 0xFF, sizeof(expect));
+    memset(written, 0, sizeof(written));
+    phrase_error = 0;
+    BootPhrase_Init(shadow_write);
+
+    while ((pos + 1U) < size) {
+        b = data[pos++];
+        addr += (uint32_t)(b & 3U) * BOOT_PHRASE_SIZE;
+        if ((b & 0x80U) != 0U) {
+            len = BOOT_PHRASE_SIZE;
+        } else {
+            len = data[pos++] % sizeof(rec);
+            if ((b & 0x40U) == 0U) {
+                len &= ~(BOOT_PHRASE_SIZE - 1U);
+            }
+            if (len == 0U) {
+                continue;
+            }
+        }
+        if ((addr + len) > FUZZ_SHADOW_SIZE) {
+            break;
+        }
+        for (i = 0U; i < len; i++) {
+            rec[i] = (uint8_t)(data[(pos + i) % size] ^ (addr + i));
+            expect[addr + i] = rec[i];
+        }
+        if ((b & 0x80U) != 0U) {
+            BootPhrase_Write(addr, rec, BOOT_PHRASE_HALF);
+            BootPhrase_Write(addr + BOOT_PHRASE_HALF, &rec[BOOT_PHRASE_HALF], BOOT_PHRASE_HALF);
+        } else {
+            BootPhrase_Write(addr, rec, len);
+        }
+        /* The next record starts on the next phrase */
+        addr = (addr + len + BOOT_PHRASE_SIZE - 1U) & ~(BOOT_PHRASE_SIZE - 1U);
+    }
+    BootPhrase_Flush();
+
+    FUZZ_CHECK(phrase_error == 0, "BootPhrase: phrase programmed twice or unaligned");
+    FUZZ_CHECK(memcmp(shadow, expect, sizeof(shadow)) == 0, "BootPhrase: flash differs from the records");
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Fuzz Target                                   */
+/* -------------------------------------------------------------------------- */
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    uint8_t *frame;
+    size_t len = size;
+
+    if (size > FUZZ_FRAME_MAX) {
+        return 0;
+    }
+    /* Exact-size block, '\0'-terminated like SREC_QueuePopFrame() output */
+    frame = malloc(size + 1U);
+    if (frame == NULL) {
+        return 0;
+    }
+    memcpy(frame, data, size);
+    frame[size] = '\0';
+
+    if ((size > 0U) && (data[0] == 'S')) {
+        check_srec(frame, data, size);
+    }
+    if (len >= SREC_LINE_MAX_LEN) {
+        len = SREC_LINE_MAX_LEN - 1U;           /* Queue entries are shorter */
+    }
+    check_decode(frame, (uint16_t)len, data, size);
+    check_phrase(data, size);
+
+    free(frame);
+    return 0;
+}
+
+#ifndef BOOT_FUZZ_LIBFUZZER
+
+/* -------------------------------------------------------------------------- */
+/*                               Driver                                        */
+/* -------------------------------------------------------------------------- */
+
+static uint32_t rng_state = 0x2545F491U;
+
+static uint32_t rng(void)
+{
+    /* xorshift32: the same inputs on every run for a given seed */
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/**
+ * @brief Apply 1..4 random edits to a copy of a seed.
+ */
+static size_t mutate(const corpus_frame_t *seed, uint8_t *out)
+{
+    static const char digits[] = "0123456789ABCDEFabcdefGS:\r";
+    size_t len = seed->len;
+    uint32_t edits = 1U + (rng() & 3U);
+    size_t at;
+
+    memcpy(out, seed->data, len);
+    while (edits-- > 0U) {
+        at = (len > 0U) ? (rng() % len) : 0U;
+        switch (rng() % 7U) {
+        case 0:                                 /* Bit flip */
+            if (len > 0U) {
+                out[at] ^= (uint8_t)(1U << (rng() & 7U));
+            }
+            break;
+        case 1:                                 /* Hex digit, or a structural char */
+            if (len > 0U) {
+                out[at] = (uint8_t)digits[rng() % (sizeof(digits) - 1U)];
+            }
+            break;
+        case 2:                                 /* Byte count field */
+            if (len >= 4U) {
+                out[2 + (rng() & 1U)] = (uint8_t)digits[rng() % 16U];
+            }
+            break;
+        case 3:                                 /* Truncate */
+            len = at;
+            break;
+        case 4:                                 /* Insert */
+            if (len < FUZZ_FRAME_MAX) {
+                memmove(&out[at + 1U], &out[at], len - at);
+                out[at] = (uint8_t)rng();
+                len++;
+            }
+            break;
+        case 5:                                 /* Delete */
+            if (len > 0U) {
+                memmove(&out[at], &out[at + 1U], len - at - 1U);
+                len--;
+            }
+            break;
+        default:                                /* Record type */
+            if (len >= 2U) {
+                out[1] = (uint8_t)digits[rng() % 10U];
+            }
+            break;
+        }
+    }
+    return len;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "usage: %s [options] [FILE.srec ...]\n"
+        "  -n, --iterations N   mutated inputs (default 200000)\n"
+        "  -s, --seed N         PRNG seed (default 0x2545F491)\n"
+        "  -i, --input FILE     run FILE as one input (a reproducer) and exit\n"
+        "Seeds: the lines of each file and the flasher's S-record, Intel HEX and\n"
+        "binary records for it; default Debug_FLASH/Mock_prj1.srec and\n"
+        "LED_APP/APP_LED/Debug_FLASH/APP_LED.srec.\n",
+        prog);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option longopts[] = {
+        { "iterations", required_argument, NULL, 'n' },
+        { "seed",       required_argument, NULL, 's' },
+        { "input",      required_argument, NULL, 'i' },
+        { "help",       no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    static const char *const defaults[] = {
+        "../../Debug_FLASH/Mock_prj1.srec",
+        "../../LED_APP/APP_LED/Debug_FLASH/APP_LED.srec"
+    };
+    const char *const *files = defaults;
+    size_t file_count = 2U;
+    uint32_t iterations = 200000U;
+    const char *input = NULL;
+    FILE *fin;
+    uint8_t buf[FUZZ_FRAME_MAX + 1U];
+    corpus_t seeds;
+    corpus_t part;
+    size_t fi;
+    size_t i;
+    size_t len;
+    uint32_t n;
+    int f;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "n:s:i:h", longopts, NULL)) != -1) {
+        switch (opt) {
+        case 'n': iterations = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': rng_state  = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'i': input      = optarg; break;
+        default:
+            usage(argv[0]);
+            return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (input != NULL) {
+        fin = fopen(input, "rb");
+        if (fin == NULL) {
+            fprintf(stderr, "boot_fuzz: %s: cannot open\n", input);
+            return 1;
+        }
+        len = fread(buf, 1U, sizeof(buf), fin);
+        fclose(fin);
+        (void)LLVMFuzzerTestOneInput(buf, len);
+        printf("boot_fuzz: %s: no failure\n", input);
+        return 0;
+    }
+    if (rng_state == 0U) {
+        rng_state = 1U;                         /* xorshift fixed point */
+    }
+    if (optind < argc) {
+        files      = (const char *const *)&argv[optind];
+        file_count = (size_t)(argc - optind);
+    }
+
+    memset(&seeds, 0, sizeof(seeds));
+    for (fi = 0U; fi < file_count; fi++) {
+        for (f = -1; f < 3; f++) {
+            if (((f < 0) ? Corpus_LoadLines(&part, files[fi])
+                         : Corpus_LoadPlan(&part, files[fi], (flash_format_t)f)) != 0) {
+                Corpus_Free(&seeds);
+                return 1;
+            }
+            for (i = 0U; i < part.count; i++) {
+                if (Corpus_Add(&seeds, part.frames[i].data, part.frames[i].len) != 0) {
+                    Corpus_Free(&part);
+                    Corpus_Free(&seeds);
+                    return 1;
+                }
+            }
+            Corpus_Free(&part);
+        }
+    }
+    if (seeds.count == 0U) {
+        fprintf(stderr, "boot_fuzz: no seeds\n");
+        return 1;
+    }
+
+    /* The seeds themselves, then the mutations */
+    for (i = 0U; i < seeds.count; i++) {
+        (void)LLVMFuzzerTestOneInput(seeds.frames[i].data, seeds.frames[i].len);
+    }
+    for (n = 0U; n < iterations; n++) {
+        len = mutate(&seeds.frames[rng() % seeds.count], buf);
+        (void)LLVMFuzzerTestOneInput(buf, len);
+    }
+
+    printf("boot_fuzz: %zu seeds, %u mutated inputs, no failure\n", seeds.count, iterations);
+    Corpus_Free(&seeds);
+    return 0;
+}
+
+#endif /* BOOT_FUZZ_LIBFUZZER */
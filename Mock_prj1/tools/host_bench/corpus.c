@@ -0,0 +1,156 @@
+/**
+ * @file    corpus.c
+ * @brief   Host bench - record frames read from image files.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "corpus.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Data bytes of an S1/S2/S3 line, 0 for any other line.
+ */
+static size_t srec_data_len(const char *line)
+{
+    unsigned int count;
+    size_t addr_len;
+
+    switch (line[1]) {
+    case '1': addr_len = 2U; break;
+    case '2': addr_len = 3U; break;
+    case '3': addr_len = 4U; break;
+    default:  return 0U;
+    }
+    if ((line[0] != 'S') || (sscanf(&line[2], "%2x", &count) != 1) || (count < (addr_len + 1U))) {
+        return 0U;
+    }
+    return count - addr_len - 1U;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+int Corpus_Add(corpus_t *c, const uint8_t *data, size_t len)
+{
+    corpus_frame_t *frames;
+    uint8_t *copy;
+
+    if ((c->count & 255U) == 0U) {
+        frames = realloc(c->frames, (c->count + 256U) * sizeof(*frames));
+        if (frames == NULL) {
+            return -1;
+        }
+        c->frames = frames;
+    }
+    copy = malloc(len + 1U);
+    if (copy == NULL) {
+        return -1;
+    }
+    memcpy(copy, data, len);
+    copy[len] = '\0';
+    c->frames[c->count].data = copy;
+    c->frames[c->count].len  = (uint16_t)len;
+    c->count++;
+    c->bytes += len;
+    return 0;
+}
+
+int Corpus_LoadLines(corpus_t *c, const char *path)
+{
+    char line[1024];
+    size_t len;
+    FILE *f;
+
+    memset(c, 0, sizeof(*c));
+    f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+        len = strcspn(line, "\r\n");
+        line[len] = '\0';
+        if (len == 0U) {
+            continue;
+        }
+        if (Corpus_Add(c, (const uint8_t *)line, len) != 0) {
+            fclose(f);
+            Corpus_Free(c);
+            return -1;
+        }
+        c->data += srec_data_len(line);
+    }
+    fclose(f);
+    return 0;
+}
+
+int Corpus_LoadPlan(corpus_t *c, const char *path, flash_format_t format)
+{
+    char err[256];
+    flash_image_t img;
+    flash_plan_t plan;
+    const char *text;
+    size_t len;
+    size_t cut;
+    size_t i;
+    int rc = 0;
+
+    memset(c, 0, sizeof(*c));
+    if (FlashImage_Load(&img, path, FLASH_APP_START, err, sizeof(err)) != 0) {
+        fprintf(stderr, "%s\n", err);
+        return -1;
+    }
+    (void)FlashImage_DropBlank(&img);
+    if (FlashPlan_Build(&img, FlashPlan_RecMax(format), 0U, 0xFFFFFFFFU, 0U, format, &plan) != 0) {
+        fprintf(stderr, "%s: cannot build the plan\n", path);
+        FlashImage_Free(&img);
+        return -1;
+    }
+
+    /* Lines 0..count-1 are records, line count is the end record */
+    for (i = 0U; (i <= plan.count) && (rc == 0); i++) {
+        text = FlashPlan_Line(&plan, i, &len);
+        if (format == FLASH_FMT_BIN) {
+            rc = Corpus_Add(c, (const uint8_t *)text, len);
+            continue;
+        }
+        /* An Intel HEX entry can hold a type 04 or 05 line first */
+        while ((len > 0U) && (rc == 0)) {
+            cut = (size_t)((const char *)memchr(text, '\n', len) - text);
+            rc = Corpus_Add(c, (const uint8_t *)text, cut);
+            text += cut + 1U;
+            len  -= cut + 1U;
+        }
+    }
+    c->data = plan.bytes;
+
+    FlashPlan_Free(&plan);
+    FlashImage_Free(&img);
+    if (rc != 0) {
+        Corpus_Free(c);
+    }
+    return rc;
+}
+
+void Corpus_Free(corpus_t *c)
+{
+    size_t i;
+
+    for (i = 0U; i < c->count; i++) {
+        free(c->frames[i].data);
+    }
+    free(c->frames);
+    memset(c, 0, sizeof(*c));
+}
@@ -0,0 +1,69 @@
+/**
+ * @file    corpus.h
+ * @brief   Host bench - record frames read from image files.
+ *
+ * A corpus holds the frames Bootloader_Mode() would pop from the SREC queue
+ * for one image: each frame is a separate heap block, '\0'-terminated like
+ * SREC_QueuePopFrame() output and without the '\n', so an address sanitizer
+ * reports any read past its end.
+ *
+ *   Corpus_LoadLines()  the lines of an S-record file as written by the
+ *                       toolchain (S0, S1/S2/S3 of any length, S7/S8/S9)
+ *   Corpus_LoadPlan()   the records tools/flasher sends for the image, in
+ *                       S-record, Intel HEX or binary format (flash_image.c)
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#ifndef CORPUS_H_
+#define CORPUS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "flash_image.h"
+
+/**
+ * @brief One frame.
+ */
+typedef struct {
+    uint8_t  *data;             /**< len bytes + '\0'                      */
+    uint16_t  len;
+} corpus_frame_t;
+
+/**
+ * @brief Frames of one image in one format.
+ */
+typedef struct {
+    corpus_frame_t *frames;
+    size_t          count;
+    size_t          bytes;      /**< Sum of frame lengths                  */
+    size_t          data;       /**< Data bytes carried by the records     */
+} corpus_t;
+
+/**
+ * @brief Read the lines of a text file; '\r' and '\n' are removed.
+ * @return 0 on success, -1 on error (message printed).
+ */
+int Corpus_LoadLines(corpus_t *c, const char *path);
+
+/**
+ * @brief Build the flasher's records for an image (all addresses kept).
+ * @return 0 on success, -1 on error (message printed).
+ */
+int Corpus_LoadPlan(corpus_t *c, const char *path, flash_format_t format);
+
+/**
+ * @brief Append a copy of a frame.
+ * @return 0 on success, -1 out of memory.
+ */
+int Corpus_Add(corpus_t *c, const uint8_t *data, size_t len);
+
+/**
+ * @brief Release a corpus.
+ */
+void Corpus_Free(corpus_t *c);
+
+#endif /* CORPUS_H_ */
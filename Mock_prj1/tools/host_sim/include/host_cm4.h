@@ -0,0 +1,47 @@
+/**
+ * @file    host_cm4.h
+ * @brief   Host replacements for the Cortex-M4 core intrinsics.
+ *
+ * Force-included (-include) in every firmware translation unit of the host
+ * build. It takes the include guards of s32_core_cm4.h and cmsis_gcc.h so
+ * their ARM inline assembly is never seen by the host compiler, and maps the
+ * intrinsics used by src/ to the simulator.
+ */
+
+#ifndef HOST_CM4_H_
+#define HOST_CM4_H_
+
+#include <stdint.h>
+#include "sim.h"
+
+/* Claim the guards of the target core headers */
+#define CORE_CM4_H
+#define __CMSIS_GCC_H
+
+/* s32_core_cm4.h */
+#define BKPT_ASM                __builtin_trap()
+#define ENABLE_INTERRUPTS()     sim_irq_enable()
+#define DISABLE_INTERRUPTS()    sim_irq_disable()
+#define MASK_PRIORITY(saved, prio)  do { (saved) = sim_get_basepri(); sim_raise_basepri(prio); } while (0)
+#define UNMASK_PRIORITY(saved)  sim_set_basepri(saved)
+#define START_FUNCTION_DECLARATION_RAMSECTION
+#define END_FUNCTION_DECLARATION_RAMSECTION ;
+#define STANDBY()               sim_wait_for_interrupt()
+
+/* cmsis_gcc.h */
+#define __DSB()                 __sync_synchronize()
+#define __DMB()                 __sync_synchronize()
+#define __ISB()                 __sync_synchronize()
+#define __NOP()                 do { } while (0)
+#define __WFI()                 sim_wait_for_interrupt()
+#define __enable_irq()          sim_irq_enable()
+#define __disable_irq()         sim_irq_disable()
+#define __get_PRIMASK()         sim_get_primask()
+#define __set_MSP(v)            sim_set_sp(0U, (uint32_t)(v))
+#define __set_PSP(v)            sim_set_sp(1U, (uint32_t)(v))
+
+/* Driver_NVIC.c: host function pointers do not fit the S32K144 table */
+#define NVIC_VECTOR_PORT
+#define NVIC_VECTOR_TABLE()     sim_vector_table()
+
+#endif /* HOST_CM4_H_ */
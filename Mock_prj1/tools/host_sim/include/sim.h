@@ -0,0 +1,56 @@
+/**
+ * @file    sim.h
+ * @brief   S32K144 virtual peripheral layer - services used by the firmware.
+ *
+ * The host build of the bootloader runs the unmodified sources of src/ as a
+ * Linux process. Peripheral registers stay at their S32K144 addresses; the
+ * simulator maps those pages, traps every access and applies the register
+ * side effects (see sim_core.c). Only the core intrinsics that have no
+ * memory-mapped equivalent are routed through the functions below, by
+ * host_cm4.h.
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief PRIMASK = 1 (cpsid i). */
+void sim_irq_disable(void);
+
+/** @brief PRIMASK = 0 (cpsie i), pending interrupts are taken immediately. */
+void sim_irq_enable(void);
+
+/** @brief Current PRIMASK value. */
+uint32_t sim_get_primask(void);
+
+/** @brief BASEPRI = value (msr basepri), unmasked interrupts are taken immediately. */
+void sim_set_basepri(uint32_t value);
+
+/** @brief BASEPRI = value if it masks more (msr basepri_max). */
+void sim_raise_basepri(uint32_t value);
+
+/** @brief Current BASEPRI value. */
+uint32_t sim_get_basepri(void);
+
+/** @brief Record a stack pointer write (MSP = 0, PSP = 1); the host stack is not changed. */
+void sim_set_sp(uint32_t psp, uint32_t value);
+
+/** @brief Sleep until the next interrupt request (wfi). */
+void sim_wait_for_interrupt(void);
+
+/** @brief Exception handler (NVIC_Handler_t of Driver_NVIC.h). */
+typedef void (*sim_handler_t)(void);
+
+/** @brief Vector table the interrupts are taken from, indexed by exception number. */
+sim_handler_t *sim_vector_table(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_H_ */
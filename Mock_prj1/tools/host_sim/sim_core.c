@@ -0,0 +1,779 @@
+/**
+ * @file    sim_core.c
+ * @brief   S32K144 virtual peripheral layer - memory map, access traps, NVIC.
+ *
+ * How a register access is simulated (x86-64 Linux):
+ *   1. Trapped pages are mapped PROT_NONE at the S32K144 address, so the
+ *      firmware's load/store raises SIGSEGV. The page fault error code tells
+ *      a store from a load.
+ *   2. The SIGSEGV handler runs the region's pre hook (e.g. refresh STAT),
+ *      opens the page and sets the x86 trap flag.
+ *   3. The instruction executes once and raises SIGTRAP. The handler closes
+ *      the page again and runs the post hook (e.g. launch an FTFC command on
+ *      a write of FSTAT.CCIF, send a character on a write of DATA).
+ *
+ * Interrupts are delivered to the CPU thread with SIGUSR1 and taken only
+ * while the simulated PRIMASK is clear, and only for lines whose NVIC
+ * priority is above the simulated BASEPRI. The handler of the pending line
+ * is then called from the signal handler, like an exception entry.
+ * Handlers do not preempt each other.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#define _GNU_SOURCE
+#include "sim_internal.h"
+#include "S32K144.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#if !defined(__x86_64__) || !defined(__linux__)
+#error "The S32K144 host simulator needs x86-64 Linux (page fault error code and trap flag)"
+#endif
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define SIM_MAX_REGIONS     (16U)
+#define SIM_NVIC_LINES      (256U)
+#define SIM_VECTOR_OFFSET   (16U)       /**< Exception number of IRQ 0 */
+#define SIM_IRQ_STORM       (64U)       /**< Handler calls per service before deferring */
+#define X86_EFLAGS_TF       (0x100UL)
+#define X86_PF_WRITE        (0x2UL)
+#define X86_PF_INSTR        (0x10UL)
+
+/* -------------------------------------------------------------------------- */
+/*                              Public Variables                               */
+/* -------------------------------------------------------------------------- */
+
+sim_options_t sim_opt = {
+    .flash_path   = NULL,
+    .pty_link     = NULL,
+    .button       = true,
+    .flash_timing = SIM_TIMING_TYP,
+    .baud_timing  = true,
+    .verbose      = false,
+    .idle_exit_ms = 0U,
+};
+
+/* startup.c is not part of the host build: the PERF startup phase reads 0 */
+uint32_t startup_init_cycles;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static sim_region_t regions[SIM_MAX_REGIONS];
+static uint32_t     region_count;
+
+/** @brief Access being single-stepped (the CPU thread is the only user). */
+static struct {
+    bool          active;
+    sim_region_t *r;
+    void         *page;
+    uint32_t      off;
+    bool          write;
+    uint32_t      old;
+    bool          usr1_blocked;
+} trap;
+
+static pthread_t cpu_thread;
+static char    **saved_argv;
+static uint64_t  start_ns;
+
+/* Simulated exception state, CPU thread only */
+static volatile sig_atomic_t primask;      /* Also read by the UART thread */
+static uint64_t masked_since_ns;            /* sim_now_ns() when PRIMASK was set */
+static volatile sig_atomic_t basepri;      /* Also read by the UART thread */
+static uint64_t basepri_since_ns;           /* sim_now_ns() when BASEPRI was raised from 0 */
+static volatile sig_atomic_t in_service;
+static volatile sig_atomic_t service_pending;
+static volatile bool         irq_level[SIM_NVIC_LINES];
+static uint32_t              irq_taken;
+static uint32_t              sp_value[2];
+
+/* Exception handlers of src/ (weak: a line without handler is ignored) */
+extern void FTFC_IRQHandler(void)          __attribute__((weak));
+extern void LPUART0_RxTx_IRQHandler(void)  __attribute__((weak));
+extern void LPUART1_RxTx_IRQHandler(void)  __attribute__((weak));
+extern void LPUART2_RxTx_IRQHandler(void)  __attribute__((weak));
+extern void PORTA_IRQHandler(void)         __attribute__((weak));
+extern void PORTB_IRQHandler(void)         __attribute__((weak));
+extern void PORTC_IRQHandler(void)         __attribute__((weak));
+extern void PORTD_IRQHandler(void)         __attribute__((weak));
+extern void PORTE_IRQHandler(void)         __attribute__((weak));
+
+static const struct {
+    uint32_t irqn;
+    sim_handler_t handler;
+} vectors[] = {
+    { FTFC_CMD_IRQn,     FTFC_IRQHandler },
+    { LPUART0_RxTx_IRQn, LPUART0_RxTx_IRQHandler },
+    { LPUART1_RxTx_IRQn, LPUART1_RxTx_IRQHandler },
+    { LPUART2_RxTx_IRQn, LPUART2_RxTx_IRQHandler },
+    { PORTA_IRQn,        PORTA_IRQHandler },
+    { PORTB_IRQn,        PORTB_IRQHandler },
+    { PORTC_IRQn,        PORTC_IRQHandler },
+    { PORTD_IRQn,        PORTD_IRQHandler },
+    { PORTE_IRQn,        PORTE_IRQHandler },
+};
+
+/* Vector table the lines are dispatched from, written by NVIC_InstallHandler() */
+static sim_handler_t vector_ram[SIM_VECTOR_OFFSET + SIM_NVIC_LINES];
+
+/* -------------------------------------------------------------------------- */
+/*                              Logging and time                               */
+/* -------------------------------------------------------------------------- */
+
+static void vmsg(const char *fmt, va_list ap)
+{
+    char buf[512];
+    int  n;
+
+    n = snprintf(buf, sizeof(buf), "[SIM %8.3f] ", (double)(sim_now_ns() - start_ns) / 1e9);
+    n += vsnprintf(buf + n, sizeof(buf) - (size_t)n, fmt, ap);
+    if (n > (int)sizeof(buf) - 2) {
+        n = (int)sizeof(buf) - 2;
+    }
+    buf[n++] = '\n';
+    (void)!write(STDERR_FILENO, buf, (size_t)n);
+}
+
+void sim_info(const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    vmsg(fmt, ap);
+    va_end(ap);
+}
+
+void sim_log(const char *fmt, ...)
+{
+    va_list ap;
+
+    if (!sim_opt.verbose) {
+        return;
+    }
+    va_start(ap, fmt);
+    vmsg(fmt, ap);
+    va_end(ap);
+}
+
+void sim_fatal(const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    vmsg(fmt, ap);
+    va_end(ap);
+    signal(SIGABRT, SIG_DFL);
+    abort();
+}
+
+uint64_t sim_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void sim_sleep_until(uint64_t t_ns)
+{
+    struct timespec ts;
+
+    ts.tv_sec  = (time_t)(t_ns / 1000000000ULL);
+    ts.tv_nsec = (long)(t_ns % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        /* Retry */
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                 Memory map                                  */
+/* -------------------------------------------------------------------------- */
+
+void *sim_map_fixed(uint32_t base, uint32_t size, int prot, int fd, long fd_off)
+{
+    void *want = (void *)(uintptr_t)base;
+    void *p;
+
+#ifdef MAP_FIXED_NOREPLACE
+    p = mmap(want, size, prot, MAP_SHARED | MAP_FIXED_NOREPLACE, fd, fd_off);
+#else
+    p = mmap(want, size, prot, MAP_SHARED, fd, fd_off);
+#endif
+    if ((p != MAP_FAILED) && (p != want)) {
+        munmap(p, size);
+        p = MAP_FAILED;
+    }
+    return p;
+}
+
+sim_region_t *sim_map_region(const char *name, uint32_t base, uint32_t size,
+                             sim_hook_t pre, sim_hook_t post)
+{
+    sim_region_t *r;
+    int fd;
+
+    if (region_count >= SIM_MAX_REGIONS) {
+        sim_fatal("too many regions (%s)", name);
+    }
+
+    fd = memfd_create(name, MFD_CLOEXEC);
+    if ((fd < 0) || (ftruncate(fd, size) != 0)) {
+        sim_fatal("memfd %s: %s", name, strerror(errno));
+    }
+
+    r = &regions[region_count++];
+    r->name = name;
+    r->base = base;
+    r->size = size;
+    r->pre  = pre;
+    r->post = post;
+    r->mem  = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if ((r->mem == MAP_FAILED) ||
+        (sim_map_fixed(base, size, ((pre != NULL) || (post != NULL)) ? PROT_NONE : (PROT_READ | PROT_WRITE), fd, 0) == MAP_FAILED)) {
+        sim_fatal("cannot map %s at 0x%08X: %s", name, base, strerror(errno));
+    }
+    close(fd);
+    return r;
+}
+
+sim_region_t *sim_find_region(uint32_t addr)
+{
+    uint32_t i;
+
+    for (i = 0U; i < region_count; i++) {
+        if ((addr >= regions[i].base) && (addr - regions[i].base < regions[i].size)) {
+            return &regions[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Plain RAM (SRAM_L/SRAM_U, FlexRAM), executable for the flash access code.
+ */
+static void map_ram(uint32_t base, uint32_t size)
+{
+    void *p = mmap((void *)(uintptr_t)base, size, PROT_READ | PROT_WRITE | PROT_EXEC,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (p != (void *)(uintptr_t)base) {
+        sim_fatal("cannot map RAM at 0x%08X: %s", base, strerror(errno));
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                Access traps                                 */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief The CPU left the bootloader through the flash (jump_to_app()).
+ */
+static void flash_fault(uintptr_t addr, const ucontext_t *uc)
+{
+    const uint8_t *flash = sim_flash_mem();
+    uint32_t vtor = sim_vtor();
+    uint32_t msp = 0U;
+    uint32_t reset = 0U;
+
+    if (vtor < SIM_FLASH_SIZE - 8U) {
+        memcpy(&msp,   &flash[vtor],      4U);
+        memcpy(&reset, &flash[vtor + 4U], 4U);
+    }
+
+    if ((uc->uc_mcontext.gregs[REG_ERR] & X86_PF_INSTR) != 0) {
+        sim_info("jump to 0x%08lX: VTOR=0x%08X MSP=0x%08X (set 0x%08X) Reset_Handler=0x%08X",
+                 (unsigned long)addr, vtor, msp, sp_value[0], reset);
+    } else {
+        sim_info("flash read at 0x%08lX outside the host mapping (vm.mmap_min_addr), "
+                 "taken as the application jump: vector 0x%08X 0x%08X",
+                 (unsigned long)addr, msp, reset);
+    }
+    sim_shutdown(0);
+}
+
+static void on_segv(int sig, siginfo_t *si, void *ctx)
+{
+    ucontext_t *uc   = ctx;
+    uintptr_t   addr = (uintptr_t)si->si_addr;
+    sim_region_t *r  = NULL;
+
+    (void)sig;
+
+    if (addr <= 0xFFFFFFFFUL) {
+        r = sim_find_region((uint32_t)addr);
+    }
+    if ((r == NULL) || ((r->pre == NULL) && (r->post == NULL)) || trap.active) {
+        if (addr < SIM_FLASH_SIZE) {
+            flash_fault(addr, uc);
+        }
+        sim_fatal("bus fault: access to 0x%08lX (pc=0x%llx)",
+                  (unsigned long)addr, (unsigned long long)uc->uc_mcontext.gregs[REG_RIP]);
+    }
+
+    trap.r     = r;
+    trap.off   = (uint32_t)addr - r->base;
+    trap.page  = (void *)(addr & ~(uintptr_t)(SIM_PAGE_SIZE - 1U));
+    trap.write = (uc->uc_mcontext.gregs[REG_ERR] & X86_PF_WRITE) != 0;
+
+    if (r->pre != NULL) {
+        r->pre(r, trap.off, trap.write, SIM_REG32(r, trap.off & ~3U));
+    }
+    trap.old = SIM_REG32(r, trap.off & ~3U);
+
+    if (mprotect(trap.page, SIM_PAGE_SIZE, PROT_READ | PROT_WRITE) != 0) {
+        sim_fatal("mprotect: %s", strerror(errno));
+    }
+    trap.active = true;
+
+    /* Execute exactly the faulting instruction, no interrupt in between */
+    uc->uc_mcontext.gregs[REG_EFL] |= X86_EFLAGS_TF;
+    trap.usr1_blocked = sigismember(&uc->uc_sigmask, SIGUSR1) != 0;
+    sigaddset(&uc->uc_sigmask, SIGUSR1);
+}
+
+static void on_trap(int sig, siginfo_t *si, void *ctx)
+{
+    ucontext_t *uc = ctx;
+
+    (void)sig;
+    (void)si;
+
+    if (!trap.active) {
+        return;
+    }
+
+    mprotect(trap.page, SIM_PAGE_SIZE, PROT_NONE);
+    uc->uc_mcontext.gregs[REG_EFL] &= ~X86_EFLAGS_TF;
+    trap.active = false;
+
+    if (trap.r->post != NULL) {
+        trap.r->post(trap.r, trap.off, trap.write, trap.old);
+    }
+
+    if (!trap.usr1_blocked) {
+        sigdelset(&uc->uc_sigmask, SIGUSR1);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                            Exceptions (NVIC/PRIMASK)                         */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Interrupt @p irqn is held off by BASEPRI.
+ */
+static bool basepri_masks(uint32_t irqn)
+{
+    uint32_t bp = (uint32_t)__atomic_load_n(&basepri, __ATOMIC_RELAXED);
+
+    return (bp != 0U) && (sim_nvic_priority(irqn) >= bp);
+}
+
+/**
+ * @brief Take every pending and enabled interrupt (CPU thread, PRIMASK = 0).
+ *
+ * Lines masked by BASEPRI stay pending until BASEPRI is lowered.
+ */
+static void service(void)
+{
+    uint32_t taken;
+    uint32_t i;
+    bool held = false;
+
+    in_service = 1;
+    do {
+        service_pending = 0;
+        for (taken = 0U; taken < SIM_IRQ_STORM; ) {
+            bool any = false;
+
+            sim_lpuart_service();
+            for (i = 0U; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+                uint32_t n = vectors[i].irqn;
+
+                sim_handler_t handler = vector_ram[SIM_VECTOR_OFFSET + n];
+
+                if (irq_level[n] && sim_nvic_enabled(n) && (handler != NULL)) {
+                    if (basepri_masks(n)) {
+                        held = true;
+                        continue;
+                    }
+                    handler();
+                    irq_taken++;
+                    taken++;
+                    any = true;
+                }
+            }
+            if (!any) {
+                break;
+            }
+        }
+        if (taken >= SIM_IRQ_STORM) {
+            /* Line stays asserted: give the thread mode code a chance to run */
+            service_pending = 1;
+            break;
+        }
+        if (held) {
+            /* Taken when BASEPRI is lowered (sim_set_basepri) */
+            service_pending = 1;
+            break;
+        }
+    } while (service_pending != 0);
+    in_service = 0;
+}
+
+static void on_usr1(int sig)
+{
+    int saved_errno = errno;
+
+    (void)sig;
+    if ((primask != 0) || (in_service != 0)) {
+        service_pending = 1;
+    } else {
+        service();
+    }
+    errno = saved_errno;
+}
+
+void sim_irq_line(uint32_t irqn, bool level)
+{
+    if (irqn >= SIM_NVIC_LINES) {
+        return;
+    }
+    if (level && !irq_level[irqn]) {
+        irq_level[irqn] = true;
+        sim_kick();
+    } else {
+        irq_level[irqn] = level;
+    }
+}
+
+void sim_kick(void)
+{
+    pthread_kill(cpu_thread, SIGUSR1);
+}
+
+void sim_irq_disable(void)
+{
+    if (primask == 0) {
+        __atomic_store_n(&masked_since_ns, sim_now_ns(), __ATOMIC_RELAXED);
+    }
+    primask = 1;
+}
+
+void sim_irq_enable(void)
+{
+    primask = 0;
+    if ((service_pending != 0) && (in_service == 0)) {
+        service();
+    }
+}
+
+uint32_t sim_get_primask(void)
+{
+    return (uint32_t)__atomic_load_n(&primask, __ATOMIC_RELAXED);
+}
+
+void sim_set_basepri(uint32_t value)
+{
+    uint32_t old = (uint32_t)basepri;
+
+    value &= 0xFFU;
+    if ((old == 0U) && (value != 0U)) {
+        __atomic_store_n(&basepri_since_ns, sim_now_ns(), __ATOMIC_RELAXED);
+    }
+    basepri = (sig_atomic_t)value;
+    if (((value == 0U) || ((old != 0U) && (value > old))) &&
+        (primask == 0) && (service_pending != 0) && (in_service == 0)) {
+        service();
+    }
+}
+
+void sim_raise_basepri(uint32_t value)
+{
+    uint32_t old = (uint32_t)basepri;
+
+    value &= 0xFFU;
+    if ((value != 0U) && ((old == 0U) || (value < old))) {
+        sim_set_basepri(value);
+    }
+}
+
+uint32_t sim_get_basepri(void)
+{
+    return (uint32_t)__atomic_load_n(&basepri, __ATOMIC_RELAXED);
+}
+
+sim_handler_t *sim_vector_table(void)
+{
+    return vector_ram;
+}
+
+uint64_t sim_masked_ns(uint32_t irqn)
+{
+    uint64_t now = sim_now_ns();
+    uint64_t ns  = 0U;
+    uint64_t since;
+
+    if (__atomic_load_n(&primask, __ATOMIC_RELAXED) != 0) {
+        since = __atomic_load_n(&masked_since_ns, __ATOMIC_RELAXED);
+        ns    = now - since;
+    }
+    if (basepri_masks(irqn)) {
+        since = __atomic_load_n(&basepri_since_ns, __ATOMIC_RELAXED);
+        if ((now - since) > ns) {
+            ns = now - since;
+        }
+    }
+    return ns;
+}
+
+void sim_set_sp(uint32_t psp, uint32_t value)
+{
+    sp_value[psp & 1U] = value;
+    sim_log("%s = 0x%08X", (psp != 0U) ? "PSP" : "MSP", value);
+}
+
+void sim_wait_for_interrupt(void)
+{
+    sigset_t usr1;
+    sigset_t old;
+    sigset_t wait;
+
+    sigemptyset(&usr1);
+    sigaddset(&usr1, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &usr1, &old);
+    if (service_pending == 0) {
+        wait = old;
+        sigdelset(&wait, SIGUSR1);
+        sigsuspend(&wait);
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+}
+
+/* -------------------------------------------------------------------------- */
+/*                           Shutdown, reset, control                          */
+/* -------------------------------------------------------------------------- */
+
+void sim_shutdown(int status)
+{
+    sim_info("stopped after %.3f s, %u interrupts taken",
+             (double)(sim_now_ns() - start_ns) / 1e9, irq_taken);
+    sim_lpuart_stats(stderr);
+    sim_ftfc_stats(stderr);
+    sim_ftfc_flush();
+    sim_lpuart_close();
+    _exit(status);
+}
+
+void sim_reset(const char *reason)
+{
+    sim_info("reset (%s)", reason);
+    sim_ftfc_flush();
+    /* The pty and flash descriptors are kept open across exec (see init) */
+    execv("/proc/self/exe", saved_argv);
+    sim_fatal("reset: execv: %s", strerror(errno));
+}
+
+/**
+ * @brief Host control thread: termination signals, reset, idle timeout.
+ */
+static void *control_thread(void *arg)
+{
+    int sfd = (int)(intptr_t)arg;
+    struct signalfd_siginfo si;
+    struct pollfd pfd = { .fd = sfd, .events = POLLIN };
+
+    for (;;) {
+        if (poll(&pfd, 1, 100) > 0) {
+            if (read(sfd, &si, sizeof(si)) == (ssize_t)sizeof(si)) {
+                if (si.ssi_signo == SIGHUP) {
+                    sim_reset("SIGHUP");
+                }
+                sim_shutdown(0);
+            }
+        }
+        if ((sim_opt.idle_exit_ms != 0U) &&
+            (sim_now_ns() - sim_lpuart_last_activity() > (uint64_t)sim_opt.idle_exit_ms * 1000000ULL)) {
+            sim_info("no UART traffic for %u ms", sim_opt.idle_exit_ms);
+            sim_shutdown(0);
+        }
+    }
+    return NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                Initialization                               */
+/* -------------------------------------------------------------------------- */
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  -f, --flash FILE     P-Flash image (512 KB, created erased); default: volatile\n"
+        "  -l, --link PATH      symlink to the LPUART1 pty slave\n"
+        "  -b, --button 0|1     BOOT button held at reset (default 1: bootloader mode)\n"
+        "  -t, --timing MODE    FTFC command timing: typ (default), max, none\n"
+        "  -n, --no-baud        deliver LPUART characters without baud-rate pacing\n"
+        "  -i, --idle-exit MS   exit after MS milliseconds without UART traffic\n"
+        "  -v, --verbose        log peripheral events\n"
+        "signals: SIGINT/SIGTERM stop, SIGHUP resets the MCU\n", prog);
+}
+
+static void parse_options(int argc, char **argv)
+{
+    static const struct option longopts[] = {
+        { "flash",     required_argument, NULL, 'f' },
+        { "link",      required_argument, NULL, 'l' },
+        { "button",    required_argument, NULL, 'b' },
+        { "timing",    required_argument, NULL, 't' },
+        { "no-baud",   no_argument,       NULL, 'n' },
+        { "idle-exit", required_argument, NULL, 'i' },
+        { "verbose",   no_argument,       NULL, 'v' },
+        { "help",      no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    int c;
+
+    while ((c = getopt_long(argc, argv, "f:l:b:t:ni:vh", longopts, NULL)) != -1) {
+        switch (c) {
+        case 'f': sim_opt.flash_path   = optarg; break;
+        case 'l': sim_opt.pty_link     = optarg; break;
+        case 'b': sim_opt.button       = (atoi(optarg) != 0); break;
+        case 'n': sim_opt.baud_timing  = false; break;
+        case 'i': sim_opt.idle_exit_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'v': sim_opt.verbose      = true; break;
+        case 't':
+            if (strcmp(optarg, "none") == 0) {
+                sim_opt.flash_timing = SIM_TIMING_NONE;
+            } else if (strcmp(optarg, "max") == 0) {
+                sim_opt.flash_timing = SIM_TIMING_MAX;
+            } else {
+                sim_opt.flash_timing = SIM_TIMING_TYP;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            exit((c == 'h') ? 0 : 2);
+        }
+    }
+}
+
+static void install(int sig, void (*action)(int, siginfo_t *, void *))
+{
+    struct sigaction sa;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = action;
+    sa.sa_flags     = SA_SIGINFO;
+    sigemptyset(&sa.sa_mask);
+    sigaddset(&sa.sa_mask, SIGUSR1);
+    if (sigaction(sig, &sa, NULL) != 0) {
+        sim_fatal("sigaction %d: %s", sig, strerror(errno));
+    }
+}
+
+/**
+ * @brief Runs before the firmware's main(): builds the S32K144 memory map.
+ *
+ * glibc passes argc/argv to ELF constructors, the firmware main(void) does
+ * not see them.
+ */
+void sim_thread_create(void *(*fn)(void *), void *arg)
+{
+    pthread_t tid;
+    sigset_t all;
+    sigset_t old;
+    int err;
+
+    /* Host threads never take simulated exceptions or control signals */
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+    err = pthread_create(&tid, NULL, fn, arg);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (err != 0) {
+        sim_fatal("pthread_create: %s", strerror(err));
+    }
+    pthread_detach(tid);
+}
+
+__attribute__((constructor(101)))
+static void sim_init(int argc, char **argv, char **envp)
+{
+    struct sigaction sa;
+    sigset_t ctl;
+    sigset_t cpu;
+    uint32_t i;
+    int sfd;
+
+    (void)envp;
+    start_ns   = sim_now_ns();
+    saved_argv = argv;
+    cpu_thread = pthread_self();
+    parse_options(argc, argv);
+
+    /* Host control signals are read by the control thread only. A reset
+     * re-executes from that thread, so unblock the CPU exceptions again. */
+    sigemptyset(&ctl);
+    sigaddset(&ctl, SIGINT);
+    sigaddset(&ctl, SIGTERM);
+    sigaddset(&ctl, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &ctl, NULL);
+    sigemptyset(&cpu);
+    sigaddset(&cpu, SIGUSR1);
+    sigaddset(&cpu, SIGSEGV);
+    sigaddset(&cpu, SIGTRAP);
+    pthread_sigmask(SIG_UNBLOCK, &cpu, NULL);
+
+    /* Exceptions */
+    install(SIGSEGV, on_segv);
+    install(SIGTRAP, on_trap);
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_usr1;
+    sa.sa_flags   = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGUSR1, &sa, NULL);
+
+    /* Memories and peripherals */
+    for (i = 0U; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        vector_ram[SIM_VECTOR_OFFSET + vectors[i].irqn] = vectors[i].handler;
+    }
+    map_ram(SIM_SRAM_BASE, SIM_SRAM_SIZE);
+    map_ram(SIM_FLEXRAM_BASE, SIM_FLEXRAM_SIZE);
+    sim_ftfc_init();
+    sim_periph_init();
+    sim_lpuart_init();
+
+    sfd = signalfd(-1, &ctl, SFD_CLOEXEC);
+    if (sfd < 0) {
+        sim_fatal("signalfd: %s", strerror(errno));
+    }
+    sim_thread_create(control_thread, (void *)(intptr_t)sfd);
+
+    sim_info("S32K144 host simulator: BOOT button %s, flash timing %s, baud pacing %s",
+             sim_opt.button ? "held" : "released",
+             (sim_opt.flash_timing == SIM_TIMING_NONE) ? "none" :
+             (sim_opt.flash_timing == SIM_TIMING_MAX) ? "max" : "typ",
+             sim_opt.baud_timing ? "on" : "off");
+}
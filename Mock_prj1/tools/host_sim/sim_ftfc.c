@@ -0,0 +1,436 @@
+/**
+ * @file    sim_ftfc.c
+ * @brief   S32K144 virtual peripheral layer - FTFC and the 512 KB P-Flash.
+ *
+ * Model:
+ *   - P-Flash is a 512 KB array (file backed with -f), visible read-only to
+ *     the firmware at 0x00000000 and written only by FTFC commands.
+ *   - Writing 1 to FSTAT.CCIF launches the command in FCCOB (FCCOB[3] is
+ *     FCCOB0, FCCOB[2..0] the address, FCCOB[4..11] the phrase data, see
+ *     Program_LongWord_8B()). Program Phrase (0x07), Erase Flash Sector
+ *     (0x09), Program Section (0x0B) and Set FlexRAM Function (0x81) are
+ *     implemented, every other command sets ACCERR. Outside RUN mode (SMC,
+ *     sim_periph.c) every command sets ACCERR.
+ *   - No EEE partition: FCNFG RAMRDY is set from reset, FlexRAM is plain
+ *     RAM (sim_core.c) and the Program Section data buffer. Set FlexRAM
+ *     Function accepts the RAM control code only.
+ *   - CCIF stays clear for the command execution time (datasheet typical or
+ *     maximum, or zero with -t none).
+ *   - Programming can only clear bits; a phrase that would need a 0 -> 1
+ *     transition sets MGSTAT0 (verify failure).
+ *
+ * The flash access code is copied by Mem_43_INFLS_IPW_LoadAc() from
+ * Mem_43_INFLS_ACWriteRomStart to WRITE_FUNCTION_ADDRESS in SRAM and called
+ * there with the Thumb bit set. On the host that image is a 13-byte x86-64
+ * jump (at offset 1, matching the odd call address) to the firmware's own
+ * Ftfc_AccessCode(), so the command launch and the CCIF wait are the real
+ * firmware code.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#define _GNU_SOURCE
+#include "sim_internal.h"
+#include "S32K144.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define FTFC_CMD_PROGRAM_PHRASE     (0x07U)
+#define FTFC_CMD_ERASE_SECTOR       (0x09U)
+#define FTFC_CMD_PROGRAM_SECTION    (0x0BU)
+#define FTFC_CMD_SET_FLEXRAM        (0x81U)
+#define FTFC_FLEXRAM_RAM            (0xFFU)     /**< Set FlexRAM control code */
+#define FTFC_CMD_REFUSED            (0x100U)    /**< Not a command: outside RUN */
+
+/** Execution times in us: { typical, maximum } (S32K1xx datasheet) */
+#define FTFC_T_PGM8_US              { 90U, 225U }
+#define FTFC_T_ERSSCR_US            { 12000U, 130000U }
+
+/** Write-1-to-clear error flags of FSTAT */
+#define FTFC_FSTAT_W1C  (FTFC_FSTAT_RDCOLERR_MASK | FTFC_FSTAT_ACCERR_MASK | FTFC_FSTAT_FPVIOL_MASK)
+
+#define FLASH_FD_ENV                "S32SIM_FLASH_FD"
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static sim_region_t *ftfc;
+static uint8_t      *flash;             /**< Simulator view of the array, RW */
+
+static struct {
+    bool     busy;
+    uint64_t done_ns;
+    uint8_t  result;                    /**< FSTAT bits set at completion    */
+} cmd;
+
+static struct {
+    uint32_t programs;
+    uint32_t erases;
+    uint32_t accerr;
+    uint32_t verify_fail;
+    uint64_t busy_ns;
+} stats;
+
+/* -------------------------------------------------------------------------- */
+/*                          Flash access code image                            */
+/* -------------------------------------------------------------------------- */
+
+/** @brief "ROM" image of the access code (defined by the linker on target). */
+uint32_t Mem_43_INFLS_ACWriteRomStart[4];
+
+/* Its size in words is the address of this absolute symbol (-no-pie build) */
+__asm__(".globl Mem_43_INFLS_ACWriteSize\n\t.set Mem_43_INFLS_ACWriteSize, 4");
+
+extern void Ftfc_AccessCode(void);
+
+/**
+ * @brief Build the access code image: nop; movabs rax, Ftfc_AccessCode; jmp rax.
+ */
+static void build_access_code(void)
+{
+    uint8_t  *p      = (uint8_t *)Mem_43_INFLS_ACWriteRomStart;
+    uint64_t  target = (uint64_t)(uintptr_t)Ftfc_AccessCode;
+
+    memset(p, 0x90, sizeof(Mem_43_INFLS_ACWriteRomStart));
+    p[1] = 0x48U;
+    p[2] = 0xB8U;
+    memcpy(&p[3], &target, sizeof(target));
+    p[11] = 0xFFU;
+    p[12] = 0xE0U;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                  Commands                                   */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Program one phrase with the data at src.
+ */
+static void program_phrase(uint32_t addr, const volatile uint8_t *src)
+{
+    uint32_t i;
+
+    for (i = 0U; i < SIM_FLASH_PHRASE_SIZE; i++) {
+        uint8_t data = src[i];
+
+        if ((data & (uint8_t)~flash[addr + i]) != 0U) {
+            cmd.result = FTFC_FSTAT_MGSTAT0_MASK;
+        }
+        flash[addr + i] &= data;
+    }
+    stats.programs++;
+}
+
+static uint32_t exec_time_us(const uint32_t t[2])
+{
+    switch (sim_opt.flash_timing) {
+    case SIM_TIMING_TYP: return t[0];
+    case SIM_TIMING_MAX: return t[1];
+    default:             return 0U;
+    }
+}
+
+static void command_complete(void)
+{
+    uint8_t fstat = SIM_REG8(ftfc, offsetof(FTFC_Type, FSTAT));
+
+    cmd.busy = false;
+    SIM_REG8(ftfc, offsetof(FTFC_Type, FSTAT)) = (uint8_t)(fstat | FTFC_FSTAT_CCIF_MASK | cmd.result);
+    sim_irq_line(FTFC_CMD_IRQn,
+                 (SIM_REG8(ftfc, offsetof(FTFC_Type, FCNFG)) & FTFC_FCNFG_CCIE_MASK) != 0U);
+}
+
+static void command_launch(void)
+{
+    static const uint32_t t_pgm8[2]   = FTFC_T_PGM8_US;
+    static const uint32_t t_ersscr[2] = FTFC_T_ERSSCR_US;
+    volatile uint8_t *fccob = &SIM_REG8(ftfc, offsetof(FTFC_Type, FCCOB));
+    uint8_t  code = fccob[3];
+    uint32_t addr = ((uint32_t)fccob[2] << 16) | ((uint32_t)fccob[1] << 8) | fccob[0];
+    uint32_t t_us = 0U;
+    uint32_t n;
+    uint32_t i;
+
+    cmd.result = 0U;
+
+    /* Program and erase are refused in HSRUN and VLPR */
+    switch ((sim_smc_runm() == 0U) ? code : FTFC_CMD_REFUSED) {
+    case FTFC_CMD_PROGRAM_PHRASE:
+        if (((addr & (SIM_FLASH_PHRASE_SIZE - 1U)) != 0U) || (addr >= SIM_FLASH_SIZE)) {
+            cmd.result = FTFC_FSTAT_ACCERR_MASK;
+            break;
+        }
+        program_phrase(addr, &fccob[4]);
+        if (cmd.result != 0U) {
+            stats.verify_fail++;
+            sim_info("FTFC: phrase 0x%05X programmed without erase", addr);
+        }
+        t_us = exec_time_us(t_pgm8);
+        break;
+
+    case FTFC_CMD_PROGRAM_SECTION:
+        /* FCCOB4..5: number of phrases, data from the start of FlexRAM */
+        n = ((uint32_t)fccob[7] << 8) | fccob[6];
+        if (((addr & (SIM_FLASH_PHRASE_SIZE - 1U)) != 0U) || (n == 0U) ||
+            (n * SIM_FLASH_PHRASE_SIZE > SIM_FLEXRAM_SIZE) ||
+            (addr + n * SIM_FLASH_PHRASE_SIZE > SIM_FLASH_SIZE) ||
+            ((SIM_REG8(ftfc, offsetof(FTFC_Type, FCNFG)) & FTFC_FCNFG_RAMRDY_MASK) == 0U)) {
+            cmd.result = FTFC_FSTAT_ACCERR_MASK;
+            break;
+        }
+        for (i = 0U; i < n; i++) {
+            program_phrase(addr + i * SIM_FLASH_PHRASE_SIZE,
+                           (const volatile uint8_t *)(uintptr_t)(SIM_FLEXRAM_BASE + i * SIM_FLASH_PHRASE_SIZE));
+        }
+        if (cmd.result != 0U) {
+            stats.verify_fail++;
+            sim_info("FTFC: section 0x%05X programmed without erase", addr);
+        }
+        /* Timed as n Program Phrase commands */
+        t_us = exec_time_us(t_pgm8) * n;
+        break;
+
+    case FTFC_CMD_SET_FLEXRAM:
+        if (fccob[2] != FTFC_FLEXRAM_RAM) {
+            cmd.result = FTFC_FSTAT_ACCERR_MASK;
+            sim_info("FTFC: FlexRAM control code 0x%02X not simulated", fccob[2]);
+            break;
+        }
+        SIM_REG8(ftfc, offsetof(FTFC_Type, FCNFG)) =
+            (uint8_t)((SIM_REG8(ftfc, offsetof(FTFC_Type, FCNFG)) & ~FTFC_FCNFG_EEERDY_MASK) |
+                      FTFC_FCNFG_RAMRDY_MASK);
+        /* Completes at once */
+        break;
+
+    case FTFC_CMD_ERASE_SECTOR:
+        if (((addr & 0xFU) != 0U) || (addr >= SIM_FLASH_SIZE)) {
+            cmd.result = FTFC_FSTAT_ACCERR_MASK;
+            break;
+        }
+        addr &= ~(SIM_FLASH_SECTOR_SIZE - 1U);
+        memset(&flash[addr], 0xFF, SIM_FLASH_SECTOR_SIZE);
+        stats.erases++;
+        sim_log("FTFC: erase sector 0x%05X", addr);
+        t_us = exec_time_us(t_ersscr);
+        break;
+
+    case FTFC_CMD_REFUSED:
+        cmd.result = FTFC_FSTAT_ACCERR_MASK;
+        sim_info("FTFC: command 0x%02X outside RUN mode", code);
+        break;
+
+    default:
+        cmd.result = FTFC_FSTAT_ACCERR_MASK;
+        sim_info("FTFC: command 0x%02X not simulated", code);
+        break;
+    }
+
+    if ((cmd.result & FTFC_FSTAT_ACCERR_MASK) != 0U) {
+        stats.accerr++;
+        sim_log("FTFC: ACCERR, command 0x%02X address 0x%06X", code, addr);
+    }
+
+    cmd.busy    = true;
+    cmd.done_ns = sim_now_ns() + (uint64_t)t_us * 1000ULL;
+    stats.busy_ns += (uint64_t)t_us * 1000ULL;
+    sim_irq_line(FTFC_CMD_IRQn, false);
+    if (t_us == 0U) {
+        command_complete();
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Register hooks                                */
+/* -------------------------------------------------------------------------- */
+
+static void ftfc_pre(sim_region_t *r, uint32_t off, bool write, uint32_t old)
+{
+    uint64_t now;
+
+    (void)r;
+    (void)old;
+
+    if ((off != offsetof(FTFC_Type, FSTAT)) || !cmd.busy) {
+        return;
+    }
+    now = sim_now_ns();
+    if ((now < cmd.done_ns) && !write) {
+        /* Polling CCIF: let host time pass instead of spinning on traps */
+        sim_sleep_until((cmd.done_ns - now > 50000ULL) ? (now + 50000ULL) : cmd.done_ns);
+        now = sim_now_ns();
+    }
+    if (now >= cmd.done_ns) {
+        command_complete();
+    }
+}
+
+static void ftfc_post(sim_region_t *r, uint32_t off, bool write, uint32_t old)
+{
+    uint8_t prev;
+    uint8_t val;
+
+    if (!write) {
+        return;
+    }
+
+    switch (off) {
+    case offsetof(FTFC_Type, FSTAT):
+        prev = (uint8_t)(old & 0xFFU);
+        val  = SIM_REG8(r, off);
+        /* Error flags are w1c, CCIF is launched by writing 1, MGSTAT0 is read-only */
+        prev &= (uint8_t)~(val & FTFC_FSTAT_W1C);
+        SIM_REG8(r, off) = prev;
+        if (((val & FTFC_FSTAT_CCIF_MASK) != 0U) && ((prev & FTFC_FSTAT_CCIF_MASK) != 0U)) {
+            if ((prev & (FTFC_FSTAT_ACCERR_MASK | FTFC_FSTAT_FPVIOL_MASK)) == 0U) {
+                SIM_REG8(r, off) = 0U;
+                command_launch();
+            }
+        }
+        break;
+
+    case offsetof(FTFC_Type, FCNFG):
+        /* RAMRDY and EEERDY are read-only */
+        SIM_REG8(r, off) = (uint8_t)((SIM_REG8(r, off) & ~(FTFC_FCNFG_RAMRDY_MASK | FTFC_FCNFG_EEERDY_MASK)) |
+                                     ((uint8_t)(old >> (8U * (off & 3U))) &
+                                      (FTFC_FCNFG_RAMRDY_MASK | FTFC_FCNFG_EEERDY_MASK)));
+        sim_irq_line(FTFC_CMD_IRQn,
+                     ((SIM_REG8(r, off) & FTFC_FCNFG_CCIE_MASK) != 0U) &&
+                     ((SIM_REG8(r, offsetof(FTFC_Type, FSTAT)) & FTFC_FSTAT_CCIF_MASK) != 0U));
+        break;
+
+    case offsetof(FTFC_Type, FSEC):
+    case offsetof(FTFC_Type, FOPT):
+        SIM_REG8(r, off) = (uint8_t)(old >> (8U * (off & 3U)));
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                 Public API                                  */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Lowest address the host lets us map (vm.mmap_min_addr).
+ */
+static uint32_t mmap_min_addr(void)
+{
+    FILE *f = fopen("/proc/sys/vm/mmap_min_addr", "r");
+    unsigned long v = 0x10000UL;
+
+    if (f != NULL) {
+        if (fscanf(f, "%lu", &v) != 1) {
+            v = 0x10000UL;
+        }
+        fclose(f);
+    }
+    v = (v + SIM_PAGE_SIZE - 1U) & ~(unsigned long)(SIM_PAGE_SIZE - 1U);
+    if (v == 0UL) {
+        v = SIM_PAGE_SIZE;
+    }
+    return (uint32_t)v;
+}
+
+/**
+ * @brief Open the flash backing store (file, inherited descriptor or new memfd).
+ */
+static int open_flash(bool *fresh)
+{
+    const char *env = getenv(FLASH_FD_ENV);
+    struct stat st;
+    char num[16];
+    int fd;
+
+    *fresh = false;
+    if (sim_opt.flash_path != NULL) {
+        fd = open(sim_opt.flash_path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    } else if (env != NULL) {
+        fd = atoi(env);
+    } else {
+        /* Volatile array, kept across a simulated reset through the environment */
+        fd = memfd_create("s32k144-pflash", 0);
+        snprintf(num, sizeof(num), "%d", fd);
+        setenv(FLASH_FD_ENV, num, 1);
+    }
+    if ((fd < 0) || (fstat(fd, &st) != 0)) {
+        sim_fatal("flash image: %s", strerror(errno));
+    }
+    if (st.st_size != (off_t)SIM_FLASH_SIZE) {
+        *fresh = (st.st_size == 0);
+        if (ftruncate(fd, SIM_FLASH_SIZE) != 0) {
+            sim_fatal("flash image: %s", strerror(errno));
+        }
+    }
+    return fd;
+}
+
+void sim_ftfc_init(void)
+{
+    uint32_t view;
+    bool fresh;
+    int fd;
+
+    build_access_code();
+
+    fd    = open_flash(&fresh);
+    flash = mmap(NULL, SIM_FLASH_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (flash == MAP_FAILED) {
+        sim_fatal("flash image: %s", strerror(errno));
+    }
+    if (fresh) {
+        memset(flash, 0xFF, SIM_FLASH_SIZE);
+    }
+
+    /* Read-only, non-executable view at the target address, as far as allowed */
+    view = mmap_min_addr();
+    if ((view >= SIM_FLASH_SIZE) ||
+        (sim_map_fixed(view, SIM_FLASH_SIZE - view, PROT_READ, fd, (long)view) == MAP_FAILED)) {
+        sim_info("flash is not mapped below 0x%05X (vm.mmap_min_addr)", view);
+    }
+    if (sim_opt.flash_path != NULL) {
+        close(fd);
+    }
+
+    ftfc = sim_map_region("FTFC", IP_FTFC_BASE, SIM_PAGE_SIZE, ftfc_pre, ftfc_post);
+    SIM_REG8(ftfc, offsetof(FTFC_Type, FSTAT)) = FTFC_FSTAT_CCIF_MASK;
+    SIM_REG8(ftfc, offsetof(FTFC_Type, FCNFG)) = FTFC_FCNFG_RAMRDY_MASK;  /* No EEE */
+    SIM_REG8(ftfc, offsetof(FTFC_Type, FSEC))  = 0xFEU;    /* Unsecured */
+    SIM_REG8(ftfc, offsetof(FTFC_Type, FOPT))  = 0xFFU;
+}
+
+uint8_t *sim_flash_mem(void)
+{
+    return flash;
+}
+
+void sim_ftfc_flush(void)
+{
+    if (flash != NULL) {
+        msync(flash, SIM_FLASH_SIZE, MS_SYNC);
+    }
+}
+
+void sim_ftfc_stats(FILE *out)
+{
+    fprintf(out, "[SIM] FTFC: %u phrases programmed, %u sectors erased, %u ACCERR, "
+                 "%u verify failures, %.3f s busy\n",
+            stats.programs, stats.erases, stats.accerr, stats.verify_fail,
+            (double)stats.busy_ns / 1e9);
+}
@@ -0,0 +1,165 @@
+/**
+ * @file    sim_internal.h
+ * @brief   S32K144 virtual peripheral layer - internal interfaces.
+ *
+ * A region is one or more 4 KB pages of the S32K144 memory map. Trapped
+ * regions are mapped PROT_NONE at their target address; every access raises
+ * SIGSEGV, the simulator runs the region's pre hook, lets the instruction
+ * execute once (single step) and runs the post hook. The hooks work on an
+ * always-writable alias of the same pages.
+ */
+
+#ifndef SIM_INTERNAL_H_
+#define SIM_INTERNAL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "sim.h"
+
+/* ============================================================
+ *                  MEMORY MAP
+ * ============================================================ */
+
+#define SIM_PAGE_SIZE           (0x1000U)
+
+#define SIM_FLASH_BASE          (0x00000000U)
+#define SIM_FLASH_SIZE          (0x00080000U)   /**< 512 KB P-Flash             */
+#define SIM_FLASH_SECTOR_SIZE   (0x1000U)       /**< 4 KB erase sector          */
+#define SIM_FLASH_PHRASE_SIZE   (8U)            /**< Program Phrase unit        */
+
+#define SIM_FLEXRAM_BASE        (0x14000000U)
+#define SIM_FLEXRAM_SIZE        (0x1000U)
+
+#define SIM_SRAM_BASE           (0x1FFF8000U)   /**< SRAM_L + SRAM_U            */
+#define SIM_SRAM_SIZE           (0x0000F000U)
+
+#define SIM_DWT_BASE            (0xE0001000U)
+#define SIM_SCS_BASE            (0xE000E000U)
+
+/* ============================================================
+ *                  REGIONS
+ * ============================================================ */
+
+typedef struct sim_region sim_region_t;
+
+/**
+ * @brief Access hook.
+ *
+ * @param r      Region.
+ * @param off    Offset of the faulting address inside the region.
+ * @param write  true for stores and read-modify-write instructions.
+ * @param old    Aligned 32-bit word at @p off before the access.
+ */
+typedef void (*sim_hook_t)(sim_region_t *r, uint32_t off, bool write, uint32_t old);
+
+struct sim_region {
+    const char *name;
+    uint32_t    base;           /**< Target address                       */
+    uint32_t    size;           /**< Multiple of SIM_PAGE_SIZE            */
+    uint8_t    *mem;            /**< Simulator alias, always RW           */
+    sim_hook_t  pre;            /**< Both NULL: mapped RW, not trapped    */
+    sim_hook_t  post;
+};
+
+#define SIM_REG32(r, off)       (*(volatile uint32_t *)((r)->mem + (off)))
+#define SIM_REG8(r, off)        (*(volatile uint8_t  *)((r)->mem + (off)))
+
+/* ============================================================
+ *                  OPTIONS
+ * ============================================================ */
+
+typedef enum {
+    SIM_TIMING_NONE = 0,        /**< Commands complete immediately        */
+    SIM_TIMING_TYP,             /**< Datasheet typical execution times    */
+    SIM_TIMING_MAX              /**< Datasheet maximum execution times    */
+} sim_timing_t;
+
+typedef struct {
+    const char  *flash_path;    /**< Flash image file (NULL: volatile)    */
+    const char  *pty_link;      /**< Symlink created to the pty slave     */
+    bool         button;        /**< BOOT button (PTC13) held at reset    */
+    sim_timing_t flash_timing;
+    bool         baud_timing;   /**< Pace LPUART characters at the baud   */
+    bool         verbose;
+    uint32_t     idle_exit_ms;  /**< Exit after this much UART silence    */
+} sim_options_t;
+
+extern sim_options_t sim_opt;
+
+/* ============================================================
+ *                  CORE (sim_core.c)
+ * ============================================================ */
+
+/** @brief Monotonic host time in ns. */
+uint64_t sim_now_ns(void);
+
+/** @brief Sleep until an absolute sim_now_ns() time. */
+void sim_sleep_until(uint64_t t_ns);
+
+/** @brief Map @p size bytes of @p fd at a fixed target address (MAP_FAILED on error). */
+void *sim_map_fixed(uint32_t base, uint32_t size, int prot, int fd, long fd_off);
+
+/** @brief Map a region at its target address (no hook: not trapped). */
+sim_region_t *sim_map_region(const char *name, uint32_t base, uint32_t size,
+                             sim_hook_t pre, sim_hook_t post);
+
+/** @brief Find the region containing a target address. */
+sim_region_t *sim_find_region(uint32_t addr);
+
+/** @brief Message on stderr (always). */
+void sim_info(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/** @brief Message on stderr (with -v only). */
+void sim_log(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/** @brief Fatal error: message, then abort. */
+void sim_fatal(const char *fmt, ...) __attribute__((format(printf, 1, 2), noreturn));
+
+/** @brief Set the request line of a peripheral interrupt (level sensitive). */
+void sim_irq_line(uint32_t irqn, bool level);
+
+/** @brief Start a detached host thread with every signal blocked. */
+void sim_thread_create(void *(*fn)(void *), void *arg);
+
+/** @brief Time interrupt @p irqn has been masked by PRIMASK or BASEPRI, 0 when
+ *         it can be taken (any thread). */
+uint64_t sim_masked_ns(uint32_t irqn);
+
+/** @brief Ask the CPU thread to look for interrupts (any thread). */
+void sim_kick(void);
+
+/** @brief Print statistics, flush the flash image and exit (any thread). */
+void sim_shutdown(int status) __attribute__((noreturn));
+
+/** @brief System reset: re-execute the simulator with the same pty and flash. */
+void sim_reset(const char *reason) __attribute__((noreturn));
+
+/* ============================================================
+ *                  PERIPHERAL MODELS
+ * ============================================================ */
+
+/* sim_periph.c: SCG, SMC, PCC, PORT, GPIO, DWT, SCS/NVIC, LMEM, MSCM */
+void     sim_periph_init(void);
+uint32_t sim_scg_core_hz(void);
+uint32_t sim_smc_runm(void);    /* SMC PMCTRL[RUNM] of the current mode: 0 RUN */
+uint32_t sim_pcc_clock_hz(uint32_t pcc_index);
+uint32_t sim_vtor(void);
+bool     sim_nvic_enabled(uint32_t irqn);
+uint32_t sim_nvic_priority(uint32_t irqn);
+
+/* sim_ftfc.c: FTFC and the P-Flash array */
+void     sim_ftfc_init(void);
+uint8_t *sim_flash_mem(void);
+void     sim_ftfc_flush(void);
+void     sim_ftfc_stats(FILE *out);
+
+/* sim_lpuart.c: LPUART0..2, LPUART1 connected to a pty */
+void     sim_lpuart_init(void);
+void     sim_lpuart_service(void);
+void     sim_lpuart_stats(FILE *out);
+void     sim_lpuart_close(void);
+uint64_t sim_lpuart_last_activity(void);
+int      sim_lpuart_pty_fd(void);
+
+#endif /* SIM_INTERNAL_H_ */
@@ -0,0 +1,443 @@
+/**
+ * @file    sim_lpuart.c
+ * @brief   S32K144 virtual peripheral layer - LPUART0..2, LPUART1 on a pty.
+ *
+ * Model (FIFO disabled, as configured by hal_usart.c):
+ *   - TX: a write of DATA sends the character to the pty at once. TDRE and
+ *     TC follow the character time derived from BAUD and the PCC clock, so
+ *     blocking sends take as long as on the board.
+ *   - RX: a host thread reads the pty and releases one character per
+ *     character time (the wire). A released character is loaded into DATA
+ *     when RDRF is clear. If it was released while the CPU had the LPUART1
+ *     interrupt masked (PRIMASK, or BASEPRI at or above its priority) for
+ *     more than MASK_SLACK_NS and RDRF is still set, it is lost
+ *     and OR is set, as on the board. The slack absorbs host scheduling
+ *     delays, which stretch short masked sections (a phrase program takes
+ *     90 us on the board) well beyond a character time.
+ *     Characters arriving while RE = 0 are dropped.
+ *   - STAT error flags are write-1-to-clear; reading DATA clears RDRF.
+ *   - The request line is RIE&RDRF | TIE&TDRE | TCIE&TC | ORIE&OR, evaluated
+ *     on register accesses and on character arrival.
+ *
+ * LPUART0 and LPUART2 are simulated without a line (TX is discarded).
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#define _GNU_SOURCE
+#include "sim_internal.h"
+#include "S32K144.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define LPUART_COUNT        (3U)
+#define PTY_UART            (1U)            /**< LPUART1: OpenSDA virtual COM */
+#define RX_RING_SIZE        (4096U)         /**< Power of two                */
+#define RX_OFF              (0xFFFFFFFFU)   /**< rx_char_ns: receiver disabled */
+#define PTY_FD_ENV          "S32SIM_PTY_FD"
+#define MASK_SLACK_NS       (10000000U)     /**< Masked time not counted as overrun */
+
+#define STAT_W1C    (LPUART_STAT_LBKDIF_MASK | LPUART_STAT_RXEDGIF_MASK | LPUART_STAT_IDLE_MASK | \
+                     LPUART_STAT_OR_MASK | LPUART_STAT_NF_MASK | LPUART_STAT_FE_MASK | LPUART_STAT_PF_MASK)
+#define STAT_RW     (LPUART_STAT_MSBF_MASK | LPUART_STAT_RXINV_MASK | LPUART_STAT_RWUID_MASK | \
+                     LPUART_STAT_BRK13_MASK | LPUART_STAT_LBKDE_MASK)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Types                                  */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    sim_region_t *r;
+    uint32_t      irqn;
+    uint32_t      pcc_index;
+    uint32_t      char_ns;      /**< Character time, 0 = not pacing    */
+    uint8_t       rx_data;      /**< Receive side of DATA              */
+    uint64_t      tx_end_ns;    /**< Shifter empty after this time     */
+} lpuart_t;
+
+typedef struct {
+    uint8_t byte;
+    uint8_t masked;             /**< Arrived in a long masked section  */
+} rx_entry_t;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static lpuart_t uart[LPUART_COUNT];
+
+static int pty_master = -1;
+static int pty_slave  = -1;
+
+/* Wire -> CPU thread (single producer, single consumer) */
+static rx_entry_t rx_ring[RX_RING_SIZE];
+static uint32_t   rx_head;                  /**< Written by the wire thread */
+static uint32_t   rx_tail;                  /**< Written by the CPU thread  */
+static uint32_t   rx_char_ns = RX_OFF;      /**< Published by the CPU thread */
+static uint64_t   last_activity_ns;
+
+static struct {
+    uint32_t rx;
+    uint32_t tx;
+    uint32_t overrun;
+    uint32_t rx_off;                        /**< Dropped, receiver disabled  */
+    uint32_t rx_full;                       /**< Dropped, ring full          */
+    uint32_t tx_full;                       /**< Dropped, pty not read       */
+} stats;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+#define U_R(u, reg)         SIM_REG32((u)->r, offsetof(LPUART_Type, reg))
+
+static lpuart_t *find(sim_region_t *r)
+{
+    uint32_t i;
+
+    for (i = 0U; i < LPUART_COUNT; i++) {
+        if (uart[i].r == r) {
+            return &uart[i];
+        }
+    }
+    sim_fatal("LPUART region %s unknown", r->name);
+}
+
+/**
+ * @brief Character time from BAUD, CTRL and the functional clock.
+ */
+static void update_timing(lpuart_t *u)
+{
+    uint32_t baud = U_R(u, BAUD);
+    uint32_t ctrl = U_R(u, CTRL);
+    uint32_t clk  = sim_pcc_clock_hz(u->pcc_index);
+    uint32_t osr  = ((baud & LPUART_BAUD_OSR_MASK) >> LPUART_BAUD_OSR_SHIFT) + 1U;
+    uint32_t sbr  = baud & LPUART_BAUD_SBR_MASK;
+    uint32_t bits = 1U + 8U + 1U;
+
+    if ((ctrl & LPUART_CTRL_M_MASK) != 0U)     bits++;
+    if ((ctrl & LPUART_CTRL_PE_MASK) != 0U)    bits++;
+    if ((baud & LPUART_BAUD_SBNS_MASK) != 0U)  bits++;
+
+    u->char_ns = 0U;
+    if (sim_opt.baud_timing && (clk != 0U) && (sbr != 0U)) {
+        u->char_ns = (uint32_t)(((uint64_t)bits * osr * sbr * 1000000000ULL) / clk);
+    }
+
+    if (u == &uart[PTY_UART]) {
+        uint32_t v = ((ctrl & LPUART_CTRL_RE_MASK) != 0U) ? u->char_ns : RX_OFF;
+
+        if (__atomic_exchange_n(&rx_char_ns, v, __ATOMIC_RELEASE) != v) {
+            sim_log("LPUART1: RE=%u, %u Hz / (%u * %u) = %u baud", (v != RX_OFF) ? 1U : 0U,
+                    clk, osr, sbr, ((osr * sbr) != 0U) ? clk / (osr * sbr) : 0U);
+        }
+    }
+}
+
+/**
+ * @brief TDRE/TC from the transmit timeline.
+ */
+static void update_tx_flags(lpuart_t *u)
+{
+    uint64_t now  = sim_now_ns();
+    uint32_t stat = U_R(u, STAT) & ~(LPUART_STAT_TDRE_MASK | LPUART_STAT_TC_MASK);
+
+    if (u->tx_end_ns <= now + u->char_ns) {
+        stat |= LPUART_STAT_TDRE_MASK;      /* Only the shifter is busy */
+    }
+    if (u->tx_end_ns <= now) {
+        stat |= LPUART_STAT_TC_MASK;
+    }
+    U_R(u, STAT) = stat;
+}
+
+static void update_irq(lpuart_t *u)
+{
+    uint32_t ctrl = U_R(u, CTRL);
+    uint32_t stat;
+
+    update_tx_flags(u);
+    stat = U_R(u, STAT);
+    sim_irq_line(u->irqn,
+        (((ctrl & LPUART_CTRL_RIE_MASK)  != 0U) && ((stat & LPUART_STAT_RDRF_MASK) != 0U)) ||
+        (((ctrl & LPUART_CTRL_TIE_MASK)  != 0U) && ((stat & LPUART_STAT_TDRE_MASK) != 0U)) ||
+        (((ctrl & LPUART_CTRL_TCIE_MASK) != 0U) && ((stat & LPUART_STAT_TC_MASK)   != 0U)) ||
+        (((ctrl & LPUART_CTRL_ORIE_MASK) != 0U) && ((stat & LPUART_STAT_OR_MASK)   != 0U)));
+}
+
+static void transmit(lpuart_t *u, uint8_t c)
+{
+    uint64_t now = sim_now_ns();
+
+    if ((U_R(u, CTRL) & LPUART_CTRL_TE_MASK) == 0U) {
+        return;
+    }
+    u->tx_end_ns = ((u->tx_end_ns > now) ? u->tx_end_ns : now) + u->char_ns;
+
+    if (u == &uart[PTY_UART]) {
+        stats.tx++;
+        __atomic_store_n(&last_activity_ns, now, __ATOMIC_RELAXED);
+        if (write(pty_master, &c, 1U) != 1) {
+            stats.tx_full++;
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Register hooks                                */
+/* -------------------------------------------------------------------------- */
+
+static void lpuart_pre(sim_region_t *r, uint32_t off, bool write, uint32_t old)
+{
+    (void)write;
+    (void)old;
+    if (off == offsetof(LPUART_Type, STAT)) {
+        update_tx_flags(find(r));
+    }
+}
+
+static void lpuart_post(sim_region_t *r, uint32_t off, bool write, uint32_t old)
+{
+    lpuart_t *u = find(r);
+    uint32_t val = SIM_REG32(r, off & ~3U);
+
+    switch (off) {
+    case offsetof(LPUART_Type, STAT):
+        if (write) {
+            U_R(u, STAT) = (old & ~STAT_RW & ~(val & STAT_W1C)) | (val & STAT_RW);
+        }
+        break;
+
+    case offsetof(LPUART_Type, DATA):
+        if (write) {
+            transmit(u, (uint8_t)val);
+            U_R(u, DATA) = u->rx_data;
+        } else if ((U_R(u, STAT) & LPUART_STAT_RDRF_MASK) != 0U) {
+            U_R(u, STAT) &= ~LPUART_STAT_RDRF_MASK;
+            if (__atomic_load_n(&rx_head, __ATOMIC_ACQUIRE) != rx_tail) {
+                sim_kick();
+            }
+        } else {
+            /* Empty read */
+        }
+        break;
+
+    case offsetof(LPUART_Type, BAUD):
+    case offsetof(LPUART_Type, CTRL):
+        if (write) {
+            update_timing(u);
+        }
+        break;
+
+    case offsetof(LPUART_Type, VERID):
+    case offsetof(LPUART_Type, PARAM):
+        if (write) {
+            SIM_REG32(r, off) = old;
+        }
+        break;
+
+    default:
+        break;
+    }
+    update_irq(u);
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                 Wire thread                                 */
+/* -------------------------------------------------------------------------- */
+
+static void *wire_thread(void *arg)
+{
+    struct pollfd pfd = { .fd = pty_master, .events = POLLIN };
+    uint64_t next_ns = 0U;
+    uint8_t  buf[256];
+    ssize_t  n;
+    ssize_t  i;
+
+    (void)arg;
+    for (;;) {
+        if (poll(&pfd, 1, -1) < 0) {
+            continue;
+        }
+        n = read(pty_master, buf, sizeof(buf));
+        if (n <= 0) {
+            if ((n < 0) && (errno != EAGAIN) && (errno != EINTR)) {
+                /* No client on the slave side, wait for one */
+                usleep(10000);
+            }
+            continue;
+        }
+
+        for (i = 0; i < n; i++) {
+            uint32_t cns = __atomic_load_n(&rx_char_ns, __ATOMIC_ACQUIRE);
+            uint64_t now = sim_now_ns();
+            uint32_t head;
+
+            if (cns == RX_OFF) {
+                stats.rx_off++;
+                continue;
+            }
+            if (cns != 0U) {
+                next_ns = ((next_ns > now) ? next_ns : now) + cns;
+                sim_sleep_until(next_ns);
+            }
+
+            head = __atomic_load_n(&rx_head, __ATOMIC_RELAXED);
+            while (head - __atomic_load_n(&rx_tail, __ATOMIC_ACQUIRE) >= RX_RING_SIZE) {
+                if (cns != 0U) {
+                    break;
+                }
+                usleep(100);
+            }
+            if (head - __atomic_load_n(&rx_tail, __ATOMIC_ACQUIRE) >= RX_RING_SIZE) {
+                stats.rx_full++;
+                continue;
+            }
+
+            rx_ring[head % RX_RING_SIZE].byte   = buf[i];
+            rx_ring[head % RX_RING_SIZE].masked = (uint8_t)(sim_masked_ns(LPUART1_RxTx_IRQn) > MASK_SLACK_NS);
+            __atomic_store_n(&rx_head, head + 1U, __ATOMIC_RELEASE);
+            __atomic_store_n(&last_activity_ns, sim_now_ns(), __ATOMIC_RELAXED);
+            sim_kick();
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Create the pty, or take over the one of the simulator before a reset.
+ */
+static void open_pty(void)
+{
+    const char *env = getenv(PTY_FD_ENV);
+    struct termios tio;
+    char num[32];
+    const char *name;
+
+    if ((env == NULL) || (sscanf(env, "%d,%d", &pty_master, &pty_slave) != 2)) {
+        pty_master = posix_openpt(O_RDWR | O_NOCTTY);
+        if ((pty_master < 0) || (grantpt(pty_master) != 0) || (unlockpt(pty_master) != 0)) {
+            sim_fatal("pty: %s", strerror(errno));
+        }
+        /* Keep the slave open: no hangup between two clients, raw line settings */
+        pty_slave = open(ptsname(pty_master), O_RDWR | O_NOCTTY);
+        if ((pty_slave < 0) || (tcgetattr(pty_slave, &tio) != 0)) {
+            sim_fatal("pty slave: %s", strerror(errno));
+        }
+        cfmakeraw(&tio);
+        tcsetattr(pty_slave, TCSANOW, &tio);
+        snprintf(num, sizeof(num), "%d,%d", pty_master, pty_slave);
+        setenv(PTY_FD_ENV, num, 1);
+    }
+    fcntl(pty_master, F_SETFL, fcntl(pty_master, F_GETFL) | O_NONBLOCK);
+
+    name = ptsname(pty_master);
+    if (sim_opt.pty_link != NULL) {
+        unlink(sim_opt.pty_link);
+        if (symlink(name, sim_opt.pty_link) != 0) {
+            sim_fatal("symlink %s: %s", sim_opt.pty_link, strerror(errno));
+        }
+    }
+    sim_info("LPUART1 <-> %s%s%s", name,
+             (sim_opt.pty_link != NULL) ? " <- " : "",
+             (sim_opt.pty_link != NULL) ? sim_opt.pty_link : "");
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                 Public API                                  */
+/* -------------------------------------------------------------------------- */
+
+void sim_lpuart_init(void)
+{
+    static const struct {
+        const char *name;
+        uint32_t    base;
+        uint32_t    irqn;
+        uint32_t    pcc_index;
+    } cfg[LPUART_COUNT] = {
+        { "LPUART0", IP_LPUART0_BASE, LPUART0_RxTx_IRQn, PCC_LPUART0_INDEX },
+        { "LPUART1", IP_LPUART1_BASE, LPUART1_RxTx_IRQn, PCC_LPUART1_INDEX },
+        { "LPUART2", IP_LPUART2_BASE, LPUART2_RxTx_IRQn, PCC_LPUART2_INDEX },
+    };
+    uint32_t i;
+
+    for (i = 0U; i < LPUART_COUNT; i++) {
+        lpuart_t *u = &uart[i];
+
+        u->r         = sim_map_region(cfg[i].name, cfg[i].base, SIM_PAGE_SIZE, lpuart_pre, lpuart_post);
+        u->irqn      = cfg[i].irqn;
+        u->pcc_index = cfg[i].pcc_index;
+        U_R(u, VERID) = 0x04010003U;
+        U_R(u, PARAM) = 0x00000202U;
+        U_R(u, BAUD)  = 0x0F000004U;
+        U_R(u, STAT)  = LPUART_STAT_TDRE_MASK | LPUART_STAT_TC_MASK;
+        U_R(u, DATA)  = LPUART_DATA_RXEMPT_MASK;
+        U_R(u, FIFO)  = 0x00C00011U;
+    }
+
+    open_pty();
+    last_activity_ns = sim_now_ns();
+    sim_thread_create(wire_thread, NULL);
+}
+
+void sim_lpuart_service(void)
+{
+    lpuart_t *u = &uart[PTY_UART];
+    uint32_t head = __atomic_load_n(&rx_head, __ATOMIC_ACQUIRE);
+
+    while (rx_tail != head) {
+        const rx_entry_t *e = &rx_ring[rx_tail % RX_RING_SIZE];
+
+        if ((U_R(u, STAT) & LPUART_STAT_RDRF_MASK) == 0U) {
+            u->rx_data   = e->byte;
+            U_R(u, DATA) = e->byte;
+            U_R(u, STAT) |= LPUART_STAT_RDRF_MASK;
+            stats.rx++;
+        } else if ((e->masked != 0U) && (u->char_ns != 0U)) {
+            U_R(u, STAT) |= LPUART_STAT_OR_MASK;
+            stats.overrun++;
+        } else {
+            break;
+        }
+        __atomic_store_n(&rx_tail, rx_tail + 1U, __ATOMIC_RELEASE);
+    }
+    update_irq(u);
+}
+
+uint64_t sim_lpuart_last_activity(void)
+{
+    return __atomic_load_n(&last_activity_ns, __ATOMIC_RELAXED);
+}
+
+int sim_lpuart_pty_fd(void)
+{
+    return pty_master;
+}
+
+void sim_lpuart_close(void)
+{
+    if (sim_opt.pty_link != NULL) {
+        unlink(sim_opt.pty_link);
+    }
+}
+
+void sim_lpuart_stats(FILE *out)
+{
+    fprintf(out, "[SIM] LPUART1: %u bytes received, %u sent, %u overruns, "
+                 "%u dropped (RE=0), %u dropped (ring full), %u lost (pty full)\n",
+            stats.rx, stats.tx, stats.overrun, stats.rx_off, stats.rx_full, stats.tx_full);
+}
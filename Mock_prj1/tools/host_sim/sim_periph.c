@@ -0,0 +1,572 @@
+/**
+ * @file    sim_periph.c
+ * @brief   S32K144 virtual peripheral layer - SCG, SMC, PCC, PORT, GPIO, DWT,
+ *          SCS, LMEM, MSCM.
+ *
+ * Model:
+ *   - SCG: xxxVLD follows xxxEN (SPLL also needs a valid SOSC), a write of
+ *     the clock configuration of the current run mode (RCCR, HCCR, VCCR)
+ *     switches CSR at once, LK protects a control register, the source of
+ *     the system clock cannot be disabled.
+ *   - SMC: PMPROT is write-once, a PMCTRL.RUNM write enters the mode at
+ *     once (PMSTAT, CSR) if PMPROT allows it and the switch starts in RUN.
+ *   - PCC, PORT: plain memory (PR set in every PCC slot), no trap.
+ *   - GPIO: PSOR/PCOR/PTOR act on PDOR, PDIR returns outputs and the input
+ *     levels; all inputs are pulled up except the BOOT button PTC13 while
+ *     it is held (-b).
+ *   - DWT.CYCCNT counts host time at the current core clock.
+ *   - SCS: NVIC enable registers, VTOR, AIRCR.SYSRESETREQ (re-executes the
+ *     simulator), CPUID.
+ *   - LMEM: cache commands complete at once (GO/LGO read 0), nothing is
+ *     cached. MSCM: plain memory.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#define _GNU_SOURCE
+#include "sim_internal.h"
+#include "S32K144.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define SOSC_HZ             (8000000U)      /**< EVB crystal                 */
+#define FIRC_HZ             (48000000U)
+#define SIRC_HI_HZ          (8000000U)
+#define SIRC_LO_HZ          (2000000U)
+
+#define GPIO_PORT_STRIDE    (0x40U)
+#define GPIO_PORT_COUNT     (5U)
+#define BUTTON_PORT         (2U)            /**< PTC13 (SW2)                  */
+#define BUTTON_PIN          (13U)
+
+#define DWT_CTRL            (0x000U)
+#define DWT_CYCCNT          (0x004U)
+#define DWT_CTRL_CYCCNTENA  (1UL << 0)
+
+#define SCS_ISER            (0x100U)
+#define SCS_ICER            (0x180U)
+#define SCS_ISPR            (0x200U)
+#define SCS_ICPR            (0x280U)
+#define SCS_IPR             (0x400U)
+#define SCS_CPUID           (0xD00U)
+#define SCS_VTOR            (0xD08U)
+#define SCS_AIRCR           (0xD0CU)
+#define SCS_DEMCR           (0xDFCU)
+#define DEMCR_TRCENA        (1UL << 24)
+#define AIRCR_VECTKEY       (0x05FAU)
+#define AIRCR_SYSRESETREQ   (1UL << 2)
+
+#define SMC_RUNM_RUN        (0U)
+#define SMC_RUNM_VLPR       (2U)
+#define SMC_RUNM_HSRUN      (3U)
+#define SMC_PMSTAT_RUN      (0x01U)
+#define SMC_PMSTAT_VLPR     (0x04U)
+#define SMC_PMSTAT_HSRUN    (0x80U)
+
+#define LMEM_PCCCR          (0x000U)
+#define LMEM_PCCSAR         (0x008U)
+#define LMEM_GO             (1UL << 31)
+#define LMEM_LGO            (1UL << 0)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static sim_region_t *scg;
+static sim_region_t *pcc;
+static sim_region_t *gpio;
+static sim_region_t *dwt;
+static sim_region_t *scs;
+static sim_region_t *smc;
+
+static uint32_t smc_runm = SMC_RUNM_RUN;    /**< Current run mode          */
+static bool     smc_pmprot_written;
+
+static uint32_t gpio_in[GPIO_PORT_COUNT];   /**< Pin levels of the inputs  */
+static uint32_t nvic_en[8];
+
+static struct {
+    uint64_t cycles;
+    uint64_t last_ns;
+    uint64_t rem;                           /**< Sub-cycle remainder (ns*Hz) */
+} cyc;
+
+/* -------------------------------------------------------------------------- */
+/*                                     SCG                                     */
+/* -------------------------------------------------------------------------- */
+
+#define SCG_R(reg)          SIM_REG32(scg, offsetof(SCG_Type, reg))
+
+static uint32_t div_out(uint32_t src_hz, uint32_t field)
+{
+    return (field == 0U) ? 0U : (src_hz >> (field - 1U));
+}
+
+static uint32_t sosc_hz(void)
+{
+    return ((SCG_R(SOSCCSR) & SCG_SOSCCSR_SOSCVLD_MASK) != 0U) ? SOSC_HZ : 0U;
+}
+
+static uint32_t sirc_hz(void)
+{
+    if ((SCG_R(SIRCCSR) & SCG_SIRCCSR_SIRCVLD_MASK) == 0U) {
+        return 0U;
+    }
+    return ((SCG_R(SIRCCFG) & SCG_SIRCCFG_RANGE_MASK) != 0U) ? SIRC_HI_HZ : SIRC_LO_HZ;
+}
+
+static uint32_t firc_hz(void)
+{
+    return ((SCG_R(FIRCCSR) & SCG_FIRCCSR_FIRCVLD_MASK) != 0U) ? FIRC_HZ : 0U;
+}
+
+static uint32_t spll_hz(void)
+{
+    uint32_t cfg = SCG_R(SPLLCFG);
+
+    if ((SCG_R(SPLLCSR) & SCG_SPLLCSR_SPLLVLD_MASK) == 0U) {
+        return 0U;
+    }
+    return SOSC_HZ / (((cfg & SCG_SPLLCFG_PREDIV_MASK) >> SCG_SPLLCFG_PREDIV_SHIFT) + 1U)
+                   * (((cfg & SCG_SPLLCFG_MULT_MASK) >> SCG_SPLLCFG_MULT_SHIFT) + 16U) / 2U;
+}
+
+uint32_t sim_scg_core_hz(void)
+{
+    uint32_t csr = SCG_R(CSR);
+    uint32_t src;
+
+    switch ((csr & SCG_CSR_SCS_MASK) >> SCG_CSR_SCS_SHIFT) {
+    case 1U: src = sosc_hz(); break;
+    case 2U: src = sirc_hz(); break;
+    case 3U: src = firc_hz(); break;
+    case 6U: src = spll_hz(); break;
+    default: src = 0U;        break;
+    }
+    return src / (((csr & SCG_CSR_DIVCORE_MASK) >> SCG_CSR_DIVCORE_SHIFT) + 1U);
+}
+
+uint32_t sim_pcc_clock_hz(uint32_t pcc_index)
+{
+    uint32_t v = SIM_REG32(pcc, pcc_index * 4U);
+
+    if ((v & PCC_PCCn_CGC_MASK) == 0U) {
+        return 0U;
+    }
+    switch ((v & PCC_PCCn_PCS_MASK) >> PCC_PCCn_PCS_SHIFT) {
+    case 1U: return div_out(sosc_hz(), (SCG_R(SOSCDIV) & SCG_SOSCDIV_SOSCDIV2_MASK) >> SCG_SOSCDIV_SOSCDIV2_SHIFT);
+    case 2U: return div_out(sirc_hz(), (SCG_R(SIRCDIV) & SCG_SIRCDIV_SIRCDIV2_MASK) >> SCG_SIRCDIV_SIRCDIV2_SHIFT);
+    case 3U: return div_out(firc_hz(), (SCG_R(FIRCDIV) & SCG_FIRCDIV_FIRCDIV2_MASK) >> SCG_FIRCDIV_FIRCDIV2_SHIFT);
+    case 6U: return div_out(spll_hz(), (SCG_R(SPLLDIV) & SCG_SPLLDIV_SPLLDIV2_MASK) >> SCG_SPLLDIV_SPLLDIV2_SHIFT);
+    default: return 0U;
+    }
+}
+
+/**
+ * @brief Bring CYCCNT up to date before the core clock or the enables change.
+ */
+static void cyc_advance(void)
+{
+    uint64_t now = sim_now_ns();
+    bool on = ((SIM_REG32(scs, SCS_DEMCR) & DEMCR_TRCENA) != 0U) &&
+              ((SIM_REG32(dwt, DWT_CTRL) & DWT_CTRL_CYCCNTENA) != 0U);
+
+    if (on) {
+        __uint128_t acc = (__uint128_t)(now - cyc.last_ns) * sim_scg_core_hz() + cyc.rem;
+
+        cyc.cycles += (uint64_t)(acc / 1000000000U);
+        cyc.rem     = (uint64_t)(acc % 1000000000U);
+    }
+    cyc.last_ns = now;
+}
+
+/**
+ * @brief xxxSEL flags follow CSR.SCS.
+ */
+static void scg_update_sel(void)
+{
+    uint32_t scs_field = (SCG_R(CSR) & SCG_CSR_SCS_MASK) >> SCG_CSR_SCS_SHIFT;
+
+    SCG_R(SOSCCSR) = (SCG_R(SOSCCSR) & ~SCG_SOSCCSR_SOSCSEL_MASK) | ((scs_field == 1U) ? SCG_SOSCCSR_SOSCSEL_MASK : 0U);
+    SCG_R(SIRCCSR) = (SCG_R(SIRCCSR) & ~SCG_SIRCCSR_SIRCSEL_MASK) | ((scs_field == 2U) ? SCG_SIRCCSR_SIRCSEL_MASK : 0U);
+    SCG_R(FIRCCSR) = (SCG_R(FIRCCSR) & ~SCG_FIRCCSR_FIRCSEL_MASK) | ((scs_field == 3U) ? SCG_FIRCCSR_FIRCSEL_MASK : 0U);
+    SCG_R(SPLLCSR) = (SCG_R(SPLLCSR) & ~SCG_SPLLCSR_SPLLSEL_MASK) | ((scs_field == 6U) ? SCG_SPLLCSR_SPLLSEL_MASK : 0U);
+}
+
+/**
+ * @brief Write of a clock source control register (SOSCCSR, SIRCCSR, ...).
+ */
+static void scg_source_write(uint32_t off, uint32_t old, uint32_t scs_code, bool usable)
+{
+    uint32_t val = SIM_REG32(scg, off);
+    uint32_t scs_field = (SCG_R(CSR) & SCG_CSR_SCS_MASK) >> SCG_CSR_SCS_SHIFT;
+
+    /* Same layout for all sources: EN bit 0, LK bit 23, VLD bit 24, SEL bit 25 */
+    if ((old & SCG_SOSCCSR_LK_MASK) != 0U) {
+        SIM_REG32(scg, off) = old;
+        return;
+    }
+    if ((scs_field == scs_code) && ((val & SCG_SOSCCSR_SOSCEN_MASK) == 0U)) {
+        /* The system clock source cannot be disabled */
+        val |= SCG_SOSCCSR_SOSCEN_MASK;
+    }
+    val &= ~(SCG_SOSCCSR_SOSCVLD_MASK | SCG_SOSCCSR_SOSCSEL_MASK);
+    if (((val & SCG_SOSCCSR_SOSCEN_MASK) != 0U) && usable) {
+        val |= SCG_SOSCCSR_SOSCVLD_MASK;
+    }
+    SIM_REG32(scg, off) = val;
+    scg_update_sel();
+}
+
+/**
+ * @brief CSR takes the clock configuration of the current run mode.
+ */
+static void scg_apply_ccr(void)
+{
+    cyc_advance();
+    if (smc_runm == SMC_RUNM_HSRUN) {
+        SCG_R(CSR) = SCG_R(HCCR);
+    } else if (smc_runm == SMC_RUNM_VLPR) {
+        SCG_R(CSR) = SCG_R(VCCR);
+    } else {
+        SCG_R(CSR) = SCG_R(RCCR);
+    }
+    scg_update_sel();
+    sim_log("SCG: core clock %u Hz", sim_scg_core_hz());
+}
+
+static void scg_post(sim_region_t *r, uint32_t off, bool write, uint32_t old)
+{
+    if (!write) {
+        return;
+    }
+
+    switch (off) {
+    case offsetof(SCG_Type, CSR):
+        SIM_REG32(r, off) = old;
+        break;
+
+    case offsetof(SCG_Type, RCCR):
+        if (smc_runm == SMC_RUNM_RUN) {
+            scg_apply_ccr();
+        }
+        break;
+    case offsetof(SCG_Type, HCCR):
+        if (smc_runm == SMC_RUNM_HSRUN) {
+            scg_apply_ccr();
+        }
+        break;
+    case offsetof(SCG_Type, VCCR):
+        if (smc_runm == SMC_RUNM_VLPR) {
+            scg_apply_ccr();
+        }
+        break;
+
+    case offsetof(SCG_Type, SOSCCSR):
+        scg_source_write(off, old, 1U, true);
+        break;
+    case offsetof(SCG_Type, SIRCCSR):
+        scg_source_write(off, old, 2U, true);
+        break;
+    case offsetof(SCG_Type, FIRCCSR):
+        scg_source_write(off, old, 3U, true);
+        break;
+    case offsetof(SCG_Type, SPLLCSR):
+        scg_source_write(off, old, 6U, sosc_hz() != 0U);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                    GPIO                                     */
+/* -------------------------------------------------------------------------- */
+
+#define GPIO_R(port, reg)   SIM_REG32(gpio, (port) * GPIO_PORT_STRIDE + offsetof(GPIO_Type, reg))
+
+static void gpio_pre(sim_region_t *r, uint32_t off, bool write, uint32_t old)
+{
+    uint32_t port = off / GPIO_PORT_STRIDE;
+
+    (void)r;
+    (void)old;
+    if (!write && (port < GPIO_PORT_COUNT) &&
+        (off % GPIO_PORT_STRIDE == offsetof(GPIO_Type, PDIR))) {
+        uint32_t ddr = GPIO_R(port, PDDR);
+
+        GPIO_R(port, PDIR) = (GPIO_R(port, PDOR) & ddr) | (gpio_in[port] & ~ddr);
+    }
+}
+
+static void gpio_post(sim_region_t *r, uint32_t off, bool write, uint32_t old)
+{
+    uint32_t port = off / GPIO_PORT_STRIDE;
+    uint32_t reg  = off % GPIO_PORT_STRIDE;
+    uint32_t prev;
+    uint32_t val;
+    uint32_t pin;
+
+    (void)r;
+    if (!write || (port >= GPIO_PORT_COUNT)) {
+        return;
+    }
+
+    prev = GPIO_R(port, PDOR);
+    val  = SIM_REG32(gpio, off);
+    switch (reg) {
+    case offsetof(GPIO_Type, PDOR): prev = old;        break;
+    case offsetof(GPIO_Type, PSOR): GPIO_R(port, PDOR) = prev | val;  break;
+    case offsetof(GPIO_Type, PCOR): GPIO_R(port, PDOR) = prev & ~val; break;
+    case offsetof(GPIO_Type, PTOR): GPIO_R(port, PDOR) = prev ^ val;  break;
+    case offsetof(GPIO_Type, PDIR): SIM_REG32(gpio, off) = old;       return;
+    default:                                                          return;
+    }
+    if ((reg == offsetof(GPIO_Type, PSOR)) || (reg == offsetof(GPIO_Type, PCOR)) ||
+        (reg == offsetof(GPIO_Type, PTOR))) {
+        SIM_REG32(gpio, off) = 0U;          /* Write-only, reads 0 */
+    }
+
+    val = GPIO_R(port, PDOR) ^ prev;
+    for (pin = 0U; pin < 32U; pin++) {
+        if ((val & (1UL << pin)) != 0U) {
+            sim_log("GPIO: PT%c%u = %u", 'A' + (int)port, pin,
+                    (GPIO_R(port, PDOR) >> pin) & 1U);
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                     DWT                                     */
+/* -------------------------------------------------------------------------- */
+
+static void dwt_pre(sim_region_t *r, uint32_t off, bool write, uint32_t old)
+{
+    (void)old;
+    cyc_advance();
+    if ((off == DWT_CYCCNT) && !write) {
+        SIM_REG32(r, DWT_CYCCNT) = (uint32_t)cyc.cycles;
+    }
+}
+
+static void dwt_post(sim_region_t *r, uint32_t off, bool write, uint32_t old)
+{
+    (void)old;
+    if (write && (off == DWT_CYCCNT)) {
+        cyc.cycles = SIM_REG32(r, DWT_CYCCNT);
+        cyc.rem    = 0U;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                 SCS / NVIC                                  */
+/* -------------------------------------------------------------------------- */
+
+bool sim_nvic_enabled(uint32_t irqn)
+{
+    return (irqn < 256U) && ((nvic_en[irqn >> 5] & (1UL << (irqn & 0x1FU))) != 0U);
+}
+
+uint32_t sim_nvic_priority(uint32_t irqn)
+{
+    return (irqn < 240U) ? SIM_REG8(scs, SCS_IPR + irqn) : 0U;
+}
+
+uint32_t sim_vtor(void)
+{
+    return SIM_REG32(scs, SCS_VTOR);
+}
+
+static void scs_pre(sim_region_t *r, uint32_t off, bool write, uint32_t old)
+{
+    (void)old;
+    if (write) {
+        if (off == SCS_DEMCR) {
+            cyc_advance();
+        }
+        return;
+    }
+    if ((off >= SCS_ISER) && (off < SCS_ISPR)) {
+        SIM_REG32(r, off & ~3U) = nvic_en[((off - SCS_ISER) & 0x7FU) >> 2];
+    }
+}
+
+static void scs_post(sim_region_t *r, uint32_t off, bool write, uint32_t old)
+{
+    uint32_t val = SIM_REG32(r, off & ~3U);
+    uint32_t i;
+
+    if (!write) {
+        return;
+    }
+
+    if ((off >= SCS_ISER) && (off < SCS_ICER)) {
+        i = (off - SCS_ISER) >> 2;
+        if (i < 8U) {
+            nvic_en[i] |= val;
+            sim_kick();
+        }
+    } else if ((off >= SCS_ICER) && (off < SCS_ISPR)) {
+        i = (off - SCS_ICER) >> 2;
+        if (i < 8U) {
+            nvic_en[i] &= ~val;
+        }
+    } else if ((off >= SCS_ISPR) && (off < SCS_ICPR + 0x80U)) {
+        /* Lines are level sensitive, software pending is not simulated */
+        SIM_REG32(r, off & ~3U) = 0U;
+    } else if (off == SCS_CPUID) {
+        SIM_REG32(r, off) = old;
+    } else if (off == SCS_VTOR) {
+        sim_log("SCB: VTOR = 0x%08X", val);
+    } else if (off == SCS_AIRCR) {
+        if (((val >> 16) == AIRCR_VECTKEY) && ((val & AIRCR_SYSRESETREQ) != 0U)) {
+            sim_reset("SYSRESETREQ");
+        }
+        SIM_REG32(r, off) = old;
+    } else {
+        /* Plain register */
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                     SMC                                     */
+/* -------------------------------------------------------------------------- */
+
+#define SMC_R(reg)          SIM_REG32(smc, offsetof(SMC_Type, reg))
+
+/**
+ * @brief PMCTRL write: enter the requested run mode if it is allowed.
+ */
+static void smc_pmctrl_write(uint32_t old)
+{
+    uint32_t runm = (SMC_R(PMCTRL) & SMC_PMCTRL_RUNM_MASK) >> SMC_PMCTRL_RUNM_SHIFT;
+    uint32_t prot = SMC_R(PMPROT);
+    bool ok;
+
+    switch (runm) {
+    case SMC_RUNM_RUN:
+        ok = true;
+        break;
+    case SMC_RUNM_HSRUN:
+        ok = ((prot & SMC_PMPROT_AHSRUN_MASK) != 0U) && (smc_runm == SMC_RUNM_RUN);
+        break;
+    case SMC_RUNM_VLPR:
+        ok = ((prot & SMC_PMPROT_AVLP_MASK) != 0U) && (smc_runm == SMC_RUNM_RUN);
+        break;
+    default:
+        ok = false;
+        break;
+    }
+    if (!ok) {
+        sim_log("SMC: RUNM %u refused in mode %u", runm, smc_runm);
+        SMC_R(PMCTRL) = old;
+        return;
+    }
+    if (runm != smc_runm) {
+        smc_runm = runm;
+        SMC_R(PMSTAT) = (runm == SMC_RUNM_HSRUN) ? SMC_PMSTAT_HSRUN :
+                        (runm == SMC_RUNM_VLPR)  ? SMC_PMSTAT_VLPR  : SMC_PMSTAT_RUN;
+        sim_log("SMC: run mode %u", runm);
+        scg_apply_ccr();
+    }
+}
+
+static void smc_post(sim_region_t *r, uint32_t off, bool write, uint32_t old)
+{
+    if (!write) {
+        return;
+    }
+
+    switch (off) {
+    case offsetof(SMC_Type, PMPROT):
+        if (smc_pmprot_written) {
+            SIM_REG32(r, off) = old;
+        }
+        smc_pmprot_written = true;
+        break;
+    case offsetof(SMC_Type, PMCTRL):
+        smc_pmctrl_write(old);
+        break;
+    case offsetof(SMC_Type, PMSTAT):
+        SIM_REG32(r, off) = old;
+        break;
+    default:
+        break;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                    LMEM                                     */
+/* -------------------------------------------------------------------------- */
+
+static void lmem_post(sim_region_t *r, uint32_t off, bool write, uint32_t old)
+{
+    (void)old;
+    if (!write) {
+        return;
+    }
+    if (off == LMEM_PCCCR) {
+        SIM_REG32(r, LMEM_PCCCR) &= ~LMEM_GO;
+    } else if (off == LMEM_PCCSAR) {
+        SIM_REG32(r, LMEM_PCCSAR) &= ~LMEM_LGO;
+    } else {
+        /* Plain register */
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                 Public API                                  */
+/* -------------------------------------------------------------------------- */
+
+uint32_t sim_smc_runm(void)
+{
+    return smc_runm;
+}
+
+void sim_periph_init(void)
+{
+    uint32_t i;
+
+    scg  = sim_map_region("SCG",  IP_SCG_BASE,   SIM_PAGE_SIZE, NULL, scg_post);
+    smc  = sim_map_region("SMC",  IP_SMC_BASE,   SIM_PAGE_SIZE, NULL, smc_post);
+    pcc  = sim_map_region("PCC",  IP_PCC_BASE,   SIM_PAGE_SIZE, NULL, NULL);
+    (void)sim_map_region("PORT",  IP_PORTA_BASE, 5U * SIM_PAGE_SIZE, NULL, NULL);
+    gpio = sim_map_region("GPIO", IP_PTA_BASE,   SIM_PAGE_SIZE, gpio_pre, gpio_post);
+    dwt  = sim_map_region("DWT",  SIM_DWT_BASE,  SIM_PAGE_SIZE, dwt_pre, dwt_post);
+    scs  = sim_map_region("SCS",  SIM_SCS_BASE,  SIM_PAGE_SIZE, scs_pre, scs_post);
+    (void)sim_map_region("LMEM",  IP_LMEM_BASE,  SIM_PAGE_SIZE, NULL, lmem_post);
+    (void)sim_map_region("MSCM",  IP_MSCM_BASE,  SIM_PAGE_SIZE, NULL, NULL);
+
+    /* Reset state: FIRC 48 MHz is the system clock, SIRC 8 MHz running */
+    SCG_R(RCCR)    = SCG_RCCR_SCS(3) | SCG_RCCR_DIVSLOW(1);
+    SCG_R(CSR)     = SCG_R(RCCR);
+    SCG_R(SIRCCFG) = SCG_SIRCCFG_RANGE(1);
+    SCG_R(SIRCCSR) = SCG_SIRCCSR_SIRCEN_MASK | SCG_SIRCCSR_SIRCVLD_MASK;
+    SCG_R(FIRCCSR) = SCG_FIRCCSR_FIRCEN_MASK | SCG_FIRCCSR_FIRCVLD_MASK;
+    scg_update_sel();
+    SMC_R(PMSTAT)  = SMC_PMSTAT_RUN;
+
+    for (i = 0U; i < PCC_PCCn_COUNT; i++) {
+        SIM_REG32(pcc, i * 4U) = PCC_PCCn_PR_MASK;
+    }
+
+    for (i = 0U; i < GPIO_PORT_COUNT; i++) {
+        gpio_in[i] = 0xFFFFFFFFU;
+    }
+    if (sim_opt.button) {
+        gpio_in[BUTTON_PORT] &= ~(1UL << BUTTON_PIN);
+    }
+
+    SIM_REG32(dwt, DWT_CTRL)  = 0x40000000U;        /* NUMCOMP = 4 */
+    SIM_REG32(scs, SCS_CPUID) = 0x410FC241U;        /* Cortex-M4 r0p1 */
+    cyc.last_ns = sim_now_ns();
+}
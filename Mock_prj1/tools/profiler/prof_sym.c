@@ -0,0 +1,315 @@
+/**
+ * @file    prof_sym.c
+ * @brief   Host profiler - function symbols of a firmware image.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#define _GNU_SOURCE
+#include "prof_sym.h"
+
+#include <ctype.h>
+#include <elf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define MAP_LINE_MAX        (1024U)
+#define MAP_START           "Linker script and memory map"
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static int sym_add(prof_symtab_t *t, uint32_t addr, uint32_t size, const char *name, size_t name_len)
+{
+    prof_sym_t *syms;
+
+    if ((t->count & (t->count - 1U)) == 0U) {
+        /* Grow at 0, 1, 2, 4, ... entries */
+        syms = realloc(t->syms, ((t->count == 0U) ? 1U : (t->count * 2U)) * sizeof(*syms));
+        if (syms == NULL) {
+            return -1;
+        }
+        t->syms = syms;
+    }
+    t->syms[t->count].addr = addr & ~1U;
+    t->syms[t->count].size = size;
+    t->syms[t->count].name = strndup(name, name_len);
+    if (t->syms[t->count].name == NULL) {
+        return -1;
+    }
+    t->count++;
+    return 0;
+}
+
+static int sym_cmp(const void *a, const void *b)
+{
+    const prof_sym_t *x = a;
+    const prof_sym_t *y = b;
+
+    if (x->addr != y->addr) {
+        return (x->addr < y->addr) ? -1 : 1;
+    }
+    /* Sized symbol first: it is the one kept */
+    if (x->size != y->size) {
+        return (x->size > y->size) ? -1 : 1;
+    }
+    return strcmp(x->name, y->name);
+}
+
+/**
+ * @brief Sort by address and keep one symbol per address.
+ */
+static void sym_finish(prof_symtab_t *t)
+{
+    size_t out = 0U;
+    size_t i;
+
+    if (t->count == 0U) {
+        return;
+    }
+    qsort(t->syms, t->count, sizeof(t->syms[0]), sym_cmp);
+    for (i = 1U; i < t->count; i++) {
+        if (t->syms[i].addr == t->syms[out].addr) {
+            free(t->syms[i].name);
+        } else {
+            t->syms[++out] = t->syms[i];
+        }
+    }
+    t->count = out + 1U;
+}
+
+static int is_identifier(const char *s, size_t len)
+{
+    size_t i;
+
+    if ((len == 0U) || (isdigit((unsigned char)s[0]) != 0)) {
+        return 0;
+    }
+    for (i = 0U; i < len; i++) {
+        if ((isalnum((unsigned char)s[i]) == 0) && (s[i] != '_')) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Split a map line into at most @p max blank-separated tokens.
+ */
+static size_t tokenize(char *line, char **tok, size_t max)
+{
+    size_t n = 0U;
+    char *save = NULL;
+    char *p;
+
+    for (p = strtok_r(line, " \t\r\n", &save); (p != NULL) && (n < max); p = strtok_r(NULL, " \t\r\n", &save)) {
+        tok[n++] = p;
+    }
+    return n;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+int ProfSym_LoadElf(prof_symtab_t *t, const char *path)
+{
+    const Elf32_Ehdr *eh;
+    const Elf32_Shdr *sh;
+    const Elf32_Shdr *str;
+    const Elf32_Sym *sym;
+    uint8_t *buf = NULL;
+    size_t size = 0U;
+    size_t i;
+    size_t n;
+    FILE *f;
+    long len;
+
+    memset(t, 0, sizeof(*t));
+    f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    if ((fseek(f, 0, SEEK_END) == 0) && ((len = ftell(f)) > 0) && (fseek(f, 0, SEEK_SET) == 0)) {
+        size = (size_t)len;
+        buf = malloc(size);
+    }
+    if ((buf == NULL) || (fread(buf, 1U, size, f) != size)) {
+        fprintf(stderr, "%s: read error\n", path);
+        free(buf);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+
+    /* ARM images are ELF32 little-endian, like the host */
+    eh = (const Elf32_Ehdr *)buf;
+    if ((size < sizeof(*eh)) || (memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0) ||
+        (eh->e_ident[EI_CLASS] != ELFCLASS32) || (eh->e_ident[EI_DATA] != ELFDATA2LSB) ||
+        (eh->e_shentsize != sizeof(Elf32_Shdr)) ||
+        (((size_t)eh->e_shoff + ((size_t)eh->e_shnum * sizeof(Elf32_Shdr))) > size)) {
+        fprintf(stderr, "%s: not a little-endian ELF32 file\n", path);
+        free(buf);
+        return -1;
+    }
+
+    sh = (const Elf32_Shdr *)&buf[eh->e_shoff];
+    for (i = 0U; i < eh->e_shnum; i++) {
+        if ((sh[i].sh_type != SHT_SYMTAB) || (sh[i].sh_link >= eh->e_shnum)) {
+            continue;
+        }
+        str = &sh[sh[i].sh_link];
+        if ((((size_t)sh[i].sh_offset + sh[i].sh_size) > size) ||
+            (((size_t)str->sh_offset + str->sh_size) > size)) {
+            break;
+        }
+        sym = (const Elf32_Sym *)&buf[sh[i].sh_offset];
+        for (n = 0U; n < (sh[i].sh_size / sizeof(Elf32_Sym)); n++) {
+            if ((ELF32_ST_TYPE(sym[n].st_info) != STT_FUNC) || (sym[n].st_shndx == SHN_UNDEF) ||
+                (sym[n].st_name == 0U) || (sym[n].st_name >= str->sh_size)) {
+                continue;
+            }
+            if (sym_add(t, sym[n].st_value, sym[n].st_size,
+                        (const char *)&buf[str->sh_offset + sym[n].st_name],
+                        strnlen((const char *)&buf[str->sh_offset + sym[n].st_name],
+                                str->sh_size - sym[n].st_name)) != 0) {
+                fprintf(stderr, "out of memory\n");
+                free(buf);
+                ProfSym_Free(t);
+                return -1;
+            }
+        }
+        break;
+    }
+    free(buf);
+
+    if (t->count == 0U) {
+        fprintf(stderr, "%s: no function symbols (stripped?)\n", path);
+        return -1;
+    }
+    sym_finish(t);
+    return 0;
+}
+
+int ProfSym_LoadMap(prof_symtab_t *t, const char *path)
+{
+    char line[MAP_LINE_MAX];
+    char next[MAP_LINE_MAX];
+    char *tok[4];
+    char name[MAP_LINE_MAX];
+    int started = 0;
+    int in_text = 0;
+    size_t n;
+    FILE *f;
+
+    memset(t, 0, sizeof(*t));
+    f = fopen(path, "r");
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (started == 0) {
+            started = (strncmp(line, MAP_START, sizeof(MAP_START) - 1U) == 0);
+            continue;
+        }
+
+        if (line[0] == '.') {
+            /* Output section: functions are in .text */
+            n = tokenize(line, tok, 1U);
+            in_text = (n == 1U) && (strcmp(tok[0], ".text") == 0);
+            continue;
+        }
+        if (in_text == 0) {
+            continue;
+        }
+
+        if ((line[0] == ' ') && (strncmp(&line[1], ".text.", 6U) == 0)) {
+            /* " .text.<name> addr size file", long names wrap after the name */
+            n = tokenize(line, tok, 3U);
+            snprintf(name, sizeof(name), "%s", &tok[0][6]);
+            if (n < 3U) {
+                if (fgets(next, sizeof(next), f) == NULL) {
+                    break;
+                }
+                n = 1U + tokenize(next, &tok[1], 2U);
+            }
+            if ((n == 3U) && (strtoul(tok[2], NULL, 16) != 0UL) &&
+                (sym_add(t, (uint32_t)strtoul(tok[1], NULL, 16), (uint32_t)strtoul(tok[2], NULL, 16),
+                         name, strlen(name)) != 0)) {
+                goto oom;
+            }
+            continue;
+        }
+
+        /* "                0x<addr>                <symbol>" */
+        n = tokenize(line, tok, 3U);
+        if ((n == 2U) && (strncmp(tok[0], "0x", 2U) == 0) && (is_identifier(tok[1], strlen(tok[1])) != 0) &&
+            (sym_add(t, (uint32_t)strtoul(tok[0], NULL, 16), 0U, tok[1], strlen(tok[1])) != 0)) {
+            goto oom;
+        }
+    }
+    fclose(f);
+
+    if (t->count == 0U) {
+        fprintf(stderr, "%s: no .text symbols (not a GNU ld map?)\n", path);
+        return -1;
+    }
+    sym_finish(t);
+    return 0;
+
+oom:
+    fprintf(stderr, "out of memory\n");
+    fclose(f);
+    ProfSym_Free(t);
+    return -1;
+}
+
+const prof_sym_t *ProfSym_Find(const prof_symtab_t *t, uint32_t addr)
+{
+    size_t lo = 0U;
+    size_t hi = t->count;
+    size_t mid;
+    const prof_sym_t *s;
+
+    /* Last symbol at or below addr */
+    while (lo < hi) {
+        mid = lo + ((hi - lo) / 2U);
+        if (t->syms[mid].addr <= addr) {
+            lo = mid + 1U;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0U) {
+        return NULL;
+    }
+    s = &t->syms[lo - 1U];
+    if ((s->size != 0U) && ((addr - s->addr) >= s->size)) {
+        return NULL;
+    }
+    return s;
+}
+
+void ProfSym_Free(prof_symtab_t *t)
+{
+    size_t i;
+
+    for (i = 0U; i < t->count; i++) {
+        free(t->syms[i].name);
+    }
+    free(t->syms);
+    t->syms  = NULL;
+    t->count = 0U;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file    prof_sym.h
+ * @brief   Host profiler - function symbols of a firmware image.
+ *
+ *   ProfSym_LoadElf()   FUNC symbols of the ELF32 .symtab (static ones
+ *                       included), with their sizes
+ *   ProfSym_LoadMap()   GNU ld .map: input sections .text.<name> (with
+ *                       -ffunction-sections) and global symbol lines; a
+ *                       symbol without size ends at the next one
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#ifndef PROF_SYM_H_
+#define PROF_SYM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief One function.
+ */
+typedef struct {
+    uint32_t addr;              /**< Start, Thumb bit cleared              */
+    uint32_t size;              /**< Bytes, 0 = up to the next symbol      */
+    char    *name;
+} prof_sym_t;
+
+/**
+ * @brief Symbols sorted by address, one per address.
+ */
+typedef struct {
+    prof_sym_t *syms;
+    size_t      count;
+} prof_symtab_t;
+
+/**
+ * @brief Load the symbols of an ELF file.
+ * @return 0 on success, -1 on error (message printed).
+ */
+int ProfSym_LoadElf(prof_symtab_t *t, const char *path);
+
+/**
+ * @brief Load the symbols of a GNU ld map file.
+ * @return 0 on success, -1 on error (message printed).
+ */
+int ProfSym_LoadMap(prof_symtab_t *t, const char *path);
+
+/**
+ * @brief Function containing an address.
+ * @return Symbol, or NULL if the address is in no function.
+ */
+const prof_sym_t *ProfSym_Find(const prof_symtab_t *t, uint32_t addr);
+
+/**
+ * @brief Release a symbol table.
+ */
+void ProfSym_Free(prof_symtab_t *t);
+
+#endif /* PROF_SYM_H_ */
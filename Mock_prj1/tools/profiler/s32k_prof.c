@@ -0,0 +1,410 @@
+/**
+ * @file    s32k_prof.c
+ * @brief   Host profiler - reads the PC histogram of the SysTick profiler
+ *          (src/include/boot_prof.h) and symbolizes it.
+ *
+ * The histogram is read from the bootloader with the PROF command (-d), or
+ * from a file saved earlier (-i). Bucket addresses are resolved against the
+ * .elf (-e) or .map (-m) of the build that produced it, normally
+ * Debug_FLASH/Mock_prj1.elf.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#define _GNU_SOURCE
+#include "prof_sym.h"
+#include "flash_link.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+/* Frame layout of BootProf_Dump() */
+#define PROF_MAGIC          (0x464F5250UL)  /* "PROF" */
+#define PROF_VERSION        (1U)
+#define PROF_HDR_WORDS      (9U)
+#define PROF_ENTRY_BYTES    (4U)
+#define PROF_ENTRIES_MAX    (65536U)
+
+#define DEFAULT_BAUD        (9600U)
+#define DEFAULT_TOP         (20U)
+#define SYNC_TIMEOUT_MS     (3000U)
+
+/* -------------------------------------------------------------------------- */
+/*                              Type Definitions                               */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    uint32_t  shift;
+    uint32_t  base;
+    uint32_t  rate_hz;
+    uint32_t  samples;
+    uint32_t  ram;
+    uint32_t  other;
+    uint32_t  saturated;
+    uint32_t  n;
+    uint8_t  *raw;              /**< Whole frame, as received              */
+    size_t    raw_len;
+} prof_dump_t;
+
+typedef struct {
+    uint32_t key;               /**< Symbol index or bucket index          */
+    uint32_t count;
+} prof_row_t;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get_le16(const uint8_t *p)
+{
+    return (uint16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint16_t entry_bucket(const prof_dump_t *d, uint32_t i)
+{
+    return get_le16(&d->raw[(PROF_HDR_WORDS * 4U) + (i * PROF_ENTRY_BYTES)]);
+}
+
+static uint16_t entry_count(const prof_dump_t *d, uint32_t i)
+{
+    return get_le16(&d->raw[(PROF_HDR_WORDS * 4U) + (i * PROF_ENTRY_BYTES) + 2U]);
+}
+
+/**
+ * @brief Check the header in d->raw and fill the fields.
+ * @return Frame length, 0 if the header is invalid.
+ */
+static size_t parse_header(prof_dump_t *d)
+{
+    const uint8_t *h = d->raw;
+
+    if ((get_le32(&h[0]) != PROF_MAGIC) || (h[4] != PROF_VERSION)) {
+        return 0U;
+    }
+    d->shift     = h[5];
+    d->base      = get_le32(&h[8]);
+    d->rate_hz   = get_le32(&h[12]);
+    d->samples   = get_le32(&h[16]);
+    d->ram       = get_le32(&h[20]);
+    d->other     = get_le32(&h[24]);
+    d->saturated = get_le32(&h[28]);
+    d->n         = get_le32(&h[32]);
+    if ((d->shift > 31U) || (d->n > PROF_ENTRIES_MAX)) {
+        return 0U;
+    }
+    return (PROF_HDR_WORDS * 4U) + ((size_t)d->n * PROF_ENTRY_BYTES);
+}
+
+static int load_file(prof_dump_t *d, const char *path)
+{
+    uint8_t hdr[PROF_HDR_WORDS * 4U];
+    size_t len;
+    FILE *f;
+
+    f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    d->raw = hdr;
+    if ((fread(hdr, 1U, sizeof(hdr), f) != sizeof(hdr)) || ((len = parse_header(d)) == 0U)) {
+        fprintf(stderr, "%s: not a PROF dump\n", path);
+        fclose(f);
+        d->raw = NULL;
+        return -1;
+    }
+    d->raw = malloc(len);
+    if (d->raw == NULL) {
+        fclose(f);
+        return -1;
+    }
+    memcpy(d->raw, hdr, sizeof(hdr));
+    if (fread(&d->raw[sizeof(hdr)], 1U, len - sizeof(hdr), f) != (len - sizeof(hdr))) {
+        fprintf(stderr, "%s: truncated (%u entries expected)\n", path, d->n);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    d->raw_len = len;
+    return 0;
+}
+
+/**
+ * @brief Send PROF (or "PROF <hz>" when @p restart is set) to the bootloader
+ *        and receive the frame.
+ */
+static int load_device(prof_dump_t *d, const char *dev, uint32_t baud, const char *restart)
+{
+    uint8_t hdr[PROF_HDR_WORDS * 4U];
+    char cmd[32];
+    flash_link_t link;
+    uint32_t timeout_ms;
+    size_t len;
+    int got = 0;
+
+    if (FlashLink_Open(&link, dev, baud, 1) != 0) {
+        perror(dev);
+        return -1;
+    }
+    FlashLink_Flush(&link);
+    snprintf(cmd, sizeof(cmd), "PROF%s%s\n", (restart != NULL) ? " " : "", (restart != NULL) ? restart : "");
+    if (FlashLink_Write(&link, cmd, strlen(cmd)) != 0) {
+        perror(dev);
+        FlashLink_Close(&link);
+        return -1;
+    }
+    if (restart != NULL) {
+        FlashLink_Drain(&link);
+        FlashLink_Close(&link);
+        return 0;
+    }
+
+    /* Skip text until the magic, then read the header and the entries */
+    memset(hdr, 0, sizeof(hdr));
+    while (get_le32(hdr) != PROF_MAGIC) {
+        memmove(hdr, &hdr[1], 3U);
+        if (FlashLink_Read(&link, &hdr[3], 1U, SYNC_TIMEOUT_MS) != 1) {
+            fprintf(stderr, "%s: no PROF frame (profiler not built, BOOT_PROF_ENABLE=0?)\n", dev);
+            FlashLink_Close(&link);
+            return -1;
+        }
+    }
+    if (FlashLink_Read(&link, &hdr[4], sizeof(hdr) - 4U, SYNC_TIMEOUT_MS) == (int)(sizeof(hdr) - 4U)) {
+        d->raw = hdr;
+        len = parse_header(d);
+        d->raw = NULL;
+        if (len != 0U) {
+            d->raw = malloc(len);
+        }
+        if (d->raw != NULL) {
+            memcpy(d->raw, hdr, sizeof(hdr));
+            /* 10 bits per byte, plus one second of slack */
+            timeout_ms = 1000U + (uint32_t)(((uint64_t)(len - sizeof(hdr)) * 10000U) / baud);
+            got = (FlashLink_Read(&link, &d->raw[sizeof(hdr)], len - sizeof(hdr), timeout_ms) ==
+                   (int)(len - sizeof(hdr)));
+        }
+    }
+    FlashLink_Close(&link);
+    if (got == 0) {
+        fprintf(stderr, "%s: PROF frame incomplete\n", dev);
+        return -1;
+    }
+    d->raw_len = len;
+    return 0;
+}
+
+static int row_cmp(const void *a, const void *b)
+{
+    const prof_row_t *x = a;
+    const prof_row_t *y = b;
+
+    if (x->count != y->count) {
+        return (x->count > y->count) ? -1 : 1;
+    }
+    return (x->key < y->key) ? -1 : (x->key > y->key);
+}
+
+static double pct(uint32_t count, uint32_t total)
+{
+    return (total != 0U) ? ((100.0 * count) / total) : 0.0;
+}
+
+/**
+ * @brief Samples per function, highest first.
+ */
+static void print_functions(const prof_dump_t *d, const prof_symtab_t *t, uint32_t top)
+{
+    prof_row_t *rows = calloc(t->count + 1U, sizeof(*rows));
+    const prof_sym_t *s;
+    uint32_t addr;
+    uint32_t i;
+
+    if (rows == NULL) {
+        return;
+    }
+    for (i = 0U; i <= t->count; i++) {
+        rows[i].key = i;
+    }
+    for (i = 0U; i < d->n; i++) {
+        addr = d->base + ((uint32_t)entry_bucket(d, i) << d->shift);
+        s = ProfSym_Find(t, addr);
+        rows[(s != NULL) ? (size_t)(s - t->syms) : t->count].count += entry_count(d, i);
+    }
+    qsort(rows, t->count + 1U, sizeof(*rows), row_cmp);
+
+    printf("\n  samples       %%  function\n");
+    for (i = 0U; (i < top) && (i <= t->count) && (rows[i].count != 0U); i++) {
+        printf("  %7u  %5.1f%%  %s\n", rows[i].count, pct(rows[i].count, d->samples),
+               (rows[i].key < t->count) ? t->syms[rows[i].key].name : "(no symbol)");
+    }
+    free(rows);
+}
+
+/**
+ * @brief Hottest buckets, as function+offset when symbols are loaded.
+ */
+static void print_buckets(const prof_dump_t *d, const prof_symtab_t *t, uint32_t top)
+{
+    prof_row_t *rows = calloc((d->n != 0U) ? d->n : 1U, sizeof(*rows));
+    const prof_sym_t *s;
+    uint32_t addr;
+    uint32_t i;
+
+    if (rows == NULL) {
+        return;
+    }
+    for (i = 0U; i < d->n; i++) {
+        rows[i].key   = entry_bucket(d, i);
+        rows[i].count = entry_count(d, i);
+    }
+    qsort(rows, d->n, sizeof(*rows), row_cmp);
+
+    printf("\n  samples       %%  address\n");
+    for (i = 0U; (i < top) && (i < d->n); i++) {
+        addr = d->base + (rows[i].key << d->shift);
+        s = (t != NULL) ? ProfSym_Find(t, addr) : NULL;
+        printf("  %7u  %5.1f%%  0x%08X", rows[i].count, pct(rows[i].count, d->samples), addr);
+        if (s != NULL) {
+            printf("  %s+0x%X", s->name, addr - s->addr);
+        }
+        printf("\n");
+    }
+    free(rows);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  -d, --device PATH    read the histogram from the bootloader (PROF command)\n"
+        "  -b, --baud N         baud rate (default %u)\n"
+        "  -r, --restart HZ     clear the histogram and sample at HZ (0 stops), then exit\n"
+        "  -i, --input FILE     read a histogram saved with -o instead\n"
+        "  -o, --output FILE    save the received histogram\n"
+        "  -e, --elf FILE       symbols from the image (Debug_FLASH/Mock_prj1.elf)\n"
+        "  -m, --map FILE       symbols from the linker map, when there is no .elf\n"
+        "  -n, --top N          rows to print (default %u)\n"
+        "  -a, --addresses      also list the hottest addresses\n",
+        prog, DEFAULT_BAUD, DEFAULT_TOP);
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                   Main                                      */
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    static const struct option longopts[] = {
+        { "device",    required_argument, NULL, 'd' },
+        { "baud",      required_argument, NULL, 'b' },
+        { "restart",   required_argument, NULL, 'r' },
+        { "input",     required_argument, NULL, 'i' },
+        { "output",    required_argument, NULL, 'o' },
+        { "elf",       required_argument, NULL, 'e' },
+        { "map",       required_argument, NULL, 'm' },
+        { "top",       required_argument, NULL, 'n' },
+        { "addresses", no_argument,       NULL, 'a' },
+        { "help",      no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    const char *device = NULL;
+    const char *input = NULL;
+    const char *output = NULL;
+    const char *elf = NULL;
+    const char *map = NULL;
+    const char *restart = NULL;
+    uint32_t baud = DEFAULT_BAUD;
+    uint32_t top = DEFAULT_TOP;
+    int addresses = 0;
+    prof_symtab_t syms = { NULL, 0U };
+    prof_dump_t d;
+    uint32_t hist = 0U;
+    uint32_t i;
+    FILE *f;
+    int c;
+
+    while ((c = getopt_long(argc, argv, "d:b:r:i:o:e:m:n:ah", longopts, NULL)) != -1) {
+        switch (c) {
+        case 'd': device  = optarg; break;
+        case 'b': baud    = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'r': restart = optarg; break;
+        case 'i': input   = optarg; break;
+        case 'o': output  = optarg; break;
+        case 'e': elf     = optarg; break;
+        case 'm': map     = optarg; break;
+        case 'n': top     = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'a': addresses = 1; break;
+        default:
+            usage(argv[0]);
+            return (c == 'h') ? 0 : 2;
+        }
+    }
+    if (((device == NULL) == (input == NULL)) || (optind != argc) || (baud == 0U) ||
+        ((restart != NULL) && (device == NULL))) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    memset(&d, 0, sizeof(d));
+    if (input != NULL) {
+        if (load_file(&d, input) != 0) {
+            return 1;
+        }
+    } else {
+        if (load_device(&d, device, baud, restart) != 0) {
+            return 1;
+        }
+        if (restart != NULL) {
+            printf("%s: sampling restarted at %s Hz\n", device, restart);
+            return 0;
+        }
+    }
+
+    if (output != NULL) {
+        f = fopen(output, "wb");
+        if ((f == NULL) || (fwrite(d.raw, 1U, d.raw_len, f) != d.raw_len) || (fclose(f) != 0)) {
+            perror(output);
+            return 1;
+        }
+    }
+
+    if ((elf != NULL) && (ProfSym_LoadElf(&syms, elf) != 0)) {
+        return 1;
+    }
+    if ((elf == NULL) && (map != NULL) && (ProfSym_LoadMap(&syms, map) != 0)) {
+        return 1;
+    }
+
+    for (i = 0U; i < d.n; i++) {
+        hist += entry_count(&d, i);
+    }
+    printf("%u samples at %u Hz (%s), %u-byte buckets from 0x%08X\n",
+           d.samples, d.rate_hz, (d.rate_hz != 0U) ? "running" : "stopped", 1U << d.shift, d.base);
+    printf("  code %u (%.1f%%), SRAM %u (%.1f%%), other %u, saturated %u\n",
+           hist, pct(hist, d.samples), d.ram, pct(d.ram, d.samples), d.other, d.saturated);
+
+    if (syms.count != 0U) {
+        print_functions(&d, &syms, top);
+    }
+    if ((addresses != 0) || (syms.count == 0U)) {
+        print_buckets(&d, (syms.count != 0U) ? &syms : NULL, top);
+    }
+
+    ProfSym_Free(&syms);
+    free(d.raw);
+    return 0;
+}
@@ -0,0 +1,408 @@
+/**
+ * @file    an386_port.c
+ * @brief   S32K144 bootloader on QEMU mps2-an386 - register files, FTFC and
+ *          instruction counter.
+ *
+ * The P-Flash array lives in the code SSRAM of the board at the S32K144
+ * addresses (APP_FLASH_START..512 KB), so the bootloader validates and reads
+ * the application exactly as on the EVB. Every program/erase command is
+ * written through to a 512 KB image file on the host with semihosting, in
+ * the same format as the flash image of tools/host_sim.
+ *
+ * Semihosting command line (QEMU -semihosting-config arg=...):
+ *   flash=FILE    flash image (default an386_flash.bin, created erased)
+ *   button=0|1    BOOT button held at reset (default 1: bootloader mode)
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "an386_s32k.h"
+#include "cmsis_gcc.h"
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+/* ARM semihosting operations */
+#define SH_SYS_OPEN             (0x01)
+#define SH_SYS_WRITE0           (0x04)
+#define SH_SYS_WRITE            (0x05)
+#define SH_SYS_READ             (0x06)
+#define SH_SYS_SEEK             (0x0A)
+#define SH_SYS_GET_CMDLINE      (0x15)
+#define SH_SYS_EXIT_EXTENDED    (0x20)
+
+#define SH_MODE_RB_PLUS         (3)         /**< "r+b" */
+#define SH_MODE_WB_PLUS         (7)         /**< "w+b" */
+#define SH_EXIT_APPLICATION     (0x20026UL) /**< ADP_Stopped_ApplicationExit */
+
+#define CMDLINE_MAX             (128U)
+
+/* FTFC commands (FLASH.h) */
+#define FTFC_CMD_PROGRAM_PHRASE (0x07U)
+#define FTFC_CMD_ERASE_SECTOR   (0x09U)
+
+/* SysTick, free running over 24 bits on SYSCLK */
+#define SYSTICK_CSR_ENABLE      (1UL << 0)
+#define SYSTICK_CSR_TICKINT     (1UL << 1)
+#define SYSTICK_CSR_CLKSOURCE   (1UL << 2)
+#define SYSTICK_CSR_COUNTFLAG   (1UL << 16)
+#define SYSTICK_RELOAD          (0x00FFFFFFUL)
+#define SYSTICK_BITS            (24U)
+
+/* SCG */
+#define SCG_XCSR_EN             (1UL << 0)
+#define SCG_CSR_RESET           (SCG_CSR_SCS(3) | SCG_CSR_DIVSLOW(1))
+
+/* SMC run modes (PMCTRL[RUNM]) and their PMSTAT values */
+#define SMC_RUNM_VLPR           (2U)
+#define SMC_RUNM_HSRUN          (3U)
+#define SMC_PMSTAT_RUN          (0x01U)
+#define SMC_PMSTAT_VLPR         (0x04U)
+#define SMC_PMSTAT_HSRUN        (0x80U)
+
+/**
+\brief Access structure of the SysTick timer.
+*/
+typedef struct {
+  volatile uint32_t CSR;                   /* Offset: 0x000 (R/W) Control and Status Register */
+  volatile uint32_t RVR;                   /* Offset: 0x004 (R/W) Reload Value Register */
+  volatile uint32_t CVR;                   /* Offset: 0x008 (R/W) Current Value Register */
+} AN386_SysTick_Type;
+
+#define AN386_SYSTICK           ((AN386_SysTick_Type *)0xE000E010UL)
+
+/** @brief Hardware side write of a read-only (__I) register. */
+#define HW_WRITE32(reg, val)    (*(volatile uint32_t *)(uint32_t)&(reg) = (uint32_t)(val))
+#define HW_WRITE8(reg, val)     (*(volatile uint8_t *)(uint32_t)&(reg) = (uint8_t)(val))
+
+/* -------------------------------------------------------------------------- */
+/*                              Public Variables                               */
+/* -------------------------------------------------------------------------- */
+
+SCG_Type    an386_scg;
+PCC_Type    an386_pcc;
+PORT_Type   an386_port[PORT_INSTANCE_COUNT];
+GPIO_Type   an386_gpio[GPIO_INSTANCE_COUNT];
+FTFC_Type   an386_ftfc;
+LPUART_Type an386_lpuart[LPUART_INSTANCE_COUNT];
+LMEM_Type   an386_lmem;
+MSCM_Type   an386_mscm;
+SMC_Type    an386_smc;
+uint32_t    an386_dwt[2];
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+/** @brief First programmable address (end of the bootloader, linker file). */
+extern uint8_t __an386_flash_start[];
+
+static int      flash_fd = -1;
+static uint32_t systick_wraps;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static int semihost(int op, const void *arg)
+{
+    register int         r0 __asm__("r0") = op;
+    register const void *r1 __asm__("r1") = arg;
+
+    __asm__ volatile ("bkpt 0xAB" : "+r"(r0) : "r"(r1) : "memory");
+    return r0;
+}
+
+static int sh_open(const char *path, int mode)
+{
+    const uint32_t arg[3] = { (uint32_t)path, (uint32_t)mode, (uint32_t)strlen(path) };
+
+    return semihost(SH_SYS_OPEN, arg);
+}
+
+static int sh_seek(int fd, uint32_t pos)
+{
+    const uint32_t arg[2] = { (uint32_t)fd, pos };
+
+    return semihost(SH_SYS_SEEK, arg);
+}
+
+/** @return Number of bytes NOT written. */
+static int sh_write(int fd, const void *data, uint32_t len)
+{
+    const uint32_t arg[3] = { (uint32_t)fd, (uint32_t)data, len };
+
+    return semihost(SH_SYS_WRITE, arg);
+}
+
+/** @return Number of bytes NOT read. */
+static int sh_read(int fd, void *data, uint32_t len)
+{
+    const uint32_t arg[3] = { (uint32_t)fd, (uint32_t)data, len };
+
+    return semihost(SH_SYS_READ, arg);
+}
+
+static void flash_write_through(uint32_t addr, uint32_t len)
+{
+    if (flash_fd < 0) {
+        return;
+    }
+    if ((sh_seek(flash_fd, addr) != 0) || (sh_write(flash_fd, (const void *)addr, len) != 0)) {
+        An386_Print("[AN386] flash image write failed\n");
+    }
+}
+
+/**
+ * @brief Open the image; load the application region or create it erased.
+ */
+static void flash_open(const char *path)
+{
+    uint32_t first = (uint32_t)__an386_flash_start;
+    uint32_t addr;
+
+    flash_fd = sh_open(path, SH_MODE_RB_PLUS);
+    if ((flash_fd >= 0) && (sh_seek(flash_fd, first) == 0) &&
+        (sh_read(flash_fd, (void *)first, AN386_FLASH_SIZE - first) == 0)) {
+        return;
+    }
+
+    /* New or short image: erased array, bootloader region included */
+    flash_fd = sh_open(path, SH_MODE_WB_PLUS);
+    memset((void *)first, 0xFF, AN386_FLASH_SIZE - first);
+    if (flash_fd < 0) {
+        An386_Print("[AN386] cannot open the flash image, flash is volatile\n");
+        return;
+    }
+    for (addr = 0U; addr < first; addr += AN386_FLASH_SECTOR_SIZE) {
+        /* The bootloader sectors hold the running code: write erased bytes */
+        (void)sh_seek(flash_fd, addr);
+        (void)sh_write(flash_fd, (const void *)(AN386_FLASH_SIZE - AN386_FLASH_SECTOR_SIZE),
+                       AN386_FLASH_SECTOR_SIZE);
+    }
+    flash_write_through(first, AN386_FLASH_SIZE - first);
+}
+
+/**
+ * @brief Split the semihosting command line into flash= and button= options.
+ */
+static void parse_cmdline(char *cmdline, const char **flash, uint32_t *button)
+{
+    char *tok = cmdline;
+    char *end;
+
+    while (*tok != '\0') {
+        while (*tok == ' ') {
+            tok++;
+        }
+        end = tok;
+        while ((*end != ' ') && (*end != '\0')) {
+            end++;
+        }
+        if (*end != '\0') {
+            *end++ = '\0';
+        }
+        if (strncmp(tok, "flash=", 6U) == 0) {
+            *flash = tok + 6;
+        } else if (strncmp(tok, "button=", 7U) == 0) {
+            *button = (tok[7] != '0') ? 1U : 0U;
+        } else {
+            /* Program name or unknown option */
+        }
+        tok = end;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                 Public API                                  */
+/* -------------------------------------------------------------------------- */
+
+void An386_Init(void)
+{
+    static char cmdline[CMDLINE_MAX];
+    uint32_t arg[2] = { (uint32_t)cmdline, sizeof(cmdline) - 1U };
+    const char *flash = "an386_flash.bin";
+    uint32_t button = 1U;
+    uint32_t i;
+
+    /* Reset values of the registers read by the firmware */
+    for (i = 0U; i < PCC_PCCn_COUNT; i++) {
+        an386_pcc.PCCn[i] = PCC_PCCn_PR_MASK;
+    }
+    an386_scg.RCCR    = SCG_CSR_RESET;
+    HW_WRITE32(an386_scg.CSR, SCG_CSR_RESET);
+    an386_scg.SIRCCSR = SCG_XCSR_EN;
+    an386_scg.FIRCCSR = SCG_XCSR_EN;
+    an386_ftfc.FSTAT  = FTFC_FSTAT_CCIF_MASK;
+    HW_WRITE32(an386_smc.PMSTAT, SMC_PMSTAT_RUN);
+    HW_WRITE8(an386_ftfc.FSEC, 0xFEU);
+    for (i = 0U; i < LPUART_INSTANCE_COUNT; i++) {
+        an386_lpuart[i].STAT = LPUART_STAT_TDRE_MASK | LPUART_STAT_TC_MASK;
+    }
+
+    if (semihost(SH_SYS_GET_CMDLINE, arg) == 0) {
+        parse_cmdline(cmdline, &flash, &button);
+    }
+    /* PTC13: pulled up, low while the button is held */
+    HW_WRITE32(an386_gpio[2].PDIR, (button != 0U) ? 0U : (1UL << 13));
+
+    flash_open(flash);
+    An386_Print((button != 0U) ? "[AN386] BOOT button held, flash image " :
+                                 "[AN386] BOOT button released, flash image ");
+    An386_Print(flash);
+    An386_Print("\n");
+
+    /* Instruction counter */
+    AN386_SYSTICK->RVR = SYSTICK_RELOAD;
+    AN386_SYSTICK->CVR = 0U;
+    AN386_SYSTICK->CSR = SYSTICK_CSR_CLKSOURCE | SYSTICK_CSR_TICKINT | SYSTICK_CSR_ENABLE;
+    systick_wraps = 0U;
+}
+
+SCG_Type *An386_ScgSync(void)
+{
+    SCG_Type *scg = &an386_scg;
+
+    /* Sources are valid as soon as they are enabled, the PLL needs SOSC */
+    scg->SIRCCSR = (scg->SIRCCSR & SCG_XCSR_EN) ? (scg->SIRCCSR | SCG_SIRCCSR_SIRCVLD_MASK)
+                                                : (scg->SIRCCSR & ~SCG_SIRCCSR_SIRCVLD_MASK);
+    scg->FIRCCSR = (scg->FIRCCSR & SCG_XCSR_EN) ? (scg->FIRCCSR | SCG_FIRCCSR_FIRCVLD_MASK)
+                                                : (scg->FIRCCSR & ~SCG_FIRCCSR_FIRCVLD_MASK);
+    scg->SOSCCSR = (scg->SOSCCSR & SCG_XCSR_EN) ? (scg->SOSCCSR | SCG_SOSCCSR_SOSCVLD_MASK)
+                                                : (scg->SOSCCSR & ~SCG_SOSCCSR_SOSCVLD_MASK);
+    scg->SPLLCSR = ((scg->SPLLCSR & SCG_XCSR_EN) && (scg->SOSCCSR & SCG_SOSCCSR_SOSCVLD_MASK))
+                 ? (scg->SPLLCSR | SCG_SPLLCSR_SPLLVLD_MASK)
+                 : (scg->SPLLCSR & ~SCG_SPLLCSR_SPLLVLD_MASK);
+
+    /* The system clock switch completes at once, with the configuration
+     * of the current run mode */
+    if (an386_smc.PMSTAT == SMC_PMSTAT_HSRUN) {
+        HW_WRITE32(scg->CSR, scg->HCCR);
+    } else if (an386_smc.PMSTAT == SMC_PMSTAT_VLPR) {
+        HW_WRITE32(scg->CSR, scg->VCCR);
+    } else {
+        HW_WRITE32(scg->CSR, scg->RCCR);
+    }
+    return scg;
+}
+
+SMC_Type *An386_SmcSync(void)
+{
+    SMC_Type *smc = &an386_smc;
+    uint32_t runm = (smc->PMCTRL & SMC_PMCTRL_RUNM_MASK) >> SMC_PMCTRL_RUNM_SHIFT;
+
+    /* The mode switch completes at once; PMPROT is not checked */
+    HW_WRITE32(smc->PMSTAT, (runm == SMC_RUNM_HSRUN) ? SMC_PMSTAT_HSRUN :
+                            (runm == SMC_RUNM_VLPR)  ? SMC_PMSTAT_VLPR  : SMC_PMSTAT_RUN);
+    return smc;
+}
+
+LMEM_Type *An386_LmemSync(void)
+{
+    LMEM_Type *lmem = &an386_lmem;
+
+    /* Nothing is cached: way and line commands complete at once */
+    lmem->PCCCR  &= ~LMEM_PCCCR_GO_MASK;
+    lmem->PCCLCR &= ~LMEM_PCCLCR_LGO_MASK;
+    lmem->PCCSAR &= ~LMEM_PCCSAR_LGO_MASK;
+    return lmem;
+}
+
+void An386_FtfcExecute(void)
+{
+    uint32_t addr = ((uint32_t)an386_ftfc.FCCOB[2] << 16) |
+                    ((uint32_t)an386_ftfc.FCCOB[1] << 8)  |
+                     (uint32_t)an386_ftfc.FCCOB[0];
+    uint32_t first = (uint32_t)__an386_flash_start;
+    uint8_t  fstat = 0U;
+    uint8_t *cell;
+    uint32_t i;
+
+    /* Program and erase are refused outside RUN */
+    switch ((an386_smc.PMSTAT == SMC_PMSTAT_RUN) ? an386_ftfc.FCCOB[3] : 0U) {
+    case FTFC_CMD_PROGRAM_PHRASE:
+        if (((addr % AN386_FLASH_PHRASE_SIZE) != 0U) ||
+            (addr + AN386_FLASH_PHRASE_SIZE > AN386_FLASH_SIZE)) {
+            fstat = FTFC_FSTAT_ACCERR_MASK;
+        } else if (addr < first) {
+            fstat = FTFC_FSTAT_FPVIOL_MASK;
+        } else {
+            cell = (uint8_t *)addr;
+            for (i = 0U; i < AN386_FLASH_PHRASE_SIZE; i++) {
+                /* Programming only clears bits */
+                if ((uint8_t)(cell[i] & an386_ftfc.FCCOB[4U + i]) != an386_ftfc.FCCOB[4U + i]) {
+                    fstat = FTFC_FSTAT_MGSTAT0_MASK;
+                }
+                cell[i] &= an386_ftfc.FCCOB[4U + i];
+            }
+            flash_write_through(addr, AN386_FLASH_PHRASE_SIZE);
+        }
+        break;
+
+    case FTFC_CMD_ERASE_SECTOR:
+        if (((addr % 16U) != 0U) || (addr >= AN386_FLASH_SIZE)) {
+            fstat = FTFC_FSTAT_ACCERR_MASK;
+        } else if (addr < first) {
+            fstat = FTFC_FSTAT_FPVIOL_MASK;
+        } else {
+            addr &= ~(AN386_FLASH_SECTOR_SIZE - 1U);
+            memset((void *)addr, 0xFF, AN386_FLASH_SECTOR_SIZE);
+            flash_write_through(addr, AN386_FLASH_SECTOR_SIZE);
+        }
+        break;
+
+    default:
+        fstat = FTFC_FSTAT_ACCERR_MASK;
+        break;
+    }
+
+    an386_ftfc.FSTAT = FTFC_FSTAT_CCIF_MASK | fstat;
+}
+
+uint32_t An386_Cycles(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t ticks;
+
+    __disable_irq();
+    /* COUNTFLAG clears on read: every wrap is counted exactly once */
+    if ((AN386_SYSTICK->CSR & SYSTICK_CSR_COUNTFLAG) != 0U) {
+        systick_wraps++;
+    }
+    ticks = SYSTICK_RELOAD - AN386_SYSTICK->CVR;
+    if ((AN386_SYSTICK->CSR & SYSTICK_CSR_COUNTFLAG) != 0U) {
+        systick_wraps++;
+        ticks = SYSTICK_RELOAD - AN386_SYSTICK->CVR;
+    }
+    __set_PRIMASK(primask);
+
+    return ((systick_wraps << SYSTICK_BITS) + ticks) * AN386_INSN_PER_TICK;
+}
+
+void An386_Print(const char *s)
+{
+    (void)semihost(SH_SYS_WRITE0, s);
+}
+
+void An386_Exit(int status)
+{
+    const uint32_t arg[2] = { SH_EXIT_APPLICATION, (uint32_t)status };
+
+    (void)semihost(SH_SYS_EXIT_EXTENDED, arg);
+    for (;;) {
+        /* Not reached */
+    }
+}
+
+/**
+ * @brief SysTick: folds counter wraps while the firmware idles.
+ */
+void SysTick_Handler(void)
+{
+    (void)An386_Cycles();
+}
@@ -0,0 +1,166 @@
+/**
+ * @file    an386_s32k.h
+ * @brief   S32K144 bootloader on QEMU mps2-an386 - register redirection.
+ *
+ * Included in front of every firmware source (-include an386_s32k.h).
+ * The AN386 has no S32K144 peripherals, so the IP_xxx pointers used by the
+ * unmodified sources are redirected to register files in RAM:
+ *   - SCG:   every access goes through An386_ScgSync(), which makes the status
+ *            bits follow the control bits (VLD after EN, CSR after the
+ *            RCCR/HCCR/VCCR of the run mode), so the polling loops of
+ *            clock_and_mode.c terminate.
+ *   - SMC:   every access goes through An386_SmcSync(), PMSTAT follows
+ *            PMCTRL[RUNM]; the FTFC refuses commands outside RUN.
+ *   - PCC, PORTx, PTx: plain register files; PTC13 (BOOT button) is set from
+ *            the semihosting command line.
+ *   - FTFC:  FCCOB is a register file; the access code copied to RAM by
+ *            Mem_43_INFLS_IPW_LoadAc() calls An386_FtfcExecute(), which runs
+ *            the command on the P-Flash array (file backed). There is no
+ *            FlexRAM: Set FlexRAM Function ends with ACCERR, so
+ *            BootFlexRam_Init() reports it unavailable.
+ *   - LPUART: only the flags read by main.c; the UART itself is driven by
+ *            hal_usart_an386.c on the CMSDK UART0 of the board, so main.c
+ *            keeps the driver receive path (BOOT_RX_DIRECT_ENABLE 0).
+ *   - LMEM:  every access goes through An386_LmemSync(), which completes the
+ *            pending cache command (GO/LGO read 0); MSCM is a register file.
+ *   - DWT:   CYCCNT is replaced by SysTick based instruction counting.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#ifndef AN386_S32K_H_
+#define AN386_S32K_H_
+
+#include "S32K144.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  BOARD
+ * ============================================================ */
+
+/** @brief SYSCLK of the MPS2 board (SysTick with CLKSOURCE = 1). */
+#define AN386_SYSCLK_HZ         (25000000UL)
+
+/**
+ * @brief Instructions per SysTick count when QEMU runs with -icount shift=0
+ *        (one instruction per ns of virtual time, 40 ns per SYSCLK period).
+ */
+#define AN386_INSN_PER_TICK     (1000000000UL / AN386_SYSCLK_HZ)
+
+/** @brief P-Flash emulated in the code SSRAM at the S32K144 addresses. */
+#define AN386_FLASH_SIZE        (0x00080000UL)
+#define AN386_FLASH_SECTOR_SIZE (0x1000UL)
+#define AN386_FLASH_PHRASE_SIZE (8UL)
+
+/* ============================================================
+ *                  REGISTER FILES
+ * ============================================================ */
+
+extern SCG_Type    an386_scg;
+extern PCC_Type    an386_pcc;
+extern PORT_Type   an386_port[PORT_INSTANCE_COUNT];
+extern GPIO_Type   an386_gpio[GPIO_INSTANCE_COUNT];
+extern FTFC_Type   an386_ftfc;
+extern LPUART_Type an386_lpuart[LPUART_INSTANCE_COUNT];
+extern LMEM_Type   an386_lmem;
+extern MSCM_Type   an386_mscm;
+extern SMC_Type    an386_smc;
+extern uint32_t    an386_dwt[2];
+
+/** @brief Update the SCG status registers, then return the register file. */
+SCG_Type *An386_ScgSync(void);
+
+/** @brief Complete the pending cache command, then return the register file. */
+LMEM_Type *An386_LmemSync(void);
+
+/** @brief Update PMSTAT from PMCTRL, then return the register file. */
+SMC_Type *An386_SmcSync(void);
+
+#undef  IP_SCG
+#define IP_SCG                  (An386_ScgSync())
+#undef  IP_PCC
+#define IP_PCC                  (&an386_pcc)
+#undef  IP_PORTA
+#define IP_PORTA                (&an386_port[0])
+#undef  IP_PORTB
+#define IP_PORTB                (&an386_port[1])
+#undef  IP_PORTC
+#define IP_PORTC                (&an386_port[2])
+#undef  IP_PORTD
+#define IP_PORTD                (&an386_port[3])
+#undef  IP_PORTE
+#define IP_PORTE                (&an386_port[4])
+#undef  IP_PTA
+#define IP_PTA                  (&an386_gpio[0])
+#undef  IP_PTB
+#define IP_PTB                  (&an386_gpio[1])
+#undef  IP_PTC
+#define IP_PTC                  (&an386_gpio[2])
+#undef  IP_PTD
+#define IP_PTD                  (&an386_gpio[3])
+#undef  IP_PTE
+#define IP_PTE                  (&an386_gpio[4])
+#undef  IP_FTFC
+#define IP_FTFC                 (&an386_ftfc)
+#undef  IP_LPUART0
+#define IP_LPUART0              (&an386_lpuart[0])
+#undef  IP_LPUART1
+#define IP_LPUART1              (&an386_lpuart[1])
+#undef  IP_LPUART2
+#define IP_LPUART2              (&an386_lpuart[2])
+#undef  IP_LMEM
+#define IP_LMEM                 (An386_LmemSync())
+#undef  IP_MSCM
+#define IP_MSCM                 (&an386_mscm)
+#undef  IP_SMC
+#define IP_SMC                  (An386_SmcSync())
+
+/* ============================================================
+ *                  CYCLE COUNTER (dwt_perf.h)
+ * ============================================================ */
+
+/**
+ * @brief Instructions executed since An386_Init() (SysTick ticks scaled by
+ *        AN386_INSN_PER_TICK, wraps like CYCCNT).
+ */
+uint32_t An386_Cycles(void);
+
+#define DWT_PERF_PORT           1
+#define DWT_PERF_DEMCR          (an386_dwt[0])
+#define DWT_PERF                ((DWT_PERF_Type *)&an386_dwt[0])
+#define DWT_PERF_NOW()          (An386_Cycles())
+
+/* ============================================================
+ *                  RECEIVE PATH (main.c)
+ * ============================================================ */
+
+/* Bytes arrive on the CMSDK UART through hal_usart_an386.c, not LPUART1 */
+#define BOOT_RX_DIRECT_ENABLE   0
+
+/* ============================================================
+ *                  PORT API (an386_port.c)
+ * ============================================================ */
+
+/** @brief Register files, SysTick, command line and flash image (before main). */
+void An386_Init(void);
+
+/** @brief Execute the command loaded in FCCOB (called by the RAM access code). */
+void An386_FtfcExecute(void);
+
+/** @brief Print a string on the QEMU console (semihosting). */
+void An386_Print(const char *s);
+
+/** @brief End the QEMU session (semihosting). */
+void An386_Exit(int status) __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AN386_S32K_H_ */
@@ -0,0 +1,144 @@
+/**
+ * @file    an386_startup.c
+ * @brief   S32K144 bootloader on QEMU mps2-an386 - vector table and reset.
+ *
+ * Replaces Project_Settings/Startup_Code in the QEMU build: the vector table
+ * uses the interrupt numbers of the AN386 (UART0 RX = IRQ 0), there is no
+ * watchdog to disable and no ECC RAM to initialize. A fault ends the QEMU
+ * session with the faulting PC on the console.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "an386_s32k.h"
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define AN386_IRQ_COUNT         (64U)
+#define AN386_CFSR              (*(volatile uint32_t *)0xE000ED28UL)
+
+/* -------------------------------------------------------------------------- */
+/*                              External Symbols                               */
+/* -------------------------------------------------------------------------- */
+
+/* Linker file an386.ld */
+extern uint32_t __StackTop;
+extern uint32_t __DATA_ROM;
+extern uint32_t __data_start__;
+extern uint32_t __data_end__;
+extern uint32_t __bss_start__;
+extern uint32_t __bss_end__;
+
+extern int main(void);
+
+/* Read by main() for the PERF startup phase; QEMU has no DWT, so it stays 0 */
+uint32_t startup_init_cycles;
+
+void Reset_Handler(void);
+void Fault_Handler(void);
+void Default_Handler(void);
+void SysTick_Handler(void);
+void UARTRX0_IRQHandler(void);
+void UART_OVF_IRQHandler(void);
+
+/* -------------------------------------------------------------------------- */
+/*                                Vector Table                                 */
+/* -------------------------------------------------------------------------- */
+
+typedef void (*an386_vector_t)(void);
+
+__attribute__((section(".isr_vector"), used))
+static const an386_vector_t an386_vectors[16U + AN386_IRQ_COUNT] = {
+    (an386_vector_t)&__StackTop,    /* Initial MSP                    */
+    Reset_Handler,                  /* Reset                          */
+    Default_Handler,                /* NMI                            */
+    Fault_Handler,                  /* HardFault                      */
+    Fault_Handler,                  /* MemManage                      */
+    Fault_Handler,                  /* BusFault                       */
+    Fault_Handler,                  /* UsageFault                     */
+    0, 0, 0, 0,                     /* Reserved                       */
+    Default_Handler,                /* SVCall                         */
+    Default_Handler,                /* DebugMonitor                   */
+    0,                              /* Reserved                       */
+    Default_Handler,                /* PendSV                         */
+    SysTick_Handler,                /* SysTick: instruction counter   */
+    [16U + 0U]  = UARTRX0_IRQHandler,   /* UART0 RX                   */
+    [16U + 1U ... 16U + 11U] = Default_Handler,
+    [16U + 12U] = UART_OVF_IRQHandler,  /* UART0..4 overrun, combined */
+    [16U + 13U ... 16U + AN386_IRQ_COUNT - 1U] = Default_Handler,
+};
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static void print_hex(const char *label, uint32_t value)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    char text[11];
+    uint32_t i;
+
+    text[0] = '0';
+    text[1] = 'x';
+    for (i = 0U; i < 8U; i++) {
+        text[2U + i] = digits[(value >> (28U - (4U * i))) & 0xFU];
+    }
+    text[10] = '\0';
+    An386_Print(label);
+    An386_Print(text);
+}
+
+/**
+ * @brief Report a fault from its exception stack frame and stop QEMU.
+ */
+__attribute__((used)) static void fault_report(const uint32_t *frame)
+{
+    print_hex("[AN386] fault: PC=", frame[6]);
+    print_hex(" LR=", frame[5]);
+    print_hex(" CFSR=", AN386_CFSR);
+    An386_Print("\n");
+    An386_Exit(1);
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                  Handlers                                   */
+/* -------------------------------------------------------------------------- */
+
+void Reset_Handler(void)
+{
+    const uint32_t *src = &__DATA_ROM;
+    uint32_t *dst;
+
+    for (dst = &__data_start__; dst < &__data_end__; ) {
+        *dst++ = *src++;
+    }
+    for (dst = &__bss_start__; dst < &__bss_end__; ) {
+        *dst++ = 0U;
+    }
+
+    An386_Init();
+    (void)main();
+    An386_Exit(0);
+}
+
+__attribute__((naked)) void Fault_Handler(void)
+{
+    __asm volatile (
+        "tst   lr, #4        \n"
+        "ite   eq            \n"
+        "mrseq r0, msp       \n"
+        "mrsne r0, psp       \n"
+        "b     fault_report  \n"
+    );
+}
+
+void Default_Handler(void)
+{
+    An386_Print("[AN386] unexpected exception\n");
+    An386_Exit(1);
+}
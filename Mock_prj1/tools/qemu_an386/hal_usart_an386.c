@@ -0,0 +1,235 @@
+/**
+ * @file    hal_usart_an386.c
+ * @brief   hal_usart.h on QEMU mps2-an386: HAL_LPUART1 on the CMSDK UART0.
+ *
+ * Replaces src/source/hal_usart.c in the QEMU build. The API, the receive
+ * path (one byte per interrupt into the buffer given to HAL_USART_Receive())
+ * and the callback events are the same, so Driver_USART.c and main.c run
+ * unmodified. QEMU connects UART0 to its serial back end (-serial pty).
+ *
+ * HAL_LPUART0 and HAL_LPUART2 are not connected: transmit is discarded.
+ * The CMSDK UART has no framing/noise/parity detection; only overruns are
+ * counted.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "hal_usart.h"
+#include "Driver_NVIC.h"
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+/**
+\brief Access structure of the CMSDK APB UART.
+*/
+typedef struct {
+  volatile uint32_t DATA;                  /* Offset: 0x000 (R/W) Data Register */
+  volatile uint32_t STATE;                 /* Offset: 0x004 (R/W) Status Register */
+  volatile uint32_t CTRL;                  /* Offset: 0x008 (R/W) Control Register */
+  volatile uint32_t INTSTATUS;             /* Offset: 0x00C (R/W) Interrupt Status / Clear Register */
+  volatile uint32_t BAUDDIV;               /* Offset: 0x010 (R/W) Baud Rate Divider Register */
+} CMSDK_UART_Type;
+
+#define AN386_UART0             ((CMSDK_UART_Type *)0x40004000UL)
+#define AN386_UART0_RX_IRQn     ((IRQn_Type)0)
+#define AN386_UART_OVF_IRQn     ((IRQn_Type)12)
+
+#define UART_STATE_TXFULL       (1UL << 0)
+#define UART_STATE_RXFULL       (1UL << 1)
+#define UART_STATE_RXOVR        (1UL << 3)
+#define UART_CTRL_TXEN          (1UL << 0)
+#define UART_CTRL_RXEN          (1UL << 1)
+#define UART_CTRL_RXIRQEN       (1UL << 3)
+#define UART_CTRL_RXOVRIRQEN    (1UL << 5)
+#define UART_INT_RX             (1UL << 1)
+#define UART_INT_RXOVR          (1UL << 3)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+/** @brief Registered CMSIS callback for each USART channel. */
+static ARM_USART_SignalEvent_t usart_cb[3] = {NULL};
+
+/** @brief Receive buffer pointer for each channel (non-blocking mode). */
+static volatile uint8_t *rx_ptr[3] = {NULL};
+
+/** @brief Remaining bytes to receive for each channel. */
+static volatile uint32_t rx_num[3] = {0};
+
+/** @brief Receive error counters for each channel (updated in the ISR). */
+static volatile HAL_USART_Errors_t rx_err[3];
+
+/* -------------------------------------------------------------------------- */
+/*                               HAL API Functions                             */
+/* -------------------------------------------------------------------------- */
+
+void HAL_USART_RegisterCallback(HAL_USART_Channel_t ch, ARM_USART_SignalEvent_t cb)
+{
+    if (ch <= HAL_LPUART2)
+        usart_cb[ch] = cb;
+}
+
+void HAL_USART_SetClockSource(HAL_USART_Channel_t ch, uint8_t pcs)
+{
+    /* UART clock is the fixed APB clock of the board */
+    (void)ch;
+    (void)pcs;
+}
+
+void HAL_USART_InitPins(HAL_USART_Channel_t ch)
+{
+    (void)ch;
+}
+
+void HAL_USART_EnableIRQ(HAL_USART_Channel_t ch)
+{
+    if (ch != HAL_LPUART1) return;
+    NVIC_SetPriority(AN386_UART0_RX_IRQn, NVIC_PRIO_LPUART);
+    NVIC_SetPriority(AN386_UART_OVF_IRQn, NVIC_PRIO_LPUART);
+    NVIC_ClearPendingIRQ(AN386_UART0_RX_IRQn);
+    NVIC_EnableIRQ(AN386_UART0_RX_IRQn);
+    NVIC_EnableIRQ(AN386_UART_OVF_IRQn);
+}
+
+void HAL_USART_DisableIRQ(HAL_USART_Channel_t ch)
+{
+    if (ch != HAL_LPUART1) return;
+    NVIC_DisableIRQ(AN386_UART0_RX_IRQn);
+    NVIC_DisableIRQ(AN386_UART_OVF_IRQn);
+}
+
+/**
+ * @brief Configure UART0: TX, RX and RX interrupt enabled.
+ *
+ * The baud rate only matters for a real line; QEMU delivers characters as
+ * fast as the back end provides them, BAUDDIV just has to be valid (>= 16).
+ */
+void HAL_USART_Config(HAL_USART_Channel_t ch, uint32_t control, HAL_USART_Baudrate_t baud)
+{
+    if (ch != HAL_LPUART1) return;
+
+    AN386_UART0->CTRL      = 0U;
+    AN386_UART0->BAUDDIV   = AN386_SYSCLK_HZ / (uint32_t)baud;
+    AN386_UART0->INTSTATUS = UART_INT_RX | UART_INT_RXOVR;
+    AN386_UART0->CTRL      = UART_CTRL_TXEN | UART_CTRL_RXEN |
+                             UART_CTRL_RXIRQEN | UART_CTRL_RXOVRIRQEN;
+
+    NVIC_SetPriority(AN386_UART0_RX_IRQn, NVIC_PRIO_LPUART);
+    NVIC_SetPriority(AN386_UART_OVF_IRQn, NVIC_PRIO_LPUART);
+    NVIC_ClearPendingIRQ(AN386_UART0_RX_IRQn);
+    NVIC_EnableIRQ(AN386_UART0_RX_IRQn);
+    NVIC_EnableIRQ(AN386_UART_OVF_IRQn);
+
+    (void)control; /* reserved parameter for compatibility */
+}
+
+/**
+ * @brief No multi-drop operation: the CMSDK UART has no 9-bit frames.
+ *
+ * A BOOT_MULTIDROP build runs as a single node that every frame reaches.
+ */
+void HAL_USART_ConfigMultidrop(HAL_USART_Channel_t ch, uint8_t node, uint8_t broadcast)
+{
+    (void)ch;
+    (void)node;
+    (void)broadcast;
+}
+
+void HAL_USART_Send(HAL_USART_Channel_t ch, const void *data, uint32_t num)
+{
+    if (ch > HAL_LPUART2 || data == NULL || num == 0) return;
+    const uint8_t *ptr = (const uint8_t *)data;
+
+    if (ch == HAL_LPUART1) {
+        while (num--) {
+            while (AN386_UART0->STATE & UART_STATE_TXFULL);
+            AN386_UART0->DATA = *ptr++;
+        }
+    }
+
+    if (usart_cb[ch])
+        usart_cb[ch](ARM_USART_EVENT_SEND_COMPLETE);
+}
+
+void HAL_USART_Receive(HAL_USART_Channel_t ch, void *data, uint32_t num)
+{
+    if (ch > HAL_LPUART2 || data == NULL || num == 0) return;
+    rx_ptr[ch] = (uint8_t *)data;
+    rx_num[ch] = num;
+
+    /* A byte already waiting raises no new interrupt: pend it (RDRF is level) */
+    if ((ch == HAL_LPUART1) && (AN386_UART0->STATE & UART_STATE_RXFULL))
+        NVIC_SetPendingIRQ(AN386_UART0_RX_IRQn);
+}
+
+/**
+ * @brief Receive interrupt: one byte into the pending receive buffer.
+ *
+ * A byte that arrives with no receive pending stays in the UART (RXFULL),
+ * like RDRF on the LPUART, until HAL_USART_Receive() is called again.
+ * QEMU does not accept more characters from the back end meanwhile.
+ */
+void HAL_USART_IRQHandler(HAL_USART_Channel_t ch)
+{
+    if (ch != HAL_LPUART1) return;
+    uint32_t state = AN386_UART0->STATE;
+
+    /* Acknowledge first: a byte arriving after the DATA read raises a new one */
+    AN386_UART0->INTSTATUS = UART_INT_RX | UART_INT_RXOVR;
+
+    /* Handle RX */
+    if ((state & UART_STATE_RXFULL) && rx_ptr[ch] && rx_num[ch])
+    {
+        *rx_ptr[ch] = (uint8_t)AN386_UART0->DATA;
+        rx_ptr[ch]++;
+        rx_num[ch]--;
+
+        if (usart_cb[ch])
+            usart_cb[ch](ARM_USART_EVENT_RECEIVE_COMPLETE);
+    }
+
+    HAL_USART_CountErrors(ch, state);
+}
+
+/**
+ * @brief Count and clear overruns; stat is the UART STATE register here.
+ */
+void HAL_USART_CountErrors(HAL_USART_Channel_t ch, uint32_t stat)
+{
+    if (ch != HAL_LPUART1) return;
+
+    /* Count and clear overruns */
+    if (stat & UART_STATE_RXOVR) {
+        rx_err[ch].overrun++;
+        AN386_UART0->STATE = UART_STATE_RXOVR;
+    }
+}
+
+void HAL_USART_GetErrors(HAL_USART_Channel_t ch, HAL_USART_Errors_t *err)
+{
+    if (ch > HAL_LPUART2 || err == NULL) return;
+    err->overrun = rx_err[ch].overrun;
+    err->noise   = rx_err[ch].noise;
+    err->framing = rx_err[ch].framing;
+    err->parity  = rx_err[ch].parity;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               IRQ Definitions                              */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief UART0 receive interrupt (IRQ 0).
+ */
+void UARTRX0_IRQHandler(void) { HAL_USART_IRQHandler(HAL_LPUART1); }
+
+/**
+ * @brief Combined UART overrun interrupt (IRQ 12).
+ */
+void UART_OVF_IRQHandler(void) { HAL_USART_IRQHandler(HAL_LPUART1); }
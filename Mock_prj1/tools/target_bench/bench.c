@@ -0,0 +1,144 @@
+/**
+ * @file    bench.c
+ * @brief   Microbenchmark harness shared by the S32K144 image and the host.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "bench.h"
+#include <stddef.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define BENCH_LINE_MAX      (128U)
+#define BENCH_CALIB_RUNS    (64U)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static uint32_t now_overhead = 0U;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static uint32_t append_str(char *buf, uint32_t pos, const char *s)
+{
+    while ((*s != '\0') && (pos < (BENCH_LINE_MAX - 1U))) {
+        buf[pos++] = *s++;
+    }
+    buf[pos] = '\0';
+    return pos;
+}
+
+static uint32_t append_u32(char *buf, uint32_t pos, uint32_t v)
+{
+    char tmp[10];
+    uint32_t n = 0U;
+
+    do {
+        tmp[n++] = (char)('0' + (v % 10U));
+        v /= 10U;
+    } while (v != 0U);
+    while ((n > 0U) && (pos < (BENCH_LINE_MAX - 1U))) {
+        buf[pos++] = tmp[--n];
+    }
+    buf[pos] = '\0';
+    return pos;
+}
+
+/**
+ * @brief Append v / 100 with two decimals.
+ */
+static uint32_t append_fix2(char *buf, uint32_t pos, uint64_t v)
+{
+    uint32_t frac = (uint32_t)(v % 100U);
+
+    pos = append_u32(buf, pos, (uint32_t)(v / 100U));
+    pos = append_str(buf, pos, ".");
+    if (frac < 10U) {
+        pos = append_str(buf, pos, "0");
+    }
+    return append_u32(buf, pos, frac);
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Public API                                    */
+/* -------------------------------------------------------------------------- */
+
+void Bench_Calibrate(void)
+{
+    uint32_t best = 0xFFFFFFFFU;
+    uint32_t t0;
+    uint32_t t1;
+    uint32_t i;
+
+    for (i = 0U; i < BENCH_CALIB_RUNS; i++) {
+        t0 = BENCH_NOW();
+        t1 = BENCH_NOW();
+        if ((t1 - t0) < best) {
+            best = t1 - t0;
+        }
+    }
+    now_overhead = best;
+}
+
+uint32_t Bench_Overhead(void)
+{
+    return now_overhead;
+}
+
+void Bench_Header(bench_write_t write)
+{
+    write("target,case,size,n,unit,min,avg,max\r\n");
+}
+
+void Bench_Run(const bench_case_t *cases, uint32_t count, uint32_t samples,
+               const char *target, bench_write_t write)
+{
+    char line[BENCH_LINE_MAX];
+    const bench_case_t *c;
+    uint64_t sum;
+    uint32_t min;
+    uint32_t max;
+    uint32_t t;
+    uint32_t pos;
+    uint32_t i;
+    uint32_t s;
+
+    for (i = 0U; i < count; i++) {
+        c   = &cases[i];
+        sum = 0U;
+        min = 0xFFFFFFFFU;
+        max = 0U;
+        (void)c->run(c->n, c->size);            /* Warm-up: caches, prefetch */
+        for (s = 0U; s < samples; s++) {
+            t = c->run(c->n, c->size);
+            sum += t;
+            min = (t < min) ? t : min;
+            max = (t > max) ? t : max;
+        }
+
+        pos = append_str(line, 0U, target);
+        pos = append_str(line, pos, ",");
+        pos = append_str(line, pos, c->name);
+        pos = append_str(line, pos, ",");
+        pos = append_u32(line, pos, c->size);
+        pos = append_str(line, pos, ",");
+        pos = append_u32(line, pos, c->n);
+        pos = append_str(line, pos, "," BENCH_UNIT ",");
+        pos = append_fix2(line, pos, ((uint64_t)min * 100U) / c->n);
+        pos = append_str(line, pos, ",");
+        pos = append_fix2(line, pos, (sum * 100U) / ((uint64_t)c->n * samples));
+        pos = append_str(line, pos, ",");
+        pos = append_fix2(line, pos, ((uint64_t)max * 100U) / c->n);
+        (void)append_str(line, pos, "\r\n");
+        write(line);
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file    bench.h
+ * @brief   Microbenchmark harness shared by the S32K144 image and the host.
+ *
+ * A case runs one operation n times and returns the elapsed ticks: DWT
+ * cycles on the target, nanoseconds on the host (BENCH_HOST). A case that
+ * needs per-call timing (an interrupt, a flash command) times each call
+ * itself and subtracts Bench_Overhead(), the cost of two BENCH_NOW() reads.
+ *
+ * Bench_Run() repeats every case a number of times and writes one CSV line
+ * per case through the output function:
+ *
+ *   target,case,size,n,unit,min,avg,max
+ *
+ * min/avg/max are ticks per operation over the samples, two decimals.
+ * The formatting uses no printf, so the image needs no float support.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ *                  TICK SOURCE
+ * ============================================================ */
+
+#ifdef BENCH_HOST
+uint32_t Bench_HostNow(void);
+#define BENCH_NOW()         Bench_HostNow()
+#define BENCH_UNIT          "ns"
+#else
+#include "dwt_perf.h"
+#define BENCH_NOW()         DWT_PERF_NOW()
+#define BENCH_UNIT          "cycles"
+#endif
+
+/** Keeps the compiler from merging or dropping repeated memory operations. */
+#define BENCH_BARRIER()     __asm__ volatile ("" ::: "memory")
+
+/* ============================================================
+ *                  TYPES
+ * ============================================================ */
+
+/**
+ * @brief Run an operation @p n times.
+ * @param[in] n    Operations.
+ * @param[in] size Bytes per operation (0 if not sized).
+ * @return Elapsed ticks for the @p n operations.
+ */
+typedef uint32_t (*bench_fn_t)(uint32_t n, uint32_t size);
+
+typedef struct {
+    const char *name;
+    bench_fn_t  run;
+    uint32_t    size;
+    uint32_t    n;              /**< Operations per sample                  */
+} bench_case_t;
+
+/** @brief Output function, one '\0'-terminated text line per call. */
+typedef void (*bench_write_t)(const char *text);
+
+/* ============================================================
+ *                  API
+ * ============================================================ */
+
+/**
+ * @brief Measure the cost of two back-to-back BENCH_NOW() reads.
+ */
+void Bench_Calibrate(void);
+
+/**
+ * @brief Ticks of two BENCH_NOW() reads (after Bench_Calibrate()).
+ */
+uint32_t Bench_Overhead(void);
+
+/**
+ * @brief Write the CSV header line.
+ */
+void Bench_Header(bench_write_t write);
+
+/**
+ * @brief Run each case @p samples times and write one CSV line per case.
+ * @param[in] target  First CSV column ("s32k144", "host" ...).
+ */
+void Bench_Run(const bench_case_t *cases, uint32_t count, uint32_t samples,
+               const char *target, bench_write_t write);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,51 @@
+/**
+ * @file    bench_host.c
+ * @brief   Host build of the pure-software cases (bench_sw.c).
+ *
+ * Prints the same CSV as the S32K144 image, in ns, so target and host
+ * lines of one driver release can be put side by side.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#define _GNU_SOURCE
+#include "bench.h"
+#include "bench_sw.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+uint32_t Bench_HostNow(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec);
+}
+
+static void host_write(const char *text)
+{
+    fputs(text, stdout);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t samples = 8U;
+
+    if (argc > 1) {
+        samples = (uint32_t)strtoul(argv[1], NULL, 0);
+        if (samples == 0U) {
+            fprintf(stderr, "usage: %s [samples]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Bench_Calibrate();
+    Bench_Header(host_write);
+    Bench_Run(bench_sw_cases, bench_sw_count, samples, "host", host_write);
+    return 0;
+}
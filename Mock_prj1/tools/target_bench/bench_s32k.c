@@ -0,0 +1,573 @@
+/**
+ * @file    bench_s32k.c
+ * @brief   S32K144 microbenchmark image: driver cases and main().
+ *
+ * Built from the Mock_prj1 drivers, startup code and linker file (the image
+ * replaces the bootloader at 0x00000000; flash it with the debugger). It
+ * runs the cases once after reset and prints the CSV over LPUART1 (OpenSDA
+ * virtual COM port) at BENCH_BAUDRATE, then idles.
+ *
+ * Driver cases, in DWT cycles at the 80 MHz RUN clock:
+ *
+ *   gpio_driver     Driver_GPIO0.SetOutput() on the red LED, alternating
+ *   gpio_hal        HAL_GPIO_Toggle() on the red LED
+ *   gpio_ptor       raw write of the PTD toggle register
+ *   lpuart_isr      LPUART0 in internal loopback: from the store that
+ *                   enables the receive interrupt (RDRF already set) to the
+ *                   registered callback, through LPUART0_RxTx_IRQHandler()
+ *                   and HAL_USART_IRQHandler(), the path Driver_USART1
+ *                   takes in the bootloader
+ *   lpuart_isr_direct  the same byte to a handler installed in the RAM
+ *                   vector table (NVIC_InstallHandler()), the path of the
+ *                   bootloader with BOOT_RX_DIRECT_ENABLE
+ *   flash_program   Program_LongWord_8B(), one phrase, interrupts masked
+ *   flash_erase     Erase_Sector(), one 4 KB sector, interrupts masked
+ *   flash_section   BootFlexRam_ProgramSection(), 1 KB from the FlexRAM
+ *                   buffer in one Program Section command (boot_flexram.h)
+ *
+ * Code fetch cases, run from P-Flash with the LMEM code cache off
+ * (target "s32k144_nocache") and on (boot_cache.h):
+ *
+ *   parse_srec      BootRecord_Decode() of an S1 line of the LED_APP image,
+ *                   the bootloader's per-record parser
+ *   app_crc32       bitwise CRC-32 over a RAM buffer, a loop with branches
+ *                   like application code
+ *
+ * Bus placement cases (boot_mem.h), RX while programming: a Flash program
+ * command runs while a RAM function pushes bytes into a ring buffer, as
+ * the LPUART receive path does during a download. The pushing code runs
+ * from SRAM_L (.code_ram), the ring is either in SRAM_L (BOOT_SRAM_L) or
+ * in SRAM_U (.bss, where the bootloader keeps its rings):
+ *
+ *   rxprog_l        cycles of the pushes, ring in SRAM_L
+ *   rxprog_u        cycles of the pushes, ring in SRAM_U
+ *   rxprog_stall_l  stall cycles of the pushes (DWT CPICNT + LSUCNT),
+ *                   ring in SRAM_L
+ *   rxprog_stall_u  the same, ring in SRAM_U
+ *
+ * The software cases run in both settings as well; the driver cases run
+ * with the cache on, as in the bootloader.
+ *
+ * The flash cases erase and program BENCH_FLASH_SCRATCH, the last P-Flash
+ * sector. Per-call cases subtract Bench_Overhead().
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "bench.h"
+#include "bench_sw.h"
+#include "Driver_USART.h"
+#include "hal_usart.h"
+#include "hal_gpio.h"
+#include "clock_and_mode.h"
+#include "FLASH.h"
+#include "dwt_perf.h"
+#include "boot_cache.h"
+#include "boot_record.h"
+#include "boot_mem.h"
+#include "boot_flexram.h"
+#include "Driver_NVIC.h"
+#include "Driver_PORT_S32K144.h"
+#include "Driver_GPIO.h"
+#include "Driver_GPIO_Pins.h"
+#include "s32_core_cm4.h"
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#ifndef BENCH_BAUDRATE
+#define BENCH_BAUDRATE      HAL_USART_BAUDRATE_115200
+#endif
+#ifndef BENCH_SAMPLES
+#define BENCH_SAMPLES       (8U)
+#endif
+
+#define BENCH_FLASH_SCRATCH (0x0007F000U)   /* Last 4 KB sector of P-Flash */
+#define BENCH_TARGET        "s32k144"
+#define BENCH_TARGET_NC     "s32k144_nocache"
+#define BENCH_CRC_SIZE      (256U)
+#define BENCH_RING_SIZE     (256U)          /* Power of two */
+#define BENCH_PHRASES       (FTFC_P_FLASH_SECTOR_SIZE / FTFC_WRITE_DOUBLE_WORD)
+
+/* DWT event counters (8 bit, wrap), not in dwt_perf.h */
+#define BENCH_DWT_CPICNT        (*(volatile uint32_t *)0xE0001008UL)
+#define BENCH_DWT_LSUCNT        (*(volatile uint32_t *)0xE0001014UL)
+#define BENCH_DWT_CPIEVTENA     (1UL << 17)
+#define BENCH_DWT_LSUEVTENA     (1UL << 20)
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+extern ARM_DRIVER_USART Driver_USART1;
+extern ARM_DRIVER_GPIO  Driver_GPIO0;
+extern ARM_DRIVER_PORT  Driver_PORT0;
+
+static volatile uint32_t isr_t1;
+static uint8_t           isr_byte;
+
+/* Line 2 of LED_APP/APP_LED/Debug_FLASH/APP_LED.srec */
+static const char parse_line[] = "S113A010F9A50000F9A50000F9A500000000000062";
+
+static uint8_t           crc_buf[BENCH_CRC_SIZE];
+static volatile uint32_t crc_sink;
+
+/* RX ring: the push reads and writes head and writes buf, like the
+ * receive callback of the bootloader */
+typedef struct {
+    volatile uint8_t  buf[BENCH_RING_SIZE];
+    volatile uint32_t head;
+} rxprog_ring_t;
+
+static BOOT_SRAM_L rxprog_ring_t ring_l;   /* Code bus, next to the code */
+static rxprog_ring_t             ring_u;   /* System bus */
+static uint32_t                  rxprog_phrase;
+static uint32_t                  rxprog_stalls;
+
+/* -------------------------------------------------------------------------- */
+/*                         Private Function Prototypes                         */
+/* -------------------------------------------------------------------------- */
+
+/* In SRAM: nothing may be fetched from P-Flash while the command runs */
+START_FUNCTION_DECLARATION_RAMSECTION
+static uint32_t rxprog_push(rxprog_ring_t *ring, uint32_t size)
+END_FUNCTION_DECLARATION_RAMSECTION
+
+/* In SRAM like LPUART0_RxTx_IRQHandler(), which it replaces */
+START_FUNCTION_DECLARATION_RAMSECTION
+static void isr_direct(void)
+END_FUNCTION_DECLARATION_RAMSECTION
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static void uart_write(const char *text)
+{
+    Driver_USART1.Send(text, strlen(text));
+    while (Driver_USART1.GetStatus().tx_busy) {
+        /* Wait for transmission complete */
+    }
+}
+
+static uint32_t run_gpio_driver(uint32_t n, uint32_t size)
+{
+    uint32_t t0 = BENCH_NOW();
+    uint32_t i;
+
+    (void)size;
+    for (i = 0U; i < n; i++) {
+        Driver_GPIO0.SetOutput(GPIO_PIN_LED_RED, i & 1U);
+    }
+    return BENCH_NOW() - t0;
+}
+
+static uint32_t run_gpio_hal(uint32_t n, uint32_t size)
+{
+    uint32_t t0 = BENCH_NOW();
+    uint32_t i;
+
+    (void)size;
+    for (i = 0U; i < n; i++) {
+        HAL_GPIO_Toggle(HAL_GPIO_PORT_D, GPIO_LED_RED_PIN);
+    }
+    return BENCH_NOW() - t0;
+}
+
+static uint32_t run_gpio_ptor(uint32_t n, uint32_t size)
+{
+    uint32_t t0 = BENCH_NOW();
+    uint32_t i;
+
+    (void)size;
+    for (i = 0U; i < n; i++) {
+        IP_PTD->PTOR = (1UL << GPIO_LED_RED_PIN);
+    }
+    return BENCH_NOW() - t0;
+}
+
+static void isr_callback(uint32_t event)
+{
+    isr_t1 = BENCH_NOW();
+    (void)event;
+}
+
+/**
+ * @brief LPUART0 in internal loopback, receive interrupt armed in the NVIC
+ *        but masked in CTRL until a case enables it.
+ */
+static void isr_init(void)
+{
+    HAL_USART_RegisterCallback(HAL_LPUART0, isr_callback);
+    HAL_USART_SetClockSource(HAL_LPUART0, 6);   /* SPLL_DIV2 = 40 MHz */
+    HAL_USART_Config(HAL_LPUART0, 0U, BENCH_BAUDRATE);
+    IP_LPUART0->CTRL = 0U;
+    IP_LPUART0->CTRL = LPUART_CTRL_LOOPS_MASK;  /* RSRC = 0: TX feeds RX */
+    IP_LPUART0->CTRL |= LPUART_CTRL_TE_MASK | LPUART_CTRL_RE_MASK;
+}
+
+static uint32_t run_lpuart_isr(uint32_t n, uint32_t size)
+{
+    uint32_t ticks = 0U;
+    uint32_t t0;
+    uint32_t i;
+
+    (void)size;
+    for (i = 0U; i < n; i++) {
+        HAL_USART_Receive(HAL_LPUART0, &isr_byte, 1U);
+        IP_LPUART0->DATA = (uint8_t)i;
+        while ((IP_LPUART0->STAT & LPUART_STAT_RDRF_MASK) == 0U) {
+            /* Wait for the looped-back byte */
+        }
+        isr_t1 = 0U;
+        t0 = BENCH_NOW();
+        IP_LPUART0->CTRL |= LPUART_CTRL_RIE_MASK;
+        while (isr_t1 == 0U) {
+            /* Wait for the callback */
+        }
+        IP_LPUART0->CTRL &= ~LPUART_CTRL_RIE_MASK;
+        ticks += (isr_t1 - t0) - Bench_Overhead();
+    }
+    return ticks;
+}
+
+/**
+ * @brief Installed LPUART0 handler: reads the byte, no callback.
+ */
+static void isr_direct(void)
+{
+    isr_t1 = BENCH_NOW();
+    isr_byte = (uint8_t)IP_LPUART0->DATA;
+}
+
+static uint32_t run_lpuart_isr_direct(uint32_t n, uint32_t size)
+{
+    NVIC_Handler_t old;
+    uint32_t ticks = 0U;
+    uint32_t t0;
+    uint32_t i;
+
+    (void)size;
+    old = NVIC_InstallHandler(LPUART0_RxTx_IRQn, isr_direct);
+    if (old == NULL) {
+        return 0U;  /* Vector table in Flash */
+    }
+    for (i = 0U; i < n; i++) {
+        IP_LPUART0->DATA = (uint8_t)i;
+        while ((IP_LPUART0->STAT & LPUART_STAT_RDRF_MASK) == 0U) {
+            /* Wait for the looped-back byte */
+        }
+        isr_t1 = 0U;
+        t0 = BENCH_NOW();
+        IP_LPUART0->CTRL |= LPUART_CTRL_RIE_MASK;
+        while (isr_t1 == 0U) {
+            /* Wait for the handler */
+        }
+        IP_LPUART0->CTRL &= ~LPUART_CTRL_RIE_MASK;
+        ticks += (isr_t1 - t0) - Bench_Overhead();
+    }
+    (void)NVIC_InstallHandler(LPUART0_RxTx_IRQn, old);
+    return ticks;
+}
+
+static uint32_t run_flash_program(uint32_t n, uint32_t size)
+{
+    static const uint8_t phrase[FTFC_WRITE_DOUBLE_WORD] = { 0x5AU, 0xA5U, 0x5AU, 0xA5U, 0x01U, 0x02U, 0x03U, 0x04U };
+    uint32_t ticks = 0U;
+    uint32_t t0;
+    uint32_t i;
+
+    (void)size;
+    DISABLE_INTERRUPTS();
+    (void)Erase_Sector(BENCH_FLASH_SCRATCH);
+    ENABLE_INTERRUPTS();
+    for (i = 0U; i < n; i++) {
+        t0 = BENCH_NOW();
+        DISABLE_INTERRUPTS();
+        (void)Program_LongWord_8B(BENCH_FLASH_SCRATCH + (i * FTFC_WRITE_DOUBLE_WORD), phrase);
+        ENABLE_INTERRUPTS();
+        ticks += (BENCH_NOW() - t0) - Bench_Overhead();
+    }
+    return ticks;
+}
+
+static uint32_t run_flash_erase(uint32_t n, uint32_t size)
+{
+    uint32_t ticks = 0U;
+    uint32_t t0;
+    uint32_t i;
+
+    (void)size;
+    for (i = 0U; i < n; i++) {
+        t0 = BENCH_NOW();
+        DISABLE_INTERRUPTS();
+        (void)Erase_Sector(BENCH_FLASH_SCRATCH);
+        ENABLE_INTERRUPTS();
+        ticks += (BENCH_NOW() - t0) - Bench_Overhead();
+    }
+    return ticks;
+}
+
+/**
+ * @brief Load a program command for the next scratch phrase (not launched).
+ *
+ * The sector is erased when the phrases run out; call with interrupts
+ * masked.
+ */
+static void rxprog_prepare(void)
+{
+    uint32_t addr;
+
+    if (rxprog_phrase == 0U) {
+        (void)Erase_Sector(BENCH_FLASH_SCRATCH);
+    }
+    addr = BENCH_FLASH_SCRATCH + (rxprog_phrase * FTFC_WRITE_DOUBLE_WORD);
+    rxprog_phrase = (rxprog_phrase + 1U) % BENCH_PHRASES;
+
+    while ((IP_FTFC->FSTAT & FTFC_FSTAT_CCIF_MASK) == 0U) {
+        /* Previous command */
+    }
+    IP_FTFC->FSTAT = FTFC_FSTAT_ACCERR_MASK | FTFC_FSTAT_FPVIOL_MASK;
+    IP_FTFC->FCCOB[3] = CMD_PROGRAM_LONGWORD;
+    IP_FTFC->FCCOB[2] = (uint8_t)(addr >> 16);
+    IP_FTFC->FCCOB[1] = (uint8_t)(addr >> 8);
+    IP_FTFC->FCCOB[0] = (uint8_t)(addr >> 0);
+    IP_FTFC->FCCOB[7] = 0x5AU;
+    IP_FTFC->FCCOB[6] = 0xA5U;
+    IP_FTFC->FCCOB[5] = 0x5AU;
+    IP_FTFC->FCCOB[4] = 0xA5U;
+    IP_FTFC->FCCOB[11] = 0x01U;
+    IP_FTFC->FCCOB[10] = 0x02U;
+    IP_FTFC->FCCOB[9]  = 0x03U;
+    IP_FTFC->FCCOB[8]  = 0x04U;
+}
+
+/**
+ * @brief Launch the loaded command, push size bytes, wait for the command.
+ *
+ * @return Cycles of the pushes; the stall cycles go to rxprog_stalls.
+ */
+static uint32_t rxprog_push(rxprog_ring_t *ring, uint32_t size)
+{
+    uint32_t stalls = 0U;
+    uint32_t cpi;
+    uint32_t lsu;
+    uint32_t t0;
+    uint32_t t1;
+    uint32_t i;
+
+    IP_FTFC->FSTAT = FTFC_FSTAT_CCIF_MASK;      /* Launch */
+    t0 = BENCH_NOW();
+    for (i = 0U; i < size; i++) {
+        cpi = BENCH_DWT_CPICNT;
+        lsu = BENCH_DWT_LSUCNT;
+        ring->buf[ring->head & (BENCH_RING_SIZE - 1U)] = (uint8_t)i;
+        ring->head++;
+        stalls += ((BENCH_DWT_CPICNT - cpi) & 0xFFU) + ((BENCH_DWT_LSUCNT - lsu) & 0xFFU);
+    }
+    t1 = BENCH_NOW();
+    while ((IP_FTFC->FSTAT & FTFC_FSTAT_CCIF_MASK) == 0U) {
+        /* Command complete */
+    }
+    rxprog_stalls = stalls;
+    return t1 - t0;
+}
+
+/**
+ * @brief n program commands with size bytes pushed during each.
+ *
+ * @return Push cycles, or stall cycles if stalls is non-zero.
+ */
+static uint32_t rxprog_run(rxprog_ring_t *ring, uint32_t n, uint32_t size, uint32_t stalls)
+{
+    uint32_t ticks = 0U;
+    uint32_t cycles;
+    uint32_t i;
+
+    for (i = 0U; i < n; i++) {
+        DISABLE_INTERRUPTS();
+        rxprog_prepare();
+        cycles = rxprog_push(ring, size);
+        ENABLE_INTERRUPTS();
+        ticks += (stalls != 0U) ? rxprog_stalls : (cycles - Bench_Overhead());
+    }
+    return ticks;
+}
+
+static uint32_t run_rxprog_l(uint32_t n, uint32_t size)
+{
+    return rxprog_run(&ring_l, n, size, 0U);
+}
+
+static uint32_t run_rxprog_u(uint32_t n, uint32_t size)
+{
+    return rxprog_run(&ring_u, n, size, 0U);
+}
+
+static uint32_t run_rxprog_stall_l(uint32_t n, uint32_t size)
+{
+    return rxprog_run(&ring_l, n, size, 1U);
+}
+
+static uint32_t run_rxprog_stall_u(uint32_t n, uint32_t size)
+{
+    return rxprog_run(&ring_u, n, size, 1U);
+}
+
+static uint32_t run_flash_section(uint32_t n, uint32_t size)
+{
+    uint8_t *stage = BootFlexRam_Stage();
+    uint32_t ticks = 0U;
+    uint32_t t0;
+    uint32_t i;
+
+    if (stage == NULL) {
+        return 0U;          /* EEE owns FlexRAM */
+    }
+    for (i = 0U; i < size; i++) {
+        stage[i] = (uint8_t)(i * 3U);
+    }
+    DISABLE_INTERRUPTS();
+    (void)Erase_Sector(BENCH_FLASH_SCRATCH);
+    ENABLE_INTERRUPTS();
+    for (i = 0U; i < n; i++) {
+        t0 = BENCH_NOW();
+        (void)BootFlexRam_ProgramSection(BENCH_FLASH_SCRATCH + (i * size), stage, size);
+        ticks += (BENCH_NOW() - t0) - Bench_Overhead();
+    }
+    return ticks;
+}
+
+static uint32_t run_parse_srec(uint32_t n, uint32_t size)
+{
+    boot_record_t rec;
+    uint32_t t0;
+    uint32_t i;
+
+    BootRecord_Reset();
+    t0 = BENCH_NOW();
+    for (i = 0U; i < n; i++) {
+        (void)BootRecord_Decode((const uint8_t *)parse_line, (uint16_t)size, &rec);
+        BENCH_BARRIER();
+    }
+    return BENCH_NOW() - t0;
+}
+
+static uint32_t run_app_crc32(uint32_t n, uint32_t size)
+{
+    uint32_t t0 = BENCH_NOW();
+    uint32_t crc;
+    uint32_t i;
+    uint32_t k;
+    uint32_t b;
+
+    for (i = 0U; i < n; i++) {
+        crc = 0xFFFFFFFFU;
+        for (k = 0U; k < size; k++) {
+            crc ^= crc_buf[k];
+            for (b = 0U; b < 8U; b++) {
+                crc = ((crc & 1U) != 0U) ? ((crc >> 1) ^ 0xEDB88320U) : (crc >> 1);
+            }
+        }
+        crc_sink = ~crc;
+    }
+    return BENCH_NOW() - t0;
+}
+
+static const bench_case_t fetch_cases[] = {
+    { "parse_srec", run_parse_srec, sizeof(parse_line) - 1U, 256U },
+    { "app_crc32",  run_app_crc32,  BENCH_CRC_SIZE,           8U },
+};
+
+static const bench_case_t driver_cases[] = {
+    { "gpio_driver",   run_gpio_driver,   0U, 1024U },
+    { "gpio_hal",      run_gpio_hal,      0U, 1024U },
+    { "gpio_ptor",     run_gpio_ptor,     0U, 1024U },
+    { "lpuart_isr",    run_lpuart_isr,    0U, 64U },
+    { "lpuart_isr_direct", run_lpuart_isr_direct, 0U, 64U },
+    /* A sector holds 512 phrases */
+    { "flash_program", run_flash_program, FTFC_WRITE_DOUBLE_WORD, 256U },
+    { "flash_erase",   run_flash_erase,   FTFC_P_FLASH_SECTOR_SIZE, 1U },
+    /* The Program Section buffer, 4 per sector */
+    { "flash_section", run_flash_section, BOOT_FLEXRAM_STAGE_SIZE,  FTFC_P_FLASH_SECTOR_SIZE / BOOT_FLEXRAM_STAGE_SIZE },
+};
+
+/* size: bytes pushed per program command */
+static const bench_case_t bus_cases[] = {
+    { "rxprog_l",       run_rxprog_l,       64U, 16U },
+    { "rxprog_u",       run_rxprog_u,       64U, 16U },
+    { "rxprog_stall_l", run_rxprog_stall_l, 64U, 16U },
+    { "rxprog_stall_u", run_rxprog_stall_u, 64U, 16U },
+};
+
+/**
+ * @brief Clocks, console and the pins and peripherals the cases use.
+ */
+static void Bench_Init(void)
+{
+    uint32_t i;
+
+    DWT_Perf_Init();
+    DWT_PERF->CTRL |= BENCH_DWT_CPIEVTENA | BENCH_DWT_LSUEVTENA;
+    SOSC_init_8MHz();
+    SPLL_init_160MHz();
+    NormalRUNmode_80MHz();
+
+    (void)Driver_USART1.Initialize(NULL);
+    (void)Driver_USART1.Control(ARM_USART_MODE_ASYNCHRONOUS |
+                                ARM_USART_DATA_BITS_8       |
+                                ARM_USART_PARITY_NONE       |
+                                ARM_USART_STOP_BITS_1,
+                                BENCH_BAUDRATE);
+
+    Driver_PORT0.EnableClock(PORTD_INDEX);
+    Driver_PORT0.SetMux(GPIO_PIN_LED_RED, ARM_PORT_MUX_GPIO);
+    Driver_GPIO0.SetDirection(GPIO_PIN_LED_RED, ARM_GPIO_OUTPUT);
+
+    isr_init();
+    Mem_43_INFLS_IPW_LoadAc();
+    (void)BootFlexRam_Init();
+    for (i = 0U; i < BENCH_CRC_SIZE; i++) {
+        crc_buf[i] = (uint8_t)(i * 7U);
+    }
+    ring_l.head = 0U;   /* .sram_l is not cleared by the startup code */
+    Bench_Calibrate();
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                   Main                                      */
+/* -------------------------------------------------------------------------- */
+
+int main(void)
+{
+    Bench_Init();
+
+    uart_write("\r\n# Mock_prj1 driver benchmark, RUN 80 MHz\r\n");
+    Bench_Header(uart_write);
+
+    /* Every fetch from the Flash array, then through the code cache */
+    BootCache_Disable();
+    Bench_Run(bench_sw_cases, bench_sw_count, BENCH_SAMPLES, BENCH_TARGET_NC, uart_write);
+    Bench_Run(fetch_cases, sizeof(fetch_cases) / sizeof(fetch_cases[0]),
+              BENCH_SAMPLES, BENCH_TARGET_NC, uart_write);
+    BootCache_Init();
+    Bench_Run(bench_sw_cases, bench_sw_count, BENCH_SAMPLES, BENCH_TARGET, uart_write);
+    Bench_Run(fetch_cases, sizeof(fetch_cases) / sizeof(fetch_cases[0]),
+              BENCH_SAMPLES, BENCH_TARGET, uart_write);
+    Bench_Run(driver_cases, sizeof(driver_cases) / sizeof(driver_cases[0]),
+              BENCH_SAMPLES, BENCH_TARGET, uart_write);
+    Bench_Run(bus_cases, sizeof(bus_cases) / sizeof(bus_cases[0]),
+              BENCH_SAMPLES, BENCH_TARGET, uart_write);
+    uart_write("# done\r\n");
+
+    while (1) {
+        /* Idle: reset to run again */
+    }
+
+    return 0;
+}
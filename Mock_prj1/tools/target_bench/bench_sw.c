@@ -0,0 +1,319 @@
+/**
+ * @file    bench_sw.c
+ * @brief   Pure-software benchmark cases, built for the target and the host.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#include "bench_sw.h"
+#include "boot_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+#define BENCH_BUF_SIZE      (4096U)
+#define BENCH_BYTES         (16384U)    /**< Bytes moved per sample */
+#define BENCH_INFLIGHT      (3U)        /**< Blocks held, like queued records */
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+/* Word aligned, like the sections init_data_bss() moves */
+static uint8_t src_buf[BENCH_BUF_SIZE] __attribute__((aligned(4)));
+static uint8_t dst_buf[BENCH_BUF_SIZE] __attribute__((aligned(4)));
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Byte copy loop init_data_bss() had before init_copy() (baseline).
+ */
+static void startup_copy(uint8_t *ram, const uint8_t *rom, const uint8_t *rom_end)
+{
+    while (rom_end != rom)
+    {
+        *ram = *rom;
+        ram++;
+        rom++;
+    }
+}
+
+/**
+ * @brief Byte clear loop init_data_bss() had before init_clear() (baseline).
+ */
+static void startup_clear(uint8_t *start, const uint8_t *end)
+{
+    while (end != start)
+    {
+        *start = 0;
+        start++;
+    }
+}
+
+/**
+ * @brief Aligned part of init_copy() in startup.c: four words per LDM/STM,
+ *        then word by word.
+ */
+static void startup_copy_w(uint8_t *ram, const uint8_t *rom, uint32_t size)
+{
+    uint32_t *dst = (uint32_t *)(void *)ram;
+    const uint32_t *src = (const uint32_t *)(const void *)rom;
+    uint32_t blocks = size & ~15UL;
+
+    if (blocks != 0U) {
+#if defined(__arm__)
+        __asm volatile (
+            "1: ldmia %[s]!, {r2-r5}    \n"
+            "   stmia %[d]!, {r2-r5}    \n"
+            "   subs  %[n], %[n], #16   \n"
+            "   bhi   1b                \n"
+            : [s] "+r" (src), [d] "+r" (dst), [n] "+r" (blocks)
+            :
+            : "r2", "r3", "r4", "r5", "cc", "memory");
+#else
+        for (; blocks != 0U; blocks -= 16U) {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = src[3];
+            dst += 4;
+            src += 4;
+        }
+#endif
+    }
+    for (size &= 15U; size >= 4U; size -= 4U) {
+        *dst++ = *src++;
+    }
+}
+
+/**
+ * @brief Aligned part of init_clear() in startup.c.
+ */
+static void startup_clear_w(uint8_t *start, uint32_t size)
+{
+    uint32_t *dst = (uint32_t *)(void *)start;
+    uint32_t blocks = size & ~15UL;
+
+    if (blocks != 0U) {
+#if defined(__arm__)
+        __asm volatile (
+            "   movs  r2, #0            \n"
+            "   movs  r3, #0            \n"
+            "   movs  r4, #0            \n"
+            "   movs  r5, #0            \n"
+            "1: stmia %[d]!, {r2-r5}    \n"
+            "   subs  %[n], %[n], #16   \n"
+            "   bhi   1b                \n"
+            : [d] "+r" (dst), [n] "+r" (blocks)
+            :
+            : "r2", "r3", "r4", "r5", "cc", "memory");
+#else
+        for (; blocks != 0U; blocks -= 16U) {
+            dst[0] = 0U;
+            dst[1] = 0U;
+            dst[2] = 0U;
+            dst[3] = 0U;
+            dst += 4;
+        }
+#endif
+    }
+    for (size &= 15U; size >= 4U; size -= 4U) {
+        *dst++ = 0U;
+    }
+}
+
+static uint32_t run_now(uint32_t n, uint32_t size)
+{
+    uint32_t t0 = BENCH_NOW();
+    uint32_t i;
+
+    (void)size;
+    for (i = 0U; i < n; i++) {
+        (void)BENCH_NOW();
+        (void)BENCH_NOW();
+    }
+    return BENCH_NOW() - t0;
+}
+
+static uint32_t run_startup_copy(uint32_t n, uint32_t size)
+{
+    uint32_t t0 = BENCH_NOW();
+    uint32_t i;
+
+    for (i = 0U; i < n; i++) {
+        startup_copy(dst_buf, src_buf, &src_buf[size]);
+        BENCH_BARRIER();
+    }
+    return BENCH_NOW() - t0;
+}
+
+static uint32_t run_startup_clear(uint32_t n, uint32_t size)
+{
+    uint32_t t0 = BENCH_NOW();
+    uint32_t i;
+
+    for (i = 0U; i < n; i++) {
+        startup_clear(dst_buf, &dst_buf[size]);
+        BENCH_BARRIER();
+    }
+    return BENCH_NOW() - t0;
+}
+
+static uint32_t run_startup_copy_w(uint32_t n, uint32_t size)
+{
+    uint32_t t0 = BENCH_NOW();
+    uint32_t i;
+
+    for (i = 0U; i < n; i++) {
+        startup_copy_w(dst_buf, src_buf, size);
+        BENCH_BARRIER();
+    }
+    return BENCH_NOW() - t0;
+}
+
+static uint32_t run_startup_clear_w(uint32_t n, uint32_t size)
+{
+    uint32_t t0 = BENCH_NOW();
+    uint32_t i;
+
+    for (i = 0U; i < n; i++) {
+        startup_clear_w(dst_buf, size);
+        BENCH_BARRIER();
+    }
+    return BENCH_NOW() - t0;
+}
+
+static uint32_t run_memcpy(uint32_t n, uint32_t size)
+{
+    uint32_t t0 = BENCH_NOW();
+    uint32_t i;
+
+    for (i = 0U; i < n; i++) {
+        memcpy(dst_buf, src_buf, size);
+        BENCH_BARRIER();
+    }
+    return BENCH_NOW() - t0;
+}
+
+static uint32_t run_memset(uint32_t n, uint32_t size)
+{
+    uint32_t t0 = BENCH_NOW();
+    uint32_t i;
+
+    for (i = 0U; i < n; i++) {
+        memset(dst_buf, 0, size);
+        BENCH_BARRIER();
+    }
+    return BENCH_NOW() - t0;
+}
+
+/**
+ * @brief One allocation and one release per operation, BENCH_INFLIGHT
+ *        blocks held: each new block replaces the oldest, as records go
+ *        through the queue.
+ */
+static uint32_t run_pool(uint32_t n, uint32_t size)
+{
+    uint8_t *held[BENCH_INFLIGHT] = { NULL };
+    uint32_t t0;
+    uint32_t i;
+    uint32_t k;
+
+    BootPool_Init();
+    t0 = BENCH_NOW();
+    for (i = 0U; i < n; i++) {
+        k = i % BENCH_INFLIGHT;
+        if (held[k] != NULL) {
+            (void)BootPool_Free(held[k]);
+        }
+        held[k] = (uint8_t *)BootPool_Alloc(size);
+        if (held[k] != NULL) {
+            held[k][0] = (uint8_t)i;
+        }
+        BENCH_BARRIER();
+    }
+    t0 = BENCH_NOW() - t0;
+    for (k = 0U; k < BENCH_INFLIGHT; k++) {
+        (void)BootPool_Free(held[k]);
+    }
+    return t0;
+}
+
+static uint32_t run_malloc(uint32_t n, uint32_t size)
+{
+    uint8_t *held[BENCH_INFLIGHT] = { NULL };
+    uint32_t t0;
+    uint32_t i;
+    uint32_t k;
+
+    t0 = BENCH_NOW();
+    for (i = 0U; i < n; i++) {
+        k = i % BENCH_INFLIGHT;
+        free(held[k]);
+        held[k] = (uint8_t *)malloc(size);
+        if (held[k] != NULL) {
+            held[k][0] = (uint8_t)i;
+        }
+        BENCH_BARRIER();
+    }
+    t0 = BENCH_NOW() - t0;
+    for (k = 0U; k < BENCH_INFLIGHT; k++) {
+        free(held[k]);
+    }
+    return t0;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                               Case Table                                    */
+/* -------------------------------------------------------------------------- */
+
+#define SIZED(name, fn, size)   { name, fn, (size), BENCH_BYTES / (size) }
+
+const bench_case_t bench_sw_cases[] = {
+    { "now", run_now, 0U, 1024U },
+    SIZED("startup_copy",    run_startup_copy,     16U),
+    SIZED("startup_copy",    run_startup_copy,     64U),
+    SIZED("startup_copy",    run_startup_copy,     256U),
+    SIZED("startup_copy",    run_startup_copy,     1024U),
+    SIZED("startup_copy",    run_startup_copy,     4096U),
+    SIZED("startup_copy_w",  run_startup_copy_w,   16U),
+    SIZED("startup_copy_w",  run_startup_copy_w,   64U),
+    SIZED("startup_copy_w",  run_startup_copy_w,   256U),
+    SIZED("startup_copy_w",  run_startup_copy_w,   1024U),
+    SIZED("startup_copy_w",  run_startup_copy_w,   4096U),
+    SIZED("memcpy",          run_memcpy,           16U),
+    SIZED("memcpy",          run_memcpy,           64U),
+    SIZED("memcpy",          run_memcpy,           256U),
+    SIZED("memcpy",          run_memcpy,           1024U),
+    SIZED("memcpy",          run_memcpy,           4096U),
+    SIZED("startup_clear",   run_startup_clear,    16U),
+    SIZED("startup_clear",   run_startup_clear,    64U),
+    SIZED("startup_clear",   run_startup_clear,    256U),
+    SIZED("startup_clear",   run_startup_clear,    1024U),
+    SIZED("startup_clear",   run_startup_clear,    4096U),
+    SIZED("startup_clear_w", run_startup_clear_w,  16U),
+    SIZED("startup_clear_w", run_startup_clear_w,  64U),
+    SIZED("startup_clear_w", run_startup_clear_w,  256U),
+    SIZED("startup_clear_w", run_startup_clear_w,  1024U),
+    SIZED("startup_clear_w", run_startup_clear_w,  4096U),
+    SIZED("memset",          run_memset,           16U),
+    SIZED("memset",          run_memset,           64U),
+    SIZED("memset",          run_memset,           256U),
+    SIZED("memset",          run_memset,           1024U),
+    SIZED("memset",          run_memset,           4096U),
+    /* Phrase and record blocks (boot_pool.h) */
+    { "pool",   run_pool,   BOOT_POOL_PHRASE_SIZE, 1024U },
+    { "pool",   run_pool,   BOOT_POOL_RECORD_SIZE, 1024U },
+    { "malloc", run_malloc, BOOT_POOL_PHRASE_SIZE, 1024U },
+    { "malloc", run_malloc, BOOT_POOL_RECORD_SIZE, 1024U },
+};
+
+const uint32_t bench_sw_count = sizeof(bench_sw_cases) / sizeof(bench_sw_cases[0]);
@@ -0,0 +1,31 @@
+/**
+ * @file    bench_sw.h
+ * @brief   Pure-software benchmark cases, built for the target and the host.
+ *
+ *   now             two BENCH_NOW() reads (the timing floor)
+ *   startup_copy    the byte copy loop init_data_bss() used to have
+ *   startup_clear   the byte clear loop init_data_bss() used to have
+ *   startup_copy_w  init_copy() of startup.c: LDM/STM blocks, then words
+ *   startup_clear_w init_clear() of startup.c
+ *   memcpy, memset  the C library routines (newlib-nano on the target)
+ *   pool            BootPool_Alloc() + BootPool_Free(), 3 blocks held
+ *   malloc          malloc() + free() in the same pattern
+ *
+ * Sized cases run at 16, 64, 256, 1024 and 4096 bytes; pool and malloc at
+ * the phrase and record block sizes of boot_pool.h.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#ifndef BENCH_SW_H_
+#define BENCH_SW_H_
+
+#include "bench.h"
+
+extern const bench_case_t bench_sw_cases[];
+extern const uint32_t     bench_sw_count;
+
+#endif /* BENCH_SW_H_ */
@@ -0,0 +1,480 @@
+/**
+ * @file    s32k_trace.c
+ * @brief   Host side of the event trace recorder (src/include/boot_trace.h):
+ *          converts the ring dump into Chrome/Perfetto trace JSON.
+ *
+ * The dump is read from the bootloader with the TRACE command (-d), or from
+ * a file saved earlier (-i). Open the JSON in https://ui.perfetto.dev or
+ * chrome://tracing. Each interrupt has its own track, the main loop another
+ * one; parse, program and erase are slices, the rest are instant events.
+ *
+ * @author
+ *   Nguyen Sy Hung
+ * @copyright
+ *   Copyright (c) 2025
+ */
+
+#define _GNU_SOURCE
+#include "flash_link.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------- */
+/*                               Private Macros                                */
+/* -------------------------------------------------------------------------- */
+
+/* Frame layout of BootTrace_Dump() */
+#define TRACE_MAGIC         (0x45435254UL)  /* "TRCE" */
+#define TRACE_VERSION       (1U)
+#define TRACE_HDR_BYTES     (20U)
+#define TRACE_ENTRY_BYTES   (8U)
+#define TRACE_EVENTS_MAX    (65536U)
+
+/* Event ids of boot_trace_ev_t */
+#define EV_ISR_ENTER        (1U)
+#define EV_ISR_EXIT         (2U)
+#define EV_LINE_RX          (3U)
+#define EV_PARSE_BEGIN      (4U)
+#define EV_PARSE_END        (5U)
+#define EV_PROGRAM_BEGIN    (6U)
+#define EV_PROGRAM_END      (7U)
+#define EV_ERASE_BEGIN      (8U)
+#define EV_ERASE_END        (9U)
+#define EV_QUEUE_FULL       (10U)
+#define EV_UART_DROP        (11U)
+
+/* Tracks: the main loop, then one per IRQ number */
+#define TID_MAIN            (1U)
+#define TID_IRQ(irq)        (16U + (irq))
+#define TID_COUNT           (16U + 256U)
+
+#define DEFAULT_BAUD        (9600U)
+#define SYNC_TIMEOUT_MS     (3000U)
+
+/* -------------------------------------------------------------------------- */
+/*                              Type Definitions                               */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    uint32_t  core_hz;
+    uint32_t  total;
+    uint32_t  n;
+    uint8_t  *raw;              /**< Whole frame, as received              */
+    size_t    raw_len;
+} trace_dump_t;
+
+/** @brief Open slices of one track. */
+typedef struct {
+    uint32_t named;             /**< thread_name emitted                   */
+    uint32_t depth;
+    double   open_us[8];
+    uint32_t open_stat[8];      /**< Index in stats[]                      */
+} track_t;
+
+/** @brief Duration statistics of the slices of one name. */
+typedef struct {
+    char     name[24];
+    uint32_t count;
+    double   max_us;
+    double   sum_us;
+} slice_stat_t;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Variables                              */
+/* -------------------------------------------------------------------------- */
+
+static track_t       tracks[TID_COUNT];
+static slice_stat_t  stats[32];
+static uint32_t      stat_count;
+
+/* -------------------------------------------------------------------------- */
+/*                              Private Functions                              */
+/* -------------------------------------------------------------------------- */
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Check the header in d->raw and fill the fields.
+ * @return Frame length, 0 if the header is invalid.
+ */
+static size_t parse_header(trace_dump_t *d)
+{
+    const uint8_t *h = d->raw;
+
+    if ((get_le32(&h[0]) != TRACE_MAGIC) || (h[4] != TRACE_VERSION)) {
+        return 0U;
+    }
+    d->core_hz = get_le32(&h[8]);
+    d->total   = get_le32(&h[12]);
+    d->n       = get_le32(&h[16]);
+    if ((d->core_hz == 0U) || (d->n > TRACE_EVENTS_MAX) || (d->n > d->total)) {
+        return 0U;
+    }
+    return TRACE_HDR_BYTES + ((size_t)d->n * TRACE_ENTRY_BYTES);
+}
+
+static int load_file(trace_dump_t *d, const char *path)
+{
+    uint8_t hdr[TRACE_HDR_BYTES];
+    size_t len;
+    FILE *f;
+
+    f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    d->raw = hdr;
+    len = (fread(hdr, 1U, sizeof(hdr), f) == sizeof(hdr)) ? parse_header(d) : 0U;
+    d->raw = (len != 0U) ? malloc(len) : NULL;
+    if (d->raw == NULL) {
+        fprintf(stderr, "%s: not a TRACE dump\n", path);
+        fclose(f);
+        return -1;
+    }
+    memcpy(d->raw, hdr, sizeof(hdr));
+    if (fread(&d->raw[sizeof(hdr)], 1U, len - sizeof(hdr), f) != (len - sizeof(hdr))) {
+        fprintf(stderr, "%s: truncated (%u events expected)\n", path, d->n);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    d->raw_len = len;
+    return 0;
+}
+
+/**
+ * @brief Send TRACE to the bootloader and receive the frame.
+ */
+static int load_device(trace_dump_t *d, const char *dev, uint32_t baud)
+{
+    static const char cmd[] = "TRACE\n";
+    uint8_t hdr[TRACE_HDR_BYTES];
+    flash_link_t link;
+    uint32_t timeout_ms;
+    size_t len = 0U;
+    int got = 0;
+
+    if (FlashLink_Open(&link, dev, baud, 1) != 0) {
+        perror(dev);
+        return -1;
+    }
+    FlashLink_Flush(&link);
+    if (FlashLink_Write(&link, cmd, sizeof(cmd) - 1U) != 0) {
+        perror(dev);
+        FlashLink_Close(&link);
+        return -1;
+    }
+
+    /* Skip text until the magic, then read the header and the events */
+    memset(hdr, 0, sizeof(hdr));
+    while (get_le32(hdr) != TRACE_MAGIC) {
+        memmove(hdr, &hdr[1], 3U);
+        if (FlashLink_Read(&link, &hdr[3], 1U, SYNC_TIMEOUT_MS) != 1) {
+            fprintf(stderr, "%s: no TRACE frame (recorder not built, BOOT_TRACE_ENABLE=0?)\n", dev);
+            FlashLink_Close(&link);
+            return -1;
+        }
+    }
+    if (FlashLink_Read(&link, &hdr[4], sizeof(hdr) - 4U, SYNC_TIMEOUT_MS) == (int)(sizeof(hdr) - 4U)) {
+        d->raw = hdr;
+        len = parse_header(d);
+        d->raw = (len != 0U) ? malloc(len) : NULL;
+        if (d->raw != NULL) {
+            memcpy(d->raw, hdr, sizeof(hdr));
+            /* 10 bits per byte, plus one second of slack */
+            timeout_ms = 1000U + (uint32_t)(((uint64_t)(len - sizeof(hdr)) * 10000U) / baud);
+            got = (FlashLink_Read(&link, &d->raw[sizeof(hdr)], len - sizeof(hdr), timeout_ms) ==
+                   (int)(len - sizeof(hdr)));
+        }
+    }
+    FlashLink_Close(&link);
+    if (got == 0) {
+        fprintf(stderr, "%s: TRACE frame incomplete\n", dev);
+        return -1;
+    }
+    d->raw_len = len;
+    return 0;
+}
+
+static const char *irq_name(uint32_t irq, char *buf, size_t size)
+{
+    switch (irq) {
+    case 18U: return "FTFC";
+    case 31U: return "LPUART0";
+    case 33U: return "LPUART1";
+    case 35U: return "LPUART2";
+    case 48U: case 49U: case 50U: case 51U:
+        snprintf(buf, size, "LPIT0_Ch%u", irq - 48U);
+        return buf;
+    case 59U: case 60U: case 61U: case 62U: case 63U:
+        snprintf(buf, size, "PORT%c", (int)('A' + (irq - 59U)));
+        return buf;
+    default:
+        snprintf(buf, size, "IRQ%u", irq);
+        return buf;
+    }
+}
+
+static void emit_sep(FILE *out, int *first)
+{
+    fputs((*first != 0) ? "\n  " : ",\n  ", out);
+    *first = 0;
+}
+
+static uint32_t stat_index(const char *name)
+{
+    uint32_t i;
+
+    for (i = 0U; i < stat_count; i++) {
+        if (strcmp(stats[i].name, name) == 0) {
+            return i;
+        }
+    }
+    if (stat_count < (sizeof(stats) / sizeof(stats[0]))) {
+        snprintf(stats[stat_count].name, sizeof(stats[0].name), "%s", name);
+        stat_count++;
+    }
+    return stat_count - 1U;
+}
+
+static void emit_begin(FILE *out, int *first, uint32_t tid, const char *name, double us, const char *args)
+{
+    track_t *t = &tracks[tid];
+
+    if (t->depth < (sizeof(t->open_us) / sizeof(t->open_us[0]))) {
+        t->open_us[t->depth]   = us;
+        t->open_stat[t->depth] = stat_index(name);
+    }
+    t->depth++;
+    emit_sep(out, first);
+    fprintf(out, "{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":%u%s}", name, us, tid, args);
+}
+
+static void emit_end(FILE *out, int *first, uint32_t tid, double us, const char *args)
+{
+    track_t *t = &tracks[tid];
+    slice_stat_t *st;
+    double dur;
+
+    if (t->depth == 0U) {
+        /* Begin is older than the ring */
+        return;
+    }
+    t->depth--;
+    if (t->depth < (sizeof(t->open_us) / sizeof(t->open_us[0]))) {
+        dur = us - t->open_us[t->depth];
+        st  = &stats[t->open_stat[t->depth]];
+        st->count++;
+        st->sum_us += dur;
+        if (dur > st->max_us) {
+            st->max_us = dur;
+        }
+    }
+    emit_sep(out, first);
+    fprintf(out, "{\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%u%s}", us, tid, args);
+}
+
+static void emit_instant(FILE *out, int *first, const char *name, double us, char scope, const char *args)
+{
+    emit_sep(out, first);
+    fprintf(out, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u%s}",
+            name, scope, us, TID_MAIN, args);
+}
+
+/**
+ * @brief Write the trace JSON and the per-track summary.
+ */
+static void convert(const trace_dump_t *d, FILE *out)
+{
+    const uint8_t *e;
+    char args[64];
+    char name[24];
+    uint64_t cycles = 0U;
+    uint32_t prev = 0U;
+    uint32_t word;
+    uint32_t arg;
+    uint32_t tid;
+    double us = 0.0;
+    int first = 1;
+    uint32_t i;
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"core_hz\":%u,\"recorded\":%u,\"lost\":%u},"
+                 "\"traceEvents\":[", d->core_hz, d->total, d->total - d->n);
+    emit_sep(out, &first);
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"S32K144 bootloader\"}}");
+    emit_sep(out, &first);
+    fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"main\"}}", TID_MAIN);
+
+    for (i = 0U; i < d->n; i++) {
+        e    = &d->raw[TRACE_HDR_BYTES + (i * TRACE_ENTRY_BYTES)];
+        word = get_le32(&e[4]);
+        arg  = word >> 8;
+
+        /* Unwrap CYCCNT: consecutive events are less than one wrap apart */
+        if (i != 0U) {
+            cycles += (uint32_t)(get_le32(e) - prev);
+        }
+        prev = get_le32(e);
+        us   = ((double)cycles * 1e6) / d->core_hz;
+
+        switch (word & 0xFFU) {
+        case EV_ISR_ENTER:
+        case EV_ISR_EXIT:
+            tid = TID_IRQ(arg & 0xFFU);
+            if (tracks[tid].named == 0U) {
+                tracks[tid].named = 1U;
+                emit_sep(out, &first);
+                fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                        tid, irq_name(arg & 0xFFU, name, sizeof(name)));
+            }
+            if ((word & 0xFFU) == EV_ISR_ENTER) {
+                emit_begin(out, &first, tid, irq_name(arg & 0xFFU, name, sizeof(name)), us, "");
+            } else {
+                emit_end(out, &first, tid, us, "");
+            }
+            break;
+        case EV_PARSE_BEGIN:
+            snprintf(args, sizeof(args), ",\"args\":{\"frame\":%u}", arg);
+            emit_begin(out, &first, TID_MAIN, "parse", us, args);
+            break;
+        case EV_PARSE_END:
+            snprintf(args, sizeof(args), ",\"args\":{\"data\":%u}", arg);
+            emit_end(out, &first, TID_MAIN, us, args);
+            break;
+        case EV_PROGRAM_BEGIN:
+            snprintf(args, sizeof(args), ",\"args\":{\"addr\":\"0x%06X\"}", arg);
+            emit_begin(out, &first, TID_MAIN, "program", us, args);
+            break;
+        case EV_ERASE_BEGIN:
+            snprintf(args, sizeof(args), ",\"args\":{\"addr\":\"0x%06X\"}", arg);
+            emit_begin(out, &first, TID_MAIN, "erase", us, args);
+            break;
+        case EV_PROGRAM_END:
+        case EV_ERASE_END:
+            emit_end(out, &first, TID_MAIN, us, "");
+            break;
+        case EV_LINE_RX:
+            snprintf(args, sizeof(args), ",\"args\":{\"len\":%u}", arg);
+            emit_instant(out, &first, "line", us, 't', args);
+            break;
+        case EV_QUEUE_FULL:
+            snprintf(args, sizeof(args), ",\"args\":{\"len\":%u}", arg);
+            emit_instant(out, &first, "queue full", us, 'p', args);
+            break;
+        case EV_UART_DROP:
+            snprintf(args, sizeof(args), ",\"args\":{\"byte\":%u}", arg & 0xFFU);
+            emit_instant(out, &first, "uart drop", us, 'p', args);
+            break;
+        default:
+            break;
+        }
+    }
+
+    /* Close slices still open at the last event */
+    for (tid = 0U; tid < TID_COUNT; tid++) {
+        while (tracks[tid].depth != 0U) {
+            emit_end(out, &first, tid, us, "");
+        }
+    }
+    fprintf(out, "\n]}\n");
+
+    fprintf(stderr, "%u events (%u recorded, %u lost), %.3f ms\n",
+            d->n, d->total, d->total - d->n, us / 1000.0);
+    for (i = 0U; i < stat_count; i++) {
+        if (stats[i].count != 0U) {
+            fprintf(stderr, "  %-10s %6u slices  avg %9.3f us  max %9.3f us\n",
+                    stats[i].name, stats[i].count, stats[i].sum_us / stats[i].count, stats[i].max_us);
+        }
+    }
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  -d, --device PATH    read the trace from the bootloader (TRACE command)\n"
+        "  -b, --baud N         baud rate (default %u)\n"
+        "  -i, --input FILE     read a dump saved with -w instead\n"
+        "  -w, --write FILE     save the received dump\n"
+        "  -o, --output FILE    trace JSON (default: stdout)\n",
+        prog, DEFAULT_BAUD);
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                   Main                                      */
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    static const struct option longopts[] = {
+        { "device", required_argument, NULL, 'd' },
+        { "baud",   required_argument, NULL, 'b' },
+        { "input",  required_argument, NULL, 'i' },
+        { "write",  required_argument, NULL, 'w' },
+        { "output", required_argument, NULL, 'o' },
+        { "help",   no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    const char *device = NULL;
+    const char *input = NULL;
+    const char *raw = NULL;
+    const char *output = NULL;
+    uint32_t baud = DEFAULT_BAUD;
+    trace_dump_t d;
+    FILE *out = stdout;
+    FILE *f;
+    int c;
+
+    while ((c = getopt_long(argc, argv, "d:b:i:w:o:h", longopts, NULL)) != -1) {
+        switch (c) {
+        case 'd': device = optarg; break;
+        case 'b': baud   = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'i': input  = optarg; break;
+        case 'w': raw    = optarg; break;
+        case 'o': output = optarg; break;
+        default:
+            usage(argv[0]);
+            return (c == 'h') ? 0 : 2;
+        }
+    }
+    if (((device == NULL) == (input == NULL)) || (optind != argc) || (baud == 0U)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    memset(&d, 0, sizeof(d));
+    if (((input != NULL) ? load_file(&d, input) : load_device(&d, device, baud)) != 0) {
+        return 1;
+    }
+
+    if (raw != NULL) {
+        f = fopen(raw, "wb");
+        if ((f == NULL) || (fwrite(d.raw, 1U, d.raw_len, f) != d.raw_len) || (fclose(f) != 0)) {
+            perror(raw);
+            return 1;
+        }
+    }
+    if (output != NULL) {
+        out = fopen(output, "w");
+        if (out == NULL) {
+            perror(output);
+            return 1;
+        }
+    }
+
+    convert(&d, out);
+
+    if ((out != stdout) && (fclose(out) != 0)) {
+        perror(output);
+        return 1;
+    }
+    free(d.raw);
+    return 0;
+}